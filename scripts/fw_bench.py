@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""Cycle cost per operation from test/fw_bench.hex, with baseline comparison.
+
+fw_bench times every peripheral and memory path with rdcycle and prints
+one row per operation on the UART (format in test/fw_bench.c). This
+script gets that table from one of
+
+  --iss (default)     verify/iss/iss (QSPI timing model, built if missing)
+  --cosim BIN         a Verilated RTL run: verify/obj_cosim/cosim_tb (§2.6)
+  --log FILE          a UART capture, e.g. from the FPGA board
+  --serial PORT       read the FPGA board's UART directly (115200 8N1,
+                      press reset after starting)
+
+prints it, and compares cyc/op against one target section of a baseline
+JSON (iss, rtl or fpga: each source has its own numbers). A row whose
+cyc/op grew by more than --tolerance (fraction) and --min-delta cycles is
+a regression; a missing row or a target that never printed DN is a
+failure. Exit status 1 on either.
+
+Only the iss section is committed. Its numbers come from the ISS QSPI
+timing model, which is not fitted to RTL or silicon (docs/verification.md
+§2.7), so comparing against it catches changes in the firmware or the
+model, not cycle counts of the chip. CI also runs the image on
+verify/obj_cosim/cosim_tb and uploads the table (test/fw_bench_rtl.json);
+the rtl and fpga sections are added with --save-baseline from such runs.
+
+Usage:
+  scripts/fw_bench.py                                       # ISS, compare to the committed baseline
+  scripts/fw_bench.py --save-baseline verify/fw_bench_baseline.json
+  scripts/fw_bench.py --cosim verify/obj_cosim/cosim_tb --target rtl
+  scripts/fw_bench.py --serial /dev/ttyUSB0 --target fpga --json fpga.json
+"""
+
+import argparse
+import json
+import os
+import re
+import select
+import subprocess
+import sys
+import tempfile
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+ISS_DIR = os.path.join(ROOT, "verify", "iss")
+IMAGE = os.path.join(ROOT, "test", "fw_bench.hex")
+BASELINE = os.path.join(ROOT, "verify", "fw_bench_baseline.json")
+
+ROW = re.compile(r"^B (\w+) (\d+) (\d+) (\d+)( nack)?\s*$")
+
+
+def parse(text):
+    """{name: {ops, cycles, cyc_per_op[, nack]}} and whether the run finished."""
+    rows = {}
+    for line in text.splitlines():
+        m = ROW.match(line.strip())
+        if m:
+            rows[m.group(1)] = {"ops": int(m.group(2)), "cycles": int(m.group(3)),
+                                "cyc_per_op": int(m.group(4)) / 10.0}
+            if m.group(5):
+                rows[m.group(1)]["nack"] = True
+    done = "BENCH" in text and re.search(r"^DN\s*$", text, re.M) is not None
+    return rows, done
+
+
+def from_iss(image, expect="DN\n", opts=()):
+    if subprocess.run(["make", "-C", ISS_DIR, "iss"], stdout=subprocess.DEVNULL).returncode:
+        sys.exit("cannot build verify/iss/iss")
+    r = subprocess.run([os.path.join(ISS_DIR, "iss"), "--expect", expect] + list(opts) + [image],
+                       stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True, errors="replace")
+    return r.stdout
+
+
+def from_cosim(binary, image):
+    with tempfile.NamedTemporaryFile(suffix=".uart") as f:
+        subprocess.run([binary, "--hex", image, "--expect", "DN\n", "--uart-file", f.name],
+                       stdout=subprocess.DEVNULL, stderr=subprocess.STDOUT)
+        return open(f.name, errors="replace").read()
+
+
+def from_serial(port, timeout, done=r"^DN\s*$"):
+    import termios
+    import tty
+    fd = os.open(port, os.O_RDONLY | os.O_NOCTTY)
+    try:
+        tty.setraw(fd)
+        attr = termios.tcgetattr(fd)
+        attr[4] = attr[5] = termios.B115200
+        termios.tcsetattr(fd, termios.TCSANOW, attr)
+        text, end = "", time.time() + timeout
+        while time.time() < end and not re.search(done, text, re.M):
+            if select.select([fd], [], [], 0.2)[0]:
+                text += os.read(fd, 4096).decode("ascii", "replace")
+        return text
+    finally:
+        os.close(fd)
+
+
+def compare(rows, base, tol, min_delta):
+    """[(name, status)] for every baseline row."""
+    out = []
+    for name, b in base.items():
+        r = rows.get(name)
+        if r is None:
+            out.append((name, "missing"))
+            continue
+        d = r["cyc_per_op"] - b["cyc_per_op"]
+        if d > min_delta and d > tol * b["cyc_per_op"]:
+            out.append((name, "REGRESSION %+.1f%%" % (100.0 * d / b["cyc_per_op"])))
+        elif -d > min_delta and -d > tol * b["cyc_per_op"]:
+            out.append((name, "faster %+.1f%%" % (100.0 * d / b["cyc_per_op"])))
+        else:
+            out.append((name, "ok"))
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    src = ap.add_mutually_exclusive_group()
+    src.add_argument("--iss", action="store_true", help="run on the ISS (default)")
+    src.add_argument("--cosim", metavar="BIN", help="run cosim_tb (Verilated RTL)")
+    src.add_argument("--log", metavar="FILE", help="parse a UART capture")
+    src.add_argument("--serial", metavar="PORT", help="read the FPGA board's UART")
+    ap.add_argument("--image", default=IMAGE, help="benchmark image (default test/fw_bench.hex)")
+    ap.add_argument("--timeout", type=float, default=30, help="--serial: seconds to wait for DN")
+    ap.add_argument("--target", help="baseline section (default iss, rtl for --cosim, fpga for --log/--serial)")
+    ap.add_argument("--baseline", default=BASELINE, help="baseline JSON (default verify/fw_bench_baseline.json)")
+    ap.add_argument("--save-baseline", metavar="FILE", help="write this run as the target's baseline")
+    ap.add_argument("--tolerance", type=float, default=0.05, help="allowed cyc/op growth (fraction)")
+    ap.add_argument("--min-delta", type=float, default=2.0, help="ignore changes below this many cycles")
+    ap.add_argument("--json", help="also write the rows as JSON")
+    args = ap.parse_args()
+
+    if args.cosim:
+        text, target = from_cosim(args.cosim, args.image), "rtl"
+    elif args.log:
+        text, target = open(args.log, errors="replace").read(), "fpga"
+    elif args.serial:
+        text, target = from_serial(args.serial, args.timeout), "fpga"
+    else:
+        text, target = from_iss(args.image), "iss"
+    target = args.target or target
+    if target == "iss":
+        print("iss: QSPI timing model numbers, a model regression only (not RTL/silicon cycles)")
+
+    rows, done = parse(text)
+    if not rows:
+        sys.exit("no benchmark rows in the output")
+    print("%-12s %6s %10s %10s" % ("operation", "ops", "cycles", "cyc/op"))
+    for name, r in rows.items():
+        print("%-12s %6d %10d %10.1f%s" % (name, r["ops"], r["cycles"], r["cyc_per_op"],
+                                           "  (nack)" if r.get("nack") else ""))
+    failed = 0 if done else 1
+    if not done:
+        print("run did not finish (no DN)")
+
+    if args.json:
+        with open(args.json, "w") as fh:
+            json.dump({"target": target, "rows": rows}, fh, indent=1, sort_keys=True)
+
+    if args.save_baseline:
+        data = json.load(open(args.save_baseline)) if os.path.exists(args.save_baseline) else {}
+        data[target] = {n: {"cyc_per_op": r["cyc_per_op"]} for n, r in rows.items()}
+        with open(args.save_baseline, "w") as fh:
+            json.dump(data, fh, indent=1, sort_keys=True)
+            fh.write("\n")
+        print("baseline %s: %s written" % (args.save_baseline, target))
+    elif os.path.exists(args.baseline):
+        base = json.load(open(args.baseline)).get(target)
+        if base is None:
+            print("no %s section in %s, nothing to compare" % (target, args.baseline))
+        else:
+            print("\nvs %s [%s], tolerance %.0f%% / %.1f cycles:" % (
+                os.path.relpath(args.baseline, ROOT), target, 100 * args.tolerance, args.min_delta))
+            for name, status in compare(rows, base, args.tolerance, args.min_delta):
+                if status != "ok":
+                    print("  %-12s %s" % (name, status))
+                failed += status == "missing" or status.startswith("REGRESSION")
+            print("%d regressions" % failed if failed else "no regressions")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
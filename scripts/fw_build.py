@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""Build test firmware images with riscv64-elf-gcc from their `Build:` comment.
+
+Every test/fw_*.c carries the gcc command line it is built with in its
+header (`Build:`). This script runs that line (scripts/fw_hal_compare.py
+parses it) for the named images, or for all of them, and writes
+DIR/fw_X.hex; it prints whether each image is identical to the committed
+test/fw_X.hex.
+
+With --out-dir test (the default is a separate directory) it replaces the
+committed images. CI builds every image into test/gcc and runs the ISS
+`make check` signatures on that directory (TEST_DIR=).
+
+Usage:
+  scripts/fw_build.py --out-dir test/gcc                    # every image
+  scripts/fw_build.py --cross riscv64-unknown-elf- fw_post  # Ubuntu's toolchain
+  scripts/fw_build.py --out-dir test fw_lora_node           # refresh a committed image
+"""
+
+import argparse
+import os
+import shutil
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from fw_hal_compare import TEST, build, build_flags, firmware_names  # noqa: E402
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("firmware", nargs="*", help="fw names (default: every test/fw_*.c)")
+    ap.add_argument("--cross", default=os.environ.get("CROSS", "riscv64-elf-"),
+                    help="toolchain prefix (default riscv64-elf-, or $CROSS)")
+    ap.add_argument("--out-dir", default=os.path.join(TEST, "gcc"),
+                    help="where fw_X.hex goes (default test/gcc)")
+    args = ap.parse_args()
+
+    if not shutil.which(args.cross + "gcc"):
+        sys.exit("%sgcc not found (--cross PREFIX)" % args.cross)
+    os.makedirs(args.out_dir, exist_ok=True)
+    names = args.firmware or firmware_names()
+
+    failed = 0
+    with tempfile.TemporaryDirectory(prefix="fw_build_") as work:
+        for name in names:
+            src = open(os.path.join(TEST, name + ".c")).read()
+            b, err = build(args.cross, src, build_flags(src, name), [], work, name)
+            if not b:
+                print("%-16s build failed\n%s" % (name, err))
+                failed += 1
+                continue
+            new = open(b["hex"]).read()
+            committed = os.path.join(TEST, name + ".hex")
+            old = open(committed).read() if os.path.exists(committed) else None
+            with open(os.path.join(args.out_dir, name + ".hex"), "w") as fh:
+                fh.write(new)
+            print("%-16s %6d B .text  %s" % (
+                name, b["text"], "new" if old is None else "same as committed" if old == new else "differs"))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+"""Code size and cycles of the test firmware: absolute vs tp-relative MMIO (test/fw_hal.h).
+
+For every test/fw_*.c this builds
+  before  the source as committed, or as of git revision --before REV
+  hal     the source with its register/bit #defines replaced by
+          #include "fw_hal.h" (a source already on the HAL: the same);
+          the image must be byte-identical to `before`
+  tp      `hal` with -DFW_HAL_TP: every register access `lw/sw OFF(tp)`
+with the flags of the "Build:" comment in the source, then runs each image
+on the ISS (verify/iss) with the UART signature of `make check` and reports
+.text bytes, cycles and instructions to the signature.
+
+Needs a RISC-V toolchain (riscv64-elf-gcc, or --cross PREFIX) and builds
+verify/iss/iss if missing. --write migrates the sources whose `hal` image
+is identical to the committed build, so the fw_*.hex files stay valid.
+
+All test sources are on the HAL now, so `before` equals `hal` unless
+--before names a revision that still has the define blocks: then a `hal`
+image that differs from `before` is a failure. CI runs it that way with
+riscv64-unknown-elf-gcc against the commit before the migration.
+
+Usage:
+  scripts/fw_hal_compare.py                    # every firmware
+  scripts/fw_hal_compare.py fw_post fw_p0b     # some of them
+  scripts/fw_hal_compare.py --json hal.json    # also write the table as JSON
+  scripts/fw_hal_compare.py --write            # move the sources onto fw_hal.h
+  scripts/fw_hal_compare.py --before REV       # HAL sources vs their define-block originals
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+TEST = os.path.join(ROOT, "test")
+ISS_DIR = os.path.join(ROOT, "verify", "iss")
+HAL = os.path.join(TEST, "fw_hal.h")
+
+
+def hal_names():
+    """Macros fw_hal.h defines; a test's own #define of one of these is dropped."""
+    return set(re.findall(r"^#define\s+(\w+)", open(HAL).read(), re.M))
+
+
+def migrate(src):
+    """Source with the HAL-covered #defines replaced by one #include, or None."""
+    names = hal_names()
+    out, included = [], False
+    for line in src.splitlines(keepends=True):
+        m = re.match(r"#define\s+(\w+)", line)
+        if m and m.group(1) in names:
+            if not included:
+                out.append('#include "fw_hal.h"\n')
+                included = True
+            continue
+        out.append(line)
+    return "".join(out) if included else None
+
+
+def firmware_names():
+    """Every test/fw_X.c with a `Build:` comment (not the driver sources it links)."""
+    return sorted(os.path.basename(p)[:-2] for p in glob.glob(os.path.join(TEST, "fw_*.c"))
+                  if re.search(r"//\s*Build:", open(p).read()))
+
+
+def build_flags(src, name):
+    """Compiler flags of the `Build:` comment (without compiler, -o and NAME.c).
+
+    Other sources on the line (fw_uart.c) stay in, relative to test/."""
+    m = re.search(r"//\s*Build:\s*\n((?://.*\n)+)", src)
+    if not m:
+        return ["-march=rv32ec_zicsr", "-mabi=ilp32e", "-nostdlib", "-Os", "-T", "fw_irq_timer.ld"]
+    lines = [l[2:].strip() for l in m.group(1).splitlines()]
+    cmd = " ".join(l for l in lines if l).replace("\\ ", " ").replace("\\", " ")
+    cmd = cmd.split("objcopy")[0]
+    toks = shlex.split(cmd)[1:]
+    flags, skip = [], False
+    for t in toks:
+        if skip:
+            skip = False
+            continue
+        if t == "-o":
+            skip = True
+            continue
+        if t == name + ".c" or "objcopy" in t:
+            continue
+        if t.startswith("riscv"):
+            break
+        flags.append(t)
+    return flags
+
+
+def iss_expectations():
+    """fw name -> (signature, extra iss options), from the ISS `make check` lines."""
+    out = {}
+    for line in open(os.path.join(ISS_DIR, "Makefile")):
+        m = re.search(r"\./iss --quiet --expect '([^']*)'\s+(.*?)\s*\$\(TEST_DIR\)/(fw_\w+)\.hex", line)
+        if m:
+            out[m.group(3)] = (m.group(1), m.group(2).split())
+    return out
+
+
+def git_source(rev, name):
+    """test/NAME.c as of revision REV, or None if it did not exist."""
+    r = run(["git", "show", "%s:test/%s.c" % (rev, name)], cwd=ROOT)
+    return r.stdout if r.returncode == 0 else None
+
+
+def run(cmd, cwd=None):
+    return subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+
+
+def build(cross, src_text, flags, defines, work, tag):
+    c = os.path.join(work, tag + ".c")
+    elf = os.path.join(work, tag + ".elf")
+    hexf = os.path.join(work, tag + ".hex")
+    with open(c, "w") as fh:
+        fh.write(src_text)
+    r = run([cross + "gcc"] + flags + defines + ["-I", TEST, "-o", elf, c], cwd=TEST)
+    if r.returncode:
+        return None, r.stdout
+    r = run([cross + "objcopy", "-O", "verilog", elf, hexf])
+    if r.returncode:
+        return None, r.stdout
+    size = run([cross + "size", elf]).stdout.splitlines()
+    text = int(size[1].split()[0]) if len(size) > 1 else 0
+    return {"elf": elf, "hex": hexf, "text": text}, ""
+
+
+def iss_run(iss, hexf, expect, opts):
+    r = run([iss, "--quiet", "--expect", expect] + opts + [hexf])
+    m = re.search(r": (\d+) cycles, (\d+) instructions", r.stdout)
+    return {"pass": r.returncode == 0, "cycles": int(m.group(1)) if m else 0,
+            "instret": int(m.group(2)) if m else 0}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("firmware", nargs="*", help="fw names (default: every test/fw_*.c)")
+    ap.add_argument("--cross", default=os.environ.get("CROSS", "riscv64-elf-"),
+                    help="toolchain prefix (default riscv64-elf-, or $CROSS)")
+    ap.add_argument("--json", help="write the results as JSON")
+    ap.add_argument("--before", metavar="REV",
+                    help="build `before` from the sources of git revision REV")
+    ap.add_argument("--write", action="store_true",
+                    help="migrate the sources whose HAL build is identical to the committed one")
+    args = ap.parse_args()
+
+    if not shutil.which(args.cross + "gcc"):
+        sys.exit("%sgcc not found (--cross PREFIX)" % args.cross)
+    iss = os.path.join(ISS_DIR, "iss")
+    if run(["make", "-C", ISS_DIR, "iss"]).returncode:
+        sys.exit("cannot build %s" % iss)
+
+    names = args.firmware or firmware_names()
+    expect = iss_expectations()
+    results, failed = {}, 0
+    print("%-16s %7s %7s %7s %6s  %9s %9s %7s  %s" % (
+        "firmware", "text", "hal", "tp", "Δtext", "cycles", "tp", "Δcyc", "status"))
+    with tempfile.TemporaryDirectory(prefix="fw_hal_") as work:
+        for name in names:
+            path = os.path.join(TEST, name + ".c")
+            src = open(path).read()
+            if args.before:                         # committed HAL source vs REV's
+                new, src = src, git_source(args.before, name) or src
+            else:
+                new = migrate(src) or src
+            if '#include "fw_hal.h"' not in new:
+                print("%-16s does not use MMIO, skipped" % name)
+                continue
+            flags = build_flags(src, name)
+            b, err_b = build(args.cross, src, flags, [], work, name + "_before")
+            h, err_h = build(args.cross, new, flags, [], work, name + "_hal")
+            t, err_t = build(args.cross, new, flags, ["-DFW_HAL_TP"], work, name + "_tp")
+            if not (b and h and t):
+                print("%-16s build failed\n%s" % (name, err_b or err_h or err_t))
+                failed += 1
+                continue
+            row = {"text": b["text"], "hal_text": h["text"], "tp_text": t["text"]}
+            status = []
+            same = open(b["hex"]).read() == open(h["hex"]).read()
+            if not same:
+                status.append("hal != before FAIL" if args.before else "hal != before")
+            if name in expect:
+                sig, opts = expect[name]
+                rb = iss_run(iss, b["hex"], sig, opts)
+                rt = iss_run(iss, t["hex"], sig, opts)
+                row.update(cycles=rb["cycles"], tp_cycles=rt["cycles"],
+                           instret=rb["instret"], tp_instret=rt["instret"])
+                if not rb["pass"]:
+                    status.append("before FAIL")
+                if not rt["pass"]:
+                    status.append("tp FAIL")
+            ok = "FAIL" not in " ".join(status)
+            failed += 0 if ok else 1
+            results[name] = row
+            cyc, tcyc = row.get("cycles"), row.get("tp_cycles")
+            print("%-16s %7d %7d %7d %+5.1f%%  %9s %9s %7s  %s" % (
+                name, row["text"], row["hal_text"], row["tp_text"],
+                100.0 * (row["tp_text"] - row["text"]) / row["text"],
+                cyc if cyc is not None else "-", tcyc if tcyc is not None else "-",
+                "%+.1f%%" % (100.0 * (tcyc - cyc) / cyc) if cyc else "-",
+                ", ".join(status) or "ok"))
+            if args.write and not args.before and ok and same and new != src:
+                with open(path, "w") as fh:
+                    fh.write(new)
+
+    if results:
+        t0 = sum(r["text"] for r in results.values())
+        t1 = sum(r["tp_text"] for r in results.values())
+        c0 = sum(r.get("cycles", 0) for r in results.values())
+        c1 = sum(r.get("tp_cycles", 0) for r in results.values())
+        print("\nTotal tp vs absolute: .text %d -> %d B (%+.1f%%), cycles %d -> %d (%+.1f%%)" % (
+            t0, t1, 100.0 * (t1 - t0) / t0, c0, c1, 100.0 * (c1 - c0) / c0 if c0 else 0.0))
+    if args.json:
+        with open(args.json, "w") as fh:
+            json.dump(results, fh, indent=1, sort_keys=True)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""CPU cost per sample of the sensor pipeline reference workload.
+
+test/fw_pipeline.hex is the production loop (timer tick, I2C reads of an
+SHT3x and a BME280, seal commit, batch frame, SX1268 uplink) as an
+interrupt-driven cooperative event loop. At the end of its window it prints
+
+  PL <ticks> <samples> <cycles> <idle cycles> <frames> <errors>
+  Q1Q2DN
+
+This script gets that line from one of
+
+  --iss (default)     verify/iss/iss --i2c-devices sht3x,bme280 --sx1268
+  --log FILE          a UART capture, e.g. from the FPGA board
+  --serial PORT       read the FPGA board's UART directly (press reset)
+
+and derives the busy cycles per sample: (cycles - idle cycles) / samples,
+where idle cycles are loop passes in which no stage had work. That is what
+the firmware and the memory path cost per sample, so it moves when either
+gets slower. samples/s is fixed by TICK_US (two samples per tick) and only
+shows that no tick was missed; it is printed, not compared. So is the
+idle fraction and the tick rate the busy time would allow,
+25 MHz / (2 * busy cycles per sample).
+
+A busy cycles per sample more than --tolerance (fraction) above the
+target's section of the baseline JSON is a regression; a failed Q1/Q2 or
+errors != 0 is a failure. Exit status 1 on either.
+
+The Verilated RTL harnesses have only the SHT31 stub on I2C, so there is
+no rtl target.
+
+Usage:
+  scripts/fw_pipeline.py                                    # ISS vs the committed baseline
+  scripts/fw_pipeline.py --save-baseline verify/fw_pipeline_baseline.json
+  scripts/fw_pipeline.py --serial /dev/ttyUSB0 --target fpga
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from fw_bench import ROOT, from_iss, from_serial  # noqa: E402
+
+IMAGE = os.path.join(ROOT, "test", "fw_pipeline.hex")
+BASELINE = os.path.join(ROOT, "verify", "fw_pipeline_baseline.json")
+ISS_OPTS = ["--i2c-devices", "sht3x,bme280", "--sx1268"]
+CLK_HZ = 25000000
+
+PL = re.compile(r"^PL (\d+) (\d+) (\d+) (\d+) (\d+) (\d+)\s*$", re.M)
+
+
+def parse(text):
+    """Metrics dict, or None when there is no PL line."""
+    m = PL.search(text)
+    if not m:
+        return None
+    ticks, samples, cycles, idle, frames, errors = (int(g) for g in m.groups())
+    return {
+        "ticks": ticks, "samples": samples, "cycles": cycles, "frames": frames, "errors": errors,
+        "busy_cyc_per_sample": round((cycles - idle) / samples, 1) if samples else 0.0,
+        "max_tick_hz": round(CLK_HZ * samples / (2.0 * (cycles - idle)), 1) if cycles > idle else 0.0,
+        "samples_per_s": round(samples * CLK_HZ / cycles, 2) if cycles else 0.0,
+        "idle_fraction": round(idle / cycles, 4) if cycles else 0.0,
+        "pass": "Q1Q2DN" in text,
+    }
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    src = ap.add_mutually_exclusive_group()
+    src.add_argument("--iss", action="store_true", help="run on the ISS (default)")
+    src.add_argument("--log", metavar="FILE", help="parse a UART capture")
+    src.add_argument("--serial", metavar="PORT", help="read the FPGA board's UART")
+    ap.add_argument("--image", default=IMAGE, help="workload image (default test/fw_pipeline.hex)")
+    ap.add_argument("--timeout", type=float, default=30, help="--serial: seconds to wait for DN")
+    ap.add_argument("--target", help="baseline section (default iss, fpga for --log/--serial)")
+    ap.add_argument("--baseline", default=BASELINE, help="baseline JSON (default verify/fw_pipeline_baseline.json)")
+    ap.add_argument("--save-baseline", metavar="FILE", help="write this run as the target's baseline")
+    ap.add_argument("--tolerance", type=float, default=0.02,
+                    help="allowed busy cycles per sample increase (fraction)")
+    ap.add_argument("--json", help="also write the metrics as JSON")
+    args = ap.parse_args()
+
+    if args.log:
+        text, target = open(args.log, errors="replace").read(), "fpga"
+    elif args.serial:
+        text, target = from_serial(args.serial, args.timeout, r"[QF]2DN"), "fpga"
+    else:
+        text, target = from_iss(args.image, "2DN", ISS_OPTS), "iss"
+    target = args.target or target
+
+    m = parse(text)
+    if m is None:
+        sys.exit("no PL line in the output")
+    print("%d ticks, %d samples, %d frames, %d errors in %d cycles" % (
+        m["ticks"], m["samples"], m["frames"], m["errors"], m["cycles"]))
+    print("busy cyc/sample %9.1f" % m["busy_cyc_per_sample"])
+    print("max tick rate   %9.1f Hz (busy time only)" % m["max_tick_hz"])
+    print("samples/s       %9.2f (set by TICK_US)" % m["samples_per_s"])
+    print("idle fraction   %9.4f" % m["idle_fraction"])
+    failed = 0
+    if not m["pass"] or m["errors"]:
+        print("self-check failed (want Q1Q2DN and 0 errors)")
+        failed = 1
+
+    if args.json:
+        with open(args.json, "w") as fh:
+            json.dump({"target": target, "metrics": m}, fh, indent=1, sort_keys=True)
+
+    keys = ("busy_cyc_per_sample",)
+    if args.save_baseline:
+        data = json.load(open(args.save_baseline)) if os.path.exists(args.save_baseline) else {}
+        data[target] = {k: m[k] for k in keys}
+        with open(args.save_baseline, "w") as fh:
+            json.dump(data, fh, indent=1, sort_keys=True)
+            fh.write("\n")
+        print("baseline %s: %s written" % (args.save_baseline, target))
+    elif os.path.exists(args.baseline):
+        base = json.load(open(args.baseline)).get(target)
+        if base is None:
+            print("no %s section in %s, nothing to compare" % (target, args.baseline))
+        else:
+            print("\nvs %s [%s]:" % (os.path.relpath(args.baseline, ROOT), target))
+            db = m["busy_cyc_per_sample"] - base["busy_cyc_per_sample"]
+            print("  busy cyc/sample %+9.1f (%+.1f%%)" % (db, 100.0 * db / base["busy_cyc_per_sample"]))
+            reg = db > args.tolerance * base["busy_cyc_per_sample"]
+            print("REGRESSION: busy cycles per sample" if reg else "no regressions")
+            failed += reg
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,97 @@
+#!/bin/bash
+# ============================================================================
+# Verilator gate-level simulation — RTL vs post-route netlist, same firmware
+# ============================================================================
+# Builds verify/gls_wrap.v + verify/gls_tb.cpp twice:
+#   obj_rtl  the RTL (src/ + tinyQV)
+#   obj_gl   the sg13g2 post-route netlist + verify/pdk/sg13g2_stdcell_nodelay.v
+#            (UDPs replaced by behavioral modules, verify/pdk/sg13g2_verilator.py)
+# then boots the same image on both and requires the UART output of the
+# gate-level run to match the RTL run byte for byte and cycle for cycle.
+#
+# Usage: scripts/gls_verilator.sh [HEX] [EXPECT]
+#   HEX      firmware image (default test/fw_post.hex)
+#   EXPECT   UART signature (default the full fw_post POST line)
+# Environment:
+#   NETLIST  gate-level netlist (default test/gate_level_netlist.v, copied in
+#            by the GDS action workflow like the cocotb GATES=yes flow)
+#   BUILD    build directory (default verify/gls_build)
+#   JOBS     parallel C++ compile jobs (default nproc)
+#
+# Needs Verilator 5. The netlist must be the IHP sg13g2 one: the snapshot
+# in tt_submission/ is an older sky130 netlist and is rejected.
+# ============================================================================
+
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+ROOT="$(cd "$SCRIPT_DIR/.." && pwd)"
+VERIFY="$ROOT/verify"
+
+HEX="$(realpath "${1:-$ROOT/test/fw_post.hex}")"
+EXPECT="${2:-POST\\nY1C1T1W1I1L1L2M1R1DN\\n}"
+NETLIST="${NETLIST:-$ROOT/test/gate_level_netlist.v}"
+BUILD="${BUILD:-$VERIFY/gls_build}"
+JOBS="${JOBS:-$(nproc)}"
+
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m'
+
+die() {
+    echo -e "${RED}$*${NC}" >&2
+    exit 1
+}
+
+[ -f "$HEX" ] || die "no firmware image: $HEX"
+[ -f "$NETLIST" ] || die "no netlist: $NETLIST (set NETLIST=, e.g. the GDS action's gate_level_netlist.v)"
+if ! grep -q 'sg13g2_' "$NETLIST"; then
+    grep -q 'sky130_fd_sc_' "$NETLIST" \
+        && die "$NETLIST is a sky130 netlist; this flow needs the ihp-sg13g2 one"
+    die "$NETLIST has no sg13g2 cells"
+fi
+command -v verilator >/dev/null || die "verilator not found (Verilator 5 required)"
+
+RTL_SRCS=(
+    "$ROOT"/src/*.v
+    "$ROOT"/src/tinyQV/cpu/*.v
+    "$ROOT"/src/tinyQV/peri/*/*.v
+)
+BOARD_SRCS=(
+    "$VERIFY/gls_wrap.v"
+    "$VERIFY/qspi_flash_model_sync.v"
+    "$VERIFY/qspi_psram_model_sync.v"
+    "$VERIFY/i2c_slave_model_sync.v"
+)
+
+mkdir -p "$BUILD"
+python3 "$VERIFY/pdk/sg13g2_verilator.py" "$BUILD/sg13g2_cells.v"
+
+# build NAME EXTRA_ARGS... -- SOURCES...
+build() {
+    local name="$1"
+    shift
+    echo "=== Building $name ==="
+    verilator --cc --exe --build --no-timing -Wno-fatal -Wno-lint -Wno-style \
+        -j "$JOBS" -O3 --x-assign fast --x-initial fast \
+        --top-module gls_wrap -GHEX_FILE="\"$HEX\"" \
+        --Mdir "$BUILD/obj_$name" -o gls_tb \
+        "$@" "${BOARD_SRCS[@]}" "$VERIFY/gls_tb.cpp" \
+        > "$BUILD/build_$name.log" 2>&1 \
+        || { tail -30 "$BUILD/build_$name.log"; die "$name build failed (see $BUILD/build_$name.log)"; }
+}
+
+build rtl -CFLAGS "-O2" "${RTL_SRCS[@]}"
+build gl -DGL_TEST -DFUNCTIONAL -DUSE_POWER_PINS -CFLAGS "-O2 -DGL_TEST" \
+    "$BUILD/sg13g2_cells.v" "$NETLIST"
+
+echo
+"$BUILD/obj_rtl/gls_tb" --expect "$EXPECT" --uart-log "$BUILD/uart_rtl.log" \
+    || die "RTL run failed"
+echo
+if "$BUILD/obj_gl/gls_tb" --expect "$EXPECT" --uart-log "$BUILD/uart_gl.log" \
+        --ref "$BUILD/uart_rtl.log"; then
+    echo -e "${GREEN}GLS matches RTL: $(basename "$HEX")${NC}"
+else
+    die "GLS differs from RTL: $(basename "$HEX")"
+fi
@@ -0,0 +1,93 @@
+#!/bin/bash
+# ============================================================================
+# IRQ latency sweep — fw_irq_* images under varying background load
+# ============================================================================
+# Builds verify/cosim_tb once per image (HEX_FILE is a Verilog parameter)
+# and runs it with --irq-latency for every load level below, writing
+#   $BUILD/<image>.<load>.csv   raw samples (irq, edge/entry/mmio cycles)
+#   $BUILD/<image>.<load>.log   histograms and the usual cosim checks
+#
+# Load levels:
+#   idle      no injected traffic
+#   dio1_20k  DIO1 (IRQ16) pulses every ~20000 cycles
+#   dio1_5k   DIO1 pulses every ~5000 cycles
+#   uart_rx   one UART RX byte every 4340 cycles (IRQ18 when enabled)
+# Injected interrupts only load the core when the image enables that IRQ;
+# they can change the image's own PASS/FAIL tags, so runs only wait for DN.
+#
+# Usage: scripts/irq_latency.sh [HEX...]   (default test/fw_irq_*.hex)
+# Environment:
+#   BUILD    output directory (default verify/irq_build)
+#   SEED     --seed for the DIO1 pulse jitter (default 1)
+#   BIN      histogram bucket in cycles (default 16)
+#   JOBS     parallel C++ compile jobs (default nproc)
+# ============================================================================
+
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+ROOT="$(cd "$SCRIPT_DIR/.." && pwd)"
+VERIFY="$ROOT/verify"
+
+BUILD="${BUILD:-$VERIFY/irq_build}"
+SEED="${SEED:-1}"
+BIN="${BIN:-16}"
+JOBS="${JOBS:-$(nproc)}"
+
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m'
+
+die() {
+    echo -e "${RED}$*${NC}" >&2
+    exit 1
+}
+
+command -v verilator >/dev/null || die "verilator not found (Verilator 5 required)"
+
+if [ $# -gt 0 ]; then
+    HEXES=("$@")
+else
+    HEXES=("$ROOT"/test/fw_irq_*.hex)
+fi
+
+LOADS=(
+    "idle|"
+    "dio1_20k|--dio1-pulse 20000"
+    "dio1_5k|--dio1-pulse 5000"
+    "uart_rx|--uart-rx-period 4340"
+)
+
+mkdir -p "$BUILD"
+status=0
+for hex in "${HEXES[@]}"; do
+    hex="$(realpath "$hex")"
+    name="$(basename "$hex" .hex)"
+    extra=()
+    [ "$name" = fw_irq_priority ] && extra=(--dio1-follows-led)
+
+    echo "=== Building cosim_tb for $name ==="
+    verilator --cc --exe --build --no-timing -Wno-fatal -Wno-lint -j "$JOBS" \
+        --top-module cosim_wrap -GHEX_FILE="\"$hex\"" --Mdir "$BUILD/obj_$name" -o cosim_tb \
+        "$VERIFY/cosim_wrap.v" "$VERIFY/qspi_flash_model_sync.v" "$VERIFY/qspi_psram_model_sync.v" \
+        "$VERIFY/i2c_slave_model_sync.v" "$ROOT"/src/*.v "$ROOT"/src/tinyQV/cpu/*.v "$ROOT"/src/tinyQV/peri/*/*.v \
+        "$VERIFY/cosim_tb.cpp" "$VERIFY/iss/rv32_core.cpp" "$VERIFY/iss/soc_model.cpp" \
+        "$VERIFY/iss/qspi_timing.cpp" "$VERIFY/iss/sx1268.cpp" \
+        -CFLAGS "-std=c++17 -O2 -I$VERIFY/iss -I$VERIFY" > "$BUILD/build_$name.log" 2>&1 \
+        || { tail -30 "$BUILD/build_$name.log"; die "$name build failed (see $BUILD/build_$name.log)"; }
+
+    for load in "${LOADS[@]}"; do
+        tag="${load%%|*}"
+        read -r -a args <<< "${load#*|}"
+        out="$BUILD/$name.$tag"
+        if "$BUILD/obj_$name/cosim_tb" --hex "$hex" --expect DN --seed "$SEED" --irq-bin "$BIN" \
+                --irq-latency "$out.csv" "${extra[@]}" "${args[@]}" > "$out.log" 2>&1; then
+            echo -e "${GREEN}--- $name, load $tag ---${NC}"
+        else
+            echo -e "${RED}--- $name, load $tag: cosim FAILED (see $out.log) ---${NC}"
+            status=1
+        fi
+        grep '^\[IRQ\]' "$out.log" || echo "  (no interrupts serviced)"
+    done
+done
+exit $status
@@ -18,6 +18,9 @@
 #   #2: seal_register.v  read_seq increment removed   (tb_seal detects)
 #   #3: watchdog.v       enabled<=1 → enabled<=0      (tb_watchdog detects)
 #   #5: crc16_engine.v   0xA001 → 0xA000              (tb_crc16 detects)
+#
+# scripts/mutate_matrix.py runs all of these (and more) against the whole TB
+# suite from one build and prints a kill matrix.
 # ============================================================================
 
 set -euo pipefail
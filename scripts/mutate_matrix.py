@@ -0,0 +1,319 @@
+#!/usr/bin/env python3
+"""Compile-once mutation testing: every mutant in one build, kill matrix out.
+
+mutate_check.sh applies one sed mutation at a time, recompiles and runs one
+TB, so only 2 of the 6 documented mutations are automated. This script
+instead writes a single mutated copy of the RTL in which every mutation
+site is guarded by a runtime mutant id:
+
+    wire i2c_data_rd = (connect_peripheral == PERI_I2C_DATA) &&
+                       ((mutant_id == 4) ? ((read_n != 2'b11)) : (read_complete));
+
+Each mutated module gets `integer mutant_id` set from the +MUTANT=N plusarg
+(0 = original design). Every TB of the CI suite is compiled once against
+that copy, then all (mutant, TB) pairs run in parallel with +MUTANT=N. A
+mutant is killed by a TB when the run does not print "ALL TESTS PASSED"
+(assertion failure, firmware hang -> timeout, or crash). The same mutated
+sources work under Verilator (Verilated::commandArgs passes +MUTANT=N).
+
+Mutant 0 runs first as the baseline: a TB that fails without mutation is
+reported and left out of the matrix.
+
+Usage:
+  scripts/mutate_matrix.py                    # all mutants x all TBs
+  scripts/mutate_matrix.py -j 16 --tb tb_seal --tb tb_watchdog
+  scripts/mutate_matrix.py --mutant 4 --mutant 6 --csv kill.csv
+  scripts/mutate_matrix.py --list
+
+Exit status 1 when a mutant survives every TB (or a TB fails the baseline).
+"""
+
+import argparse
+import concurrent.futures
+import os
+import shutil
+import subprocess
+import sys
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SRC = os.path.join(ROOT, "src")
+TEST = os.path.join(ROOT, "test")
+
+# ============================================================================
+# Mutants: (id, file in src/, anchor, original expression, mutant expression,
+# description). The anchor must match exactly one line; the original
+# expression must occur exactly once in it.
+# ============================================================================
+MUTANTS = [
+    (1, "seal_register.v", "mono_count <= mono_count + 1;",
+     "mono_count + 1", "mono_count",
+     "seal mono_count+1 -> mono_count"),
+    (2, "seal_register.v", "read_seq <= (read_seq == 2'd2) ? 2'd0 : read_seq + 1;",
+     "(read_seq == 2'd2) ? 2'd0 : read_seq + 1", "2'd0",
+     "seal read_seq stuck at 0"),
+    (3, "watchdog.v", "enabled <= 1'b1;",
+     "1'b1", "1'b0",
+     "WDT enabled<=1 -> enabled<=0"),
+    (4, "project.v", "wire        i2c_data_rd = (connect_peripheral == PERI_I2C_DATA) && read_complete;",
+     "read_complete", "(read_n != 2'b11)",
+     "i2c_data_rd read_complete -> read_n"),
+    (5, "crc16_engine.v", "crc_reg <= (crc_reg >> 1) ^ 16'hA001;",
+     "16'hA001", "16'hA000",
+     "CRC polynomial 0xA001 -> 0xA000"),
+    (6, "project.v", "wire        seal_data_rd = (connect_peripheral == PERI_SEAL_DATA) && read_complete;",
+     "read_complete", "(read_n != 2'b11)",
+     "seal_data_rd read_complete -> read_n"),
+    (7, "project.v", ".uart_rx_read(connect_peripheral == PERI_UART && read_complete),",
+     "read_complete", "(read_n != 2'b11)",
+     "uart_rx_read read_complete -> read_n"),
+    (8, "project.v", "assign crc_engine_dv   = seal_using_crc ? seal_crc_feed  : crc_peri_dv;",
+     "seal_using_crc ? seal_crc_feed  : crc_peri_dv", "seal_crc_feed | crc_peri_dv",
+     "CRC arbitration: CPU feed leaks into seal"),
+    (9, "watchdog.v", "if (kick && kick_value != 32'd0) begin",
+     "kick && kick_value != 32'd0", "kick",
+     "WDT kick with 0 accepted"),
+    (10, "seal_register.v", "commit_dropped <= 1'b1;",
+     "1'b1", "1'b0",
+     "seal commit_dropped never set"),
+    (11, "seal_register.v", "session_locked <= 1'b1;",
+     "1'b1", "1'b0",
+     "seal session_id never locked"),
+    (12, "project.v", "else if (pps_rising) pps_count <= pps_count + 1;",
+     "pps_rising", "pps_sync[1]",
+     "PPS counts level instead of edge"),
+    (13, "project.v", "if (timer_count == 32'd1) timer_irq <= 1;",
+     "32'd1", "32'd0",
+     "timer IRQ on 0 instead of 1"),
+]
+
+# ============================================================================
+# TB suite (mirrors .github/workflows/test.yaml): name -> (model files in
+# test/, RTL set, timeout in seconds)
+# ============================================================================
+UNIT = {
+    "tb_rtc":      ["rtc_counter.v"],
+    "tb_crc16":    ["crc16_engine.v", "crc16_peripheral.v"],
+    "tb_watchdog": ["watchdog.v"],
+    "tb_i2c":      ["i2c_master.v", "i2c_peripheral.v"],
+    "tb_seal":     ["seal_register.v", "crc16_engine.v"],
+}
+
+SOC_RTL = [
+    "project.v", "latch_mem.v", "crc16_engine.v", "crc16_peripheral.v",
+    "seal_register.v", "i2c_master.v", "i2c_peripheral.v", "watchdog.v",
+    "rtc_counter.v",
+    "tinyQV/cpu/tinyqv.v", "tinyQV/cpu/alu.v", "tinyQV/cpu/core.v",
+    "tinyQV/cpu/counter.v", "tinyQV/cpu/cpu.v", "tinyQV/cpu/decode.v",
+    "tinyQV/cpu/mem_ctrl.v", "tinyQV/cpu/qspi_ctrl.v", "tinyQV/cpu/register.v",
+    "tinyQV/cpu/latch_reg.v",
+    "tinyQV/peri/uart/uart_tx.v", "tinyQV/peri/uart/uart_rx.v",
+    "tinyQV/peri/spi/spi.v",
+]
+
+FLASH = ["qspi_flash_model.v"]
+FLASH_PSRAM = ["qspi_flash_model.v", "qspi_psram_model.v"]
+FLASH_PSRAM_I2C = ["qspi_flash_model.v", "qspi_psram_model.v", "i2c_slave_model.v"]
+
+SOC = {
+    "tb_project":               ([], 120),
+    "tb_integration":           (FLASH, 300),
+    "tb_integration_b":         (FLASH_PSRAM_I2C, 600),
+    "tb_read_clear_regression": ([], 120),
+    "tb_irq_timer":             (FLASH_PSRAM, 120),
+    "tb_wdt_reboot":            (FLASH_PSRAM, 120),
+    "tb_soft_reset":            (FLASH_PSRAM, 120),
+    "tb_i2c_stress":            (FLASH_PSRAM_I2C, 120),
+    "tb_crc_arb":               (FLASH_PSRAM, 120),
+    "tb_timer_edge":            (FLASH_PSRAM, 120),
+    "tb_i2c_nack":              (FLASH_PSRAM_I2C, 120),
+    "tb_concurrent":            (FLASH_PSRAM_I2C, 120),
+}
+
+INCLUDES = ["-I{src}", "-I{src}/tinyQV/cpu", "-I{src}/tinyQV/peri/pwm",
+            "-I{src}/tinyQV/peri/spi", "-I{src}/tinyQV/peri/ttgame",
+            "-I{src}/tinyQV/peri/uart"]
+
+PASS_MARK = "ALL TESTS PASSED"
+
+
+def tb_sources(name, src):
+    """Source list and timeout for one TB against RTL tree `src`."""
+    if name in UNIT:
+        return [name + ".v"] + [os.path.join(src, f) for f in UNIT[name]], 120
+    models, timeout = SOC[name]
+    rtl = list(SOC_RTL)
+    if name == "tb_project":
+        rtl += ["tinyQV/peri/pwm/pwm.v", "tinyQV/peri/ttgame/ttgame.v"]
+    return [name + ".v"] + models + [os.path.join(src, f) for f in rtl], timeout
+
+
+# ============================================================================
+# Mutated RTL
+# ============================================================================
+def guard(mid, orig, mut):
+    return "((mutant_id == %d) ? (%s) : (%s))" % (mid, mut, orig)
+
+
+def write_mutated_tree(out_src, mutants):
+    """Copy src/ to out_src and splice the mutant guards in."""
+    if os.path.isdir(out_src):
+        shutil.rmtree(out_src)
+    shutil.copytree(SRC, out_src, ignore=shutil.ignore_patterns(".git", "*.mutate_backup"))
+    by_file = {}
+    for m in mutants:
+        by_file.setdefault(m[1], []).append(m)
+
+    for fname, ms in by_file.items():
+        path = os.path.join(out_src, fname)
+        with open(path) as f:
+            lines = f.read().split("\n")
+        for mid, _, anchor, orig, mut, _ in ms:
+            hits = [i for i, l in enumerate(lines) if anchor in " ".join(l.split())
+                    or anchor in l]
+            if len(hits) != 1:
+                sys.exit("mutant #%d: anchor matches %d lines in %s" % (mid, len(hits), fname))
+            line = lines[hits[0]]
+            if line.count(orig) != 1:
+                sys.exit("mutant #%d: '%s' occurs %d times in %s:%d"
+                         % (mid, orig, line.count(orig), fname, hits[0] + 1))
+            lines[hits[0]] = line.replace(orig, guard(mid, orig, mut))
+
+        # mutant_id after the module port list (first ");" line)
+        mod = next((i for i, l in enumerate(lines) if l.lstrip().startswith("module ")), None)
+        end = next((i for i in range(mod or 0, len(lines)) if lines[i].strip() == ");"), None)
+        if mod is None or end is None:
+            sys.exit("cannot find the module header in %s" % fname)
+        lines[end + 1:end + 1] = [
+            "",
+            "    // Mutation testing (scripts/mutate_matrix.py): +MUTANT=N, 0 = original",
+            "    integer mutant_id;",
+            "    initial if (!$value$plusargs(\"MUTANT=%d\", mutant_id)) mutant_id = 0;",
+        ]
+        with open(path, "w") as f:
+            f.write("\n".join(lines))
+
+
+# ============================================================================
+# Build and run
+# ============================================================================
+def compile_tb(name, src, build):
+    srcs, timeout = tb_sources(name, src)
+    out = os.path.join(build, name + ".vvp")
+    cmd = ["iverilog", "-g2012", "-DSIM", "-o", out] + \
+          [i.format(src=src) for i in INCLUDES] + srcs
+    r = subprocess.run(cmd, cwd=TEST, capture_output=True, text=True)
+    if r.returncode != 0:
+        return name, None, timeout, r.stderr.strip().splitlines()[-5:]
+    return name, out, timeout, []
+
+
+def run_one(vvp, mid, timeout, log):
+    """Returns 'pass', 'fail' or 'timeout'."""
+    try:
+        with open(log, "w") as f:
+            subprocess.run(["vvp", "-n", vvp, "+MUTANT=%d" % mid], cwd=TEST,
+                           stdout=f, stderr=subprocess.STDOUT, timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return "timeout"
+    with open(log, errors="replace") as f:
+        return "pass" if PASS_MARK in f.read() else "fail"
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 4)
+    ap.add_argument("--tb", action="append", help="limit to these TBs (repeatable)")
+    ap.add_argument("--mutant", type=int, action="append", help="limit to these ids (repeatable)")
+    ap.add_argument("--build", default=os.path.join(TEST, "mutate_build"))
+    ap.add_argument("--csv", help="also write the kill matrix as CSV")
+    ap.add_argument("--list", action="store_true", help="list mutants and TBs, then exit")
+    args = ap.parse_args()
+
+    tbs = list(UNIT) + list(SOC)
+    if args.list:
+        for m in MUTANTS:
+            print("#%-3d %-16s %s" % (m[0], m[1], m[5]))
+        print("TBs: " + " ".join(tbs))
+        return 0
+    if args.tb:
+        bad = [t for t in args.tb if t not in tbs]
+        if bad:
+            sys.exit("unknown TB: " + " ".join(bad))
+        tbs = args.tb
+    mutants = [m for m in MUTANTS if not args.mutant or m[0] in args.mutant]
+    if not mutants:
+        sys.exit("no mutants selected")
+
+    os.makedirs(args.build, exist_ok=True)
+    src = os.path.join(args.build, "src")
+    logs = os.path.join(args.build, "logs")
+    os.makedirs(logs, exist_ok=True)
+    # All mutants are spliced in even when only some are run, so the build
+    # is the same for every selection.
+    write_mutated_tree(src, MUTANTS)
+
+    t0 = time.time()
+    vvps, timeouts = {}, {}
+    with concurrent.futures.ThreadPoolExecutor(args.jobs) as pool:
+        for name, vvp, timeout, err in pool.map(lambda t: compile_tb(t, src, args.build), tbs):
+            if vvp is None:
+                print("[COMPILE FAIL] %s" % name)
+                for l in err:
+                    print("    " + l)
+                continue
+            vvps[name] = vvp
+            timeouts[name] = timeout
+    print("Compiled %d TBs once with %d mutants in %.0f s" % (len(vvps), len(MUTANTS), time.time() - t0))
+
+    # Baseline, then every (mutant, TB) pair
+    t0 = time.time()
+    jobs = [(0, t) for t in vvps] + [(m[0], t) for m in mutants for t in vvps]
+    result = {}
+
+    def job(mt):
+        mid, tb = mt
+        log = os.path.join(logs, "%s.m%d.log" % (tb, mid))
+        return mt, run_one(vvps[tb], mid, timeouts[tb], log)
+
+    with concurrent.futures.ThreadPoolExecutor(args.jobs) as pool:
+        for mt, r in pool.map(job, jobs):
+            result[mt] = r
+    print("Ran %d simulations in %.0f s (-j %d)" % (len(jobs), time.time() - t0, args.jobs))
+
+    broken = [t for t in vvps if result[(0, t)] != "pass"]
+    for t in broken:
+        print("[BASELINE FAIL] %s (%s) — left out of the matrix, see %s"
+              % (t, result[(0, t)], os.path.join(logs, t + ".m0.log")))
+    cols = [t for t in vvps if t not in broken]
+
+    # Kill matrix: K = assertion failure, T = timeout/hang, . = survived
+    mark = {"fail": "K", "timeout": "T", "pass": "."}
+    short = [c[3:] if c.startswith("tb_") else c for c in cols]
+    print("")
+    print("%-4s %-42s " % ("#", "mutant") + " ".join("%s" % s[:4].ljust(4) for s in short) + "  kills")
+    survivors = []
+    for mid, _, _, _, _, desc in mutants:
+        row = [mark[result[(mid, c)]] for c in cols]
+        kills = sum(1 for x in row if x != ".")
+        if kills == 0:
+            survivors.append(mid)
+        print("%-4d %-42s " % (mid, desc[:42]) + " ".join(x.ljust(4) for x in row) + "  %d" % kills)
+    print("")
+    print("Columns: " + ", ".join(cols))
+    killed = len(mutants) - len(survivors)
+    print("MUTATION SCORE: %d/%d killed (%.0f%%)" % (killed, len(mutants), 100.0 * killed / len(mutants)))
+    if survivors:
+        print("SURVIVED: " + " ".join("#%d" % m for m in survivors))
+
+    if args.csv:
+        with open(args.csv, "w") as f:
+            f.write("id,mutant," + ",".join(cols) + "\n")
+            for mid, _, _, _, _, desc in mutants:
+                f.write("%d,\"%s\"," % (mid, desc) + ",".join(mark[result[(mid, c)]] for c in cols) + "\n")
+
+    return 1 if survivors or broken else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
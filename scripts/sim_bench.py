@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+"""Verilator simulation throughput benchmark with baseline comparison.
+
+Builds every Verilator harness from scratch with one fixed set of options,
+runs it once (or --repeat times, best run kept) and records per harness:
+
+    build_s        wall time of `verilator --build` (clean Mdir)
+    run_s          wall time of the run
+    cycles         clock cycles simulated (the harness prints "[PERF] N cycles")
+    cycles_per_s   cycles / run_s
+    peak_rss_kb    peak resident set size of the run (wait4 ru_maxrss)
+
+Harnesses: the cov_*_tb unit/bus benches, seal_cov_tb, tb/verilator/sim_seal
+(only when HUB_INC points at the seal_engine.hpp include dir) and the
+full-SoC POST boot (cov_project_tb on fw_post.hex).
+
+Usage:
+  scripts/sim_bench.py                              # all, JSON to verify/bench_build/bench.json
+  scripts/sim_bench.py cov_wdt soc_post --repeat 3
+  scripts/sim_bench.py --save-baseline verify/bench_build/baseline.json
+  scripts/sim_bench.py --baseline baseline.json --tolerance 0.10 --build-tolerance 0.30
+  scripts/sim_bench.py --compare new.json --baseline baseline.json   # no builds
+  scripts/sim_bench.py --list
+
+A regression is cycles_per_s lower, or build_s / peak_rss_kb higher, than
+the baseline by more than the tolerance (a fraction). A different cycle
+count is reported as a workload change (the harness or firmware changed,
+so the two numbers are not comparable). Exit status 1 on any regression,
+failed build or failed run.
+"""
+
+import argparse
+import glob
+import json
+import os
+import platform
+import re
+import shutil
+import subprocess
+import sys
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SRC = os.path.join(ROOT, "src")
+VERIFY = os.path.join(ROOT, "verify")
+TBV = os.path.join(ROOT, "tb", "verilator")
+BUILD = os.path.join(VERIFY, "bench_build")
+
+# Same for every harness, so numbers are comparable between commits
+VERILATOR_FLAGS = ["--cc", "--exe", "--build", "--no-timing", "-Wno-fatal", "-Wno-lint", "-Wno-style",
+                   "-O3", "--x-assign", "fast", "--x-initial", "fast"]
+CFLAGS = "-O2 -std=c++17 -I%s -I%s" % (os.path.join(VERIFY, "iss"), VERIFY)
+
+TINYQV = sorted(glob.glob(os.path.join(SRC, "tinyQV", "cpu", "*.v")) +
+                glob.glob(os.path.join(SRC, "tinyQV", "peri", "*", "*.v")))
+SOC_BOARD = [os.path.join(VERIFY, f) for f in
+             ("cov_project_wrap.v", "qspi_flash_model_sync.v", "qspi_psram_model_sync.v",
+              "i2c_slave_model_sync.v")]
+
+# name: top module, Verilog sources, C++ sources, extra Verilator flags,
+# run arguments, run directory, directories the run writes into (relative
+# to the run directory), environment variable the build needs
+HARNESSES = {
+    "cov_crc16": dict(top="cov_crc16_wrap",
+                      v=[os.path.join(VERIFY, "cov_crc16_wrap.v"), os.path.join(SRC, "crc16_peripheral.v"),
+                         os.path.join(SRC, "crc16_engine.v")],
+                      cpp=[os.path.join(VERIFY, "cov_crc16_tb.cpp")],
+                      flags=["--coverage"], run_dirs=["verify/obj_crc16"]),
+    "cov_i2c": dict(top="cov_i2c_wrap",
+                    v=[os.path.join(VERIFY, "cov_i2c_wrap.v"), os.path.join(SRC, "i2c_peripheral.v"),
+                       os.path.join(SRC, "i2c_master.v")],
+                    cpp=[os.path.join(VERIFY, "cov_i2c_tb.cpp"), os.path.join(VERIFY, "iss", "i2c_devices.cpp")],
+                    flags=["--coverage"]),
+    "cov_latch": dict(top="latch_mem", v=[os.path.join(SRC, "latch_mem.v")],
+                      cpp=[os.path.join(VERIFY, "cov_latch_tb.cpp")],
+                      flags=["--coverage"], run_dirs=["verify/obj_latch"]),
+    "cov_rtc": dict(top="rtc_counter", v=[os.path.join(SRC, "rtc_counter.v")],
+                    cpp=[os.path.join(VERIFY, "cov_rtc_tb.cpp")],
+                    flags=["--coverage"], run_dirs=["verify/obj_rtc"]),
+    "cov_wdt": dict(top="watchdog", v=[os.path.join(SRC, "watchdog.v")],
+                    cpp=[os.path.join(VERIFY, "cov_wdt_tb.cpp")],
+                    flags=["--coverage"], run_dirs=["verify/obj_wdt"]),
+    "seal_cov": dict(top="seal_register", v=[os.path.join(SRC, "seal_register.v")],
+                     cpp=[os.path.join(VERIFY, "seal_cov_tb.cpp")],
+                     flags=["--coverage", "--trace"], args=["--no-trace"]),
+    "sim_seal": dict(top="seal_tb_top",
+                     v=[os.path.join(TBV, "seal_tb_top.v"), os.path.join(SRC, "seal_register.v"),
+                        os.path.join(SRC, "crc16_engine.v")],
+                     cpp=[os.path.join(TBV, "sim_seal.cpp")],
+                     flags=[], needs="HUB_INC"),
+    "soc_post": dict(top="cov_project_wrap",
+                     v=SOC_BOARD + sorted(glob.glob(os.path.join(SRC, "*.v"))) + TINYQV,
+                     cpp=[os.path.join(VERIFY, "cov_project_tb.cpp")],
+                     flags=["--coverage"], cwd=VERIFY),
+}
+
+METRICS = [  # (key, higher is better)
+    ("cycles_per_s", True),
+    ("build_s", False),
+    ("peak_rss_kb", False),
+]
+
+
+def tool_version(cmd):
+    try:
+        out = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True).stdout
+        return out.splitlines()[0].strip() if out else "?"
+    except OSError:
+        return "not found"
+
+
+def timed(cmd, cwd, log_path):
+    """Runs cmd with output to log_path; returns (rc, wall s, peak RSS kB)."""
+    with open(log_path, "w") as log:
+        t0 = time.perf_counter()
+        p = subprocess.Popen(cmd, cwd=cwd, stdout=log, stderr=subprocess.STDOUT)
+        _, status, ru = os.wait4(p.pid, 0)
+        wall = time.perf_counter() - t0
+    p.returncode = os.waitstatus_to_exitcode(status)
+    return p.returncode, wall, ru.ru_maxrss
+
+
+def tail(path, n=20):
+    with open(path, errors="replace") as fh:
+        return "".join(fh.readlines()[-n:])
+
+
+def bench(name, h, jobs, repeat):
+    mdir = os.path.join(BUILD, "obj_" + name)
+    shutil.rmtree(mdir, ignore_errors=True)
+    os.makedirs(mdir)
+    cflags = CFLAGS
+    if h.get("needs"):
+        cflags += " -I" + os.environ[h["needs"]]
+    cmd = (["verilator"] + VERILATOR_FLAGS + ["-j", str(jobs)] + h["flags"] +
+           ["--top-module", h["top"], "--Mdir", mdir, "-o", name, "-CFLAGS", cflags] + h["v"] + h["cpp"])
+    build_log = os.path.join(BUILD, "build_%s.log" % name)
+    rc, build_s, build_rss = timed(cmd, ROOT, build_log)
+    res = {"status": "BUILD_FAIL", "build_s": round(build_s, 2), "build_peak_rss_kb": build_rss}
+    if rc:
+        sys.stdout.write(tail(build_log))
+        return res
+
+    cwd = h.get("cwd") or mdir
+    for d in h.get("run_dirs", []):
+        os.makedirs(os.path.join(cwd, d), exist_ok=True)
+    run_log = os.path.join(BUILD, "run_%s.log" % name)
+    best = None
+    for _ in range(repeat):
+        rc, run_s, rss = timed([os.path.join(mdir, name)] + h.get("args", []), cwd, run_log)
+        m = re.search(r"^\[PERF\] (\d+) cycles", open(run_log, errors="replace").read(), re.M)
+        if rc or not m:
+            sys.stdout.write(tail(run_log))
+            res.update(status="RUN_FAIL" if rc else "NO_PERF", run_s=round(run_s, 3))
+            return res
+        if best is None or run_s < best[0]:
+            best = (run_s, int(m.group(1)), rss)
+    run_s, cycles, rss = best
+    res.update(status="PASS", run_s=round(run_s, 3), cycles=cycles,
+               cycles_per_s=round(cycles / run_s) if run_s > 0 else 0, peak_rss_kb=rss)
+    return res
+
+
+def compare(report, baseline, tol, build_tol):
+    """Prints the metric diff; returns the number of regressions."""
+    regressions = 0
+    if report["host"] != baseline.get("host"):
+        print("note: baseline host differs: %s" % baseline.get("host"))
+    print("%-10s %-13s %14s %14s %8s" % ("HARNESS", "METRIC", "BASELINE", "NOW", "DELTA"))
+    for name, now in report["harnesses"].items():
+        base = baseline.get("harnesses", {}).get(name)
+        if not base or base.get("status") != "PASS" or now.get("status") != "PASS":
+            continue
+        if now["cycles"] != base["cycles"]:
+            print("%-10s workload changed: %d -> %d cycles, not compared" % (name, base["cycles"], now["cycles"]))
+            continue
+        for key, higher_better in METRICS:
+            b, n = base.get(key), now.get(key)
+            if not b or n is None:
+                continue
+            delta = (n - b) / b
+            limit = build_tol if key == "build_s" else tol
+            bad = -delta > limit if higher_better else delta > limit
+            regressions += bad
+            print("%-10s %-13s %14s %14s %+7.1f%%%s" % (name, key, b, n, 100 * delta, "  REGRESSION" if bad else ""))
+    return regressions
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("harness", nargs="*", help="harnesses to run (default all)")
+    ap.add_argument("--repeat", type=int, default=1, help="runs per harness, fastest kept")
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1, help="C++ compile jobs")
+    ap.add_argument("--out", default=os.path.join(BUILD, "bench.json"))
+    ap.add_argument("--baseline", help="JSON from an earlier run to compare against")
+    ap.add_argument("--save-baseline", metavar="FILE", help="also write the result to FILE")
+    ap.add_argument("--compare", metavar="FILE", help="compare FILE with --baseline, no builds")
+    ap.add_argument("--tolerance", type=float, default=0.10, help="cycles/s and RSS (default 0.10)")
+    ap.add_argument("--build-tolerance", type=float, default=0.30, help="build time (default 0.30)")
+    ap.add_argument("--list", action="store_true")
+    args = ap.parse_args()
+
+    if args.list:
+        for name, h in HARNESSES.items():
+            need = "  (needs %s)" % h["needs"] if h.get("needs") else ""
+            print("%-10s %-18s %s%s" % (name, h["top"], " ".join(os.path.relpath(c, ROOT) for c in h["cpp"]), need))
+        return 0
+
+    if args.compare:
+        if not args.baseline:
+            ap.error("--compare needs --baseline")
+        with open(args.compare) as fh, open(args.baseline) as bh:
+            return 1 if compare(json.load(fh), json.load(bh), args.tolerance, args.build_tolerance) else 0
+
+    names = args.harness or list(HARNESSES)
+    for n in names:
+        if n not in HARNESSES:
+            ap.error("unknown harness %s (--list)" % n)
+    if not shutil.which("verilator"):
+        sys.exit("verilator not found (Verilator 5 required)")
+
+    os.makedirs(BUILD, exist_ok=True)
+    report = {
+        "host": "%s %s, %d cpus" % (platform.node(), platform.machine(), os.cpu_count() or 1),
+        "verilator": tool_version(["verilator", "--version"]),
+        "cxx": tool_version([os.environ.get("CXX", "g++"), "--version"]),
+        "commit": subprocess.run(["git", "rev-parse", "--short", "HEAD"], cwd=ROOT, stdout=subprocess.PIPE,
+                                 stderr=subprocess.DEVNULL, text=True).stdout.strip(),
+        "flags": " ".join(VERILATOR_FLAGS) + " -CFLAGS '%s'" % CFLAGS,
+        "repeat": args.repeat,
+        "harnesses": {},
+    }
+
+    failed = 0
+    print("%-10s %8s %8s %12s %14s %10s  %s" % ("HARNESS", "BUILD s", "RUN s", "CYCLES", "CYCLES/s", "RSS MB", "STATUS"))
+    for name in names:
+        h = HARNESSES[name]
+        if h.get("needs") and not os.environ.get(h["needs"]):
+            report["harnesses"][name] = {"status": "SKIP"}
+            print("%-10s %8s %8s %12s %14s %10s  SKIP (%s not set)" % (name, "-", "-", "-", "-", "-", h["needs"]))
+            continue
+        r = bench(name, h, args.jobs, args.repeat)
+        report["harnesses"][name] = r
+        failed += r["status"] != "PASS"
+        print("%-10s %8.1f %8s %12s %14s %10s  %s" % (
+            name, r["build_s"], "%.2f" % r["run_s"] if "run_s" in r else "-", r.get("cycles", "-"),
+            "{:,}".format(r["cycles_per_s"]) if "cycles_per_s" in r else "-",
+            "%.1f" % (r["peak_rss_kb"] / 1024) if "peak_rss_kb" in r else "-", r["status"]), flush=True)
+
+    for path in filter(None, [args.out, args.save_baseline]):
+        with open(path, "w") as fh:
+            json.dump(report, fh, indent=2)
+        print("wrote %s" % path)
+
+    regressions = 0
+    if args.baseline:
+        print()
+        with open(args.baseline) as fh:
+            regressions = compare(report, json.load(fh), args.tolerance, args.build_tolerance)
+        print("\n%d regression(s) beyond tolerance" % regressions)
+    return 1 if failed or regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,542 @@
+#!/usr/bin/env python3
+"""Incremental regression: run only the tests a change can affect, most relevant first.
+
+Builds the module graph of every Verilog file in src/, test/ and verify/
+(module definitions, instantiations, `include and the images named in
+$readmemh / HEX_FILE strings) and elaborates each test of the suite from its
+top module:
+
+    tb_*, lint, synth, timescale, iss   steps of .github/workflows/test.yaml
+    cocotb:<suite>                      test/test_*.mk (RTL build)
+    mutate_check                        scripts/mutate_check.sh (RTL_SRCS + TBs)
+    verilator:<harness>                 verify/ harnesses (scripts/sim_bench.py)
+    soclib                              verify/soclib `make check`
+
+A test depends on the files of the modules it elaborates ("elab"), on files
+it only compiles ("compile": listed but never instantiated), and on its own
+sources (testbench C++/Python, images, the file that defines the step).
+Lint, synth and timescale steps depend on every file they list.
+
+Changed files come from `git diff --name-only BASE` plus untracked files
+(or --files). Affected tests run in priority order:
+  1. recorded coverage hits in the changed modules (--coverage-map, most
+     first; a test recorded with zero hits goes after unrecorded ones)
+  2. instance depth of the closest changed module below the test's top
+     (the unit TB of a block before the SoC tests that contain it)
+  3. estimated cost (CI timeout)
+then the rest: compile-only tests, and with --all every unaffected test.
+Changing test.yaml or this script selects the whole suite.
+
+Coverage per test is recorded from Verilator coverage.dat files (points
+with a non-zero count, per module):
+  scripts/test_select.py --record-coverage verilator:soc_post verify/coverage.dat
+
+Usage:
+  scripts/test_select.py                       # plan for the working tree vs HEAD
+  scripts/test_select.py --base origin/main --run
+  scripts/test_select.py --files src/rtc_counter.v --run --limit 5
+  scripts/test_select.py --list                # every test, top and dependencies
+"""
+
+import argparse
+import collections
+import glob
+import json
+import os
+import re
+import shlex
+import subprocess
+import sys
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SCRIPTS = os.path.join(ROOT, "scripts")
+SRC = os.path.join(ROOT, "src")
+TEST = os.path.join(ROOT, "test")
+VERIFY = os.path.join(ROOT, "verify")
+WORKFLOW = os.path.join(ROOT, ".github", "workflows", "test.yaml")
+COVERAGE_MAP = os.path.join(VERIFY, "coverage_map.json")
+
+# Changing one of these can change any test
+GLOBAL = [WORKFLOW, os.path.abspath(__file__)]
+
+SKIP_DIRS = ("/.", "_build", "obj_", "sim_build", "/build")
+
+VERILOG_WORDS = {
+    "module", "endmodule", "input", "output", "inout", "wire", "reg", "logic", "integer", "real",
+    "genvar", "parameter", "localparam", "assign", "always", "initial", "begin", "end", "if", "else",
+    "case", "casez", "casex", "endcase", "for", "while", "repeat", "forever", "function", "endfunction",
+    "task", "endtask", "generate", "endgenerate", "default", "posedge", "negedge", "or", "and", "not",
+    "signed", "unsigned", "return", "fork", "join", "disable", "wait", "specify", "endspecify",
+}
+
+
+def rel(path):
+    return os.path.relpath(path, ROOT)
+
+
+# ============================================================================
+# Verilog module graph
+# ============================================================================
+class VerilogFile:
+    def __init__(self, path):
+        self.path = path
+        self.modules = {}           # name -> set of instantiated identifiers
+        self.includes = []
+        self.images = []            # "*.hex" / "*.mem" string literals
+        try:
+            text = open(path, errors="replace").read()
+        except OSError:
+            self.parsed = False
+            return
+        self.parsed = True
+        self.images = re.findall(r'"([\w./-]+\.(?:hex|mem))"', text)
+        text = re.sub(r"/\*.*?\*/", " ", text, flags=re.S)
+        text = re.sub(r"//[^\n]*", " ", text)
+        self.includes = re.findall(r'`include\s+"([^"]+)"', text)
+        for m in re.finditer(r"\bmodule\s+(\w+)(.*?)\bendmodule\b", text, re.S):
+            body = m.group(2)
+            insts = set()
+            for i in re.finditer(r"(?:^|;|\bbegin\b|\bend\b|\belse\b|\))\s*([A-Za-z_]\w*)\s*"
+                                 r"(?:#\s*\((?:[^()]|\([^()]*\))*\)\s*)?([A-Za-z_]\w*)\s*(?:\[[^\]]*\]\s*)?\(",
+                                 body, re.M):
+                if i.group(1) not in VERILOG_WORDS and i.group(2) not in VERILOG_WORDS:
+                    insts.add(i.group(1))
+            self.modules[m.group(1)] = insts
+
+
+class Design:
+    def __init__(self):
+        self.files = {}
+        self.defs = collections.defaultdict(list)       # module -> [paths]
+        for base in (SRC, TEST, VERIFY):
+            for d, _, names in os.walk(base):
+                if any(s in d for s in SKIP_DIRS):
+                    continue
+                for n in names:
+                    if n.endswith((".v", ".sv")):
+                        self.file(os.path.join(d, n))
+
+    def file(self, path):
+        path = os.path.abspath(path)
+        if path not in self.files:
+            vf = self.files[path] = VerilogFile(path)
+            for name in vf.modules:
+                self.defs[name].append(path)
+        return self.files[path]
+
+
+class Test:
+    def __init__(self, name, kind, command, cost, files=(), top=None, cwd=ROOT, whole=False, extra=()):
+        self.name = name
+        self.kind = kind
+        self.command = command          # shell, run from ROOT
+        self.cost = cost                # seconds, rough
+        self.files = [os.path.abspath(f) for f in files]
+        self.top = top
+        self.cwd = cwd
+        self.whole = whole              # depends on every listed file (lint/synth)
+        self.extra = {os.path.abspath(f) for f in extra}
+        self.elab = {}                  # path -> min depth
+        self.depth = {}                 # module -> min depth
+        self.count = collections.Counter()      # module -> instances
+        self.compile_only = set()
+        self.tops = []
+
+    def elaborate(self, design):
+        for f in self.files:
+            design.file(f)
+        local = {}
+        for f in self.files:
+            for m in design.files[f].modules:
+                local.setdefault(m, f)
+        if self.top:
+            tops = [self.top]
+        else:
+            used = set()
+            for f in self.files:
+                for insts in design.files[f].modules.values():
+                    used |= insts
+            tops = [m for m in local if m not in used]
+        self.tops = tops
+
+        def paths(m):
+            if m in local:
+                return [local[m]]
+            return design.defs.get(m, [])
+
+        queue = collections.deque((m, 0) for m in tops)
+        while queue:
+            m, d = queue.popleft()
+            self.count[m] += 1
+            if m in self.depth and self.depth[m] <= d and self.count[m] > 1:
+                continue
+            self.depth[m] = min(d, self.depth.get(m, d))
+            for p in paths(m):
+                if self.elab.get(p, 1 << 30) > d:
+                    self.elab[p] = d
+                vf = design.files[p]
+                for inc in vf.includes:
+                    for cand in [os.path.join(os.path.dirname(p), inc), os.path.join(SRC, inc),
+                                 os.path.join(SRC, "tinyQV", "cpu", inc)]:
+                        if os.path.exists(cand):
+                            self.elab.setdefault(os.path.abspath(cand), d)
+                for img in vf.images:
+                    for cand in [os.path.join(self.cwd, img), os.path.join(TEST, img)]:
+                        if os.path.exists(cand):
+                            self.extra.add(os.path.abspath(cand))
+                            break
+                for sub in vf.modules.get(m, ()):
+                    if sub in local or sub in design.defs:
+                        queue.append((sub, d + 1))
+        for f in self.files:
+            if f not in self.elab:
+                if self.whole or not design.files[f].parsed:
+                    self.elab[f] = 0    # lint/synth read it; unparsed: assume it matters
+                else:
+                    self.compile_only.add(f)
+
+
+# ============================================================================
+# Suite discovery
+# ============================================================================
+def verilog_tokens(script, cwd):
+    """.v/.vlt paths in a shell script, globbed relative to cwd."""
+    out = []
+    for tok in re.findall(r"[\w./*${}-]+\.(?:v|vlt)\b", script):
+        if "$" in tok:
+            continue
+        path = os.path.join(cwd, tok)
+        hits = sorted(glob.glob(path)) if "*" in tok else [path]
+        out.extend(os.path.abspath(h) for h in hits)
+    return out
+
+
+def workflow_steps():
+    """(name, run script) of every step of test.yaml, without a YAML parser."""
+    steps, name, run, run_indent = [], None, None, None
+    for line in open(WORKFLOW):
+        stripped = line.strip()
+        indent = len(line) - len(line.lstrip())
+        if run is not None:
+            if stripped and indent <= run_indent:
+                steps.append((name, "".join(run)))
+                run = None
+            else:
+                run.append(line[run_indent + 2:] if len(line) > run_indent + 2 else "\n")
+                continue
+        m = re.match(r"\s*- name:\s*(.*)", line)
+        if m:
+            name = m.group(1).strip().strip('"')
+        elif re.match(r"\s*run:\s*\|", line):
+            run, run_indent = [], indent
+    if run is not None:
+        steps.append((name, "".join(run)))
+    return steps
+
+
+def ci_tests():
+    tests = []
+    for name, script in workflow_steps():
+        m = re.search(r"^\s*cd\s+(\S+)", script, re.M)
+        cwd = os.path.join(ROOT, m.group(1)) if m else ROOT
+        command = "bash -eo pipefail -c %s" % shlex.quote(script)
+        out = re.search(r"iverilog\b.*?-o\s+(\w+)\.vvp", script)
+        if out:
+            tm = re.search(r"timeout\s+(\d+)", script)
+            tests.append(Test(out.group(1), "ci", command, int(tm.group(1)) if tm else 10,
+                              verilog_tokens(script, cwd), cwd=cwd, extra=[WORKFLOW]))
+        elif "verilator --lint-only" in script:
+            tests.append(Test("lint", "ci", command, 20, verilog_tokens(script, cwd), whole=True, extra=[WORKFLOW]))
+        elif "yosys -p" in script:
+            files = verilog_tokens(script.replace(":", " "), cwd)
+            tests.append(Test("synth", "ci", command, 30, files, whole=True, extra=[WORKFLOW]))
+        elif "timescale" in script:
+            tests.append(Test("timescale", "ci", command, 1, verilog_tokens(script, cwd), whole=True,
+                              extra=[WORKFLOW]))
+        elif "make check" in script and "verify/iss" in script:
+            iss = os.path.join(VERIFY, "iss")
+            extra = [os.path.join(iss, f) for f in os.listdir(iss) if f.endswith((".cpp", ".h", "Makefile"))]
+            mk = open(os.path.join(iss, "Makefile")).read()
+            extra += [os.path.join(TEST, h) for h in set(re.findall(r"(fw_\w+\.hex)", mk))]
+            tests.append(Test("iss", "ci", command, 30, extra=extra + [WORKFLOW]))
+    return tests
+
+
+def cocotb_tests():
+    tests = []
+    for mk in sorted(glob.glob(os.path.join(TEST, "test_*.mk"))):
+        text = re.sub(r"\\\n", " ", open(mk).read())
+        suite = os.path.basename(mk)[5:-3]
+        m = re.search(r"^PROJECT_SOURCES\s*=\s*(.*)$", text, re.M)
+        files = verilog_tokens(m.group(1), SRC) if m else []
+        for line in re.findall(r"^VERILOG_SOURCES\s*\+=\s*(.*)$", text, re.M):
+            if "PDK_ROOT" in line or "runs/" in line or "gate_level" in line or "SRC_DIR" in line:
+                continue
+            files += verilog_tokens(line.replace("$(PWD)/", ""), TEST)
+        top = re.search(r"^TOPLEVEL\s*=\s*(\w+)", text, re.M)
+        prog = re.search(r"^PROG\s*\?=\s*(\w+)", text, re.M)
+        module = re.search(r"^MODULE\s*=\s*(\S+)", text, re.M)
+        extra = [mk, os.path.join(TEST, "test_util.py")]
+        if module:
+            mod = module.group(1).replace("$(PROG)", prog.group(1) if prog else "")
+            extra.append(os.path.join(TEST, mod + ".py"))
+        if prog:
+            extra.append(os.path.join(TEST, prog.group(1) + ".hex"))
+        command = ("cd test && make -f %s && ! grep -q '<failure' results.xml" % os.path.basename(mk))
+        tests.append(Test("cocotb:" + suite, "cocotb", command, 300, files,
+                          top=top.group(1) if top else None, cwd=TEST, extra=extra))
+    return tests
+
+
+def mutate_tests():
+    path = os.path.join(SCRIPTS, "mutate_check.sh")
+    text = re.sub(r"\\\n", " ", open(path).read())
+    m = re.search(r"RTL_SRCS=\((.*?)\)", text, re.S)
+    files = [os.path.join(ROOT, p) for p in re.findall(r'"\$ROOT/([^"]+)"', m.group(1))] if m else []
+    for call in re.findall(r"^run_mutation\s+(.*)$", text, re.M):
+        files += [os.path.join(TEST, t) for t in re.findall(r"\b(\w+\.v)\b", call.rsplit('"', 1)[-1])]
+    return [Test("mutate_check", "script", "scripts/mutate_check.sh", 600, sorted(set(files)),
+                 cwd=TEST, extra=[path])]
+
+
+def cpp_deps(paths):
+    """C++ sources plus the local headers they include, transitively."""
+    out, todo = set(), list(paths)
+    while todo:
+        p = os.path.abspath(todo.pop())
+        if p in out or not os.path.exists(p):
+            continue
+        out.add(p)
+        for inc in re.findall(r'#include\s+"([^"]+)"', open(p, errors="replace").read()):
+            for d in (os.path.dirname(p), VERIFY, os.path.join(VERIFY, "iss")):
+                cand = os.path.join(d, inc)
+                if os.path.exists(cand):
+                    todo.append(cand)
+                    break
+    return out
+
+
+def harness_tests():
+    sys.path.insert(0, SCRIPTS)
+    import sim_bench
+    tests = []
+    for name, h in sim_bench.HARNESSES.items():
+        cwd = h.get("cwd", ROOT)
+        tests.append(Test("verilator:" + name, "verilator", "scripts/sim_bench.py " + name,
+                          600 if name == "soc_post" else 120, h["v"], top=h["top"], cwd=cwd,
+                          extra=cpp_deps(h["cpp"]) | {sim_bench.__file__}))
+    return tests
+
+
+def soclib_tests():
+    d = os.path.join(VERIFY, "soclib")
+    if not os.path.isdir(d):
+        return []
+    files = [os.path.join(VERIFY, f) for f in ("cosim_wrap.v", "qspi_flash_model_sync.v",
+                                               "qspi_psram_model_sync.v", "i2c_slave_model_sync.v")]
+    files += sorted(glob.glob(os.path.join(SRC, "*.v")) + glob.glob(os.path.join(SRC, "tinyQV", "cpu", "*.v")) +
+                    glob.glob(os.path.join(SRC, "tinyQV", "peri", "*", "*.v")))
+    srcs = glob.glob(os.path.join(d, "*.cpp")) + glob.glob(os.path.join(d, "tests", "*.cpp"))
+    extra = cpp_deps(srcs) | {os.path.join(d, "Makefile"), os.path.join(d, "images.txt")}
+    images = os.path.join(d, "images.txt")
+    if os.path.exists(images):
+        extra |= {os.path.join(TEST, h) for h in re.findall(r"^(fw_\w+\.hex)", open(images).read(), re.M)}
+    for src in srcs:
+        extra |= {os.path.join(TEST, h) for h in re.findall(r'"(fw_\w+\.hex)"', open(src).read())}
+    return [Test("soclib", "verilator", "make -C verify/soclib check", 900, files, top="cosim_wrap",
+                 cwd=VERIFY, extra=extra)]
+
+
+def suite(design):
+    tests = ci_tests() + cocotb_tests() + mutate_tests() + harness_tests() + soclib_tests()
+    for t in tests:
+        t.elaborate(design)
+    return tests
+
+
+# ============================================================================
+# Selection
+# ============================================================================
+def changed_files(base):
+    def git(*args):
+        return subprocess.run(["git"] + list(args), cwd=ROOT, stdout=subprocess.PIPE, text=True,
+                              check=True).stdout.split()
+    files = git("diff", "--name-only", base) + git("ls-files", "--others", "--exclude-standard")
+    return sorted({os.path.join(ROOT, f) for f in files})
+
+
+def expand(path):
+    """Firmware sources stand for the image built from them; a firmware
+    header (fw_hal.h, fw_uart.h) for every image whose source includes it,
+    a driver source (fw_uart.c) for every image whose Build: line links it."""
+    out = {path}
+    stem, ext = os.path.splitext(path)
+    base = os.path.basename(stem)
+    if ext == ".c" and base.startswith("fw_") and not os.path.exists(stem + ".hex"):
+        for src in glob.glob(os.path.join(TEST, "fw_*.c")):
+            if src != path and re.search(r"^//.*\s%s\b" % re.escape(base + ".c"), open(src).read(), re.M):
+                out |= expand(src)
+    elif ext in (".c", ".ld") and base.startswith("fw_"):
+        out.add(stem + ".hex")
+    elif ext == ".h" and base.startswith("fw_") and os.path.dirname(path) == TEST:
+        for src in glob.glob(os.path.join(TEST, "fw_*.c")) + glob.glob(os.path.join(TEST, "fw_*.h")):
+            if src != path and '#include "%s"' % os.path.basename(path) in open(src).read():
+                out |= expand(src)
+    return out
+
+
+def coverage_hits(cov, test, modules):
+    rec = cov.get(test.name)
+    if rec is None:
+        return None
+    return sum(rec.get(m, 0) for m in modules)
+
+
+def select(tests, design, changed, cov):
+    """Returns [(test, reason, depth, hits)] affected, [(test, reason)] compile-only, unmatched files."""
+    given = changed
+    changed = set().union(*(expand(c) for c in given)) if given else set()
+    if changed & set(GLOBAL):
+        return [(t, "suite definition", 0, None) for t in tests], [], []
+    mods = {}
+    for c in changed:
+        if c in design.files:
+            for m in design.files[c].modules:
+                mods[m] = c
+        elif c.endswith((".v", ".sv")) and os.path.exists(c):
+            for m in design.file(c).modules:
+                mods[m] = c
+    affected, compile_only, seen = [], [], set()
+    for t in tests:
+        elab = {c for c in changed if c in t.elab}
+        own = {c for c in changed if c in t.extra}
+        if elab or own:
+            hit_mods = [m for m, f in mods.items() if f in elab and m in t.depth]
+            depth = 0 if t.whole or own else min(t.depth[m] for m in hit_mods)
+            reason = ", ".join(sorted(hit_mods) or [rel(c) for c in sorted(own)])[:60]
+            affected.append((t, reason, depth, coverage_hits(cov, t, hit_mods) if hit_mods else None))
+            seen |= elab | own
+        elif changed & t.compile_only:
+            compile_only.append((t, ", ".join(rel(c) for c in sorted(changed & t.compile_only))[:60]))
+            seen |= changed & t.compile_only
+
+    def rank(a):
+        t, _, depth, hits = a
+        cov_rank = 1 if hits is None else (0 if hits else 2)
+        return (cov_rank, -(hits or 0), depth, t.cost, t.name)
+    affected.sort(key=rank)
+    compile_only.sort(key=lambda a: (a[0].cost, a[0].name))
+    unmatched = sorted(c for c in given if not expand(c) & seen and os.path.exists(c))
+    return affected, compile_only, unmatched
+
+
+# ============================================================================
+# Coverage map
+# ============================================================================
+def record_coverage(design, path, test, dat):
+    """Adds covered points per module of a Verilator coverage.dat under `test`."""
+    by_file = collections.Counter()
+    for raw in open(dat, errors="replace"):
+        if not raw.startswith("C '"):
+            continue
+        body, _, count = raw.rstrip("\n").rpartition("' ")
+        if int(count or 0) == 0:
+            continue
+        fields = dict(item.split("\x02", 1) for item in body[3:].split("\x01") if "\x02" in item)
+        by_file[os.path.basename(fields.get("f", ""))] += 1
+    per_module = collections.Counter()
+    for p, vf in design.files.items():
+        n = by_file.get(os.path.basename(p), 0)
+        for m in vf.modules:
+            per_module[m] += n
+    cov = json.load(open(path)) if os.path.exists(path) else {}
+    cov[test] = {m: n for m, n in per_module.items() if n}
+    with open(path, "w") as fh:
+        json.dump(cov, fh, indent=1, sort_keys=True)
+    print("%s: %d modules with coverage -> %s" % (test, len(cov[test]), rel(path)))
+
+
+# ============================================================================
+# Main
+# ============================================================================
+def run(plan, keep_going):
+    passed = failed = 0
+    for t in plan:
+        print("\n=== %s ===\n%s" % (t.name, t.command if len(t.command) < 200 else t.command[:200] + " ..."),
+              flush=True)
+        t0 = time.time()
+        rc = subprocess.call(t.command, shell=True, cwd=ROOT, executable="/bin/bash")
+        status = "PASS" if rc == 0 else "FAIL"
+        print("[%s] %s (%.0f s)" % (status, t.name, time.time() - t0), flush=True)
+        if rc == 0:
+            passed += 1
+        else:
+            failed += 1
+            if not keep_going:
+                break
+    print("\n=== Results: %d PASS, %d FAIL, %d not run ===" % (passed, failed, len(plan) - passed - failed))
+    return 1 if failed else 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("--base", default="HEAD", help="git revision to diff against (default HEAD)")
+    ap.add_argument("--files", nargs="+", help="changed files instead of git diff")
+    ap.add_argument("--all", action="store_true", help="append the unaffected tests")
+    ap.add_argument("--no-compile-only", action="store_true",
+                    help="skip tests that only compile the changed files")
+    ap.add_argument("--limit", type=int, help="run at most N tests of the plan")
+    ap.add_argument("--run", action="store_true", help="run the plan (default: print it)")
+    ap.add_argument("--keep-going", action="store_true", help="do not stop at the first failure")
+    ap.add_argument("--coverage-map", default=COVERAGE_MAP)
+    ap.add_argument("--record-coverage", nargs=2, metavar=("TEST", "COVERAGE_DAT"))
+    ap.add_argument("--list", action="store_true", help="print every test and its dependencies")
+    args = ap.parse_args()
+
+    design = Design()
+    if args.record_coverage:
+        record_coverage(design, args.coverage_map, *args.record_coverage)
+        return 0
+    tests = suite(design)
+
+    if args.list:
+        for t in tests:
+            print("%-28s %-9s top=%s elab=%d compile-only=%d other=%d cost=%ds" % (
+                t.name, t.kind, ",".join(t.tops) or "-", len(t.elab), len(t.compile_only), len(t.extra), t.cost))
+        return 0
+
+    changed = [os.path.abspath(f) for f in args.files] if args.files else changed_files(args.base)
+    cov = json.load(open(args.coverage_map)) if os.path.exists(args.coverage_map) else {}
+    affected, compile_only, unmatched = select(tests, design, changed, cov)
+
+    print("Changed (%d): %s" % (len(changed), " ".join(rel(c) for c in changed) or "-"))
+    if unmatched:
+        print("No test depends on: %s" % " ".join(rel(c) for c in unmatched))
+    print("\n%3s  %-28s %-5s %6s %6s  %s" % ("#", "TEST", "DEPTH", "COV", "COST", "WHY"))
+    plan = []
+    for t, why, depth, hits in affected:
+        plan.append(t)
+        print("%3d  %-28s %5d %6s %5ds  %s" % (len(plan), t.name, depth, "-" if hits is None else hits, t.cost, why))
+    if compile_only and not args.no_compile_only:
+        print("     -- compile only (listed, not elaborated) --")
+        for t, why in compile_only:
+            plan.append(t)
+            print("%3d  %-28s %5s %6s %5ds  %s" % (len(plan), t.name, "-", "-", t.cost, why))
+    rest = [t for t in tests if t not in plan and not (args.no_compile_only and t in [c[0] for c in compile_only])]
+    if args.all and rest:
+        print("     -- not affected --")
+        for t in rest:
+            plan.append(t)
+            print("%3d  %-28s %5s %6s %5ds" % (len(plan), t.name, "-", "-", t.cost))
+    print("\n%d of %d tests selected, ~%d s (full suite ~%d s)" % (
+        len(plan), len(tests), sum(t.cost for t in plan), sum(t.cost for t in tests)))
+    if args.limit is not None:
+        plan = plan[:args.limit]
+    if not args.run:
+        return 0
+    return run(plan, args.keep_going)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
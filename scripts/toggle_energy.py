@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+"""Per-instance toggle activity and rough dynamic energy from Verilator toggle counts.
+
+Reads a coverage.dat written by a model built with --coverage-toggle
+(cosim_tb --toggle-dat, or cov_project_tb's coverage.dat for POST), groups
+the toggle points by instance below the DUT (i_crc16, i_seal, i_wdt,
+i_tinyqv, ...; signals of project.v itself are "(project)") and estimates
+dynamic energy with rough IHP SG13G2 numbers (1.2 V, typical corner):
+
+    flop bit   E_CLK per clock cycle (clock pin + local clock net, paid
+               whether or not D changes: what clock gating removes)
+               + E_REG per output transition
+    net bit    E_NET per transition (average gate input + wire load)
+
+The defaults are order-of-magnitude figures for ranking blocks, not a
+power sign-off; override them with --e-clk/--e-reg/--e-net (fJ).
+
+A signal is a flop when it is declared `reg` and assigned with `<=` in its
+source file; other toggle points are nets. Input ports are skipped (the
+driving net is counted in the parent). Verilator counts each transition;
+versions that split 0->1 / 1->0 points are summed.
+
+Usage:
+  scripts/toggle_energy.py verify/toggle.dat --cycles 2000000
+  scripts/toggle_energy.py toggle.dat --log cosim.log --depth 2 --top 30
+  scripts/toggle_energy.py coverage.dat --cycles 75000000 --json energy.json
+"""
+
+import argparse
+import collections
+import json
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+E_CLK = 10.0    # fJ per flop bit per cycle
+E_REG = 20.0    # fJ per flop output transition
+E_NET = 6.0     # fJ per net transition
+
+
+def parse_dat(path):
+    """Yields (hier, signal, file, line, count) for every toggle point."""
+    with open(path, errors="replace") as fh:
+        for raw in fh:
+            if not raw.startswith("C '"):
+                continue
+            body, _, count = raw.rstrip("\n").rpartition("' ")
+            fields = {}
+            for item in body[3:].split("\x01"):
+                if "\x02" in item:
+                    k, v = item.split("\x02", 1)
+                    fields[k] = v
+            if fields.get("t") != "toggle" and not fields.get("page", "").startswith("v_toggle"):
+                continue
+            yield (fields.get("h", ""), fields.get("o", ""), fields.get("f", ""),
+                   int(fields.get("l", "0") or 0), int(count))
+
+
+class Sources:
+    """Declaration lookup: which toggle points are flops, which are input ports."""
+
+    def __init__(self):
+        self.by_name = collections.defaultdict(list)
+        for d, _, files in os.walk(ROOT):
+            if "/." in d or "_build" in d or "obj_" in d:
+                continue
+            for f in files:
+                if f.endswith((".v", ".sv")):
+                    self.by_name[f].append(os.path.join(d, f))
+        self.text = {}
+
+    def lines(self, fname):
+        if fname not in self.text:
+            cands = [fname, os.path.join(ROOT, fname), os.path.join(ROOT, "verify", fname)]
+            cands += self.by_name.get(os.path.basename(fname), [])
+            path = next((c for c in cands if os.path.isfile(c)), None)
+            self.text[fname] = open(path, errors="replace").read().split("\n") if path else []
+        return self.text[fname]
+
+    def kind(self, fname, line, name):
+        """'flop', 'net' or 'input'."""
+        lines = self.lines(fname)
+        decl = lines[line - 1] if 0 < line <= len(lines) else ""
+        if re.search(r"\binput\b", decl):
+            return "input"
+        if re.search(r"\breg\b", decl):
+            nb = re.compile(r"\b%s\s*(\[[^\]]*\]\s*)*<=" % re.escape(name))
+            if any(nb.search(l) for l in lines):
+                return "flop"
+        return "net"
+
+
+def group_of(hier, depth):
+    parts = hier.split(".")
+    if "dut" not in parts:
+        return None
+    below = parts[parts.index("dut") + 1:]
+    return ".".join(below[:depth]) if below else "(project)"
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("dat")
+    ap.add_argument("--cycles", type=int, help="clock cycles covered by the counts")
+    ap.add_argument("--log", help="take --cycles from a cosim_tb log ([TOGGLE] N cycles)")
+    ap.add_argument("--depth", type=int, default=1, help="instance levels below dut per group")
+    ap.add_argument("--top", type=int, default=20, help="signals to list")
+    ap.add_argument("--e-clk", type=float, default=E_CLK)
+    ap.add_argument("--e-reg", type=float, default=E_REG)
+    ap.add_argument("--e-net", type=float, default=E_NET)
+    ap.add_argument("--json", help="write the table as JSON")
+    args = ap.parse_args()
+
+    cycles = args.cycles
+    if args.log:
+        m = re.search(r"^\[TOGGLE\] (\d+) cycles", open(args.log, errors="replace").read(), re.M)
+        if not m:
+            sys.exit("no [TOGGLE] line in %s" % args.log)
+        cycles = int(m.group(1))
+    if not cycles:
+        sys.exit("--cycles or --log required")
+
+    src = Sources()
+    # (group, signal) -> [kind, bits, toggles]
+    sig = {}
+    for hier, comment, fname, line, count in parse_dat(args.dat):
+        group = group_of(hier, args.depth)
+        if group is None:
+            continue
+        name = re.sub(r":.*$", "", comment)         # drop 0->1 / 1->0 suffix
+        bit = name
+        base = re.sub(r"(\[\d+\])+$", "", name)
+        key = (group, hier + "." + base)
+        if key not in sig:
+            kind = src.kind(fname, line, base.split(".")[-1])
+            if kind == "input":
+                sig[key] = None
+                continue
+            sig[key] = [kind, set(), 0]
+        if sig[key] is None:
+            continue
+        sig[key][1].add(bit)
+        sig[key][2] += count
+
+    groups = collections.OrderedDict()
+    rows = []
+    for (group, name), v in sig.items():
+        if v is None:
+            continue
+        kind, bits, toggles = v
+        nbits = len(bits)
+        if kind == "flop":
+            e_clk, e_data = nbits * cycles * args.e_clk, toggles * args.e_reg
+        else:
+            e_clk, e_data = 0.0, toggles * args.e_net
+        g = groups.setdefault(group, {"flop_bits": 0, "net_bits": 0, "flop_toggles": 0, "net_toggles": 0,
+                                      "e_clk_fj": 0.0, "e_data_fj": 0.0})
+        g["flop_bits" if kind == "flop" else "net_bits"] += nbits
+        g["flop_toggles" if kind == "flop" else "net_toggles"] += toggles
+        g["e_clk_fj"] += e_clk
+        g["e_data_fj"] += e_data
+        rows.append((e_clk + e_data, group, name, kind, nbits, toggles, e_clk))
+
+    total = sum(g["e_clk_fj"] + g["e_data_fj"] for g in groups.values()) or 1.0
+    print("Toggle energy over %d cycles (E_clk %.0f fJ/bit/cycle, E_reg %.0f fJ, E_net %.0f fJ)\n"
+          % (cycles, args.e_clk, args.e_reg, args.e_net))
+    print("%-22s %7s %7s %10s %12s %12s %12s %7s %9s" % (
+        "INSTANCE", "FLOPS", "NETS", "ACTIVITY", "CLOCK pJ", "DATA pJ", "TOTAL pJ", "SHARE", "CLK SHARE"))
+    for name, g in sorted(groups.items(), key=lambda kv: -(kv[1]["e_clk_fj"] + kv[1]["e_data_fj"])):
+        e = g["e_clk_fj"] + g["e_data_fj"]
+        g["activity"] = g["flop_toggles"] / (g["flop_bits"] * cycles) if g["flop_bits"] else 0.0
+        g["share"] = e / total
+        print("%-22s %7d %7d %10.5f %12.1f %12.1f %12.1f %6.1f%% %8.1f%%" % (
+            name, g["flop_bits"], g["net_bits"], g["activity"], g["e_clk_fj"] / 1000, g["e_data_fj"] / 1000,
+            e / 1000, 100 * g["share"], 100 * g["e_clk_fj"] / e if e else 0))
+    print("\nACTIVITY = flop output transitions per flop bit per cycle. A block with a high CLK SHARE")
+    print("and low ACTIVITY pays mostly for its clock: a clock-gating candidate.\n")
+
+    print("%-50s %-5s %5s %12s %10s %12s" % ("SIGNAL", "KIND", "BITS", "TOGGLES", "PER CYCLE", "TOTAL pJ"))
+    rows.sort(reverse=True)
+    for e, group, name, kind, nbits, toggles, _ in rows[:args.top]:
+        short = name.split(".dut.", 1)[-1]
+        print("%-50s %-5s %5d %12d %10.4f %12.1f" % (short, kind, nbits, toggles, toggles / cycles, e / 1000))
+
+    if args.json:
+        with open(args.json, "w") as fh:
+            json.dump({"cycles": cycles, "e_clk_fj": args.e_clk, "e_reg_fj": args.e_reg, "e_net_fj": args.e_net,
+                       "instances": groups,
+                       "signals": [{"name": n.split(".dut.", 1)[-1], "kind": k, "bits": b, "toggles": t,
+                                    "energy_fj": e} for e, _, n, k, b, t, _ in rows]}, fh, indent=2)
+        print("\nwrote %s" % args.json)
+
+
+if __name__ == "__main__":
+    main()
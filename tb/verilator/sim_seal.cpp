@@ -471,5 +471,6 @@ int main(int argc, char** argv) {
 
     top->final();
     delete top;
+    printf("[PERF] %llu cycles\n", (unsigned long long)(sim_time / 2));
     return g_fail > 0 ? 1 : 0;
 }
@@ -0,0 +1,260 @@
+// ============================================================================
+// Micro-benchmark: cycle cost of every peripheral and memory path
+// ============================================================================
+// Target: LoRa Edge SoC (TinyQV RV32EC @ 25MHz)
+// Runs on: verify/iss (iss), verify/cosim_tb / soclib (Verilated RTL),
+//          the Alchitry Cu FPGA build (UART on the FTDI port, 115200 8N1)
+//
+// Each benchmark runs its operation n times (n a power of two) between two
+// rdcycle reads. The cost of the rdcycle pair and of the bare loop (the
+// "loop" row, same loop shape with an empty body) is taken off, so cyc/op
+// is what the operation itself adds. Memory rows do 8 accesses per loop
+// iteration from inline asm so the loop is a small part of the total.
+//
+//   loop        empty loop iteration (subtracted from every other row)
+//   flash_lw    lw from flash (XIP data read, breaks the fetch stream)
+//   psram_lw/sw lw/sw to PSRAM
+//   lmem_lw/sw  lw/sw to latch_mem (tp - 32, no QSPI)
+//   mmio_lw/sw  GPIO_IN read / GPIO_OUT write
+//   crc16_byte  CRC16_DATA write + busy poll
+//   seal        SEAL_DATA + SEAL_CTRL commit, busy poll, 3 SEAL_DATA reads
+//   i2c_rreg    W(0x44) reg, R(0x44) 2 bytes at 200 kHz (SHT31 on the
+//               testbench board; "nack" in the last column without one)
+//   spi_byte    SPI_DATA write + busy poll (no device needed)
+//   uart_byte   polled UART byte, steady state (line rate: 2170)
+//
+// verify/fw_bench_baseline.json has only the iss section so far: those
+// numbers are the ISS QSPI timing model (not fitted), so the CI check is a
+// model regression, not a measurement of the RTL or the chip.
+//
+// Output (parsed by scripts/fw_bench.py):
+//   BENCH
+//   B <name> <ops> <cycles> <cyc/op x10> [nack]
+//   ...
+//   DN
+//
+// Build:
+//   riscv64-elf-gcc -march=rv32ec_zicsr -mabi=ilp32e -nostdlib -Os \
+//     -T fw_irq_timer.ld -o fw_bench.elf fw_bench.c
+//   riscv64-elf-objcopy -O verilog fw_bench.elf fw_bench.hex
+// ============================================================================
+
+#include "fw_hal.h"
+
+#define SHT31_ADDR      0x44u
+#define PSRAM_SCRATCH   ((volatile unsigned int *)0x01000400)
+#define LMEM_SCRATCH    ((volatile unsigned int *)0x07FFFFE0)
+#define I2C_NACKED      (*(volatile unsigned int *)0x01000404)  // no .bss in this layout
+
+static const unsigned int flash_word = 0x5A5A5A5Au;
+
+// ============================================================================
+// Vector table
+// ============================================================================
+void __attribute__((naked, section(".text._vectors"))) _vectors(void) {
+    __asm__ volatile (
+        ".option push\n"
+        ".option norvc\n"
+        "j _reset_handler\n"
+        "j _trap_handler\n"
+        "j _trap_handler\n"
+        ".option pop\n"
+    );
+}
+
+void __attribute__((naked)) _trap_handler(void) {
+    __asm__ volatile ("j _trap_handler\n");
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+static inline unsigned int rdcycle(void) {
+    unsigned int c;
+    __asm__ volatile ("csrr %0, 0xC00" : "=r"(c));
+    return c;
+}
+
+static void put_str(const char *s) {
+    hal_uart_puts(s);
+}
+
+// No divider on RV32EC: subtract powers of ten
+static void put_dec(unsigned int v) {
+    static const unsigned int pow10[] = { 1000000000u, 100000000u, 10000000u, 1000000u,
+                                          100000u, 10000u, 1000u, 100u, 10u, 1u };
+    int started = 0;
+    for (unsigned int i = 0; i < sizeof(pow10) / sizeof(pow10[0]); i++) {
+        unsigned char d = '0';
+        while (v >= pow10[i]) {
+            v -= pow10[i];
+            d++;
+        }
+        if (d != '0' || started || i == 9) {
+            hal_uart_putc(d);
+            started = 1;
+        }
+    }
+}
+
+// ============================================================================
+// Benchmarks: each runs n iterations and returns the elapsed cycles
+// ============================================================================
+#define X8(s)   s s s s s s s s
+
+static unsigned int b_loop(unsigned int n) {
+    unsigned int t0 = rdcycle();
+    for (; n; n--) __asm__ volatile ("");
+    return rdcycle() - t0;
+}
+
+#define LOAD_BENCH(fn, ptr)                                             \
+    static unsigned int fn(unsigned int n) {                            \
+        volatile unsigned int *p = (ptr);                               \
+        unsigned int v;                                                 \
+        unsigned int t0 = rdcycle();                                    \
+        for (; n; n--)                                                  \
+            __asm__ volatile (X8("lw %0, 0(%1)\n") : "=&r"(v) : "r"(p) : "memory"); \
+        return rdcycle() - t0;                                          \
+    }
+
+#define STORE_BENCH(fn, ptr)                                            \
+    static unsigned int fn(unsigned int n) {                            \
+        volatile unsigned int *p = (ptr);                               \
+        unsigned int t0 = rdcycle();                                    \
+        for (; n; n--)                                                  \
+            __asm__ volatile (X8("sw zero, 0(%0)\n") : : "r"(p) : "memory"); \
+        return rdcycle() - t0;                                          \
+    }
+
+LOAD_BENCH(b_flash_lw, (volatile unsigned int *)&flash_word)
+LOAD_BENCH(b_psram_lw, PSRAM_SCRATCH)
+STORE_BENCH(b_psram_sw, PSRAM_SCRATCH)
+LOAD_BENCH(b_lmem_lw, LMEM_SCRATCH)
+STORE_BENCH(b_lmem_sw, LMEM_SCRATCH)
+LOAD_BENCH(b_mmio_lw, &GPIO_IN)
+STORE_BENCH(b_mmio_sw, &GPIO_OUT)
+
+static unsigned int b_crc16_byte(unsigned int n) {
+    hal_crc16_init();
+    unsigned int t0 = rdcycle();
+    for (; n; n--) hal_crc16_feed((unsigned char)n);
+    return rdcycle() - t0;
+}
+
+static unsigned int b_seal(unsigned int n) {
+    unsigned int r[3];
+    unsigned int t0 = rdcycle();
+    for (; n; n--) {
+        hal_seal_commit(0x42, n);
+        hal_seal_read(r);
+    }
+    return rdcycle() - t0;
+}
+
+static unsigned int b_i2c_rreg(unsigned int n) {
+    I2C_NACKED = 0;
+    hal_i2c_set_prescale(63);                   // 200 kHz
+    unsigned int t0 = rdcycle();
+    for (; n; n--) {
+        I2C_DATA = I2C_CMD_START | I2C_CMD_WRITE | SHT31_ADDR;
+        hal_i2c_wait_tx();
+        I2C_DATA = I2C_CMD_WRITE | I2C_CMD_STOP | 0xE0;     // SHT31 fetch data
+        hal_i2c_wait_tx();
+        hal_i2c_wait_idle();
+        I2C_NACKED |= hal_i2c_nack();
+        I2C_DATA = I2C_CMD_START | I2C_CMD_READ | SHT31_ADDR;
+        hal_i2c_wait_rx();
+        I2C_DATA = I2C_CMD_READ | I2C_CMD_STOP | SHT31_ADDR;
+        hal_i2c_wait_rx();
+        hal_i2c_wait_idle();
+    }
+    return rdcycle() - t0;
+}
+
+static unsigned int b_spi_byte(unsigned int n) {
+    unsigned int t0 = rdcycle();
+    for (; n > 1; n--) hal_spi_xfer(0xA5);
+    hal_spi_xfer(0xA5 | SPI_END);
+    return rdcycle() - t0;
+}
+
+static unsigned int b_uart_byte(unsigned int n) {
+    hal_uart_putc('.');                         // steady state: every putc
+                                                // waits out the previous frame
+    unsigned int t0 = rdcycle();
+    for (; n; n--) hal_uart_putc('.');
+    unsigned int t = rdcycle() - t0;
+    hal_uart_putc('\n');
+    return t;
+}
+
+struct bench {
+    const char   *name;
+    unsigned int (*fn)(unsigned int n);
+    unsigned int  log2_n;                       // loop iterations
+    unsigned int  log2_ops;                     // operations per iteration
+};
+
+static const struct bench benches[] = {
+    { "flash_lw",   b_flash_lw,   6, 3 },
+    { "psram_lw",   b_psram_lw,   6, 3 },
+    { "psram_sw",   b_psram_sw,   6, 3 },
+    { "lmem_lw",    b_lmem_lw,    6, 3 },
+    { "lmem_sw",    b_lmem_sw,    6, 3 },
+    { "mmio_lw",    b_mmio_lw,    6, 3 },
+    { "mmio_sw",    b_mmio_sw,    6, 3 },
+    { "crc16_byte", b_crc16_byte, 6, 0 },
+    { "seal",       b_seal,       4, 0 },
+    { "i2c_rreg",   b_i2c_rreg,   3, 0 },
+    { "spi_byte",   b_spi_byte,   4, 0 },
+    { "uart_byte",  b_uart_byte,  4, 0 },
+};
+
+static void put_row(const char *name, unsigned int log2_ops, unsigned int cycles) {
+    put_str("B ");
+    put_str(name);
+    hal_uart_putc(' ');
+    put_dec(1u << log2_ops);
+    hal_uart_putc(' ');
+    put_dec(cycles);
+    hal_uart_putc(' ');
+    unsigned int c2 = cycles << 1;
+    __asm__ ("" : "+r"(c2));                    // x10 by shifts: keep it from becoming __mulsi3
+    put_dec(((c2 << 2) + c2) >> log2_ops);
+}
+
+// ============================================================================
+// Reset handler
+// ============================================================================
+void __attribute__((naked, noreturn)) _reset_handler(void) {
+    __asm__ volatile (
+        "li sp, 0x01000100\n"
+        "j main\n"
+    );
+}
+
+void __attribute__((noreturn)) main(void) {
+    unsigned int t0 = rdcycle();
+    unsigned int t_rd = rdcycle() - t0;         // back-to-back rdcycle
+
+    put_str("BENCH\n");
+
+    // Bare loop, 64 iterations: the per-iteration cost is taken off below
+    unsigned int loop64 = b_loop(64) - t_rd;
+    put_row("loop", 6, loop64);
+    hal_uart_putc('\n');
+
+    for (unsigned int i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        const struct bench *b = &benches[i];
+        unsigned int t = b->fn(1u << b->log2_n) - t_rd;
+        unsigned int loop = (loop64 << b->log2_n) >> 6;
+        t = t > loop ? t - loop : 0;
+        put_row(b->name, b->log2_n + b->log2_ops, t);
+        if (b->fn == b_i2c_rreg && I2C_NACKED) put_str(" nack");
+        hal_uart_putc('\n');
+    }
+
+    put_str("DN\n");
+    while (1);
+}
@@ -17,24 +17,7 @@
 // Expected UART output: "H1H2H3DN" (8 chars)
 // ============================================================================
 
-#define PERI_BASE       0x08000000u
-#define UART_DATA       (*(volatile unsigned int*)(PERI_BASE + 0x10))
-#define UART_STATUS     (*(volatile unsigned int*)(PERI_BASE + 0x14))
-#define I2C_DATA        (*(volatile unsigned int*)(PERI_BASE + 0x18))
-#define I2C_CONFIG      (*(volatile unsigned int*)(PERI_BASE + 0x1C))
-#define CRC16_DATA      (*(volatile unsigned int*)(PERI_BASE + 0x08))
-#define TIMER_COUNTDOWN (*(volatile unsigned int*)(PERI_BASE + 0x30))
-
-#define UART_TX_BUSY    (1u << 0)
-#define I2C_CMD_START   (1u << 8)
-#define I2C_CMD_READ    (1u << 9)
-#define I2C_CMD_WRITE   (1u << 10)
-#define I2C_CMD_STOP    (1u << 12)
-#define I2C_BUSY        (1u << 9)
-#define I2C_RX_VALID    (1u << 10)
-#define I2C_TX_PENDING  (1u << 11)
-#define CRC16_BUSY      (1u << 16)
-#define CRC16_INIT      (1u << 8)
+#include "fw_hal.h"
 
 // Shared state in PSRAM
 #define P_IRQ_COUNT ((volatile unsigned int *)0x01000084)
@@ -22,19 +22,7 @@
 //   DN = Done
 // ============================================================================
 
-#define PERI_BASE       0x08000000u
-#define UART_DATA       (*(volatile unsigned int*)(PERI_BASE + 0x10))
-#define UART_STATUS     (*(volatile unsigned int*)(PERI_BASE + 0x14))
-#define CRC16_DATA      (*(volatile unsigned int*)(PERI_BASE + 0x08))
-#define SEAL_DATA       (*(volatile unsigned int*)(PERI_BASE + 0x2C))
-#define SEAL_CTRL       (*(volatile unsigned int*)(PERI_BASE + 0x38))
-
-#define UART_TX_BUSY    (1u << 0)
-#define CRC16_BUSY      (1u << 16)
-#define CRC16_INIT      (1u << 8)
-#define SEAL_COMMIT     (1u << 1)
-#define SEAL_BUSY       (1u << 0)
-#define SEAL_READY      (1u << 1)
+#include "fw_hal.h"
 
 // ============================================================================
 // Vector table
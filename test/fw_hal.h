@@ -0,0 +1,284 @@
+// ============================================================================
+// fw_hal.h — LoRa Edge SoC firmware HAL (header-only)
+// ============================================================================
+// Register map, bit fields and inline helpers for the MMIO peripherals
+// (docs/info.md). Register names match the #defines the fw_*.c tests
+// carry, so a test switches over by replacing its define block with
+//
+//   #include "fw_hal.h"
+//
+// Every test that touches MMIO includes it. CI checks with
+// riscv64-elf-gcc that each image is byte-identical to the build of its
+// define-block original (scripts/fw_hal_compare.py --before).
+//
+// tinyQV hardwires tp = 0x08000000 (PERI_BASE) and gp = 0x01000400
+// (PSRAM), so any register is also reachable as one `lw/sw rd, OFF(tp)`
+// — the form the hand-written ISRs use. That is not the default: tp is
+// outside the RVC register window, so every access is a 4-byte
+// instruction, while with an absolute base the compiler hoists one `lui`
+// and uses 2-byte c.lw/c.sw. scripts/fw_hal_compare.py measures both
+// per image (CI: test/fw_hal.json); tp-relative costs .text and saves
+// no cycles worth having, since fetch from QSPI flash dominates. So:
+//
+//   default         absolute addresses (same code as the old #defines)
+//   -DFW_HAL_TP     every register through tp
+//   HAL_TP_REG(off) one access through tp, for C ISRs and one-shot writes
+//                   where no base register is live
+//   HAL_GP_WORD(a)  PSRAM word within ±2 KiB of gp (mailboxes, boot magic)
+//
+// Helpers are static inline and prefixed hal_ so they do not clash with
+// the tests' own uart_putc/i2c_wait functions. Poll loops take the
+// same 200000-iteration bound the tests use where a hang is possible.
+// ============================================================================
+
+#ifndef FW_HAL_H
+#define FW_HAL_H
+
+#define PERI_BASE       0x08000000u
+#define HAL_GP_BASE     0x01000400u
+
+register volatile unsigned int *hal_tp __asm__("tp");
+register volatile unsigned int *hal_gp __asm__("gp");
+#define HAL_TP_REG(off)     (hal_tp[(off) / 4])
+#define HAL_GP_WORD(addr)   (hal_gp[((int)(addr) - (int)HAL_GP_BASE) / 4])
+
+#ifdef FW_HAL_TP
+#define HAL_REG(off)        HAL_TP_REG(off)
+#else
+#define HAL_REG(off)        (*(volatile unsigned int*)(PERI_BASE + (off)))
+#endif
+
+// ---- Registers (slot = addr[5:2]) ----
+#define GPIO_OUT        HAL_REG(0x00)
+#define GPIO_IN         HAL_REG(0x04)
+#define CRC16_DATA      HAL_REG(0x08)
+#define GPIO_OUT_SEL    HAL_REG(0x0C)
+#define UART_DATA       HAL_REG(0x10)
+#define UART_STATUS     HAL_REG(0x14)
+#define I2C_DATA        HAL_REG(0x18)
+#define I2C_CONFIG      HAL_REG(0x1C)
+#define SPI_DATA        HAL_REG(0x20)
+#define SPI_STATUS      HAL_REG(0x24)
+#define RTC_SECONDS     HAL_REG(0x28)
+#define SEAL_DATA       HAL_REG(0x2C)
+#define TIMER_COUNTDOWN HAL_REG(0x30)
+#define WDT_KICK        HAL_REG(0x34)
+#define SEAL_CTRL       HAL_REG(0x38)
+#define SYS_INFO        HAL_REG(0x3C)
+
+// ---- GPIO ----
+#define GPIO_DIO1       (1u << 0)       // ui_in[0] SX1268 DIO1
+#define GPIO_BUSY       (1u << 1)       // ui_in[1] SX1268 BUSY
+#define GPIO_PPS        (1u << 4)       // ui_in[4] 1PPS
+#define GPIO_LED        (1u << 7)       // uo_out[7]
+#define GPIO_SEL_PWM_OUT7 (1u << 8)
+#define GPIO_SEL_PWM_IO7  (1u << 9)
+
+// ---- UART ----
+#define UART_TX_BUSY    (1u << 0)
+#define UART_RX_VALID   (1u << 1)
+
+// ---- CRC16 (MODBUS) ----
+#define CRC16_INIT      (1u << 8)       // write: reset to 0xFFFF
+#define CRC16_BUSY      (1u << 16)      // read: engine or Seal active
+
+// ---- I2C ----
+#define I2C_CMD_START   (1u << 8)
+#define I2C_CMD_READ    (1u << 9)
+#define I2C_CMD_WRITE   (1u << 10)
+#define I2C_CMD_WRITE_MULTI (1u << 11)
+#define I2C_CMD_STOP    (1u << 12)
+#define I2C_NACK        (1u << 8)       // read: miss_ack
+#define I2C_BUSY        (1u << 9)
+#define I2C_RX_VALID    (1u << 10)      // cleared by the read
+#define I2C_TX_PENDING  (1u << 11)
+
+// ---- SPI ----
+#define SPI_BUSY        (1u << 0)       // STATUS read
+#define SPI_END         (1u << 8)       // DATA write: release CS after this byte
+#define SPI_DC          (1u << 9)
+#define SPI_READ_LATENCY (1u << 8)      // CONFIG write
+
+// ---- Seal ----
+#define SEAL_CRC_RESET  (1u << 0)       // CTRL write
+#define SEAL_COMMIT     (1u << 1)
+#define SEAL_SID_SHIFT  2
+#define SEAL_BUSY       (1u << 0)       // CTRL read
+#define SEAL_READY      (1u << 1)
+#define SEAL_DROPPED    (1u << 2)
+
+// ---- SysInfo ----
+#define SYS_SOFT_RESET  0xA5u
+#define SYS_CHIP_ID     0x01u
+#define SYS_VERSION     0x10u
+
+#define HAL_POLL_MAX    200000u
+
+#define HAL_INLINE static inline __attribute__((always_inline))
+
+// ---- UART ----
+HAL_INLINE void hal_uart_putc(unsigned char c) {
+    while (UART_STATUS & UART_TX_BUSY);
+    UART_DATA = c;
+}
+
+static inline void hal_uart_puts(const char *s) {
+    while (*s) hal_uart_putc(*s++);
+}
+
+HAL_INLINE int hal_uart_rx_ready(void) {
+    return UART_STATUS & UART_RX_VALID;
+}
+
+HAL_INLINE unsigned char hal_uart_getc(void) {
+    while (!(UART_STATUS & UART_RX_VALID));
+    return UART_DATA & 0xFF;
+}
+
+// ---- CRC16 ----
+HAL_INLINE void hal_crc16_wait(void) {
+    while (CRC16_DATA & CRC16_BUSY);
+}
+
+HAL_INLINE void hal_crc16_init(void) {
+    CRC16_DATA = CRC16_INIT;
+    hal_crc16_wait();
+}
+
+HAL_INLINE void hal_crc16_feed(unsigned char b) {
+    CRC16_DATA = b;
+    hal_crc16_wait();
+}
+
+HAL_INLINE unsigned int hal_crc16_value(void) {
+    return CRC16_DATA & 0xFFFF;
+}
+
+static inline unsigned int hal_crc16(const unsigned char *p, unsigned int n) {
+    hal_crc16_init();
+    while (n--) hal_crc16_feed(*p++);
+    return hal_crc16_value();
+}
+
+// ---- Seal ----
+// Commit `value` for sensor `sid`; the three result words follow on SEAL_DATA
+HAL_INLINE void hal_seal_commit(unsigned int sid, unsigned int value) {
+    while (!(SEAL_CTRL & SEAL_READY));
+    SEAL_DATA = value;
+    SEAL_CTRL = (sid << SEAL_SID_SHIFT) | SEAL_COMMIT;
+    while (SEAL_CTRL & SEAL_BUSY);
+}
+
+// r[0] = value, r[1] = {sid, mono[23:0]}, r[2] = {mono[31:24], crc, 0x00}
+HAL_INLINE void hal_seal_read(unsigned int r[3]) {
+    r[0] = SEAL_DATA;
+    r[1] = SEAL_DATA;
+    r[2] = SEAL_DATA;
+}
+
+HAL_INLINE unsigned int hal_seal_mono(const unsigned int r[3]) {
+    return (r[1] & 0x00FFFFFF) | (r[2] & 0xFF000000);
+}
+
+HAL_INLINE unsigned int hal_seal_crc(const unsigned int r[3]) {
+    return (r[2] >> 8) & 0xFFFF;
+}
+
+// ---- I2C ----
+HAL_INLINE void hal_i2c_set_prescale(unsigned int prescale) {
+    I2C_CONFIG = prescale;
+}
+
+// 1 when the byte has left the TX holding register, 0 on timeout
+HAL_INLINE int hal_i2c_wait_tx(void) {
+    unsigned int t = HAL_POLL_MAX;
+    while ((I2C_DATA & I2C_TX_PENDING) && t > 0) t--;
+    return t > 0;
+}
+
+// 1 when the master is idle, 0 on timeout
+HAL_INLINE int hal_i2c_wait_idle(void) {
+    unsigned int t = HAL_POLL_MAX;
+    while ((I2C_DATA & I2C_BUSY) && t > 0) t--;
+    return t > 0;
+}
+
+// Received byte, or -1 on timeout
+HAL_INLINE int hal_i2c_wait_rx(void) {
+    for (unsigned int t = HAL_POLL_MAX; t > 0; t--) {
+        unsigned int v = I2C_DATA;
+        if (v & I2C_RX_VALID) return v & 0xFF;
+    }
+    return -1;
+}
+
+HAL_INLINE int hal_i2c_nack(void) {
+    return (I2C_DATA & I2C_NACK) != 0;
+}
+
+// ---- SPI ----
+HAL_INLINE unsigned char hal_spi_xfer(unsigned int b) {
+    while (SPI_STATUS & SPI_BUSY);
+    SPI_DATA = b;
+    while (SPI_STATUS & SPI_BUSY);
+    return SPI_DATA & 0xFF;
+}
+
+// ---- Timer (µs countdown, IRQ17 on expiry) ----
+HAL_INLINE void hal_timer_start(unsigned int us) {
+    TIMER_COUNTDOWN = us;
+}
+
+// Stops the timer and clears a pending timer IRQ
+HAL_INLINE void hal_timer_stop(void) {
+    TIMER_COUNTDOWN = 0;
+}
+
+HAL_INLINE unsigned int hal_timer_remaining(void) {
+    return TIMER_COUNTDOWN;
+}
+
+// 1 when the countdown reached 0, 0 on timeout
+HAL_INLINE int hal_timer_wait(void) {
+    unsigned int t = HAL_POLL_MAX;
+    while (TIMER_COUNTDOWN != 0 && t > 0) t--;
+    return t > 0;
+}
+
+// ---- WDT (cannot be disabled once kicked) ----
+HAL_INLINE void hal_wdt_kick(unsigned int us) {
+    WDT_KICK = us;
+}
+
+HAL_INLINE unsigned int hal_wdt_remaining(void) {
+    return WDT_KICK;
+}
+
+// ---- RTC ----
+HAL_INLINE unsigned int hal_rtc_seconds(void) {
+    return RTC_SECONDS;
+}
+
+HAL_INLINE void hal_rtc_set(unsigned int s) {
+    RTC_SECONDS = s;
+}
+
+// ---- SysInfo ----
+HAL_INLINE unsigned int hal_chip_id(void) {
+    return (SYS_INFO >> 8) & 0xFF;
+}
+
+HAL_INLINE unsigned int hal_version(void) {
+    return SYS_INFO & 0xFF;
+}
+
+HAL_INLINE unsigned int hal_pps_count(void) {
+    return SYS_INFO >> 16;
+}
+
+static inline void __attribute__((noreturn)) hal_soft_reset(void) {
+    SYS_INFO = SYS_SOFT_RESET;
+    while (1);
+}
+
+#endif // FW_HAL_H
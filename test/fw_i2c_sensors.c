@@ -0,0 +1,236 @@
+// ============================================================================
+// Test J: I2C Sensors — Acquisition Cycles Against Register-Level Models
+// ============================================================================
+// Target: LoRa Edge SoC (TinyQV RV32EC @ 25MHz)
+// Tests: measurement delays, ACK polling and register-pointer reads on a
+//        multi-device bus (verify/iss/i2c_devices.h):
+//          iss --i2c-devices sht3x,bme280,eeprom fw_i2c_sensors.hex
+//
+// Build:
+//   riscv64-elf-gcc -march=rv32ec_zicsr -mabi=ilp32e -nostdlib -Os \
+//     -T fw_irq_timer.ld -o fw_i2c_sensors.elf fw_i2c_sensors.c
+//   riscv64-elf-objcopy -O verilog fw_i2c_sensors.elf fw_i2c_sensors.hex
+//
+// Strategy:
+//   J1: SHT3x @0x44 single shot 0x2400 (no stretching): the sensor NACKs its
+//       read header for ~15 ms; poll until ACK, check both CRC-8s and that
+//       at least one poll was refused
+//   J2: BME280 @0x76 chip id 0x60, forced measurement (x1/x1/x1); poll
+//       status.measuring until clear, burst-read 0xF7..0xFE and compare the
+//       20/20/16-bit ADC fields with the model's defaults
+//   J3: 24C32 @0x50 8-byte page write at 0x001C (wraps to 0x0000 inside the
+//       32-byte page), ACK-poll through tWR, read both halves back
+//
+// Expected UART output: "J1J2J3DN" (8 chars)
+// ============================================================================
+
+#include "fw_hal.h"
+
+#define SHT3X_ADDR      0x44
+#define BME280_ADDR     0x76
+#define EEPROM_ADDR     0x50
+
+// Model defaults (Bme280Slave adc_t/adc_p/adc_h)
+#define BME_ADC_T       519888u
+#define BME_ADC_P       415148u
+#define BME_ADC_H       30000u
+
+// ~100 kHz: one poll of a 6-byte read is ~0.7 ms, so 15 ms needs ~25
+#define POLL_MAX        200
+
+// ============================================================================
+// Vector table
+// ============================================================================
+void __attribute__((naked, section(".text._vectors"))) _vectors(void) {
+    __asm__ volatile (
+        ".option push\n"
+        ".option norvc\n"
+        "j _reset_handler\n"
+        "j _trap_handler\n"
+        "j _trap_handler\n"
+        ".option pop\n"
+    );
+}
+
+void __attribute__((naked)) _trap_handler(void) {
+    __asm__ volatile ("j _trap_handler\n");
+}
+
+// ============================================================================
+// UART + I2C helpers
+// ============================================================================
+static void uart_putc(unsigned char c) {
+    while (UART_STATUS & UART_TX_BUSY);
+    UART_DATA = c;
+}
+
+static int i2c_wait_tx(void) {
+    unsigned int t = 200000;
+    while ((I2C_DATA & I2C_TX_PENDING) && t > 0) t--;
+    return t > 0;
+}
+
+static int i2c_wait_idle(void) {
+    unsigned int t = 200000;
+    while ((I2C_DATA & I2C_BUSY) && t > 0) t--;
+    return t > 0;
+}
+
+static int i2c_wait_rx(void) {
+    unsigned int t = 200000;
+    unsigned int v;
+    while (t > 0) {
+        v = I2C_DATA;
+        if (v & I2C_RX_VALID)
+            return v & 0xFF;
+        t--;
+    }
+    return -1;
+}
+
+// START + W(addr) + buf[0..n-1] + STOP (n >= 1). Returns 1 when every byte
+// was ACKed. The NACK latch is read before the next command clears it.
+static int i2c_write(unsigned int addr, const unsigned char *buf, int n) {
+    int i;
+    I2C_DATA = I2C_CMD_START | I2C_CMD_WRITE | addr;
+    i2c_wait_tx();
+    for (i = 0; i < n; i++) {
+        I2C_DATA = I2C_CMD_WRITE | (i == n - 1 ? I2C_CMD_STOP : 0) | buf[i];
+        i2c_wait_tx();
+    }
+    i2c_wait_idle();
+    return !(I2C_DATA & I2C_NACK);
+}
+
+// START + R(addr) + n bytes (ACK all but the last) + STOP. Returns 1 when
+// the address was ACKed; the bytes are 0xFF otherwise. The address NACK
+// lands with the first byte and the next READ beat clears it, so sample it
+// there.
+static int i2c_read(unsigned int addr, unsigned char *buf, int n) {
+    int i, nack = 0;
+    for (i = 0; i < n; i++) {
+        I2C_DATA = (i == 0 ? I2C_CMD_START : 0) | I2C_CMD_READ |
+                   (i == n - 1 ? I2C_CMD_STOP : 0) | addr;
+        buf[i] = (unsigned char)i2c_wait_rx();
+        if (i == 0) nack = (I2C_DATA & I2C_NACK) != 0;
+    }
+    i2c_wait_idle();
+    return !nack;
+}
+
+// Register read: W(addr) reg, then R(addr) n bytes
+static int i2c_read_reg(unsigned int addr, unsigned char reg, unsigned char *buf, int n) {
+    if (!i2c_write(addr, &reg, 1)) return 0;
+    return i2c_read(addr, buf, n);
+}
+
+static int i2c_write_reg(unsigned int addr, unsigned char reg, unsigned char val) {
+    unsigned char b[2];
+    b[0] = reg;
+    b[1] = val;
+    return i2c_write(addr, b, 2);
+}
+
+// Sensirion CRC-8: poly 0x31, init 0xFF
+static unsigned char crc8(const unsigned char *p, int n) {
+    unsigned char c = 0xFF;
+    int i, b;
+    for (i = 0; i < n; i++) {
+        c ^= p[i];
+        for (b = 0; b < 8; b++)
+            c = (c & 0x80) ? (unsigned char)((c << 1) ^ 0x31) : (unsigned char)(c << 1);
+    }
+    return c;
+}
+
+// ============================================================================
+// Reset handler
+// ============================================================================
+void __attribute__((naked, noreturn)) _reset_handler(void) {
+    __asm__ volatile (
+        "li sp, 0x01000100\n"
+        "j main\n"
+    );
+}
+
+void __attribute__((noreturn)) main(void) {
+    unsigned char buf[8];
+    int polls, ok, i;
+    unsigned int v;
+
+    I2C_CONFIG = 63;
+
+    // ---- J1: SHT3x single shot, NACK until the measurement is done ----
+    {
+        buf[0] = 0x24;
+        buf[1] = 0x00;
+        ok = i2c_write(SHT3X_ADDR, buf, 2);
+        for (polls = 0; polls < POLL_MAX; polls++)
+            if (i2c_read(SHT3X_ADDR, buf, 6)) break;
+        ok = ok && polls > 0 && polls < POLL_MAX &&
+             crc8(buf, 2) == buf[2] && crc8(buf + 3, 2) == buf[5];
+        // 23.5 degC -> 0x6434, 45 %RH -> 0x7332
+        v = ((unsigned int)buf[0] << 8) | buf[1];
+        ok = ok && v > 0x6000 && v < 0x6800;
+        uart_putc('J');
+        uart_putc(ok ? '1' : '0');
+    }
+
+    // ---- J2: BME280 forced measurement ----
+    {
+        ok = i2c_read_reg(BME280_ADDR, 0xD0, buf, 1) && buf[0] == 0x60;
+        ok = ok && i2c_write_reg(BME280_ADDR, 0xF2, 0x01);     // osrs_h x1
+        ok = ok && i2c_write_reg(BME280_ADDR, 0xF4, 0x25);     // osrs_t/p x1, forced
+        for (polls = 0; polls < POLL_MAX; polls++) {
+            if (!i2c_read_reg(BME280_ADDR, 0xF3, buf, 1)) break;
+            if (!(buf[0] & 0x08)) break;                        // measuring
+        }
+        ok = ok && polls > 0 && polls < POLL_MAX;
+        ok = ok && i2c_read_reg(BME280_ADDR, 0xF7, buf, 8);
+        v = ((unsigned int)buf[0] << 12) | ((unsigned int)buf[1] << 4) | (buf[2] >> 4);
+        ok = ok && v == BME_ADC_P;
+        v = ((unsigned int)buf[3] << 12) | ((unsigned int)buf[4] << 4) | (buf[5] >> 4);
+        ok = ok && v == BME_ADC_T;
+        v = ((unsigned int)buf[6] << 8) | buf[7];
+        ok = ok && v == BME_ADC_H;
+        uart_putc('J');
+        uart_putc(ok ? '2' : '0');
+    }
+
+    // ---- J3: EEPROM page write with wrap, ACK polling, read back ----
+    {
+        I2C_DATA = I2C_CMD_START | I2C_CMD_WRITE | EEPROM_ADDR;
+        i2c_wait_tx();
+        I2C_DATA = I2C_CMD_WRITE | 0x00;
+        i2c_wait_tx();
+        I2C_DATA = I2C_CMD_WRITE | 0x1C;
+        i2c_wait_tx();
+        for (i = 0; i < 8; i++) {
+            I2C_DATA = I2C_CMD_WRITE | (i == 7 ? I2C_CMD_STOP : 0) | (0xA0 + i);
+            i2c_wait_tx();
+        }
+        i2c_wait_idle();
+        ok = !(I2C_DATA & I2C_NACK);
+
+        // ACK polling: the address is refused for tWR after the STOP
+        buf[0] = 0x00;
+        buf[1] = 0x1C;
+        for (polls = 0; polls < POLL_MAX; polls++)
+            if (i2c_write(EEPROM_ADDR, buf, 2)) break;
+        ok = ok && polls > 0 && polls < POLL_MAX;
+        ok = ok && i2c_read(EEPROM_ADDR, buf, 4);
+        for (i = 0; i < 4; i++) ok = ok && buf[i] == 0xA0 + i;
+
+        buf[0] = 0x00;
+        buf[1] = 0x00;
+        ok = ok && i2c_write(EEPROM_ADDR, buf, 2) && i2c_read(EEPROM_ADDR, buf, 4);
+        for (i = 0; i < 4; i++) ok = ok && buf[i] == 0xA4 + i;
+        uart_putc('J');
+        uart_putc(ok ? '3' : '0');
+    }
+
+    uart_putc('D');
+    uart_putc('N');
+
+    while (1);
+}
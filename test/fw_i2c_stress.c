@@ -21,21 +21,7 @@
 //   DN = Done
 // ============================================================================
 
-#define PERI_BASE       0x08000000u
-#define UART_DATA       (*(volatile unsigned int*)(PERI_BASE + 0x10))
-#define UART_STATUS     (*(volatile unsigned int*)(PERI_BASE + 0x14))
-#define I2C_DATA        (*(volatile unsigned int*)(PERI_BASE + 0x18))
-#define I2C_CONFIG      (*(volatile unsigned int*)(PERI_BASE + 0x1C))
-
-#define UART_TX_BUSY    (1u << 0)
-#define I2C_CMD_START   (1u << 8)
-#define I2C_CMD_READ    (1u << 9)
-#define I2C_CMD_WRITE   (1u << 10)
-#define I2C_CMD_STOP    (1u << 12)
-#define I2C_BUSY        (1u << 9)
-#define I2C_NACK        (1u << 8)
-#define I2C_RX_VALID    (1u << 10)
-#define I2C_TX_PENDING  (1u << 11)
+#include "fw_hal.h"
 
 // Expected SHT31 read data from i2c_slave_model
 static const unsigned char expected[6] = {0x63, 0x32, 0xA1, 0x8C, 0xA4, 0xDB};
@@ -28,14 +28,7 @@
 // Expected UART output: "P1P2P3P4DN" (10 chars)
 // ============================================================================
 
-#define PERI_BASE       0x08000000u
-#define GPIO_OUT        (*(volatile unsigned int*)(PERI_BASE + 0x00))
-#define GPIO_OUT_SEL    (*(volatile unsigned int*)(PERI_BASE + 0x0C))
-#define UART_DATA       (*(volatile unsigned int*)(PERI_BASE + 0x10))
-#define UART_STATUS     (*(volatile unsigned int*)(PERI_BASE + 0x14))
-#define TIMER_COUNTDOWN (*(volatile unsigned int*)(PERI_BASE + 0x30))
-
-#define UART_TX_BUSY    (1u << 0)
+#include "fw_hal.h"
 
 // PSRAM shared state addresses
 // irq_count      @ 0x01000084
@@ -13,13 +13,7 @@
 // Expected UART output: "I1I2DN" (two IRQs pass + done)
 // ============================================================================
 
-#define PERI_BASE       0x08000000u
-#define UART_DATA       (*(volatile unsigned int*)(PERI_BASE + 0x10))
-#define UART_STATUS     (*(volatile unsigned int*)(PERI_BASE + 0x14))
-#define TIMER_COUNTDOWN (*(volatile unsigned int*)(PERI_BASE + 0x30))
-#define SYS_INFO        (*(volatile unsigned int*)(PERI_BASE + 0x3C))
-
-#define UART_TX_BUSY    (1u << 0)
+#include "fw_hal.h"
 
 // ============================================================================
 // Shared state between ISR and main (volatile!)
@@ -0,0 +1,288 @@
+// ============================================================================
+// LoRa node: seal records over SX1268 with gateway ACK and retry
+// ============================================================================
+// Target: LoRa Edge SoC (TinyQV RV32EC @ 25MHz)
+// Runs on: verify/iss/lora_net (N nodes + SX1268 model + gateway),
+//          iss --sx1268 / cosim_tb --sx1268 (one node, loopback ACK)
+//
+// For each record:
+//   1. Seal commit: value = {node_id[15:0], seq[15:0]}, sensor_id = node_id
+//   2. Frame = {node_id, SEAL_DATA read 0, 1, 2 (little endian)}  13 bytes
+//   3. SetTx, wait TxDone on DIO1
+//   4. SetRx with a 60 ms window (inverted IQ, as gateway downlinks are)
+//   5. ACK = {'A', node_id, mono[31:0] LE}; anything else -> random backoff
+//      (radio RandomNumberGen) and retransmit, up to MAX_TRIES
+//   6. UART 'A' (acked) or 'X' (given up), then sleep period + 0..262 ms
+// After the last record: UART "DN".
+//
+// Per-node provisioning lives in the last 16 bytes of flash (0x3FFF0),
+// written by the harness after loading the image:
+//   [0] node_id   [1] record count   [2] period in us
+//   [3] mask for the random delay before the first uplink (us)
+// Blank flash (0xFFFFFFFF) selects node 1, 3 records, 100 ms, no delay.
+//
+// Build:
+//   riscv64-elf-gcc -march=rv32ec_zicsr -mabi=ilp32e -nostdlib -Os \
+//     -T fw_irq_timer.ld -o fw_lora_node.elf fw_lora_node.c
+//   riscv64-elf-objcopy -O verilog fw_lora_node.elf fw_lora_node.hex
+//
+// Expected UART output: one 'A'/'X' per record, then "DN" ("AAADN" unprovisioned
+// with a loopback ACK)
+// ============================================================================
+
+#include "fw_hal.h"
+
+#define PROV            ((const volatile unsigned int*)0x0003FFF0u)
+
+
+// SX1268 opcodes / IRQ bits
+#define SX_SET_STANDBY      0x80
+#define SX_SET_PACKET_TYPE  0x8A
+#define SX_SET_RF_FREQ      0x86
+#define SX_SET_MOD_PARAMS   0x8B
+#define SX_SET_PKT_PARAMS   0x8C
+#define SX_SET_BUFFER_BASE  0x8F
+#define SX_SET_DIO_IRQ      0x08
+#define SX_WRITE_BUFFER     0x0E
+#define SX_READ_BUFFER      0x1E
+#define SX_READ_REGISTER    0x1D
+#define SX_SET_TX           0x83
+#define SX_SET_RX           0x82
+#define SX_GET_IRQ_STATUS   0x12
+#define SX_CLR_IRQ_STATUS   0x02
+#define SX_GET_RX_BUF_STAT  0x13
+
+#define SX_IRQ_TX_DONE      0x0001
+#define SX_IRQ_RX_DONE      0x0002
+#define SX_IRQ_TIMEOUT      0x0200
+
+#define FRAME_LEN           13
+#define ACK_LEN             6
+#define MAX_TRIES           4
+#define RX_WINDOW           3840    // x 15.625 us = 60 ms
+#define DIO1_GUARD_US       500000  // radio never answered
+
+// ============================================================================
+// Vector table
+// ============================================================================
+void __attribute__((naked, section(".text._vectors"))) _vectors(void) {
+    __asm__ volatile (
+        ".option push\n"
+        ".option norvc\n"
+        "j _reset_handler\n"
+        "j _trap_handler\n"
+        "j _trap_handler\n"
+        ".option pop\n"
+    );
+}
+
+void __attribute__((naked)) _trap_handler(void) {
+    __asm__ volatile ("j _trap_handler\n");
+}
+
+// ============================================================================
+// UART / timer helpers
+// ============================================================================
+static void uart_putc(unsigned char c) {
+    while (UART_STATUS & UART_TX_BUSY);
+    UART_DATA = c;
+}
+
+static void delay_us(unsigned int us) {
+    TIMER_COUNTDOWN = us;
+    while (TIMER_COUNTDOWN != 0);
+}
+
+// ============================================================================
+// SX1268 over spi_ctrl
+// ============================================================================
+static unsigned int spi_xfer(unsigned int b) {
+    SPI_DATA = b;
+    while (SPI_STATUS & SPI_BUSY);
+    return SPI_DATA & 0xFF;
+}
+
+// Write-only command: opcode + n parameter bytes
+static void sx_cmd(unsigned int op, const unsigned char *p, int n) {
+    while (GPIO_IN & GPIO_BUSY);
+    spi_xfer(op | (n == 0 ? SPI_END : 0));
+    for (int i = 0; i < n; i++)
+        spi_xfer(p[i] | (i == n - 1 ? SPI_END : 0));
+}
+
+static void sx_cmd1(unsigned int op, unsigned int a) {
+    unsigned char p[1];
+    p[0] = (unsigned char)a;
+    sx_cmd(op, p, 1);
+}
+
+static unsigned int sx_get_irq(void) {
+    while (GPIO_IN & GPIO_BUSY);
+    spi_xfer(SX_GET_IRQ_STATUS);
+    spi_xfer(0);
+    unsigned int hi = spi_xfer(0);
+    return (hi << 8) | spi_xfer(SPI_END);
+}
+
+static void sx_clear_irq(void) {
+    unsigned char p[2];
+    p[0] = 0xFF;
+    p[1] = 0xFF;
+    sx_cmd(SX_CLR_IRQ_STATUS, p, 2);
+}
+
+static unsigned int sx_random(void) {
+    while (GPIO_IN & GPIO_BUSY);
+    spi_xfer(SX_READ_REGISTER);
+    spi_xfer(0x08);
+    spi_xfer(0x19);
+    spi_xfer(0);
+    unsigned int r = 0;
+    for (int i = 0; i < 4; i++)
+        r = (r << 8) | spi_xfer(i == 3 ? SPI_END : 0);
+    return r;
+}
+
+static void sx_packet_params(unsigned int len, unsigned int invert_iq) {
+    unsigned char p[6];
+    p[0] = 0x00;            // preamble 8 symbols
+    p[1] = 0x08;
+    p[2] = 0x00;            // explicit header
+    p[3] = (unsigned char)len;
+    p[4] = 0x01;            // CRC on
+    p[5] = (unsigned char)invert_iq;
+    sx_cmd(SX_SET_PKT_PARAMS, p, 6);
+}
+
+static void sx_init(void) {
+    unsigned char p[8];
+    sx_cmd1(SX_SET_STANDBY, 0x00);
+    sx_cmd1(SX_SET_PACKET_TYPE, 0x01);          // LoRa
+    p[0] = 0x1D; p[1] = 0x60; p[2] = 0x00; p[3] = 0x00;
+    sx_cmd(SX_SET_RF_FREQ, p, 4);               // 470 MHz
+    p[0] = 0x00; p[1] = 0x80;
+    sx_cmd(SX_SET_BUFFER_BASE, p, 2);           // TX at 0, RX at 0x80
+    p[0] = 0x07; p[1] = 0x04; p[2] = 0x01; p[3] = 0x00;
+    sx_cmd(SX_SET_MOD_PARAMS, p, 4);            // SF7, BW125, CR4/5
+    p[0] = 0x02; p[1] = 0x03;                   // TxDone | RxDone | Timeout
+    p[2] = 0x02; p[3] = 0x03;                   // all on DIO1
+    p[4] = 0x00; p[5] = 0x00; p[6] = 0x00; p[7] = 0x00;
+    sx_cmd(SX_SET_DIO_IRQ, p, 8);
+    sx_clear_irq();
+}
+
+// Wait for DIO1, return (and clear) the IRQ status. 0 on guard timeout.
+static unsigned int sx_wait_irq(void) {
+    TIMER_COUNTDOWN = DIO1_GUARD_US;
+    while (!(GPIO_IN & GPIO_DIO1))
+        if (TIMER_COUNTDOWN == 0) return 0;
+    unsigned int irq = sx_get_irq();
+    sx_clear_irq();
+    return irq;
+}
+
+static int sx_send(const unsigned char *frame, int len) {
+    sx_packet_params(len, 0);
+    while (GPIO_IN & GPIO_BUSY);
+    spi_xfer(SX_WRITE_BUFFER);
+    spi_xfer(0x00);
+    for (int i = 0; i < len; i++)
+        spi_xfer(frame[i] | (i == len - 1 ? SPI_END : 0));
+    unsigned char p[3];
+    p[0] = 0; p[1] = 0; p[2] = 0;               // no TX timeout
+    sx_cmd(SX_SET_TX, p, 3);
+    return (sx_wait_irq() & SX_IRQ_TX_DONE) != 0;
+}
+
+// Listen for one downlink; returns its length (0 = timeout/none)
+static int sx_receive(unsigned char *buf, int max) {
+    sx_packet_params(max, 1);
+    unsigned char p[3];
+    p[0] = (RX_WINDOW >> 16) & 0xFF;
+    p[1] = (RX_WINDOW >> 8) & 0xFF;
+    p[2] = RX_WINDOW & 0xFF;
+    sx_cmd(SX_SET_RX, p, 3);
+    if (!(sx_wait_irq() & SX_IRQ_RX_DONE)) return 0;
+
+    while (GPIO_IN & GPIO_BUSY);
+    spi_xfer(SX_GET_RX_BUF_STAT);
+    spi_xfer(0);
+    int len = spi_xfer(0);
+    int start = spi_xfer(SPI_END);
+    if (len > max) len = max;
+
+    while (GPIO_IN & GPIO_BUSY);
+    spi_xfer(SX_READ_BUFFER);
+    spi_xfer(start);
+    spi_xfer(len == 0 ? SPI_END : 0);
+    for (int i = 0; i < len; i++)
+        buf[i] = (unsigned char)spi_xfer(i == len - 1 ? SPI_END : 0);
+    return len;
+}
+
+// ============================================================================
+// Reset handler
+// ============================================================================
+void __attribute__((naked, noreturn)) _reset_handler(void) {
+    __asm__ volatile (
+        "li sp, 0x01000100\n"
+        "j main\n"
+    );
+}
+
+static void put32(unsigned char *p, unsigned int v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+void __attribute__((noreturn)) main(void) {
+    unsigned int node_id = PROV[0];
+    unsigned int count = PROV[1];
+    unsigned int period = PROV[2];
+    unsigned int spread = PROV[3];
+    if (node_id == 0xFFFFFFFFu) {
+        node_id = 1;
+        count = 3;
+        period = 100000;
+        spread = 0;
+    }
+    node_id &= 0xFF;
+
+    sx_init();
+    delay_us(sx_random() & spread);             // spread the fleet's first uplink
+
+    unsigned char frame[FRAME_LEN];
+    unsigned char ack[ACK_LEN + 2];
+    for (unsigned int seq = 0; seq < count; seq++) {
+        SEAL_DATA = (node_id << 16) | (seq & 0xFFFF);
+        SEAL_CTRL = SEAL_COMMIT | (node_id << 2);
+        while (SEAL_CTRL & SEAL_BUSY);
+        unsigned int w0 = SEAL_DATA;
+        unsigned int w1 = SEAL_DATA;
+        unsigned int w2 = SEAL_DATA;
+        unsigned int mono = (w1 & 0x00FFFFFFu) | (w2 & 0xFF000000u);
+
+        frame[0] = (unsigned char)node_id;
+        put32(frame + 1, w0);
+        put32(frame + 5, w1);
+        put32(frame + 9, w2);
+
+        int acked = 0;
+        for (int tries = 0; tries < MAX_TRIES && !acked; tries++) {
+            if (tries)
+                delay_us(10000 + (sx_random() & ((0x10000u << tries) - 1)));
+            if (!sx_send(frame, FRAME_LEN)) continue;
+            int n = sx_receive(ack, sizeof(ack));
+            acked = n == ACK_LEN && ack[0] == 'A' && ack[1] == node_id &&
+                    (ack[2] | (ack[3] << 8) | (ack[4] << 16) | ((unsigned int)ack[5] << 24)) == mono;
+        }
+        uart_putc(acked ? 'A' : 'X');
+        delay_us(period + (sx_random() & 0x3FFFF));
+    }
+
+    uart_putc('D');
+    uart_putc('N');
+    while (1);
+}
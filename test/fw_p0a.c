@@ -24,19 +24,7 @@
 //   7. UART "DN" (done) → infinite loop
 // ============================================================================
 
-#define PERI_BASE       0x08000000u
-
-#define GPIO_OUT        (*(volatile unsigned int*)(PERI_BASE + 0x00))
-#define GPIO_IN         (*(volatile unsigned int*)(PERI_BASE + 0x04))
-#define CRC16_DATA      (*(volatile unsigned int*)(PERI_BASE + 0x08))
-#define UART_DATA       (*(volatile unsigned int*)(PERI_BASE + 0x10))
-#define UART_STATUS     (*(volatile unsigned int*)(PERI_BASE + 0x14))
-#define TIMER_COUNTDOWN (*(volatile unsigned int*)(PERI_BASE + 0x30))
-#define SYS_INFO        (*(volatile unsigned int*)(PERI_BASE + 0x3C))
-
-#define UART_TX_BUSY    (1u << 0)
-#define CRC16_BUSY      (1u << 16)
-#define CRC16_INIT      (1u << 8)
+#include "fw_hal.h"
 
 void __attribute__((naked, noreturn, section(".text._start"))) _start(void) {
     __asm__ volatile (
@@ -0,0 +1,582 @@
+// ============================================================================
+// Reference workload: event-driven sensor pipeline
+// ============================================================================
+// Target: LoRa Edge SoC (TinyQV RV32EC @ 25MHz)
+// Runs on: iss --i2c-devices sht3x,bme280 --sx1268 (scripts/fw_pipeline.py),
+//          the FPGA build with both sensors on the I2C header and an SX1268
+//
+// The production loop as a cooperative event loop. Interrupts only count
+// events; every stage is a step function that does one bounded piece of
+// work and returns 1, or returns 0 at once when it is waiting:
+//
+//   IRQ17  timer tick (TICK_US)    -> acquire: start the I2C script
+//   i2c    one I2C beat per step   -> read SHT3x + BME280 results, trigger
+//                                     the next conversions (they run
+//                                     during the rest of the tick)
+//   seal   one commit per step     -> record into the sensor's batch
+//   frame  BATCH records per sensor -> seal_batch_encode() into the frame
+//                                     queue
+//   radio  one SPI command per step -> PacketParams, WriteBuffer, SetTx
+//   IRQ16  DIO1 (TxDone)           -> GetIrqStatus, ClearIrqStatus
+//   IRQ18  UART RX (fw_uart.h)     -> '?' prints the counters line
+//   uart   one TX byte per step    -> uart_tx_poll() (fw_uart.h, no TX IRQ)
+//
+// Waits are polled with a cycle deadline (I2C beat, seal, SPI byte, radio
+// BUSY and TxDone), never with an open loop. A loop pass in which no stage
+// made progress is idle time: on silicon it would be a WFI. The run is
+// RUN_TICKS ticks; the window for the busy cycles per sample
+// (scripts/fw_pipeline.py) starts at the first tick and ends at tick
+// RUN_TICKS + 1. The frames still queued then are sent before the report.
+//
+// Sensors (values are what the seal commits, one record per sensor per tick):
+//   0x44  SHT3x single shot 0x2416 (4 ms)      {T[15:0], RH[15:0]}
+//   0x76  BME280 forced, T/P x1, H skipped     {P adc[19:4], T adc[19:4]}
+//
+// Tests:
+//   Q1: every tick in the window gave both samples and they were sealed
+//       (no NACK, CRC-8, I2C timeout, seal drop or tick overrun)
+//   Q2: every batch was encoded and sent, with TxDone on DIO1
+//
+// Build:
+//   riscv64-elf-gcc -march=rv32ec_zicsr -mabi=ilp32e -nostdlib -Os \
+//     -T fw_irq_timer.ld -o fw_pipeline.elf fw_pipeline.c fw_uart.c
+//   riscv64-elf-objcopy -O verilog fw_pipeline.elf fw_pipeline.hex
+//
+// Expected UART output:
+//   "PL <ticks> <samples> <cycles> <idle cycles> <frames> <errors>\n"
+//   then "Q1Q2DN"
+// ============================================================================
+
+#include "fw_uart.h"
+#include "fw_seal_batch.h"
+
+#define TICK_US         20000u          // 50 Hz
+#define RUN_TICKS       48u
+#define BATCH           8u              // records per uplink frame
+#define NSENS           2u
+#define SQ_SIZE         4u              // seal queue (power of two, >= NSENS)
+#define FQ_SIZE         4u              // frame queue slots (power of two)
+#define FRAME_MAX       128u
+
+#define SHT3X_ADDR      0x44u
+#define BME280_ADDR     0x76u
+
+// Deadlines in cycles (25 per us)
+#define I2C_BEAT_CYCLES 25000u          // 1 ms for one 45 us beat
+#define SEAL_CYCLES     2500u
+#define SPI_POLL        1000u
+#define BUSY_CYCLES     25000u          // radio BUSY (commands take ~3 us)
+#define TX_CYCLES       7500000u        // 300 ms for TxDone
+
+// SX1268
+#define SX_SET_STANDBY      0x80
+#define SX_SET_PACKET_TYPE  0x8A
+#define SX_SET_RF_FREQ      0x86
+#define SX_SET_MOD_PARAMS   0x8B
+#define SX_SET_PKT_PARAMS   0x8C
+#define SX_SET_BUFFER_BASE  0x8F
+#define SX_SET_DIO_IRQ      0x08
+#define SX_WRITE_BUFFER     0x0E
+#define SX_SET_TX           0x83
+#define SX_GET_IRQ_STATUS   0x12
+#define SX_CLR_IRQ_STATUS   0x02
+#define SX_IRQ_TX_DONE      0x0001
+
+// ============================================================================
+// State in PSRAM (no .data/.bss in this layout; fw_uart.h owns latch_mem
+// and the rings at 0x01000400..0x010005FF)
+// ============================================================================
+struct pipe {
+    // Written by _irq_handler only
+    unsigned int ticks;
+    unsigned int dio1;
+    // Event loop
+    unsigned int seen;                  // ticks handled
+    unsigned int dio1_seen;
+    unsigned int t_start, cycles, idle;
+    // I2C script
+    unsigned int op, phase, full, t_op, nack;
+    unsigned int nrx;
+    unsigned char rx[16];
+    // Seal queue: the samples of one tick
+    unsigned int sq_head, sq_tail, seal_busy, t_seal;
+    unsigned int sq_val[SQ_SIZE], sq_ch[SQ_SIZE];
+    unsigned int bcount[NSENS];
+    // Frame queue and radio
+    unsigned int fq_head, fq_tail;
+    unsigned int flen[FQ_SIZE];
+    unsigned int r_state, t_radio;
+    // Counters
+    unsigned int samples, frames;
+    unsigned int missed, i2c_timeouts, seal_errors, overruns, frame_drops, tx_errors;
+};
+
+#define P               ((volatile struct pipe *)0x01000600)
+#define RECS            ((struct seal_rec *)0x01000700)     // [NSENS][BATCH]
+#define FRAMES          ((unsigned char *)0x01000900)       // [FQ_SIZE][FRAME_MAX]
+
+static const unsigned char sensor_id[NSENS] = { SHT3X_ADDR, BME280_ADDR };
+
+// ============================================================================
+// Vector table
+// ============================================================================
+void __attribute__((naked, section(".text._vectors"))) _vectors(void) {
+    __asm__ volatile (
+        ".option push\n"
+        ".option norvc\n"
+        "j _reset_handler\n"       // 0x0: reset
+        "j _trap_handler\n"        // 0x4: trap
+        "j _uart_irq_handler\n"    // 0x8: interrupt (UART, then _irq_handler)
+        ".option pop\n"
+    );
+}
+
+void __attribute__((naked)) _trap_handler(void) {
+    __asm__ volatile ("j _trap_handler\n");
+}
+
+// ============================================================================
+// IRQ16/17: count the event, nothing else
+// ============================================================================
+void __attribute__((interrupt)) _irq_handler(void) {
+    unsigned int cause;
+    __asm__ volatile ("csrr %0, mcause" : "=r"(cause));
+    cause &= 0x1F;
+    if (cause == 17) {
+        P->ticks++;
+        __asm__ volatile ("csrc 0x344, %0" : : "r"(1u << 17));
+        TIMER_COUNTDOWN = TICK_US;                  // after the csrc: keep the next edge
+    } else if (cause == 16) {
+        P->dio1++;
+        __asm__ volatile ("csrc 0x344, %0" : : "r"(1u << 16));
+    }
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+static inline unsigned int rdcycle(void) {
+    unsigned int c;
+    __asm__ volatile ("csrr %0, 0xC00" : "=r"(c));
+    return c;
+}
+
+// No divider on RV32EC: subtract powers of ten
+static char *put_dec(char *p, unsigned int v) {
+    static const unsigned int pow10[] = { 1000000000u, 100000000u, 10000000u, 1000000u,
+                                          100000u, 10000u, 1000u, 100u, 10u, 1u };
+    int started = 0;
+    for (unsigned int i = 0; i < sizeof(pow10) / sizeof(pow10[0]); i++) {
+        char d = '0';
+        while (v >= pow10[i]) {
+            v -= pow10[i];
+            d++;
+        }
+        if (d != '0' || started || i == 9) {
+            *p++ = d;
+            started = 1;
+        }
+    }
+    *p++ = ' ';
+    return p;
+}
+
+static unsigned int errors(void) {
+    return P->missed + P->i2c_timeouts + P->seal_errors + P->overruns + P->frame_drops + P->tx_errors;
+}
+
+// "PL ticks samples cycles idle frames errors\n"; cycles/idle run on until
+// the window closes
+static void report(void) {
+    char line[80];
+    char *p = line;
+    unsigned int cycles = P->cycles ? P->cycles : rdcycle() - P->t_start;
+    *p++ = 'P';
+    *p++ = 'L';
+    *p++ = ' ';
+    p = put_dec(p, P->seen > RUN_TICKS ? RUN_TICKS : P->seen);
+    p = put_dec(p, P->samples);
+    p = put_dec(p, cycles);
+    p = put_dec(p, P->idle);
+    p = put_dec(p, P->frames);
+    p = put_dec(p, errors());
+    p[-1] = '\n';
+    uart_write(line, (unsigned int)(p - line));
+}
+
+// Sensirion CRC-8: poly 0x31, init 0xFF
+static unsigned int crc8(const volatile unsigned char *p) {
+    unsigned int c = 0xFF;
+    for (int i = 0; i < 2; i++) {
+        c ^= p[i];
+        for (int b = 0; b < 8; b++)
+            c = (c & 0x80) ? ((c << 1) ^ 0x31) & 0xFF : (c << 1) & 0xFF;
+    }
+    return c;
+}
+
+// ============================================================================
+// Acquire: I2C script, one beat per step
+// ============================================================================
+// Each entry is one I2C_DATA command; OP_BME marks the BME280's beats for
+// the per-sensor NACK mask. A beat is done when the TX holding register has
+// drained (write) or the byte arrived (read); a STOP beat also waits for
+// the bus to go idle, and a START waits for it before being issued.
+#define OP_BME          0x8000u
+#define OP_CMD          0x1FFFu
+#define S_              I2C_CMD_START
+#define W_              I2C_CMD_WRITE
+#define R_              I2C_CMD_READ
+#define P_              I2C_CMD_STOP
+
+static const unsigned short i2c_script[] = {
+    // Results of the conversions triggered last tick
+    S_ | R_ | SHT3X_ADDR, R_ | SHT3X_ADDR, R_ | SHT3X_ADDR,     // T, crc, RH, crc
+    R_ | SHT3X_ADDR, R_ | SHT3X_ADDR, R_ | P_ | SHT3X_ADDR,
+    OP_BME | S_ | W_ | BME280_ADDR, OP_BME | W_ | P_ | 0xF7,     // press_msb..temp_xlsb
+    OP_BME | S_ | R_ | BME280_ADDR, OP_BME | R_ | BME280_ADDR, OP_BME | R_ | BME280_ADDR,
+    OP_BME | R_ | BME280_ADDR, OP_BME | R_ | BME280_ADDR, OP_BME | R_ | P_ | BME280_ADDR,
+#define OPS_TRIGGER     14u
+    // Next conversions
+    S_ | W_ | SHT3X_ADDR, W_ | 0x24, W_ | P_ | 0x16,            // single shot, low repeatability
+    OP_BME | S_ | W_ | BME280_ADDR, OP_BME | W_ | 0xF4, OP_BME | W_ | P_ | 0x25,  // forced
+};
+#define NOPS            (sizeof(i2c_script) / sizeof(i2c_script[0]))
+
+static void i2c_start(unsigned int first) {
+    P->op = first;
+    P->full = first == 0;
+    P->phase = 0;
+    P->nack = 0;
+    P->nrx = 0;
+    P->t_op = rdcycle();
+}
+
+static void seal_push(unsigned int ch, unsigned int value) {
+    unsigned int h = P->sq_head;
+    P->sq_val[h] = value;
+    P->sq_ch[h] = ch;
+    P->sq_head = (h + 1) & (SQ_SIZE - 1);
+}
+
+// Script finished: hand the readings to the seal stage
+static void i2c_done(void) {
+    volatile unsigned char *b = P->rx;
+    if (!(P->nack & 1) && crc8(b) == b[2] && crc8(b + 3) == b[5])
+        seal_push(0, ((unsigned int)b[0] << 24) | (b[1] << 16) | (b[3] << 8) | b[4]);
+    else
+        P->missed++;
+    // x1 oversampling: 16-bit results, adc[3:0] are zero
+    if (!(P->nack & 2))
+        seal_push(1, ((unsigned int)b[6] << 24) | (b[7] << 16) | (b[9] << 8) | b[10]);
+    else
+        P->missed++;
+}
+
+static int i2c_next(unsigned int op) {
+    P->phase = 0;
+    P->op = ++op;
+    P->t_op = rdcycle();
+    if (op == NOPS && P->full) i2c_done();
+    return 1;
+}
+
+static int i2c_step(void) {
+    unsigned int op = P->op;
+    if (op >= NOPS) return 0;
+    unsigned int c = i2c_script[op], cmd = c & OP_CMD, s;
+    unsigned int bit = (c & OP_BME) ? 2 : 1;
+
+    switch (P->phase) {
+    case 0:                                     // issue
+        if ((cmd & I2C_CMD_START) && (I2C_DATA & I2C_BUSY)) break;
+        I2C_DATA = cmd;
+        P->phase = 1;
+        P->t_op = rdcycle();
+        return 1;
+    case 1:                                     // beat done
+        s = I2C_DATA;
+        if (cmd & I2C_CMD_READ) {
+            if (!(s & I2C_RX_VALID)) break;
+            P->rx[P->nrx++] = (unsigned char)s;
+            // The address NACK lands with the first byte; the next beat clears it
+            if ((cmd & I2C_CMD_START) && (I2C_DATA & I2C_NACK)) P->nack |= bit;
+        } else if (s & I2C_TX_PENDING) {
+            break;
+        }
+        if (!(cmd & I2C_CMD_STOP)) return i2c_next(op);
+        P->phase = 2;
+        P->t_op = rdcycle();
+        return 1;
+    default:                                    // STOP: bus idle, write NACK valid
+        s = I2C_DATA;
+        if (s & I2C_BUSY) break;
+        if (!(cmd & I2C_CMD_READ) && (s & I2C_NACK)) P->nack |= bit;
+        return i2c_next(op);
+    }
+    if (rdcycle() - P->t_op > I2C_BEAT_CYCLES) {
+        P->i2c_timeouts++;
+        P->op = NOPS;
+        return 1;
+    }
+    return 0;
+}
+
+// ============================================================================
+// Seal: one commit per step, then the record into its sensor's batch
+// ============================================================================
+static void frame_push(unsigned int ch) {
+    unsigned int h = P->fq_head;
+    if (((h - P->fq_tail) & (2 * FQ_SIZE - 1)) == FQ_SIZE) {
+        P->frame_drops++;
+        return;
+    }
+    unsigned int slot = h & (FQ_SIZE - 1);
+    P->flen[slot] = seal_batch_encode(RECS + ch * BATCH, BATCH, FRAMES + slot * FRAME_MAX);
+    P->fq_head = (h + 1) & (2 * FQ_SIZE - 1);
+}
+
+static int seal_step(void) {
+    if (P->seal_busy) {
+        unsigned int ctrl = SEAL_CTRL;
+        if (ctrl & SEAL_BUSY) {
+            if (rdcycle() - P->t_seal <= SEAL_CYCLES) return 0;
+            ctrl = SEAL_DROPPED;
+        }
+        P->seal_busy = 0;
+        unsigned int t = P->sq_tail;
+        P->sq_tail = (t + 1) & (SQ_SIZE - 1);
+        if (ctrl & SEAL_DROPPED) {
+            P->seal_errors++;
+            return 1;
+        }
+        unsigned int ch = P->sq_ch[t], w[3], n = P->bcount[ch];
+        hal_seal_read(w);
+        struct seal_rec *r = RECS + ch * BATCH + n;
+        r->value   = w[0];
+        r->mono    = hal_seal_mono(w);
+        r->crc     = (unsigned short)hal_seal_crc(w);
+        r->sensor  = sensor_id[ch];
+        r->session = (unsigned char)(w[1] >> 24);
+        if (P->cycles == 0) P->samples++;
+        if (++n == BATCH) {
+            frame_push(ch);
+            n = 0;
+        }
+        P->bcount[ch] = n;
+        return 1;
+    }
+    if (P->sq_tail == P->sq_head || !(SEAL_CTRL & SEAL_READY)) return 0;
+    unsigned int t = P->sq_tail;
+    SEAL_DATA = P->sq_val[t];
+    SEAL_CTRL = ((unsigned int)sensor_id[P->sq_ch[t]] << SEAL_SID_SHIFT) | SEAL_COMMIT;
+    P->seal_busy = 1;
+    P->t_seal = rdcycle();
+    return 1;
+}
+
+// ============================================================================
+// Radio: one SX1268 command per step (the SPI bytes themselves are ~160
+// cycles each, so a command is short work, not a wait)
+// ============================================================================
+static unsigned int spi_xfer(unsigned int b) {
+    unsigned int t = SPI_POLL;
+    SPI_DATA = b;
+    while ((SPI_STATUS & SPI_BUSY) && --t);
+    return SPI_DATA & 0xFF;
+}
+
+// hdr[0..hn-1] then p[0..n-1], CS released after the last byte
+static void sx_cmd(const unsigned char *hdr, unsigned int hn, const unsigned char *p, unsigned int n) {
+    for (unsigned int i = 0; i < hn; i++)
+        spi_xfer(hdr[i] | (i == hn - 1 && n == 0 ? SPI_END : 0));
+    for (unsigned int i = 0; i < n; i++)
+        spi_xfer(p[i] | (i == n - 1 ? SPI_END : 0));
+}
+
+static unsigned int sx_get_irq(void) {
+    spi_xfer(SX_GET_IRQ_STATUS);
+    spi_xfer(0);
+    unsigned int hi = spi_xfer(0);
+    return (hi << 8) | spi_xfer(SPI_END);
+}
+
+enum { R_IDLE, R_PARAMS, R_BUFFER, R_TX, R_WAIT, R_IRQ, R_CLEAR };
+
+static int radio_step(void) {
+    unsigned int st = P->r_state;
+    if (st == R_IDLE && P->fq_tail == P->fq_head) return 0;
+    if (st == R_WAIT) {
+        if (P->dio1 != P->dio1_seen) {
+            P->dio1_seen = P->dio1;
+            P->r_state = R_IRQ;
+            P->t_radio = rdcycle();
+            return 1;
+        }
+        if (rdcycle() - P->t_radio <= TX_CYCLES) return 0;
+        P->tx_errors++;
+        P->r_state = R_CLEAR;
+        return 1;
+    }
+    if (GPIO_IN & GPIO_BUSY) {
+        if (st == R_IDLE || rdcycle() - P->t_radio <= BUSY_CYCLES) return 0;
+        P->tx_errors++;                         // radio stuck: drop the frame
+        P->fq_tail = (P->fq_tail + 1) & (2 * FQ_SIZE - 1);
+        P->r_state = R_IDLE;
+        return 1;
+    }
+
+    unsigned int slot = P->fq_tail & (FQ_SIZE - 1);
+    unsigned char h[7];
+    switch (st) {
+    case R_IDLE:
+    case R_PARAMS:
+        h[0] = SX_SET_PKT_PARAMS;
+        h[1] = 0x00;                            // preamble 8 symbols
+        h[2] = 0x08;
+        h[3] = 0x00;                            // explicit header
+        h[4] = (unsigned char)P->flen[slot];
+        h[5] = 0x01;                            // CRC on
+        h[6] = 0x00;                            // standard IQ
+        sx_cmd(h, 7, 0, 0);
+        st = R_BUFFER;
+        break;
+    case R_BUFFER:
+        h[0] = SX_WRITE_BUFFER;
+        h[1] = 0x00;
+        sx_cmd(h, 2, FRAMES + slot * FRAME_MAX, P->flen[slot]);
+        st = R_TX;
+        break;
+    case R_TX:
+        h[0] = SX_SET_TX;
+        h[1] = h[2] = h[3] = 0;                 // no TX timeout
+        sx_cmd(h, 4, 0, 0);
+        st = R_WAIT;
+        break;
+    case R_IRQ:
+        if (sx_get_irq() & SX_IRQ_TX_DONE) P->frames++;
+        else P->tx_errors++;
+        st = R_CLEAR;
+        break;
+    default:                                    // R_CLEAR
+        h[0] = SX_CLR_IRQ_STATUS;
+        h[1] = h[2] = 0xFF;
+        sx_cmd(h, 3, 0, 0);
+        P->fq_tail = (P->fq_tail + 1) & (2 * FQ_SIZE - 1);
+        st = R_IDLE;
+        break;
+    }
+    P->r_state = st;
+    P->t_radio = rdcycle();
+    return 1;
+}
+
+// Blocking, bounded: init only
+static void sx_init_cmd(const unsigned char *p, unsigned int n) {
+    unsigned int t = HAL_POLL_MAX;
+    while ((GPIO_IN & GPIO_BUSY) && --t);
+    sx_cmd(p, n, 0, 0);
+}
+
+static void sx_init(void) {
+    static const unsigned char standby[]  = { SX_SET_STANDBY, 0x00 };
+    static const unsigned char lora[]     = { SX_SET_PACKET_TYPE, 0x01 };
+    static const unsigned char freq[]     = { SX_SET_RF_FREQ, 0x1D, 0x60, 0x00, 0x00 };    // 470 MHz
+    static const unsigned char base[]     = { SX_SET_BUFFER_BASE, 0x00, 0x80 };
+    static const unsigned char mod[]      = { SX_SET_MOD_PARAMS, 0x07, 0x06, 0x01, 0x00 }; // SF7 BW500 CR4/5
+    static const unsigned char dio[]      = { SX_SET_DIO_IRQ, 0x00, 0x01, 0x00, 0x01, 0, 0, 0, 0 };
+    static const unsigned char clear[]    = { SX_CLR_IRQ_STATUS, 0xFF, 0xFF };
+    sx_init_cmd(standby, sizeof(standby));
+    sx_init_cmd(lora, sizeof(lora));
+    sx_init_cmd(freq, sizeof(freq));
+    sx_init_cmd(base, sizeof(base));
+    sx_init_cmd(mod, sizeof(mod));
+    sx_init_cmd(dio, sizeof(dio));
+    sx_init_cmd(clear, sizeof(clear));
+}
+
+// ============================================================================
+// Events: timer tick and host command
+// ============================================================================
+static int tick_step(void) {
+    if (P->seen == P->ticks) return 0;
+    unsigned int n = ++P->seen;
+    if (n == 1) {
+        P->t_start = rdcycle();
+        P->idle = 0;
+    }
+    if (n > RUN_TICKS) {                        // window closed
+        P->cycles = rdcycle() - P->t_start;
+        return 1;
+    }
+    if (P->op < NOPS) P->overruns++;            // last tick's script still running
+    else i2c_start(0);
+    return 1;
+}
+
+static int rx_step(void) {
+    unsigned char c;
+    if (uart_rx_count() == 0) return 0;
+    uart_read(&c, 1);
+    if (c == '?') report();
+    return 1;
+}
+
+// ============================================================================
+// Reset handler
+// ============================================================================
+void __attribute__((naked, noreturn)) _reset_handler(void) {
+    __asm__ volatile (
+        "li sp, 0x01000100\n"
+        "j main\n"
+    );
+}
+
+void __attribute__((noreturn)) main(void) {
+    volatile unsigned int *z = (volatile unsigned int *)P;
+    for (unsigned int i = 0; i < sizeof(struct pipe) / 4; i++) z[i] = 0;
+    P->op = NOPS;
+
+    uart_init();
+    sx_init();
+    hal_i2c_set_prescale(63);                   // 200 kHz
+
+    // Trigger the first conversions so tick 1 has results to read
+    i2c_start(OPS_TRIGGER);
+    while (P->op < NOPS) i2c_step();
+    int init_ok = P->nack == 0;
+
+    TIMER_COUNTDOWN = TICK_US;
+    __asm__ volatile ("csrs 0x304, %0" : : "r"((1u << 16) | (1u << 17)));
+    __asm__ volatile ("csrs mstatus, %0" : : "r"(8));
+
+    // ---- Event loop: the measured window ----
+    while (P->seen <= RUN_TICKS) {
+        unsigned int t = rdcycle();
+        int busy = tick_step();
+        busy |= i2c_step();
+        busy |= seal_step();
+        busy |= radio_step();
+        busy |= rx_step();
+        busy |= uart_tx_poll();
+        if (!busy) P->idle += rdcycle() - t;
+    }
+    hal_timer_stop();
+    __asm__ volatile ("csrc 0x304, %0" : : "r"(1u << 17));
+
+    // ---- Drain: send what is still queued (not measured) ----
+    while (P->seal_busy || P->sq_tail != P->sq_head || P->fq_tail != P->fq_head || P->r_state != R_IDLE) {
+        seal_step();
+        radio_step();
+        uart_tx_poll();
+    }
+
+    report();
+    int q1 = init_ok && P->samples == NSENS * RUN_TICKS && P->missed == 0 &&
+             P->i2c_timeouts == 0 && P->seal_errors == 0 && P->overruns == 0;
+    int q2 = P->frames == NSENS * RUN_TICKS / BATCH && P->frame_drops == 0 && P->tx_errors == 0;
+    unsigned char r[6] = { q1 ? 'Q' : 'F', '1', q2 ? 'Q' : 'F', '2', 'D', 'N' };
+    while (uart_write(r, sizeof(r)) == 0);
+    uart_flush();
+    while (1);
+}
@@ -26,36 +26,7 @@
 //   "DN\n"               — All done
 // ============================================================================
 
-#define PERI_BASE       0x08000000u
-
-#define GPIO_OUT        (*(volatile unsigned int*)(PERI_BASE + 0x00))
-#define GPIO_IN         (*(volatile unsigned int*)(PERI_BASE + 0x04))
-#define CRC16_DATA      (*(volatile unsigned int*)(PERI_BASE + 0x08))
-#define UART_DATA       (*(volatile unsigned int*)(PERI_BASE + 0x10))
-#define UART_STATUS     (*(volatile unsigned int*)(PERI_BASE + 0x14))
-#define I2C_DATA        (*(volatile unsigned int*)(PERI_BASE + 0x18))
-#define I2C_CONFIG      (*(volatile unsigned int*)(PERI_BASE + 0x1C))
-#define RTC_SECONDS     (*(volatile unsigned int*)(PERI_BASE + 0x28))
-#define SEAL_DATA       (*(volatile unsigned int*)(PERI_BASE + 0x2C))
-#define TIMER_COUNTDOWN (*(volatile unsigned int*)(PERI_BASE + 0x30))
-#define WDT_KICK        (*(volatile unsigned int*)(PERI_BASE + 0x34))
-#define SEAL_CTRL       (*(volatile unsigned int*)(PERI_BASE + 0x38))
-#define SYS_INFO        (*(volatile unsigned int*)(PERI_BASE + 0x3C))
-
-#define UART_TX_BUSY    (1u << 0)
-#define CRC16_BUSY      (1u << 16)
-#define CRC16_INIT      (1u << 8)
-#define I2C_CMD_START   (1u << 8)
-#define I2C_CMD_READ    (1u << 9)
-#define I2C_CMD_WRITE   (1u << 10)
-#define I2C_CMD_STOP    (1u << 12)
-#define I2C_BUSY        (1u << 9)
-#define I2C_NACK        (1u << 8)
-#define I2C_RX_VALID    (1u << 10)
-#define I2C_TX_PENDING  (1u << 11)
-#define SEAL_COMMIT     (1u << 1)
-#define SEAL_BUSY       (1u << 0)
-#define SEAL_READY      (1u << 1)
+#include "fw_hal.h"
 
 void __attribute__((naked, noreturn, section(".text._start"))) _start(void) {
     __asm__ volatile (
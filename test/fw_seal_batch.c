@@ -0,0 +1,120 @@
+// ============================================================================
+// Test: Seal batching — N records in one compact uplink payload
+// ============================================================================
+// Target: LoRa Edge SoC (TinyQV RV32EC @ 25MHz)
+// Tests:
+//   K1: 16 samples of sensor 0x42 sealed through SEAL_DATA/SEAL_CTRL (one
+//       commit of sensor 0x43 in between, so the batch has a mono step of 2);
+//       one session, mono strictly increasing
+//   K2: seal_batch_encode() packs them into at most half the 11 bytes per
+//       record plus the header
+//   K3: seal_batch_decode() gives back every record, and each record's CRC
+//       still matches CRC16(sensor_id, value, mono) on the hardware engine
+//
+// Build:
+//   riscv64-elf-gcc -march=rv32ec_zicsr -mabi=ilp32e -nostdlib -Os \
+//     -T fw_irq_timer.ld -o fw_seal_batch.elf fw_seal_batch.c
+//   riscv64-elf-objcopy -O verilog fw_seal_batch.elf fw_seal_batch.hex
+//
+// Expected UART output: "SB", length byte, the encoded batch, then
+// "K1K2K3DN". verify/iss/seal_batch_test decodes the batch on the host.
+// ============================================================================
+
+#include "fw_seal_batch.h"
+
+// Work buffers in PSRAM above the stack (no .data/.bss in this layout)
+#define NREC            16u
+#define VALUES          ((unsigned int *)0x01000400)
+#define RECS            ((struct seal_rec *)0x01000500)
+#define BACK            ((struct seal_rec *)0x01000700)
+#define BATCH           ((unsigned char *)0x01000900)
+
+// ============================================================================
+// Vector table
+// ============================================================================
+void __attribute__((naked, section(".text._vectors"))) _vectors(void) {
+    __asm__ volatile (
+        ".option push\n"
+        ".option norvc\n"
+        "j _reset_handler\n"
+        "j _trap_handler\n"
+        "j _trap_handler\n"
+        ".option pop\n"
+    );
+}
+
+void __attribute__((naked)) _trap_handler(void) {
+    __asm__ volatile ("j _trap_handler\n");
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+static void put_result(unsigned char test_num, int pass) {
+    hal_uart_putc(pass ? 'K' : 'F');
+    hal_uart_putc(test_num);
+}
+
+static unsigned int seal_crc_hw(const struct seal_rec *r) {
+    hal_crc16_init();
+    hal_crc16_feed(r->sensor);
+    for (unsigned int k = 0; k < 32; k += 8) hal_crc16_feed((unsigned char)(r->value >> k));
+    for (unsigned int k = 0; k < 32; k += 8) hal_crc16_feed((unsigned char)(r->mono >> k));
+    return hal_crc16_value();
+}
+
+// ============================================================================
+// Reset handler
+// ============================================================================
+void __attribute__((naked, noreturn)) _reset_handler(void) {
+    __asm__ volatile (
+        "li sp, 0x01000100\n"
+        "j main\n"
+    );
+}
+
+void __attribute__((noreturn)) main(void) {
+    // A slowly drifting 12-bit reading, plus both varint extremes
+    unsigned int v = 2150;
+    for (unsigned int i = 0; i < NREC; i++) {
+        v += (i & 3) - 1;
+        VALUES[i] = v;
+    }
+    VALUES[3] = 0;
+    VALUES[12] = 0xFFFFFFFFu;
+
+    // ---- K1: seal, with another sensor's commit in the middle ----
+    struct seal_rec other;
+    unsigned int half = NREC / 2;
+    unsigned int n = seal_batch_commit(0x42, VALUES, half, RECS);
+    n += seal_batch_commit(0x43, VALUES, 1, &other);
+    n += seal_batch_commit(0x42, VALUES + half, NREC - half, RECS + half);
+    int ok = n == NREC + 1 && RECS[half].mono - RECS[half - 1].mono == 2;
+    for (unsigned int i = 1; ok && i < NREC; i++)
+        ok = RECS[i].session == RECS[0].session && RECS[i].mono > RECS[i - 1].mono;
+    int k1 = ok;
+
+    // ---- K2: encode ----
+    unsigned int len = seal_batch_encode(RECS, NREC, BATCH);
+    int k2 = len != 0 && len <= NREC * 11 / 2 + SEAL_BATCH_HDR;
+
+    // ---- K3: decode on target, re-check every CRC ----
+    ok = seal_batch_decode(BATCH, len, BACK, NREC) == (int)NREC;
+    for (unsigned int i = 0; ok && i < NREC; i++)
+        ok = BACK[i].value == RECS[i].value && BACK[i].mono == RECS[i].mono &&
+             BACK[i].crc == RECS[i].crc && BACK[i].sensor == 0x42 &&
+             BACK[i].session == RECS[i].session && seal_crc_hw(&BACK[i]) == BACK[i].crc;
+    int k3 = ok;
+
+    hal_uart_putc('S');
+    hal_uart_putc('B');
+    hal_uart_putc((unsigned char)len);
+    for (unsigned int i = 0; i < len; i++) hal_uart_putc(BATCH[i]);
+
+    put_result('1', k1);
+    put_result('2', k2);
+    put_result('3', k3);
+    hal_uart_putc('D');
+    hal_uart_putc('N');
+    while (1);
+}
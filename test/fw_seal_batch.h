@@ -0,0 +1,139 @@
+// ============================================================================
+// fw_seal_batch.h — seal N samples and pack them for the uplink (header-only)
+// ============================================================================
+// A single seal record costs 11 bytes of payload (value, session_id,
+// mono_count, crc) plus the sensor_id. Within one batch the sensor and the
+// session are the same for every record and mono_count only grows, so the
+// batch sends them once:
+//
+//   offset  size     field
+//   0       1        sensor_id
+//   1       1        session_id
+//   2       1        count (1..SEAL_BATCH_MAX)
+//   3       4        mono_count of record 0, LE
+//   then count times:
+//           varint   mono_count - previous mono_count   (not for record 0)
+//           varint   value
+//           2        crc16 of the record, LE (seal_register.v, unchanged)
+//
+// varint = unsigned LEB128: 7 bits per byte, low group first, bit 7 set on
+// every byte but the last (1..5 bytes for 32 bits). Back-to-back commits
+// have a mono step of 1 (one byte); a 14-bit sensor reading takes two, so a
+// record shrinks from 11 to 5 bytes. Every record keeps its own CRC: the
+// receiver rebuilds {sensor_id, value, mono_count} and checks it exactly
+// as for a single record (verify/iss/seal_batch.h is the host decoder).
+//
+//   seal_batch_commit(sensor, v, n, r)   commit v[0..n-1], read back records
+//   seal_batch_encode(r, n, out)         pack; returns length, 0 if r[] mix
+//                                        sensors/sessions or n is out of range
+//   seal_batch_decode(p, len, r, max)    unpack; returns count or -1
+// ============================================================================
+
+#ifndef FW_SEAL_BATCH_H
+#define FW_SEAL_BATCH_H
+
+#include "fw_hal.h"
+
+#define SEAL_BATCH_MAX      255u
+#define SEAL_BATCH_HDR      7u
+#define SEAL_BATCH_LEN(n)   (SEAL_BATCH_HDR + (n) * 12u)    // worst case
+
+struct seal_rec {
+    unsigned int   value;
+    unsigned int   mono;
+    unsigned short crc;
+    unsigned char  sensor;
+    unsigned char  session;
+};
+
+// Commit each value for `sensor` and read the sealed record back. Returns
+// how many were sealed; stops early if the seal stays busy (bounded poll).
+static unsigned int seal_batch_commit(unsigned int sensor, const unsigned int *v,
+                                      unsigned int n, struct seal_rec *r) {
+    for (unsigned int i = 0; i < n; i++) {
+        unsigned int t = HAL_POLL_MAX;
+        while (!(SEAL_CTRL & SEAL_READY) && t > 0) t--;
+        if (t == 0) return i;
+        SEAL_DATA = v[i];
+        SEAL_CTRL = (sensor << SEAL_SID_SHIFT) | SEAL_COMMIT;
+        t = HAL_POLL_MAX;
+        while ((SEAL_CTRL & SEAL_BUSY) && t > 0) t--;
+        if (t == 0 || (SEAL_CTRL & SEAL_DROPPED)) return i;
+        unsigned int w[3];
+        hal_seal_read(w);
+        r[i].value   = w[0];
+        r[i].mono    = hal_seal_mono(w);
+        r[i].crc     = (unsigned short)hal_seal_crc(w);
+        r[i].sensor  = (unsigned char)sensor;
+        r[i].session = (unsigned char)(w[1] >> 24);
+    }
+    return n;
+}
+
+static unsigned char *seal_batch_put_varint(unsigned char *p, unsigned int v) {
+    while (v >= 0x80) {
+        *p++ = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (unsigned char)v;
+    return p;
+}
+
+// NULL on a truncated or over-long (> 5 bytes, > 32 bits) varint
+static const unsigned char *seal_batch_get_varint(const unsigned char *p, const unsigned char *end,
+                                                  unsigned int *v) {
+    unsigned int x = 0;
+    for (unsigned int shift = 0; shift < 35; shift += 7) {
+        if (p == end) return 0;
+        unsigned int b = *p++;
+        if (shift == 28 && b > 0x0F) return 0;
+        x |= (b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = x;
+            return p;
+        }
+    }
+    return 0;
+}
+
+static unsigned int seal_batch_encode(const struct seal_rec *r, unsigned int n, unsigned char *out) {
+    if (n == 0 || n > SEAL_BATCH_MAX) return 0;
+    for (unsigned int i = 1; i < n; i++)
+        if (r[i].sensor != r[0].sensor || r[i].session != r[0].session) return 0;
+    unsigned char *p = out;
+    *p++ = r[0].sensor;
+    *p++ = r[0].session;
+    *p++ = (unsigned char)n;
+    for (unsigned int k = 0; k < 32; k += 8) *p++ = (unsigned char)(r[0].mono >> k);
+    for (unsigned int i = 0; i < n; i++) {
+        if (i) p = seal_batch_put_varint(p, r[i].mono - r[i - 1].mono);
+        p = seal_batch_put_varint(p, r[i].value);
+        *p++ = (unsigned char)r[i].crc;
+        *p++ = (unsigned char)(r[i].crc >> 8);
+    }
+    return (unsigned int)(p - out);
+}
+
+// Rebuilds the records; the CRCs are passed through, not checked
+static int seal_batch_decode(const unsigned char *p, unsigned int len, struct seal_rec *r,
+                             unsigned int max) {
+    const unsigned char *end = p + len;
+    if (len < SEAL_BATCH_HDR || p[2] == 0 || p[2] > max) return -1;
+    unsigned int n = p[2];
+    unsigned int mono = p[3] | (p[4] << 8) | (p[5] << 16) | ((unsigned int)p[6] << 24);
+    const unsigned char *q = p + SEAL_BATCH_HDR;
+    for (unsigned int i = 0; i < n; i++) {
+        unsigned int d = 0;
+        if (i && !(q = seal_batch_get_varint(q, end, &d))) return -1;
+        mono += d;
+        if (!(q = seal_batch_get_varint(q, end, &r[i].value)) || end - q < 2) return -1;
+        r[i].mono    = mono;
+        r[i].crc     = (unsigned short)(q[0] | (q[1] << 8));
+        r[i].sensor  = p[0];
+        r[i].session = p[1];
+        q += 2;
+    }
+    return q == end ? (int)n : -1;
+}
+
+#endif // FW_SEAL_BATCH_H
@@ -18,12 +18,7 @@
 // Expected UART output: "F1F2F3DN" (8 chars)
 // ============================================================================
 
-#define PERI_BASE       0x08000000u
-#define UART_DATA       (*(volatile unsigned int*)(PERI_BASE + 0x10))
-#define UART_STATUS     (*(volatile unsigned int*)(PERI_BASE + 0x14))
-#define TIMER_COUNTDOWN (*(volatile unsigned int*)(PERI_BASE + 0x30))
-
-#define UART_TX_BUSY    (1u << 0)
+#include "fw_hal.h"
 
 // Shared state in PSRAM
 #define P_IRQ_COUNT ((volatile unsigned int *)0x01000084)
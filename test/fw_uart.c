@@ -0,0 +1,56 @@
+// ============================================================================
+// fw_uart.c — IRQ18 entry of the UART driver (fw_uart.h)
+// ============================================================================
+// Linked into every firmware that includes fw_uart.h (its Build: line names
+// this file). Kept out of the header so the one non-static, naked handler
+// is defined exactly once.
+//
+// Only a0..a2 are touched, saved in latch_mem (tp-32 .. tp-21); the ring
+// indices are at tp-20 .. tp-1 (table in fw_uart.h). RX ring full bumps
+// rx_overrun and drops the byte. Any cause other than IRQ18 restores a0/a1
+// and jumps to the firmware's _irq_handler with every register intact.
+// ============================================================================
+
+#include "fw_uart.h"
+
+#define UART_STR_(x)    #x
+#define UART_STR(x)     UART_STR_(x)
+
+void __attribute__((naked)) _uart_irq_handler(void) {
+    __asm__ volatile (
+        "sw a0, -32(tp)\n"
+        "sw a1, -28(tp)\n"
+        "csrr a0, mcause\n"
+        "andi a0, a0, 0x1F\n"
+        "addi a0, a0, -18\n"
+        "bnez a0, 8f\n"
+        // IRQ18: RX valid
+        "sw a2, -24(tp)\n"
+        "lw a1, 0x10(tp)\n"             // UART_DATA, read clears rx_valid
+        "lw a0, -12(tp)\n"              // rx_head
+        "lw a2, -8(tp)\n"               // rx_tail
+        "sub a2, a2, a0\n"
+        "addi a2, a2, -1\n"
+        "andi a2, a2, " UART_STR(UART_RXQ_SIZE - 1) "\n"
+        "beqz a2, 3f\n"                 // full
+        "add a2, a0, gp\n"
+        "sb a1, " UART_STR(UART_TXQ_SIZE) "(a2)\n"
+        "addi a0, a0, 1\n"
+        "andi a0, a0, " UART_STR(UART_RXQ_SIZE - 1) "\n"
+        "sw a0, -12(tp)\n"
+        "j 4f\n"
+        "3:\n"
+        "lw a0, -4(tp)\n"
+        "addi a0, a0, 1\n"
+        "sw a0, -4(tp)\n"
+        "4:\n"
+        "lw a2, -24(tp)\n"
+        "lw a1, -28(tp)\n"
+        "lw a0, -32(tp)\n"
+        "mret\n"
+        "8:\n"                          // not ours
+        "lw a1, -28(tp)\n"
+        "lw a0, -32(tp)\n"
+        "j _irq_handler\n"
+    );
+}
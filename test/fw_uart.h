@@ -0,0 +1,157 @@
+// ============================================================================
+// fw_uart.h — UART driver: IRQ18 RX ring, polled TX ring (fw_hal.h, fw_uart.c)
+// ============================================================================
+// TX and RX ring buffers in PSRAM:
+//
+//   RX  IRQ18 uart_rx_valid (level): the ISR moves UART_DATA into the RX ring
+//   TX  polled: uart_tx_poll() moves one TX ring byte to UART_DATA when the
+//       transmitter is idle (STATUS bit 0 clear). Call it from the main loop
+//       and/or a periodic tick; uart_write() also polls as it copies
+//
+// TX is not interrupt-driven and does not run at line rate. project.v has
+// no TX-ready interrupt (IRQ19 is tied off) and no holding register, and a
+// timer tick per frame (2170 clocks) is more than a C ISR with a PSRAM
+// stack can keep up with. Each frame therefore starts at the first
+// uart_tx_poll() after the previous stop bit: the gap between frames is up
+// to one polling interval. uart_tx_poll() runs with MIE cleared for its
+// few instructions, so main and an ISR may both call it.
+//
+// Every PSRAM access costs a QSPI transaction plus a fetch restart (~60
+// clocks), and an ISR that spills registers to a PSRAM stack costs about a
+// frame. _uart_irq_handler (fw_uart.c, link it with the firmware) is
+// therefore hand-written like the other ISRs: its scratch registers and the
+// ring indices live in latch_mem (no QSPI), the RX ring sits at
+// gp + UART_TXQ_SIZE so it is one `add` + `sb` away, and the only PSRAM
+// access is the data byte. The driver uses all 32 bytes of latch_mem,
+// one word each, so a firmware linking it must not use latch_mem itself:
+//
+//   0x07FFFFE0..E3  tp-32  a0 save (ISR)
+//   0x07FFFFE4..E7  tp-28  a1 save (ISR)
+//   0x07FFFFE8..EB  tp-24  a2 save (ISR)
+//   0x07FFFFEC..EF  tp-20  tx_head      UART_LMEM[3]
+//   0x07FFFFF0..F3  tp-16  tx_tail      UART_LMEM[4]
+//   0x07FFFFF4..F7  tp-12  rx_head      UART_LMEM[5]
+//   0x07FFFFF8..FB  tp-8   rx_tail      UART_LMEM[6]
+//   0x07FFFFFC..FF  tp-4   rx_overrun   UART_LMEM[7]
+//
+// The firmware points the interrupt vector at _uart_irq_handler; any other
+// cause is passed on with all registers intact to the firmware's own
+// _irq_handler, which returns with mret as usual.
+//
+//   uart_init()           reset rings, enable IRQ18 (caller sets mstatus.MIE)
+//   uart_write(p, n)      queue up to n bytes, never blocks; returns queued
+//   uart_tx_poll()        start the next queued byte if the line is idle;
+//                         returns 1 when it wrote one
+//   uart_tx_pending()     bytes still in the TX ring (not counting the shifter)
+//   uart_read(p, n)       take up to n received bytes, never blocks
+//   uart_flush()          poll until the TX ring and the shifter are empty
+//   uart_wdt_hook(m)      flush if the armed WDT has < m µs left; call it from
+//                         a periodic tick so a log tail survives a WDT reset
+// ============================================================================
+
+#ifndef FW_UART_H
+#define FW_UART_H
+
+#include "fw_hal.h"
+
+#define UART_TXQ_SIZE   256             // power of two, at gp (no suffix: used in asm)
+#define UART_RXQ_SIZE   256             // power of two, at gp + UART_TXQ_SIZE
+#define UART_TXQ        ((volatile unsigned char *)HAL_GP_BASE)
+#define UART_RXQ        ((volatile unsigned char *)(HAL_GP_BASE + UART_TXQ_SIZE))
+
+#define UART_LMEM       ((volatile unsigned int *)0x07FFFFE0u)     // tp - 32
+#define UART_TX_HEAD    UART_LMEM[3]
+#define UART_TX_TAIL    UART_LMEM[4]
+#define UART_RX_HEAD    UART_LMEM[5]
+#define UART_RX_TAIL    UART_LMEM[6]
+#define UART_RX_OVERRUN UART_LMEM[7]
+
+#define UART_MIE_RX     (1u << 18)
+#define UART_BYTE_US    87u             // 10 bits at 115200 baud
+
+// IRQ18 entry (fw_uart.c): the firmware's interrupt vector jumps here
+void _uart_irq_handler(void);
+
+static inline void uart_init(void) {
+    UART_TX_HEAD = UART_TX_TAIL = 0;
+    UART_RX_HEAD = UART_RX_TAIL = 0;
+    UART_RX_OVERRUN = 0;
+    __asm__ volatile ("csrs 0x304, %0" : : "r"(UART_MIE_RX));
+}
+
+static inline unsigned int uart_tx_pending(void) {
+    return (UART_TX_HEAD - UART_TX_TAIL) & (UART_TXQ_SIZE - 1);
+}
+
+static inline unsigned int uart_tx_free(void) {
+    return UART_TXQ_SIZE - 1 - uart_tx_pending();
+}
+
+// Start the next queued byte if the transmitter is idle. MIE is cleared
+// around the tail update so main and an ISR can both pump the ring.
+static int uart_tx_poll(void) {
+    unsigned int mstatus, tail, sent = 0;
+    __asm__ volatile ("csrrci %0, mstatus, 8" : "=r"(mstatus));
+    tail = UART_TX_TAIL;
+    if (tail != UART_TX_HEAD && !(UART_STATUS & UART_TX_BUSY)) {
+        UART_DATA = UART_TXQ[tail];
+        UART_TX_TAIL = (tail + 1) & (UART_TXQ_SIZE - 1);
+        sent = 1;
+    }
+    __asm__ volatile ("csrs mstatus, %0" : : "r"(mstatus & 8));
+    return sent;
+}
+
+// Queue up to n bytes; returns how many fit. Never waits for the line.
+// Each byte is published and the line polled as it is copied, so the
+// first frame starts at once and the line keeps running through the PSRAM
+// copy; the rest goes out from the caller's uart_tx_poll().
+static unsigned int uart_write(const void *p, unsigned int n) {
+    const unsigned char *s = (const unsigned char *)p;
+    unsigned int head = UART_TX_HEAD;
+    unsigned int room = (UART_TX_TAIL - head - 1) & (UART_TXQ_SIZE - 1);
+    if (n > room) n = room;
+    for (unsigned int i = 0; i < n; i++) {
+        UART_TXQ[head] = s[i];
+        head = (head + 1) & (UART_TXQ_SIZE - 1);
+        UART_TX_HEAD = head;
+        uart_tx_poll();
+    }
+    return n;
+}
+
+static inline unsigned int uart_rx_count(void) {
+    return (UART_RX_HEAD - UART_RX_TAIL) & (UART_RXQ_SIZE - 1);
+}
+
+// Take up to n received bytes; returns how many were copied.
+static unsigned int uart_read(void *p, unsigned int n) {
+    unsigned char *s = (unsigned char *)p;
+    unsigned int tail = UART_RX_TAIL, head = UART_RX_HEAD, i = 0;
+    while (i < n && tail != head) {
+        s[i++] = UART_RXQ[tail];
+        tail = (tail + 1) & (UART_RXQ_SIZE - 1);
+    }
+    UART_RX_TAIL = tail;
+    return i;
+}
+
+// Send everything queued and wait until the last frame has left the
+// shifter. Safe from an ISR; RX keeps running when MIE is set.
+static void uart_flush(void) {
+    while (uart_tx_pending())
+        uart_tx_poll();
+    while (UART_STATUS & UART_TX_BUSY);
+}
+
+// Watchdog warning: the WDT has no early interrupt, so a periodic tick
+// asks how long is left. Returns 1 when it flushed. A disabled WDT reads 0.
+static inline int uart_wdt_hook(unsigned int margin_us) {
+    unsigned int left = hal_wdt_remaining();
+    if (left == 0 || left >= margin_us || uart_tx_pending() == 0)
+        return 0;
+    uart_flush();
+    return 1;
+}
+
+#endif // FW_UART_H
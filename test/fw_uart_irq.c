@@ -0,0 +1,186 @@
+// ============================================================================
+// Test: UART driver — RX ring on IRQ18, polled TX ring (fw_uart.h)
+// ============================================================================
+// Target: LoRa Edge SoC (TinyQV RV32EC @ 25MHz)
+// Needs uart_rxd looped back to uart_txd (iss --uart-loopback).
+// TX is polled (fw_uart.h: no TX-ready source), so this does not show line
+// rate: each frame may start up to one main-loop step after the previous
+// stop bit. What it checks is that main keeps working while the block goes
+// out and that the gaps stay within that bound.
+//
+// Tests:
+//   U1: uart_write() of a 64-byte block returns while most of it is still
+//       queued; main then runs a software CRC and calls uart_tx_poll() once
+//       per step. The block is out within 64 * (2170 clocks + longest step)
+//       and main got work done
+//   U2: the 64 looped-back bytes arrive in the RX ring via IRQ18, in
+//       order, no overrun
+//   U3: a log tail is queued, then main hangs without polling TX; the
+//       periodic timer tick's uart_wdt_hook() sees the armed WDT run low
+//       and flushes the tail before the WDT reset. After the reboot the
+//       PSRAM record shows the flush happened.
+//
+// Build:
+//   riscv64-elf-gcc -march=rv32ec_zicsr -mabi=ilp32e -nostdlib -Os \
+//     -T fw_irq_timer.ld -o fw_uart_irq.elf fw_uart_irq.c fw_uart.c
+//   riscv64-elf-objcopy -O verilog fw_uart_irq.elf fw_uart_irq.hex
+//
+// Expected UART output: the 64-byte block, "U1U2", "WDT-TAIL:0123456789",
+// reboot, "U3DN"
+// ============================================================================
+
+#include "fw_uart.h"
+
+// PSRAM boot record (survives the WDT reset; stack is below 0x100,
+// the UART rings at 0x400)
+#define P_MAGIC         ((volatile unsigned int *)0x01000200)
+#define P_FLUSHED       ((volatile unsigned int *)0x01000204)   // bytes flushed by the hook
+#define P_TICK          ((volatile unsigned int *)0x01000208)   // timer ISR re-arms when set
+#define BOOT_MAGIC      0x0A17F1u
+
+#define BYTE_CLKS       2170u           // 10 bits * 217 clocks
+#define BLOCK           64u
+#define BLOCK_SHIFT     6               // BLOCK = 1 << BLOCK_SHIFT (no M extension)
+#define WDT_US          3000u
+#define WDT_MARGIN_US   2500u           // > tail length * UART_BYTE_US
+#define TICK_US         250u
+
+static const char tail_msg[] = "WDT-TAIL:0123456789";
+
+// ============================================================================
+// Vector table
+// ============================================================================
+void __attribute__((naked, section(".text._vectors"))) _vectors(void) {
+    __asm__ volatile (
+        ".option push\n"
+        ".option norvc\n"
+        "j _reset_handler\n"       // 0x0: reset
+        "j _trap_handler\n"        // 0x4: trap
+        "j _uart_irq_handler\n"    // 0x8: interrupt (UART RX, then _irq_handler)
+        ".option pop\n"
+    );
+}
+
+void __attribute__((naked)) _trap_handler(void) {
+    __asm__ volatile ("j _trap_handler\n");
+}
+
+// ============================================================================
+// IRQ handler for everything but IRQ18: the timer tick (WDT warning)
+// ============================================================================
+void __attribute__((interrupt)) _irq_handler(void) {
+    unsigned int cause;
+    __asm__ volatile ("csrr %0, mcause" : "=r"(cause));
+    if ((cause & 0x1F) == 17) {
+        unsigned int pending = uart_tx_pending();
+        if (uart_wdt_hook(WDT_MARGIN_US)) {
+            *P_FLUSHED = pending;
+            *P_TICK = 0;
+        }
+        __asm__ volatile ("csrc 0x344, %0" : : "r"(1u << 17));
+        TIMER_COUNTDOWN = *P_TICK ? TICK_US : 0;      // after the csrc: keep the next edge
+    }
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+static inline unsigned int rdcycle(void) {
+    unsigned int c;
+    __asm__ volatile ("csrr %0, 0xC00" : "=r"(c));
+    return c;
+}
+
+static void put_result(unsigned char test_num, int pass) {
+    unsigned char r[2] = { pass ? 'U' : 'F', test_num };
+    while (uart_write(r, 2) == 0);
+}
+
+static unsigned int crc16_sw(unsigned int crc, unsigned int b) {
+    crc ^= b & 0xFF;
+    for (int i = 0; i < 8; i++)
+        crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+    return crc;
+}
+
+// ============================================================================
+// Reset handler
+// ============================================================================
+void __attribute__((naked, noreturn)) _reset_handler(void) {
+    __asm__ volatile (
+        "li sp, 0x01000100\n"
+        "j main\n"
+    );
+}
+
+void __attribute__((noreturn)) main(void) {
+    unsigned int mstatus_mie = 8;
+
+    uart_init();
+    __asm__ volatile ("csrs 0x304, %0" : : "r"(1u << 17));
+    __asm__ volatile ("csrs mstatus, %0" : : "r"(mstatus_mie));
+
+    if (*P_MAGIC == BOOT_MAGIC) {
+        // ---- Boot 2: after the WDT reset ----
+        *P_MAGIC = 0;
+        put_result('3', *P_FLUSHED != 0);
+        uart_write("DN", 2);
+        uart_flush();
+        while (1);
+    }
+
+    // ================================================================
+    // U1: non-blocking 64-byte write, polled out while main computes
+    // ================================================================
+    unsigned char block[BLOCK];
+    unsigned char c = 'A';
+    for (unsigned int i = 0; i < BLOCK; i++) {
+        block[i] = c;
+        c = c == 'Z' ? 'A' : c + 1;
+    }
+
+    unsigned int t0 = rdcycle();
+    unsigned int n = uart_write(block, BLOCK);
+    unsigned int t_call = rdcycle() - t0;
+
+    unsigned int work = 0, crc = 0xFFFF, step_max = 0, t_step = rdcycle();
+    while (uart_tx_pending() || (UART_STATUS & UART_TX_BUSY)) {
+        uart_tx_poll();
+        crc = crc16_sw(crc, work);
+        work++;
+        unsigned int t = rdcycle();
+        if (t - t_step > step_max) step_max = t - t_step;
+        t_step = t;
+    }
+    unsigned int t_done = rdcycle() - t0;
+
+    // ================================================================
+    // U2: every byte came back through IRQ18
+    // ================================================================
+    unsigned char echo[BLOCK];
+    unsigned int got = 0;
+    for (unsigned int t = HAL_POLL_MAX; got < BLOCK && t > 0; t--)
+        got += uart_read(echo + got, BLOCK - got);
+    int rx_ok = got == BLOCK && UART_RX_OVERRUN == 0;
+    for (unsigned int i = 0; rx_ok && i < BLOCK; i++)
+        rx_ok = echo[i] == block[i];
+
+    put_result('1', n == BLOCK && t_call < BLOCK * BYTE_CLKS / 2 && work > BLOCK / 2 &&
+                    t_done <= BLOCK * BYTE_CLKS + (step_max << BLOCK_SHIFT) && crc != 0);
+    put_result('2', rx_ok);
+    uart_flush();
+
+    // ================================================================
+    // U3: main hangs with TX queued; the tick's WDT hook flushes the tail
+    // ================================================================
+    *P_MAGIC = BOOT_MAGIC;
+    *P_FLUSHED = 0;
+    *P_TICK = 1;
+    __asm__ volatile ("csrc mstatus, %0" : : "r"(mstatus_mie));
+    uart_write(tail_msg, sizeof(tail_msg) - 1);
+    hal_wdt_kick(WDT_US);
+    TIMER_COUNTDOWN = TICK_US;
+    __asm__ volatile ("csrs mstatus, %0" : : "r"(mstatus_mie));
+
+    while (1);      // hung, no uart_tx_poll(): only the WDT gets us out
+}
@@ -18,12 +18,7 @@
 // Expected UART output: "B1B2DN" (6 chars)
 // ============================================================================
 
-#define PERI_BASE       0x08000000u
-#define UART_DATA       (*(volatile unsigned int*)(PERI_BASE + 0x10))
-#define UART_STATUS     (*(volatile unsigned int*)(PERI_BASE + 0x14))
-#define WDT_KICK        (*(volatile unsigned int*)(PERI_BASE + 0x34))
-
-#define UART_TX_BUSY    (1u << 0)
+#include "fw_hal.h"
 
 // PSRAM address for boot detection magic
 #define PSRAM_MAGIC_ADDR  ((volatile unsigned int *)0x01000200)
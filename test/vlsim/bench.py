@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Wall time per cocotb test: Icarus (test_*.mk) vs the Verilator backend.
+
+Usage: bench.py [--seed N] [SUITE ...]      SUITE = basic | periph | periph_e2e
+
+For each suite, runs the cocotb makefile with SIM=icarus (per-test times
+from results.xml) and the vlsim Makefile target (build timed separately,
+per-test times from vlsim.py --results), with the same COCOTB_SEED, then
+prints one row per test and writes build/bench.json.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+import xml.etree.ElementTree as ET
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+TEST_DIR = os.path.dirname(HERE)
+BUILD = os.path.join(HERE, "build")
+
+MAKEFILES = {"basic": "test_basic.mk", "periph": "test_periph.mk", "periph_e2e": "test_periph_e2e.mk"}
+
+
+def run(cmd, cwd, env):
+    t0 = time.perf_counter()
+    r = subprocess.run(cmd, cwd=cwd, env=env, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    return r.returncode, time.perf_counter() - t0, r.stdout
+
+
+def icarus(suite, env):
+    results = os.path.join(TEST_DIR, "results.xml")
+    if os.path.exists(results):
+        os.remove(results)
+    rc, total, out = run(["make", "-B", "-f", MAKEFILES[suite], "SIM=icarus", "WAVES=0"], TEST_DIR, env)
+    tests = {}
+    if os.path.exists(results):
+        for tc in ET.parse(results).getroot().iter("testcase"):
+            failed = tc.find("failure") is not None or tc.find("error") is not None
+            skipped = tc.find("skipped") is not None
+            tests[tc.get("name")] = {"status": "SKIP" if skipped else "FAIL" if failed else "PASS",
+                                     "real_s": float(tc.get("time", 0))}
+    elif rc:
+        sys.stdout.write(out[-3000:])
+    run_s = sum(t["real_s"] for t in tests.values())
+    return {"total_s": total, "build_s": total - run_s, "tests": tests}
+
+
+def verilator(suite, env):
+    rc, build_s, out = run(["make", "build_" + suite], HERE, env)
+    if rc:
+        sys.stdout.write(out[-3000:])
+        return {"total_s": build_s, "build_s": build_s, "tests": {}}
+    res_path = os.path.join(BUILD, "results_%s.json" % suite)
+    if os.path.exists(res_path):
+        os.remove(res_path)
+    rc, run_s, out = run(["make", suite], HERE, env)
+    tests = {}
+    if os.path.exists(res_path):
+        with open(res_path) as fh:
+            for t in json.load(fh)["tests"]:
+                tests[t["name"]] = {"status": t["status"], "real_s": t["real_s"]}
+    elif rc:
+        sys.stdout.write(out[-3000:])
+    return {"total_s": build_s + run_s, "build_s": build_s, "tests": tests}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("suites", nargs="*", default=list(MAKEFILES))
+    ap.add_argument("--seed", type=int, default=1)
+    args = ap.parse_args()
+
+    env = dict(os.environ, COCOTB_SEED=str(args.seed), RANDOM_SEED=str(args.seed))
+    os.makedirs(BUILD, exist_ok=True)
+    report = {"seed": args.seed, "suites": {}}
+
+    for suite in args.suites:
+        print("=== %s ===" % suite, flush=True)
+        ic, vl = icarus(suite, env), verilator(suite, env)
+        report["suites"][suite] = {"icarus": ic, "verilator": vl}
+
+        print("%-40s %10s %10s %8s  %s" % ("TEST", "ICARUS s", "VERILATOR s", "SPEEDUP", "STATUS (I/V)"))
+        names = list(ic["tests"]) + [n for n in vl["tests"] if n not in ic["tests"]]
+        for n in names:
+            i, v = ic["tests"].get(n), vl["tests"].get(n)
+            si = "%.2f" % i["real_s"] if i else "-"
+            sv = "%.2f" % v["real_s"] if v else "-"
+            sp = "%.1fx" % (i["real_s"] / v["real_s"]) if i and v and v["real_s"] > 0 else "-"
+            st = "%s/%s" % (i["status"] if i else "-", v["status"] if v else "-")
+            print("%-40s %10s %10s %8s  %s" % (n, si, sv, sp, st))
+        ri = sum(t["real_s"] for t in ic["tests"].values())
+        rv = sum(t["real_s"] for t in vl["tests"].values())
+        print("%-40s %10.2f %10.2f %8s" % ("tests total", ri, rv, "%.1fx" % (ri / rv) if rv > 0 else "-"))
+        print("%-40s %10.2f %10.2f" % ("build / startup", ic["build_s"], vl["build_s"]))
+        print(flush=True)
+
+    with open(os.path.join(BUILD, "bench.json"), "w") as fh:
+        json.dump(report, fh, indent=2)
+    print("wrote %s" % os.path.join(BUILD, "bench.json"))
+
+
+if __name__ == "__main__":
+    main()
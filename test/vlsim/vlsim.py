@@ -0,0 +1,455 @@
+#!/usr/bin/env python3
+"""Run the cocotb test modules on a Verilated testbench, without a simulator.
+
+The test modules (test.py, test_peripherals.py, test_peripheral_e2e.py) are
+imported unchanged: a small cocotb-compatible layer (cocotb.test,
+start_soon, Clock, ClockCycles, Timer, RisingEdge, FallingEdge, ReadOnly,
+get_sim_time, dut.<signal>.value) is installed under the cocotb module
+names and scheduled on top of vlsim_model (vlsim_model.cpp). Clocks run
+inside the model and ClockCycles(clk, n) is a single C++ call, so long
+waits cost no Python at all.
+
+Usage (normally through test/vlsim/Makefile):
+  vlsim.py --top tb_periph --module test_peripherals [--testcase NAME ...]
+           [--results results_vlsim.json] [--seed N] [+plusarg ...]
+
+Differences from Icarus: the model is two-state (no X/Z, so nothing raises
+on unresolved values), and only signals made public in public.vlt can be
+accessed.
+"""
+
+import argparse
+import collections
+import heapq
+import importlib
+import json
+import logging
+import os
+import random
+import sys
+import time
+import traceback
+import types
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+TEST_DIR = os.path.dirname(HERE)
+
+_PS = {"fs": 1e-3, "ps": 1, "ns": 1e3, "us": 1e6, "ms": 1e9, "sec": 1e12, "s": 1e12, "step": 1}
+
+
+def _to_ps(value, unit):
+    return int(round(value * _PS[unit or "step"]))
+
+
+# ============================================================================
+# Handles and values
+# ============================================================================
+class LogicValue(int):
+    """Integer value of a signal, with the cocotb accessors the tests use."""
+
+    def __new__(cls, value, width):
+        v = super().__new__(cls, value)
+        v._width = width
+        return v
+
+    @property
+    def integer(self):
+        return int(self)
+
+    def to_unsigned(self):
+        return int(self)
+
+    @property
+    def binstr(self):
+        return format(int(self), "0%db" % self._width)
+
+    @property
+    def is_resolvable(self):
+        return True
+
+    def __len__(self):
+        return self._width
+
+
+class Handle:
+    """dut, dut.uo_out, dut.user_project.i_tinyqv.instr_addr, dut.flash.rom[3]."""
+
+    def __init__(self, sim, path):
+        self._sim = sim
+        self._path = path
+        self._id = None
+        self._children = {}
+
+    def __getattr__(self, name):
+        if name.startswith("_"):
+            raise AttributeError(name)
+        return self._child("%s.%s" % (self._path, name), name)
+
+    def __getitem__(self, index):
+        return self._child("%s[%d]" % (self._path, index), index)
+
+    def _child(self, path, key):
+        h = self._children.get(key)
+        if h is None:
+            h = self._children[key] = Handle(self._sim, path)
+        return h
+
+    def _handle_id(self):
+        if self._id is None:
+            self._id = self._sim.model.handle(self._path)
+        return self._id
+
+    @property
+    def value(self):
+        i = self._handle_id()
+        return LogicValue(self._sim.model.get(i), self._sim.model.width(i))
+
+    @value.setter
+    def value(self, v):
+        self._sim.model.set(self._handle_id(), int(v))
+
+    def setimmediatevalue(self, v):
+        self.value = v
+
+    def __len__(self):
+        return self._sim.model.width(self._handle_id())
+
+    def __repr__(self):
+        return "<Handle %s>" % self._path
+
+
+# ============================================================================
+# Triggers and tasks
+# ============================================================================
+class Trigger:
+    def __await__(self):
+        yield self
+        return self
+
+
+class Timer(Trigger):
+    def __init__(self, time=0, units="step", *, unit=None, round_mode=None):
+        self.ps = _to_ps(time, unit or units)
+
+
+class _Edge(Trigger):
+    def __init__(self, signal, edge, count=1):
+        self.signal, self.edge, self.count = signal, edge, count
+
+
+class RisingEdge(_Edge):
+    def __init__(self, signal):
+        super().__init__(signal, 1)
+
+
+class FallingEdge(_Edge):
+    def __init__(self, signal):
+        super().__init__(signal, 2)
+
+
+class Edge(_Edge):
+    def __init__(self, signal):
+        super().__init__(signal, 0)
+
+
+class ClockCycles(_Edge):
+    def __init__(self, signal, num_cycles, rising=True):
+        super().__init__(signal, 1 if rising else 2, num_cycles)
+
+
+class ReadOnly(Trigger):
+    pass
+
+
+class _Join(Trigger):
+    def __init__(self, task):
+        self.task = task
+
+
+class _Never(Trigger):
+    pass
+
+
+class Task:
+    def __init__(self, coro):
+        self._coro = coro
+        self.done_ = False
+        self._result = None
+        self._exc = None
+        self._joiners = []
+
+    def __await__(self):
+        if not self.done_:
+            yield _Join(self)
+        if self._exc is not None:
+            raise self._exc
+        return self._result
+
+    def done(self):
+        return self.done_
+
+    def result(self):
+        if self._exc is not None:
+            raise self._exc
+        return self._result
+
+    def kill(self):
+        if not self.done_:
+            self.done_ = True
+            self._coro.close()
+
+    cancel = kill
+
+
+class Clock:
+    def __init__(self, signal, period, units="step", *, unit=None, impl=None):
+        self.signal = signal
+        self.period = _to_ps(period, unit or units)
+
+    async def start(self, start_high=True, cycles=None):
+        model = self.signal._sim.model
+        cid = model.add_clock(self.signal._handle_id(), self.period, self.period // 2, start_high)
+        try:
+            await _Never()
+        finally:
+            model.stop_clock(cid)
+
+
+# ============================================================================
+# Scheduler
+# ============================================================================
+class Scheduler:
+    def __init__(self, model):
+        self.model = model
+        self.tasks = []
+        self.ready = collections.deque()
+        self.timers = []                # heap of (deadline, seq, task)
+        self.edges = []                 # [task, id, edge, remaining, last]
+        self.readonly = []
+        self.seq = 0
+        self.failure = None
+
+    def start_soon(self, coro):
+        if isinstance(coro, Task):
+            task = coro
+        else:
+            task = Task(coro)
+        self.tasks.append(task)
+        self.ready.append(task)
+        return task
+
+    def _finish(self, task, result=None, exc=None):
+        task.done_ = True
+        task._result, task._exc = result, exc
+        self.ready.extend(task._joiners)
+        task._joiners = []
+
+    def _step(self, task):
+        if task.done_:
+            return
+        try:
+            trig = task._coro.send(None)
+        except StopIteration as e:
+            self._finish(task, e.value)
+            return
+        except BaseException as e:          # noqa: B902 — assertion in any task fails the test
+            self._finish(task, exc=e)
+            if self.failure is None:
+                self.failure = e
+            return
+        self._wait(task, trig)
+
+    def _wait(self, task, trig):
+        if isinstance(trig, Timer):
+            self.seq += 1
+            heapq.heappush(self.timers, (self.model.time + trig.ps, self.seq, task))
+        elif isinstance(trig, _Edge):
+            sid = trig.signal._handle_id()
+            self.edges.append([task, sid, trig.edge, trig.count, self.model.get(sid)])
+        elif isinstance(trig, ReadOnly):
+            self.readonly.append(task)
+        elif isinstance(trig, _Join):
+            if trig.task.done_:
+                self.ready.append(task)
+            else:
+                trig.task._joiners.append(task)
+        elif isinstance(trig, _Never):
+            pass
+        else:
+            raise TypeError("vlsim: unsupported trigger %r" % (trig,))
+
+    def run(self, coro):
+        main = self.start_soon(coro)
+        try:
+            while not main.done_ and self.failure is None:
+                while self.ready and self.failure is None:
+                    self._step(self.ready.popleft())
+                if main.done_ or self.failure is not None:
+                    break
+                if self.readonly:
+                    self.model.settle()
+                    self.ready.extend(self.readonly)
+                    self.readonly = []
+                    continue
+                if not self.timers and not self.edges:
+                    raise RuntimeError("vlsim: test is waiting on nothing")
+
+                t_end = self.timers[0][0] if self.timers else (1 << 63)
+                watches = [(e[1], e[2], e[3], e[4]) for e in self.edges]
+                now, res = self.model.advance(t_end, watches)
+                waiting = []
+                for e, (_, _, remaining, last) in zip(self.edges, res):
+                    e[3], e[4] = remaining, last
+                    if remaining == 0:
+                        self.ready.append(e[0])
+                    else:
+                        waiting.append(e)
+                self.edges = waiting
+                while self.timers and self.timers[0][0] <= now:
+                    self.ready.append(heapq.heappop(self.timers)[2])
+        finally:
+            for t in self.tasks:
+                t.kill()
+            self.tasks, self.timers, self.edges, self.readonly = [], [], [], []
+            self.ready.clear()
+        failure, self.failure = self.failure, None
+        if failure is not None:
+            raise failure
+        return main.result()
+
+
+# ============================================================================
+# cocotb shim
+# ============================================================================
+_tests = []
+_sched = None
+_model = None
+
+
+def _test(_func=None, *, expect_fail=False, expect_error=(), skip=False, timeout_time=None,
+          timeout_unit="step", stage=0, **_kw):
+    def wrap(f):
+        f._vlsim = {"expect_fail": expect_fail, "expect_error": expect_error, "skip": skip}
+        _tests.append(f)
+        return f
+    return wrap(_func) if _func is not None else wrap
+
+
+def _start_soon(coro):
+    return _sched.start_soon(coro)
+
+
+async def _start(coro):
+    return _sched.start_soon(coro)
+
+
+def _get_sim_time(units="step", unit=None):
+    t = _model.time / _PS[unit or units]
+    return t if (unit or units) != "step" else int(t)
+
+
+def install_shim():
+    cocotb = types.ModuleType("cocotb")
+    cocotb.test = _test
+    cocotb.start_soon = _start_soon
+    cocotb.start = _start
+    cocotb.log = logging.getLogger("cocotb")
+    cocotb.__version__ = "vlsim"
+
+    mods = {
+        "clock": {"Clock": Clock},
+        "triggers": {"Timer": Timer, "ClockCycles": ClockCycles, "RisingEdge": RisingEdge,
+                     "FallingEdge": FallingEdge, "Edge": Edge, "ReadOnly": ReadOnly, "Trigger": Trigger},
+        "utils": {"get_sim_time": _get_sim_time},
+        "handle": {"SimHandleBase": Handle},
+        "types": {"LogicArray": LogicValue},
+        "task": {"Task": Task},
+    }
+    sys.modules["cocotb"] = cocotb
+    for name, attrs in mods.items():
+        m = types.ModuleType("cocotb." + name)
+        m.__dict__.update(attrs)
+        setattr(cocotb, name, m)
+        sys.modules["cocotb." + name] = m
+
+
+# ============================================================================
+# Runner
+# ============================================================================
+def main():
+    global _sched, _model
+
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("--top", required=True, help="toplevel module (tb, tb_periph, tb_e2e)")
+    ap.add_argument("--module", required=True, help="cocotb test module in test/")
+    ap.add_argument("--testcase", action="append", default=[], help="run only these tests")
+    ap.add_argument("--build", default=os.path.join(HERE, "build"), help="Makefile build dir")
+    ap.add_argument("--results", help="write per-test results JSON here")
+    ap.add_argument("--seed", type=int, default=int(time.time()))
+    args, plusargs = ap.parse_known_args()
+
+    logging.basicConfig(level=logging.INFO, format="%(asctime)s %(levelname)-7s %(name)s  %(message)s",
+                        datefmt="%H:%M:%S")
+    random.seed(args.seed)
+    os.environ.setdefault("COCOTB_SEED", str(args.seed))
+
+    sys.path.insert(0, os.path.join(args.build, args.top))
+    import vlsim_model                      # noqa: E402 — built by the Makefile
+
+    install_shim()
+    sys.path.insert(0, TEST_DIR)
+    os.chdir(TEST_DIR)                      # $readmemh paths are relative to test/
+    t0 = time.perf_counter()
+    _model = vlsim_model.Model(plusargs)
+    _sched = Scheduler(_model)
+    build_s = time.perf_counter() - t0
+    importlib.import_module(args.module)
+
+    dut = Handle(_sched, args.top)
+    dut._log = logging.getLogger("cocotb." + args.top)
+
+    results = []
+    for f in _tests:
+        name = f.__name__
+        if args.testcase and name not in args.testcase:
+            continue
+        opts = f._vlsim
+        if opts["skip"]:
+            results.append({"name": name, "status": "SKIP", "sim_ns": 0, "real_s": 0})
+            continue
+        dut._log.info("running %s", name)
+        t_sim, t_real = _model.time, time.perf_counter()
+        err = None
+        try:
+            _sched.run(f(dut))
+        except BaseException as e:          # noqa: B902
+            if isinstance(e, KeyboardInterrupt):
+                raise
+            err = e
+        failed = err is not None
+        ok = failed == bool(opts["expect_fail"])
+        real_s = time.perf_counter() - t_real
+        sim_ns = (_model.time - t_sim) / 1e3
+        if failed and not ok:
+            dut._log.error("%s failed:\n%s", name, "".join(traceback.format_exception(type(err), err, err.__traceback__)))
+        status = "PASS" if ok else "FAIL"
+        dut._log.info("%s %s (%.0f ns sim, %.2f s real)", name, status, sim_ns, real_s)
+        results.append({"name": name, "status": status, "sim_ns": sim_ns, "real_s": real_s})
+
+    print()
+    print("%-40s %6s %14s %10s" % ("TEST", "STATUS", "SIM TIME (ns)", "REAL (s)"))
+    for r in results:
+        print("%-40s %6s %14.0f %10.2f" % (r["name"], r["status"], r["sim_ns"], r["real_s"]))
+    npass = sum(r["status"] == "PASS" for r in results)
+    nfail = sum(r["status"] == "FAIL" for r in results)
+    print("TESTS=%d PASS=%d FAIL=%d SKIP=%d" % (len(results), npass, nfail, len(results) - npass - nfail))
+
+    if args.results:
+        with open(args.results, "w") as fh:
+            json.dump({"backend": "verilator", "top": args.top, "module": args.module,
+                       "seed": args.seed, "init_s": build_s, "tests": results}, fh, indent=2)
+    return 1 if nfail else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,230 @@
+// vlsim_model.cpp — pybind11 wrapper around a Verilated cocotb testbench
+//
+// Built once per testbench (tb, tb_periph, tb_e2e) by test/vlsim/Makefile
+// with -DVLSIM_TOP=V<toplevel>; vlsim.py drives it with the unchanged
+// cocotb test modules.
+//
+//   Model(plusargs)           construct, evaluate initial blocks
+//   handle(name) -> id        VPI lookup, "tb.user_project.i_tinyqv.x" or
+//                             "tb.flash.rom[12]" (memory word)
+//   get(id) / set(id, value)  up to 64 bits
+//   add_clock / stop_clock    free-running clocks, toggled in C++
+//   advance(t_end, watches)   run until t_end (ps) or until an edge watch
+//                             has seen its last edge
+//   settle()                  finish the current time step (ReadOnly)
+//
+// Edge semantics follow cocotb on Icarus: a task woken by an edge of a
+// clock registered with add_clock sees the values from before that edge,
+// and its writes take effect after the flops have sampled. advance() stops
+// with the new clock level written but not evaluated; writes made while
+// stopped there are staged and applied after the edge is evaluated.
+// Edges of any other signal are reported after evaluation.
+
+#include "verilated.h"
+#include "verilated_vpi.h"
+
+#define VLSIM_STR2(x) #x
+#define VLSIM_STR(x) VLSIM_STR2(x)
+#include VLSIM_STR(VLSIM_TOP.h)
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace py = pybind11;
+
+// (signal id, edge: 0 any / 1 rising / 2 falling, edges still to wait for,
+//  last sampled value)
+using Watch = std::tuple<int, int, uint64_t, uint64_t>;
+
+class Model {
+public:
+    explicit Model(const std::vector<std::string> &plusargs) {
+        ctx_ = std::make_unique<VerilatedContext>();
+        std::vector<const char *> argv{"vlsim"};
+        for (const std::string &a : plusargs) argv.push_back(a.c_str());
+        ctx_->commandArgs((int)argv.size(), argv.data());
+        top_ = std::make_unique<VLSIM_TOP>(ctx_.get());
+        top_->eval();
+    }
+
+    ~Model() { top_->final(); }
+
+    int handle(const std::string &name) {
+        auto it = ids_.find(name);
+        if (it != ids_.end()) return it->second;
+
+        vpiHandle h = nullptr;
+        if (!name.empty() && name.back() == ']') {
+            size_t lb = name.rfind('[');
+            int base = handle(name.substr(0, lb));
+            h = vpi_handle_by_index(sigs_[base].h, std::stoi(name.substr(lb + 1)));
+        } else {
+            h = vpi_handle_by_name((PLI_BYTE8 *)name.c_str(), nullptr);
+            if (!h) h = vpi_handle_by_name((PLI_BYTE8 *)("TOP." + name).c_str(), nullptr);
+        }
+        if (!h) throw py::key_error("no public signal " + name + " (see test/vlsim/public.vlt)");
+
+        Signal s{h, vpi_get(vpiSize, h), false};
+        if (s.width > 64) throw py::value_error(name + " is wider than 64 bits");
+        sigs_.push_back(s);
+        ids_[name] = (int)sigs_.size() - 1;
+        return (int)sigs_.size() - 1;
+    }
+
+    int width(int id) const { return sig(id).width; }
+
+    uint64_t get(int id) const {
+        s_vpi_value v;
+        v.format = vpiVectorVal;
+        vpi_get_value(sig(id).h, &v);
+        uint64_t r = (uint32_t)v.value.vector[0].aval;
+        if (sig(id).width > 32) r |= (uint64_t)(uint32_t)v.value.vector[1].aval << 32;
+        return r;
+    }
+
+    void set(int id, uint64_t value) {
+        if (pending_edge_) staged_.push_back({id, value});
+        else put(id, value);
+    }
+
+    int add_clock(int id, uint64_t period_ps, uint64_t high_ps, bool start_high) {
+        if (high_ps == 0 || high_ps >= period_ps) throw py::value_error("bad clock period");
+        set(id, start_high);
+        clocks_.push_back({id, period_ps, high_ps, start_high, now() + (start_high ? high_ps : period_ps - high_ps), true});
+        sigs_[id].is_clock = true;
+        return (int)clocks_.size() - 1;
+    }
+
+    void stop_clock(int c) {
+        clocks_.at(c).running = false;
+        int id = clocks_[c].id;
+        bool any = false;
+        for (const Clock &k : clocks_) any |= k.running && k.id == id;
+        sigs_[id].is_clock = any;
+    }
+
+    uint64_t now() const { return ctx_->time(); }
+
+    void settle() {
+        if (pending_edge_) {
+            top_->eval();
+            pending_edge_ = false;
+            for (auto &w : staged_) put(w.first, w.second);
+            staged_.clear();
+        }
+        top_->eval();
+        if (ctx_->gotFinish()) throw std::runtime_error("$finish called");
+    }
+
+    std::pair<uint64_t, std::vector<Watch>> advance(uint64_t t_end, std::vector<Watch> watches) {
+        settle();
+        if (check(watches, false, true) || t_end <= now()) return {now(), watches};
+
+        while (true) {
+            uint64_t next = t_end;
+            for (const Clock &c : clocks_)
+                if (c.running && c.next < next) next = c.next;
+            bool events = top_->eventsPending();
+            if (events && top_->nextTimeSlot() < next) next = top_->nextTimeSlot();
+            ctx_->time(next);
+
+            // Verilog delays first, so `always #20 clk = ~clk` and a
+            // Clock on the same signal agree instead of cancelling
+            if (events && top_->nextTimeSlot() <= next) top_->eval();
+
+            bool toggled = false;
+            for (Clock &c : clocks_) {
+                if (!c.running || c.next != next) continue;
+                c.high = !c.high;
+                put(c.id, c.high);
+                c.next += c.high ? c.high_ps : c.period_ps - c.high_ps;
+                toggled = true;
+            }
+            if (toggled) {
+                if (check(watches, true, false)) {
+                    pending_edge_ = true;
+                    return {now(), watches};
+                }
+                top_->eval();
+            }
+            if (ctx_->gotFinish()) throw std::runtime_error("$finish called");
+            if (check(watches, false, false) || next >= t_end) return {now(), watches};
+        }
+    }
+
+private:
+    struct Signal {
+        vpiHandle h;
+        int width;
+        bool is_clock;
+    };
+    struct Clock {
+        int id;
+        uint64_t period_ps, high_ps;
+        bool high;
+        uint64_t next;
+        bool running;
+    };
+
+    const Signal &sig(int id) const {
+        if (id < 0 || id >= (int)sigs_.size()) throw py::index_error("bad signal id");
+        return sigs_[id];
+    }
+
+    void put(int id, uint64_t value) {
+        s_vpi_vecval vec[2] = {{(PLI_INT32)(uint32_t)value, 0}, {(PLI_INT32)(uint32_t)(value >> 32), 0}};
+        s_vpi_value v;
+        v.format = vpiVectorVal;
+        v.value.vector = vec;
+        vpi_put_value(sig(id).h, &v, nullptr, vpiNoDelay);
+    }
+
+    // Samples the watches (clock signals only, or all others; `all` = both)
+    // and counts edges. True if any watch reached zero.
+    bool check(std::vector<Watch> &watches, bool clocks, bool all) {
+        bool fired = false;
+        for (Watch &w : watches) {
+            int id = std::get<0>(w);
+            if (!all && sigs_[id].is_clock != clocks) continue;
+            uint64_t v = get(id), last = std::get<3>(w);
+            if (v == last) continue;
+            std::get<3>(w) = v;
+            int edge = std::get<1>(w);
+            bool hit = edge == 0 || (edge == 1 && !(last & 1) && (v & 1)) ||
+                       (edge == 2 && (last & 1) && !(v & 1));
+            if (hit && std::get<2>(w) > 0 && --std::get<2>(w) == 0) fired = true;
+        }
+        return fired;
+    }
+
+    std::unique_ptr<VerilatedContext> ctx_;
+    std::unique_ptr<VLSIM_TOP> top_;
+    std::vector<Signal> sigs_;
+    std::unordered_map<std::string, int> ids_;
+    std::vector<Clock> clocks_;
+    bool pending_edge_ = false;
+    std::vector<std::pair<int, uint64_t>> staged_;
+};
+
+PYBIND11_MODULE(vlsim_model, m) {
+    m.doc() = "Verilated " VLSIM_STR(VLSIM_TOP) " for test/vlsim/vlsim.py";
+    py::class_<Model>(m, "Model")
+        .def(py::init<const std::vector<std::string> &>(), py::arg("plusargs") = std::vector<std::string>{})
+        .def("handle", &Model::handle)
+        .def("width", &Model::width)
+        .def("get", &Model::get)
+        .def("set", &Model::set)
+        .def("add_clock", &Model::add_clock)
+        .def("stop_clock", &Model::stop_clock)
+        .def("advance", &Model::advance)
+        .def("settle", &Model::settle)
+        .def_property_readonly("time", &Model::now);
+}
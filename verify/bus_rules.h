@@ -0,0 +1,152 @@
+// bus_rules.h — Runtime checker for project.v RULE A / RULE B
+//
+// tinyQV reads MMIO bit-serially: read_n stays != 2'b11 while data_from_read
+// is shifted in, and read_complete pulses once at the end. project.v requires
+//   RULE A  read side effects (pop, clear) happen on read_complete only
+//   RULE B  the slot's data_from_read holds still until read_complete
+// A side effect on read_n shows up as RULE B: the consumed bits change in
+// the middle of the read. Feed sample() the project.v taps once per clock
+// (after the rising edge); it opens a transaction on the first read_n cycle,
+// compares every following read_n cycle with the first value and closes on
+// read_complete.
+//
+// Each slot has a mask of bits that must hold. Registers that only change
+// on a CPU write (and the RULE A slots: UART, I2C_DATA, SEAL_DATA) are
+// fully checked; free-running status (GPIO_IN, timers, busy flags) may
+// legitimately move, so those changes are only counted ("live" column).
+// I2C_DATA mixes both: rx data + RX_VALID are checked while RX_VALID was
+// set at the start of the read, BUSY/NACK/TX_PENDING are live. GPIO_OUT
+// reads uo_out: only the bits gpio_out_sel hands to software (plus the
+// constant RESET/LED defaults, bits 1 and 7) are checked, the rest are the
+// UART/I2C/SPI pins. Feed write() the same taps so gpio_out_sel is known.
+//
+// Used by cosim_tb.cpp and cov_project_tb.cpp; a violation fails the run.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+class BusRuleMonitor {
+public:
+    static const uint8_t PERI_NONE = 0x1F;          // latch_mem / unmapped
+    static const int     MAX_REPORT = 8;
+
+    struct SlotStats {
+        uint64_t reads = 0;
+        uint64_t live_changes = 0;                  // masked-out bits moved
+        uint64_t violations = 0;
+    };
+    SlotStats slots[32];
+    uint64_t  violations = 0;
+    uint64_t  unterminated = 0;                     // read_n dropped, no read_complete
+
+    // Bits that must not change during a read of `slot`, given the value
+    // at the start of the read and project.v's gpio_out_sel
+    static uint32_t stable_mask(uint8_t slot, uint32_t first, uint8_t gpio_out_sel) {
+        switch (slot) {
+        case 0x0: return gpio_out_sel | 0x82u;      // GPIO_OUT (project.v uo_out mux)
+        case 0x3: return 0xFF;                      // GPIO_OUT_SEL
+        case 0x4: return 0xFF;                      // UART rx data (consumed)
+        case 0x6: return (first & (1u << 10)) ? 0x4FF : 0;  // I2C rx data + RX_VALID
+        case 0x7: return 0xFFFFFFFF;                // I2C_CONFIG
+        case 0xB: return 0xFFFFFFFF;                // SEAL_DATA (read serialization)
+        case 0xF: return 0xFFFF;                    // SYSINFO id/version (pps_count live)
+        case PERI_NONE: return 0xFFFFFFFF;          // latch_mem
+        default:  return 0;                         // live status / counters
+        }
+    }
+
+    static const char *slot_name(uint8_t slot) {
+        static const char *const names[16] = {
+            "GPIO_OUT", "GPIO_IN", "CRC16", "GPIO_OUT_SEL", "UART", "UART_STATUS",
+            "I2C_DATA", "I2C_CONFIG", "SPI", "SPI_STATUS", "RTC", "SEAL_DATA",
+            "TIMER", "WDT", "SEAL_CTRL", "SYSINFO"};
+        if (slot < 16) return names[slot];
+        return slot == PERI_NONE ? "latch_mem" : "unmapped";
+    }
+
+    void sample(uint64_t cycle, uint8_t read_n, bool read_complete, uint8_t slot, uint32_t data) {
+        if (read_n != 3) {
+            uint32_t width = read_n == 0 ? 0xFF : read_n == 1 ? 0xFFFF : 0xFFFFFFFF;
+            if (!open || reading_dropped) {
+                if (open) unterminated++;
+                begin(cycle, slot, data, width);
+            } else if (slot != cur_slot) {
+                flag(cycle, "slot changed mid-read", data, ~0u);
+                begin(cycle, slot, data, width);
+            } else {
+                compare(cycle, data);
+            }
+        } else if (open) {
+            reading_dropped = true;         // address may move on: stop comparing
+        }
+        if (read_complete && open) open = false;
+    }
+
+    // project.v write port, once per clock: tracks gpio_out_sel
+    void write(uint8_t write_n, uint8_t slot, uint32_t data) {
+        if (write_n != 3 && slot == 0x3) gpio_out_sel = (uint8_t)data;
+    }
+
+    // Core reset: drop an open transaction (gpio_out_sel resets with it)
+    void reset() {
+        open = false;
+        gpio_out_sel = 0;
+    }
+
+    // Summary of slots that were read; returns true when no rule was broken
+    bool report() const {
+        printf("[BUS] RULE A/B monitor: %-12s %10s %8s %6s\n", "slot", "reads", "live", "viol");
+        for (int s = 0; s < 32; s++) {
+            const SlotStats &st = slots[s];
+            if (!st.reads) continue;
+            printf("[BUS]                   %-12s %10llu %8llu %6llu\n", slot_name((uint8_t)s),
+                    (unsigned long long)st.reads, (unsigned long long)st.live_changes,
+                    (unsigned long long)st.violations);
+        }
+        if (unterminated)
+            printf("[BUS] %llu reads ended without read_complete\n", (unsigned long long)unterminated);
+        return violations == 0;
+    }
+
+private:
+    bool     open = false, reading_dropped = false;
+    uint8_t  cur_slot = 0;
+    uint8_t  gpio_out_sel = 0;
+    uint32_t first = 0, width = 0, mask = 0;
+    uint64_t start = 0;
+    bool     live_seen = false, bad_seen = false;
+
+    void begin(uint64_t cycle, uint8_t slot, uint32_t data, uint32_t w) {
+        open = true;
+        reading_dropped = false;
+        cur_slot = slot;
+        first = data;
+        width = w;
+        mask = stable_mask(slot, data, gpio_out_sel) & w;
+        start = cycle;
+        live_seen = bad_seen = false;
+        slots[slot & 31].reads++;
+    }
+
+    void compare(uint64_t cycle, uint32_t data) {
+        uint32_t diff = (data ^ first) & width;
+        if (!diff) return;
+        if (diff & mask) {
+            if (!bad_seen) flag(cycle, "read data changed mid-read", data, diff & mask);
+            bad_seen = true;
+        } else if (!live_seen) {
+            slots[cur_slot & 31].live_changes++;
+            live_seen = true;
+        }
+    }
+
+    void flag(uint64_t cycle, const char *what, uint32_t data, uint32_t bits) {
+        slots[cur_slot & 31].violations++;
+        if (violations++ < MAX_REPORT)
+            printf("[BUS] cycle %llu: %s: %s %08x -> %08x (bits %08x, read began cycle %llu)\n",
+                   (unsigned long long)cycle, slot_name(cur_slot), what, first, data, bits,
+                   (unsigned long long)start);
+    }
+};
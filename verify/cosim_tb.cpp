@@ -0,0 +1,755 @@
+// cosim_tb.cpp — Lockstep RTL-vs-ISS co-simulation for the full LoRa Edge SoC
+//
+// Boots a firmware image on the Verilated SoC (cosim_wrap.v) and replays
+// every retired instruction on the Rv32Core ISS (verify/iss/). Compared:
+//   - register writes: tinyQV shifts the written value out on debug_rd, one
+//     nibble per clock (LSB first) while debug_reg_wen is high; each 32-bit
+//     value is checked against the ISS's rd write in program order
+//   - data-bus transactions to MMIO (0x8000000) and latch_mem (0x4000000):
+//     address, size and write data; latch_mem read data
+//
+// MMIO read data is taken from the RTL (the ISS core runs against the real
+// peripherals), so polling loops stay in step. Interrupt lines are sampled
+// from project.v's interrupt_req at each debug_instr_complete. Before it
+// replays instruction k the ISS sees the lines sampled when k-1 completed
+// (the boundary tinyQV checks), never k's own sample, so it cannot enter a
+// handler one instruction before the RTL does.
+//
+// --hex loads the image into the ISS and, through +flash_hex=, into the
+// flash model, so one build boots any image whatever HEX_FILE it was built
+// with.
+//
+// On the first mismatch the ISS state, the last retired instructions and the
+// last RTL bus transactions are dumped and the run fails.
+//
+// --timing-trace FILE records the RTL cycles of every retired instruction;
+// verify/iss/calib compares them per function against the QSPI timing model.
+//
+// Every MMIO read is also checked against project.v RULE A/B (bus_rules.h):
+// read data of a slot must not change between read_n and read_complete.
+//
+// --mmio-profile FILE writes per-slot MMIO reads/writes/bus cycles, polling
+// spins and QSPI flash/PSRAM cycles of the image as JSON (mmio_profile.h)
+// and prints the table.
+//
+// --irq-latency FILE measures, for every IRQ16/17/18 source edge (ui_in[0],
+// timer_irq, uart_rx_valid), the cycles to handler entry (the vector
+// instruction retires) and to the handler's first MMIO access; prints
+// histograms (--irq-bin N cycles per bucket) and writes the samples as CSV
+// (irq_latency.h). Background load for the measurement: --dio1-pulse N
+// raises DIO1 for 16 cycles every N/2..3N/2 cycles (--seed), --uart-rx-period
+// N sends one byte every N cycles into ui_in[7].
+//
+// --uart-loopback drives ui_in[7] from uo_out[0] (uart_txd), as the ISS
+// option of the same name does for fw_uart_irq.
+//
+// --toggle-dat FILE writes Verilator toggle counts (build with
+// --coverage-toggle) for the whole run or for --toggle-window A:B cycles;
+// scripts/toggle_energy.py turns them into per-instance activity/energy.
+//
+// UART output is collected by UartSink (uart_sink.h), the last 1 MiB kept;
+// --uart-file FILE also streams every byte to FILE. The --expect signature
+// is matched as bytes arrive.
+//
+// --sx1268 puts the verify/iss SX1268 model on the radio pins through
+// Sx1268Pins (sampled once per clock), with a loopback gateway that ACKs
+// fw_lora_node uplinks --sx1268-ack-ms after they end (default 10).
+//
+// --ring-trace N keeps the last N cycles of the wrapper ports in memory
+// (ring_trace.h) and writes cosim_fail.fst/.vcd if any check fails;
+// --trace-trigger EXPR also writes cosim_trigger.* around the first cycle
+// where EXPR holds, e.g. 'bus_addr==0x8000028&&bus_write_n!=3'.
+//
+// Build and run: see docs/verification.md §2.6, e.g.
+//   ./obj_cosim/cosim_tb --hex ../test/fw_post.hex --expect 'POST\nY1C1T1W1I1L1L2M1R1DN\n'
+
+#include "Vcosim_wrap.h"
+#include "verilated.h"
+#if defined(VM_COVERAGE) && VM_COVERAGE
+#include "verilated_cov.h"
+#define COSIM_TOGGLE 1
+#else
+#define COSIM_TOGGLE 0
+#endif
+
+#include "bus_rules.h"
+#include "irq_latency.h"
+#include "mmio_profile.h"
+#include "ring_trace.h"
+#include "rv32_core.h"
+#include "soc_model.h"
+#include "qspi_timing.h"
+#include "sx1268.h"
+#include "sx1268_pins.h"
+#include "uart_sink.h"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+
+static Vcosim_wrap *dut;
+static VerilatedContext *contextp;
+static uint64_t cycle;
+static RingTrace *ring;
+
+// ================================================================
+// UART: uo_out[0] into UartSink, stimulus into ui_in[7]
+// ================================================================
+static const int UART_BIT_CLKS = 217;
+static UartSink uart;
+
+// --uart-rx-period: one 8N1 byte (0x00, 0x01, ...) at the start of every
+// period, PERIOD >= 10 bit times
+static uint8_t uart_rx_level(uint64_t cycle, uint64_t period) {
+    uint64_t bit = (cycle % period) / UART_BIT_CLKS;
+    if (bit == 0) return 0;
+    if (bit >= 9) return 1;
+    return ((cycle / period) >> (bit - 1)) & 1;
+}
+
+// ================================================================
+// RTL event capture
+// ================================================================
+struct BusEvent {
+    uint64_t cycle;
+    bool     write;
+    uint32_t addr;
+    uint32_t data;
+    int      size;
+};
+
+struct RegWrite {
+    uint64_t cycle;
+    uint32_t value;
+};
+
+static std::deque<BusEvent> rtl_bus;        // not yet consumed by the ISS
+static std::deque<RegWrite> rtl_wr;
+static std::deque<uint8_t>  rtl_irq;        // interrupt_req at each instr_complete
+static uint8_t              irq_boundary;   // rtl_irq of the last replayed instruction
+static std::deque<uint64_t> rtl_done;       // cycle of each instr_complete
+static uint64_t rtl_retired;
+
+static const int HIST = 16;
+static BusEvent bus_hist[HIST];
+static int bus_hist_n;
+
+static int      nib_idx = -1;
+static uint32_t nib_val;
+static int      rd_size;
+static uint32_t rd_addr, rd_data;
+
+static BusRuleMonitor bus_rules;
+static MmioProfiler *mmio_profile;
+static IrqLatency *irq_lat;
+static uint8_t irq_src_prev;        // {uart_rx_valid, timer_irq, dio1} last cycle
+static int irq_entry_line = -1;     // ISS took an IRQ, vector insn not retired yet
+
+static int size_of(uint8_t rw_n) { return rw_n == 0 ? 1 : rw_n == 1 ? 2 : 4; }
+
+static bool on_data_bus(uint32_t a) { return (a & 0x0C000000u) != 0; }
+
+static void push_bus(const BusEvent &e) {
+    rtl_bus.push_back(e);
+    bus_hist[bus_hist_n++ % HIST] = e;
+}
+
+static void capture() {
+    // Register write-back, 4 bits per clock
+    if (dut->dbg_reg_wen) {
+        if (dut->dbg_counter_0 || nib_idx < 0) { nib_idx = 0; nib_val = 0; }
+        if (nib_idx < 8) nib_val |= (uint32_t)(dut->dbg_rd & 0xF) << (4 * nib_idx);
+        if (++nib_idx == 8) {
+            rtl_wr.push_back({cycle, nib_val});
+            nib_idx = -1;
+        }
+    }
+
+    uint32_t addr = dut->bus_addr;
+    if (dut->bus_write_n != 3 && dut->bus_data_ready && on_data_bus(addr)) {
+        int size = size_of(dut->bus_write_n);
+        uint32_t mask = size == 4 ? 0xFFFFFFFFu : (1u << (8 * size)) - 1;
+        push_bus({cycle, true, addr, dut->bus_data_to_write & mask, size});
+    }
+    bus_rules.write(dut->bus_write_n, dut->bus_connect_peripheral, dut->bus_data_to_write);
+    bus_rules.sample(cycle, dut->bus_read_n, dut->bus_read_complete, dut->bus_connect_peripheral,
+                     dut->bus_data_from_read);
+    if (mmio_profile)
+        mmio_profile->sample(cycle, dut->bus_read_n, dut->bus_write_n, dut->bus_read_complete,
+                             dut->bus_connect_peripheral, dut->bus_data_from_read, dut->uio_out);
+    if (dut->bus_read_n != 3) {
+        rd_size = size_of(dut->bus_read_n);
+        rd_addr = addr;
+        rd_data = dut->bus_data_from_read;
+    }
+    if (dut->bus_read_complete && on_data_bus(rd_addr)) {
+        uint32_t mask = rd_size == 4 ? 0xFFFFFFFFu : (1u << (8 * rd_size)) - 1;
+        push_bus({cycle, false, rd_addr, rd_data & mask, rd_size});
+    }
+
+    if (dut->dbg_instr_complete) {
+        rtl_retired++;
+        rtl_irq.push_back(dut->bus_interrupt_req);
+        rtl_done.push_back(cycle);
+    }
+
+    if (irq_lat) {
+        uint8_t src = (dut->dio1 & 1) | (dut->bus_interrupt_req & 6);
+        for (int line = 0; line < IrqLatency::LINES; line++)
+            if (((src & ~irq_src_prev) >> line) & 1) irq_lat->edge(line, cycle);
+        irq_src_prev = src;
+    }
+}
+
+static void tick() {
+    dut->clk = 0;
+    contextp->timeInc(1);
+    dut->eval();
+    dut->clk = 1;
+    contextp->timeInc(1);
+    dut->eval();
+    if (ring) ring->sample(cycle);
+    cycle++;
+    uart.sample(cycle, dut->uo_out & 0x01);
+}
+
+static void ring_setup(size_t depth) {
+    ring = new RingTrace(depth);
+    ring->add("uo_out", &dut->uo_out);
+    ring->add("uio_out", &dut->uio_out);
+    ring->add("uio_oe", &dut->uio_oe);
+    ring->add("dio1", &dut->dio1, 1);
+    ring->add("dbg_instr_complete", &dut->dbg_instr_complete, 1);
+    ring->add("dbg_reg_wen", &dut->dbg_reg_wen, 1);
+    ring->add("dbg_counter_0", &dut->dbg_counter_0, 1);
+    ring->add("dbg_rd", &dut->dbg_rd, 4);
+    ring->add("bus_addr", &dut->bus_addr, 28);
+    ring->add("bus_write_n", &dut->bus_write_n, 2);
+    ring->add("bus_read_n", &dut->bus_read_n, 2);
+    ring->add("bus_read_complete", &dut->bus_read_complete, 1);
+    ring->add("bus_data_ready", &dut->bus_data_ready, 1);
+    ring->add("bus_data_to_write", &dut->bus_data_to_write);
+    ring->add("bus_data_from_read", &dut->bus_data_from_read);
+    ring->add("bus_connect_peripheral", &dut->bus_connect_peripheral, 5);
+    ring->add("bus_interrupt_req", &dut->bus_interrupt_req, 4);
+}
+
+// ================================================================
+// ISS side: memories are local, MMIO comes from the RTL event stream
+// ================================================================
+struct Divergence {
+    std::string what;
+    uint32_t expect, actual;
+};
+
+class CosimBus : public Rv32Bus {
+public:
+    uint8_t flash[SocModel::FLASH_BYTES];
+    uint8_t psram[SocModel::PSRAM_BYTES];
+    uint8_t lmem[SocModel::LMEM_BYTES];
+    Divergence div;
+    bool diverged = false;
+    uint64_t compared = 0;
+    uint64_t last_cycle = 0;        // RTL cycle of the last consumed bus event
+
+    CosimBus() {
+        memset(flash, 0xFF, sizeof(flash));
+        memset(psram, 0xFF, sizeof(psram));
+        memset(lmem, 0, sizeof(lmem));
+    }
+
+    uint32_t load(uint32_t addr, int size) override {
+        addr &= 0x0FFFFFFF;
+        uint32_t v = 0;
+        if (!on_data_bus(addr)) {
+            for (int i = size - 1; i >= 0; i--) v = (v << 8) | mem_byte(addr + i);
+            return v;
+        }
+        const BusEvent *e = next(false, addr, size);
+        if (!e) return 0;
+        if (addr & 0x4000000) {
+            for (int i = size - 1; i >= 0; i--) v = (v << 8) | lmem[(addr + i) % 32];
+            if (v != e->data) fail("latch_mem read data", v, e->data);
+        }
+        v = e->data;
+        last_cycle = e->cycle;
+        rtl_bus.pop_front();
+        compared++;
+        return v;
+    }
+
+    void store(uint32_t addr, uint32_t data, int size) override {
+        addr &= 0x0FFFFFFF;
+        if (!on_data_bus(addr)) {
+            if (addr >= 0x1000000 && addr < 0x1800000)
+                for (int i = 0; i < size; i++)
+                    psram[(addr + i) % SocModel::PSRAM_BYTES] = (uint8_t)(data >> (8 * i));
+            return;
+        }
+        const BusEvent *e = next(true, addr, size);
+        if (!e) return;
+        if (e->data != data) fail("bus write data", data, e->data);
+        if (addr & 0x4000000)
+            for (int i = 0; i < size; i++) lmem[(addr + i) % 32] = (uint8_t)(data >> (8 * i));
+        last_cycle = e->cycle;
+        rtl_bus.pop_front();
+        compared++;
+    }
+
+    uint16_t fetch16(uint32_t addr) override {
+        return (uint16_t)(mem_byte(addr) | (mem_byte(addr + 1) << 8));
+    }
+
+    uint64_t cycle_count() const override { return cycle; }
+
+    void fail(const std::string &what, uint32_t expect, uint32_t actual) {
+        if (diverged) return;
+        diverged = true;
+        div = {what, expect, actual};
+    }
+
+private:
+    uint8_t mem_byte(uint32_t a) const {
+        a &= 0x0FFFFFFF;
+        if (a < 0x1000000) return flash[a % SocModel::FLASH_BYTES];
+        if (a < 0x1800000) return psram[a % SocModel::PSRAM_BYTES];
+        return 0xFF;
+    }
+
+    const BusEvent *next(bool write, uint32_t addr, int size) {
+        if (rtl_bus.empty()) {
+            fail(write ? "ISS bus write, RTL idle" : "ISS bus read, RTL idle", addr, 0);
+            return nullptr;
+        }
+        const BusEvent &e = rtl_bus.front();
+        if (e.write != write) {
+            fail(write ? "ISS write, RTL read at" : "ISS read, RTL write at", addr, e.addr);
+            return nullptr;
+        }
+        if ((e.addr & 0x0FFFFFFF) != addr) {
+            fail("bus address", addr, e.addr);
+            return nullptr;
+        }
+        if (e.size != size) {
+            fail("bus size", (uint32_t)size, (uint32_t)e.size);
+            return nullptr;
+        }
+        return &e;
+    }
+};
+
+static CosimBus bus;
+static Rv32Core cpu;
+
+// Expected register writes, in ISS program order
+struct Expect {
+    uint64_t index;         // ISS instruction number
+    uint32_t pc;
+    int      rd;
+    uint32_t value;
+    bool     optional;      // x0/gp/tp: RTL may or may not show the write
+    bool     adopt;         // cycle/time CSR read: take the RTL value
+};
+static std::deque<Expect> iss_wr;
+
+static const int RET_HIST = 16;
+static Rv32Retire ret_hist[RET_HIST];
+static uint64_t iss_retired;
+static uint64_t reg_compared;
+
+static bool is_counter_csr_read(uint32_t insn) {
+    if ((insn & 0x7F) != 0x73 || ((insn >> 12) & 3) == 0) return false;
+    uint32_t csr = insn >> 20;
+    return csr == 0xC00 || csr == 0xC01 || csr == 0xC80 || csr == 0xC81 ||
+           csr == 0xB00 || csr == 0xB80;
+}
+
+// --timing-trace: RTL cycles per retired instruction, for verify/iss/calib
+static FILE    *ttrace;
+static uint64_t ttrace_last;        // previous instr_complete (or reset release)
+static bool     ttrace_reset;
+
+static void ttrace_write(const Rv32Retire &r, uint32_t cycles) {
+    TimingTraceRec rec = timing_trace_pack(r, cycles, ttrace_reset);
+    fwrite(&rec, sizeof(rec), 1, ttrace);
+    ttrace_reset = false;
+}
+
+static void iss_step() {
+    cpu.set_irq_lines(irq_boundary);
+    Rv32Retire r;
+    if (cpu.irq_ready()) {
+        cpu.take_irq(r);
+        if (irq_lat && (cpu.mcause & 0x1F) < 16 + IrqLatency::LINES) irq_entry_line = (cpu.mcause & 0x1F) - 16;
+        ret_hist[(iss_retired + RET_HIST - 1) % RET_HIST] = r;   // shown before next insn
+        if (ttrace) ttrace_write(r, 0);     // entry cycles land on the handler's first insn
+        return;
+    }
+    if (!rtl_irq.empty()) {
+        irq_boundary = rtl_irq.front();
+        rtl_irq.pop_front();
+    }
+    cpu.step(bus, r);
+    if (irq_lat && !rtl_done.empty()) {
+        if (irq_entry_line >= 0) {
+            irq_lat->entered(irq_entry_line, rtl_done.front());
+            irq_entry_line = -1;
+        } else if (r.mem && (r.mem_addr & 0x8000000)) {
+            irq_lat->mmio(bus.last_cycle);
+        }
+    }
+    if (ttrace && !rtl_done.empty()) {
+        ttrace_write(r, (uint32_t)(rtl_done.front() - ttrace_last));
+        ttrace_last = rtl_done.front();
+    }
+    if (!rtl_done.empty()) rtl_done.pop_front();
+    ret_hist[iss_retired % RET_HIST] = r;
+    iss_retired++;
+
+    if (r.rd >= 0)
+        iss_wr.push_back({iss_retired - 1, r.pc, r.rd, r.rd_value, false,
+                          is_counter_csr_read(r.insn)});
+    else if (r.rd_discard >= 0)
+        iss_wr.push_back({iss_retired - 1, r.pc, r.rd_discard, r.rd_value, true, false});
+}
+
+static void match_reg_writes() {
+    while (!rtl_wr.empty() && !iss_wr.empty() && !bus.diverged) {
+        uint32_t v = rtl_wr.front().value;
+        Expect &x = iss_wr.front();
+        if (x.optional && v != x.value) {
+            iss_wr.pop_front();             // the RTL did not write x0/gp/tp
+            continue;
+        }
+        if (x.adopt) {
+            cpu.x[x.rd] = v;
+        } else if (v != x.value) {
+            char what[64];
+            snprintf(what, sizeof(what), "register write %s @pc %08x",
+                     Rv32Core::reg_name(x.rd), x.pc);
+            bus.fail(what, x.value, v);
+            return;
+        }
+        rtl_wr.pop_front();
+        iss_wr.pop_front();
+        reg_compared++;
+    }
+    // An ISS write with no RTL counterpart long after the fact is a divergence
+    while (!iss_wr.empty() && iss_wr.front().optional && iss_retired > iss_wr.front().index + 8)
+        iss_wr.pop_front();
+    if (!iss_wr.empty() && iss_retired > iss_wr.front().index + 64)
+        bus.fail("register write missing in RTL", iss_wr.front().value, 0);
+}
+
+static void dump_state() {
+    printf("\n=== DIVERGENCE at ISS instruction #%llu, RTL cycle %llu ===\n",
+           (unsigned long long)(iss_retired ? iss_retired - 1 : 0), (unsigned long long)cycle);
+    printf("  %s: ISS %08x, RTL %08x\n", bus.div.what.c_str(), bus.div.expect, bus.div.actual);
+
+    printf("\n--- ISS state (after the diverging instruction) ---\n");
+    printf("  pc=%08x mstatus=%08x mie=%08x mip=%08x mepc=%08x mcause=%08x\n",
+           cpu.pc, cpu.mstatus, cpu.mie, cpu.mip, cpu.mepc, cpu.mcause);
+    for (int i = 0; i < 16; i++)
+        printf("  x%-2d %-4s %08x%s", i, Rv32Core::reg_name(i), cpu.x[i], (i % 4 == 3) ? "\n" : "");
+
+    printf("\n--- Last ISS instructions ---\n");
+    uint64_t n = iss_retired < RET_HIST ? iss_retired : RET_HIST;
+    for (uint64_t k = iss_retired - n; k < iss_retired; k++) {
+        const Rv32Retire &r = ret_hist[k % RET_HIST];
+        printf("  #%-8llu %08x  %08x", (unsigned long long)k, r.pc, r.insn);
+        if (r.rd >= 0) printf("  %-4s=%08x", Rv32Core::reg_name(r.rd), r.rd_value);
+        if (r.mem) printf("  %s[%08x]=%08x", r.mem_write ? "st" : "ld", r.mem_addr, r.mem_data);
+        printf("\n");
+    }
+
+    printf("\n--- Last RTL bus transactions ---\n");
+    int m = bus_hist_n < HIST ? bus_hist_n : HIST;
+    for (int k = bus_hist_n - m; k < bus_hist_n; k++) {
+        const BusEvent &e = bus_hist[k % HIST];
+        printf("  cycle %-10llu %s%d [%07x] %08x\n", (unsigned long long)e.cycle,
+               e.write ? "W" : "R", e.size * 8, e.addr, e.data);
+    }
+    printf("  pending RTL register writes: %zu, pending ISS writes: %zu\n",
+           rtl_wr.size(), iss_wr.size());
+}
+
+// --toggle-dat: Verilator toggle counters, restarted at the window start
+static void toggle_zero() {
+#if COSIM_TOGGLE
+    VerilatedCov::zero();
+#endif
+}
+
+static void toggle_write(const char *path, uint64_t from, uint64_t to) {
+#if COSIM_TOGGLE
+    VerilatedCov::write(path);
+#endif
+    printf("[TOGGLE] %llu cycles (%llu..%llu) -> %s\n", (unsigned long long)(to - from),
+           (unsigned long long)from, (unsigned long long)to, path);
+}
+
+static std::string unescape(const char *s) {
+    std::string r;
+    for (; *s; s++) {
+        if (s[0] == '\\' && s[1] == 'n') { r += '\n'; s++; }
+        else r += *s;
+    }
+    return r;
+}
+
+int main(int argc, char **argv) {
+    const char *hex = "fw_post.hex";
+    std::string expect = "DN";
+    uint64_t max_cycles = 80000000ULL;
+    uint64_t lag = 2;
+    bool dio1_follows_led = false, sx1268 = false, uart_loopback = false;
+    uint32_t ack_ms = 10;
+    const char *ttrace_path = nullptr;
+    size_t ring_depth = 0;
+    const char *trigger = nullptr;
+    const char *profile_path = nullptr;
+    const char *irq_path = nullptr;
+    uint64_t irq_bin = 16, dio1_period = 0, uart_rx_period = 0, seed = 1;
+    const char *toggle_path = nullptr;
+    const char *uart_path = nullptr;
+    uint64_t toggle_from = 0, toggle_to = ~0ULL;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--hex") && i + 1 < argc) hex = argv[++i];
+        else if (!strcmp(argv[i], "--expect") && i + 1 < argc) expect = unescape(argv[++i]);
+        else if (!strcmp(argv[i], "--max-cycles") && i + 1 < argc) max_cycles = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--lag") && i + 1 < argc) lag = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--dio1-follows-led")) dio1_follows_led = true;
+        else if (!strcmp(argv[i], "--uart-loopback")) uart_loopback = true;
+        else if (!strcmp(argv[i], "--sx1268")) sx1268 = true;
+        else if (!strcmp(argv[i], "--sx1268-ack-ms") && i + 1 < argc) ack_ms = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--timing-trace") && i + 1 < argc) ttrace_path = argv[++i];
+        else if (!strcmp(argv[i], "--ring-trace") && i + 1 < argc) ring_depth = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--trace-trigger") && i + 1 < argc) trigger = argv[++i];
+        else if (!strcmp(argv[i], "--mmio-profile") && i + 1 < argc) profile_path = argv[++i];
+        else if (!strcmp(argv[i], "--irq-latency") && i + 1 < argc) irq_path = argv[++i];
+        else if (!strcmp(argv[i], "--irq-bin") && i + 1 < argc) irq_bin = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--dio1-pulse") && i + 1 < argc) dio1_period = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--uart-rx-period") && i + 1 < argc) uart_rx_period = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--toggle-dat") && i + 1 < argc) toggle_path = argv[++i];
+        else if (!strcmp(argv[i], "--uart-file") && i + 1 < argc) uart_path = argv[++i];
+        else if (!strcmp(argv[i], "--toggle-window") && i + 1 < argc) {
+            char *end;
+            toggle_from = strtoull(argv[++i], &end, 0);
+            if (*end == ':') toggle_to = strtoull(end + 1, nullptr, 0);
+        }
+    }
+
+    contextp = new VerilatedContext;
+    std::string flash_arg = std::string("+flash_hex=") + hex;
+    std::vector<const char *> vargs(argv, argv + argc);
+    vargs.push_back(flash_arg.c_str());
+    contextp->commandArgs((int)vargs.size(), vargs.data());
+    dut = new Vcosim_wrap{contextp};
+    if (toggle_path && !COSIM_TOGGLE) {
+        printf("[FAIL] --toggle-dat needs a model built with --coverage-toggle\n");
+        return 1;
+    }
+    FILE *uart_file = nullptr;
+    if (uart_path && !(uart_file = fopen(uart_path, "wb"))) {
+        printf("[FAIL] cannot write %s\n", uart_path);
+        return 1;
+    }
+    uart.set_file(uart_file);
+    uart.set_limit(1 << 20);
+    int signature = uart.watch(expect);
+    if (profile_path) mmio_profile = new MmioProfiler;
+    if (irq_path) irq_lat = new IrqLatency;
+    if (uart_rx_period && uart_rx_period < 10 * UART_BIT_CLKS) uart_rx_period = 10 * UART_BIT_CLKS;
+    if (trigger && !ring_depth) ring_depth = 16384;
+    if (ring_depth) {
+        ring_setup(ring_depth);
+        std::string err;
+        if (trigger && !ring->set_trigger(trigger, std::string("cosim_trigger") + RingTrace::ext(), &err)) {
+            printf("[FAIL] --trace-trigger: %s\n", err.c_str());
+            return 1;
+        }
+    }
+
+    printf("=== LoRa Edge SoC — RTL/ISS lockstep co-simulation ===\n");
+    printf("Image: %s\n", hex);
+    if (!load_verilog_hex(hex, bus.flash, SocModel::FLASH_BYTES)) {
+        printf("[FAIL] cannot read %s\n", hex);
+        return 1;
+    }
+    cpu.set_icache_range(SocModel::FLASH_BYTES);
+    if (ttrace_path) {
+        ttrace = fopen(ttrace_path, "wb");
+        if (!ttrace) {
+            printf("[FAIL] cannot write %s\n", ttrace_path);
+            return 1;
+        }
+        fwrite(&TIMING_TRACE_MAGIC, 4, 1, ttrace);
+    }
+
+    Sx1268 radio;
+    Sx1268Pins pins(radio);
+    uint64_t rng = 1;
+    radio.random = [&rng] {
+        rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (uint32_t)(rng >> 32);
+    };
+    sx1268_loopback_ack(radio, (uint64_t)ack_ms * (SocModel::CLK_HZ / 1000));
+
+    dut->rst_n = 0;
+    dut->dio1 = 0;
+    dut->sx_busy = 0;
+    dut->sx_miso = 1;
+    dut->uart_rx = 1;
+    dut->pps = 0;
+    dut->clk = 0;
+    for (int i = 0; i < 20; i++) tick();
+    dut->rst_n = 1;
+
+    uint64_t resets = 0;
+    bool prev_rst = true;
+    uint64_t load_rng = seed, dio1_next = cycle + dio1_period, dio1_high_until = 0;
+    auto load_rand = [&load_rng] {
+        load_rng = load_rng * 6364136223846793005ULL + 1442695040888963407ULL;
+        return load_rng >> 33;
+    };
+    bool toggle_open = false, toggle_done = false;
+    while (cycle < max_cycles && !bus.diverged) {
+        tick();
+        capture();
+        if (toggle_path && !toggle_open && !toggle_done && cycle >= toggle_from) {
+            toggle_zero();
+            toggle_from = cycle;
+            toggle_open = true;
+        }
+        if (toggle_open && cycle >= toggle_to) {
+            toggle_done = true;
+            toggle_write(toggle_path, toggle_from, cycle);
+            toggle_open = false;
+        }
+
+        // WDT / soft reset: the core restarts from 0x0 with PSRAM intact
+        bool in_rst = !dut->uio_oe;
+        if (in_rst && !prev_rst) {
+            while (iss_retired < rtl_retired && !bus.diverged) iss_step();
+            match_reg_writes();
+            cpu.reset();
+            rtl_wr.clear(); iss_wr.clear(); rtl_bus.clear(); rtl_irq.clear(); rtl_done.clear();
+            irq_boundary = 0;
+            iss_retired = rtl_retired = 0;
+            nib_idx = -1;
+            bus_rules.reset();
+            if (mmio_profile) mmio_profile->reset();
+            if (irq_lat) irq_lat->reset();
+            irq_entry_line = -1;
+            resets++;
+        }
+        if (!in_rst && prev_rst) {
+            ttrace_last = cycle;            // reset hold is not charged to any instruction
+            ttrace_reset = resets > 0;
+        }
+        prev_rst = in_rst;
+
+        if (dio1_follows_led) dut->dio1 = (dut->uo_out >> 7) & 1;
+        if (dio1_period) {
+            if (cycle >= dio1_next) {
+                dio1_high_until = cycle + 16;
+                dio1_next = cycle + dio1_period / 2 + load_rand() % dio1_period;
+            }
+            if (!dio1_follows_led) dut->dio1 = 0;
+            dut->dio1 |= cycle < dio1_high_until;
+        }
+        if (uart_rx_period) dut->uart_rx = uart_rx_level(cycle, uart_rx_period);
+        if (uart_loopback) dut->uart_rx = dut->uo_out & 1;
+        if (sx1268) {
+            uint8_t ui = pins.eval(cycle, dut->uo_out, 0);
+            dut->dio1 = ui & 1;
+            dut->sx_busy = (ui >> 1) & 1;
+            dut->sx_miso = (ui >> 2) & 1;
+        }
+
+        while (iss_retired + lag < rtl_retired && !bus.diverged) iss_step();
+        match_reg_writes();
+
+        if (uart.seen(signature)) break;
+    }
+
+    int pass = 0, fail = 0;
+    if (bus.diverged) {
+        dump_state();
+        printf("\n[FAIL] lockstep\n");
+        fail++;
+    } else {
+        printf("[PASS] lockstep: %llu instructions, %llu register writes, %llu bus transactions, %llu resets\n",
+               (unsigned long long)rtl_retired, (unsigned long long)reg_compared,
+               (unsigned long long)bus.compared, (unsigned long long)resets);
+        pass++;
+    }
+    if (uart_file) fclose(uart_file);
+    if (uart.seen(signature)) {
+        printf("[PASS] UART signature at cycle %llu\n", (unsigned long long)uart.seen_cycle(signature));
+        pass++;
+    } else {
+        printf("[FAIL] UART signature after %llu cycles (%llu bytes)\n",
+               (unsigned long long)cycle, (unsigned long long)uart.total());
+        fail++;
+    }
+
+    if (bus_rules.report()) {
+        printf("[PASS] RULE A/B: read data stable until read_complete\n");
+        pass++;
+    } else {
+        printf("[FAIL] RULE A/B: %llu violations\n", (unsigned long long)bus_rules.violations);
+        fail++;
+    }
+
+    if (mmio_profile) {
+        mmio_profile->report();
+        if (!mmio_profile->write_json(profile_path, hex)) {
+            printf("[FAIL] cannot write %s\n", profile_path);
+            fail++;
+        }
+    }
+
+    if (toggle_open) {
+        toggle_write(toggle_path, toggle_from, cycle);
+    } else if (toggle_path && !toggle_done) {
+        printf("[FAIL] --toggle-window starts after the run ended (cycle %llu)\n", (unsigned long long)cycle);
+        fail++;
+    }
+
+    if (irq_lat) {
+        irq_lat->report(irq_bin);
+        if (!irq_lat->write_csv(irq_path)) {
+            printf("[FAIL] cannot write %s\n", irq_path);
+            fail++;
+        }
+    }
+
+    if (sx1268) {
+        bool ok = radio.busy_violations == 0;
+        printf("[%s] SX1268: %u TX, %u RX, %u RX timeouts, %u BUSY violations\n",
+               ok ? "PASS" : "FAIL", radio.tx_count, radio.rx_count, radio.rx_timeouts,
+               radio.busy_violations);
+        if (ok) pass++;
+        else fail++;
+    }
+
+    if (ring) {
+        ring->finish();
+        if (fail) ring->dump(std::string("cosim_fail") + RingTrace::ext(), bus.diverged ? "lockstep divergence" : "check failed");
+    }
+
+    printf("\n=== Results: %d PASS, %d FAIL ===\n", pass, fail);
+    if (fail == 0) printf("ALL TESTS PASSED\n");
+
+    if (ttrace) fclose(ttrace);
+    dut->final();
+    delete dut;
+    delete contextp;
+    return fail == 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+// ============================================================================
+// cosim_wrap.v — Verilator wrapper for RTL-vs-ISS lockstep co-simulation
+// ============================================================================
+// Same board as cov_project_wrap.v (DUT + synchronous flash/PSRAM/I2C models)
+// plus:
+//   - HEX_FILE parameter (-GHEX_FILE=...) so any fw_*.hex can be booted;
+//     +flash_hex=PATH at run time overrides it (verify/soclib)
+//   - dio1 / sx_busy / sx_miso inputs for TBs that drive the SX1268 pins
+//     (DIO1 = IRQ16; cosim_tb --sx1268 runs the verify/iss/sx1268 model)
+//   - uart_rx input (ui_in[7], 1 = idle) for cosim_tb --uart-rx-period
+//   - pps input (ui_in[4]) for TBs that drive the 1PPS pin
+//   - tinyQV debug port and data bus exported by hierarchical reference,
+//     consumed by cosim_tb.cpp
+// ============================================================================
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+module cosim_wrap #(
+    parameter HEX_FILE = "fw_post.hex"
+) (
+    input  wire       clk,
+    input  wire       rst_n,
+    input  wire       dio1,
+    input  wire       sx_busy,
+    input  wire       sx_miso,
+    input  wire       uart_rx,
+    input  wire       pps,
+    output wire [7:0] uo_out,
+    output wire [7:0] uio_out,
+    output wire [7:0] uio_oe,
+
+    // tinyQV debug port
+    output wire        dbg_instr_complete,
+    output wire        dbg_reg_wen,
+    output wire        dbg_counter_0,
+    output wire [3:0]  dbg_rd,
+
+    // tinyQV data bus as seen by project.v
+    output wire [27:0] bus_addr,
+    output wire [1:0]  bus_write_n,
+    output wire [1:0]  bus_read_n,
+    output wire        bus_read_complete,
+    output wire        bus_data_ready,
+    output wire [31:0] bus_data_to_write,
+    output wire [31:0] bus_data_from_read,
+    output wire [4:0]  bus_connect_peripheral,
+    output wire [3:0]  bus_interrupt_req
+);
+
+    // TT interface signals
+    reg  [7:0] ui_in;
+    reg  [7:0] uio_in;
+
+    // DUT
+    tt_um_techhu_rv32_trial dut (
+        .ui_in  (ui_in),
+        .uo_out (uo_out),
+        .uio_in (uio_in),
+        .uio_out(uio_out),
+        .uio_oe (uio_oe),
+        .ena    (1'b1),
+        .clk    (clk),
+        .rst_n  (rst_n)
+    );
+
+    // ================================================================
+    // QSPI Flash Model (synchronous — uses sys_clk edge detection)
+    // ================================================================
+    wire flash_cs_n = uio_out[0];
+    wire spi_clk    = uio_out[3];
+
+    wire [3:0] qspi_data_to_flash = {uio_out[5], uio_out[4], uio_out[2], uio_out[1]};
+    wire [3:0] qspi_data_from_flash;
+    wire [3:0] qspi_oe = {uio_oe[5], uio_oe[4], uio_oe[2], uio_oe[1]};
+
+    qspi_flash_model #(.HEX_FILE(HEX_FILE)) i_flash (
+        .sys_clk     (clk),
+        .spi_clk     (spi_clk),
+        .spi_cs_n    (flash_cs_n),
+        .spi_data_in (qspi_data_to_flash),
+        .spi_data_out(qspi_data_from_flash),
+        .spi_data_oe (qspi_oe)
+    );
+
+    // ================================================================
+    // QSPI PSRAM Model (synchronous)
+    // ================================================================
+    wire ram_a_cs_n = uio_out[6];
+
+    wire [3:0] qspi_data_to_psram = {uio_out[5], uio_out[4], uio_out[2], uio_out[1]};
+    wire [3:0] qspi_data_from_psram;
+
+    qspi_psram_model i_psram (
+        .sys_clk     (clk),
+        .spi_clk     (spi_clk),
+        .spi_cs_n    (ram_a_cs_n),
+        .spi_data_in (qspi_data_to_psram),
+        .spi_data_out(qspi_data_from_psram),
+        .spi_data_oe (qspi_oe)
+    );
+
+    // ================================================================
+    // I2C Slave Model (synchronous)
+    // ================================================================
+    wire i2c_scl = uo_out[2];
+    wire i2c_sda_master = uo_out[6];
+
+    wire slave_sda_o;
+    wire sda_bus_value = i2c_sda_master & slave_sda_o;
+
+    i2c_slave_model #(.SLAVE_ADDR(7'h44)) i_sht31 (
+        .sys_clk(clk),
+        .scl(i2c_scl),
+        .sda_i(sda_bus_value),
+        .sda_o(slave_sda_o)
+    );
+
+    // ================================================================
+    // QSPI Data Bus Mux (Flash vs PSRAM readback)
+    // ================================================================
+    wire [3:0] ext_data_to_dut;
+    assign ext_data_to_dut = (!flash_cs_n) ? qspi_data_from_flash :
+                              (!ram_a_cs_n) ? qspi_data_from_psram :
+                              4'hF;
+
+    // ================================================================
+    // Pin Connection — Latency Config + Flash/PSRAM Mux
+    // ================================================================
+    reg latency_config_done;
+    always @(posedge clk) begin
+        if (rst_n) latency_config_done <= 1;
+        else latency_config_done <= 0;
+    end
+
+    always @(*) begin
+        // uio_in: QSPI data bus + latency config
+        uio_in[0] = 1'b1;
+        uio_in[3] = 1'b1;
+        uio_in[6] = 1'b1;
+        uio_in[7] = 1'b1;
+
+        if (!latency_config_done) begin
+            uio_in[1] = 1'b1;
+            uio_in[2] = 1'b0;
+            uio_in[4] = 1'b0;
+            uio_in[5] = 1'b0;
+        end else begin
+            uio_in[1] = uio_oe[1] ? uio_out[1] : ext_data_to_dut[0];
+            uio_in[2] = uio_oe[2] ? uio_out[2] : ext_data_to_dut[1];
+            uio_in[4] = uio_oe[4] ? uio_out[4] : ext_data_to_dut[2];
+            uio_in[5] = uio_oe[5] ? uio_out[5] : ext_data_to_dut[3];
+        end
+
+        // ui_in: dedicated input pins
+        ui_in[0] = dio1;       // DIO1 (IRQ) - driven by cosim_tb.cpp
+        ui_in[1] = sx_busy;    // SX1268 BUSY - driven by cosim_tb.cpp (0 = idle)
+        ui_in[2] = sx_miso;    // SPI MISO - driven by cosim_tb.cpp (1 = idle)
+        ui_in[3] = sda_bus_value; // I2C SDA readback
+        ui_in[4] = pps;        // 1PPS - driven by the TB (0 when unused)
+        ui_in[5] = 1'b0;       // spare GPIO
+        ui_in[6] = 1'b0;       // spare GPIO
+        ui_in[7] = uart_rx;    // UART RX - driven by cosim_tb.cpp (1 = idle)
+    end
+
+    // ================================================================
+    // Debug / bus taps
+    // ================================================================
+    assign dbg_instr_complete = dut.debug_instr_complete;
+    assign dbg_reg_wen        = dut.debug_reg_wen;
+    assign dbg_counter_0      = dut.debug_counter_0;
+    assign dbg_rd             = dut.debug_rd;
+
+    assign bus_addr           = dut.addr;
+    assign bus_write_n        = dut.write_n;
+    assign bus_read_n         = dut.read_n;
+    assign bus_read_complete  = dut.read_complete;
+    assign bus_data_ready     = dut.data_ready;
+    assign bus_data_to_write  = dut.data_to_write;
+    assign bus_data_from_read = dut.data_from_read;
+    assign bus_connect_peripheral = dut.connect_peripheral;
+    assign bus_interrupt_req  = dut.interrupt_req;
+
+endmodule
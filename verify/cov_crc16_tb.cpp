@@ -428,5 +428,6 @@ int main(int argc, char **argv) {
     dut->final();
     delete dut;
 
+    printf("[PERF] %llu cycles\n", (unsigned long long)(sim_time / 2));
     return fail_count > 0 ? 1 : 0;
 }
@@ -18,10 +18,16 @@
 //   8. Multiple back-to-back transactions
 //   9. Read config register
 //  10. Stop-only command (standalone)
+//  11. Register-level device models (iss/i2c_devices.h) behind the pin
+//      adapter iss/i2c_pins.h: SHT3x NACK-on-busy polling, SHT3x clock
+//      stretching (scl_i = scl_o & device SCL), EEPROM page write + ACK
+//      polling, BME280 register pointer
 
 #include "Vcov_i2c_wrap.h"
 #include "verilated.h"
 #include "verilated_cov.h"
+#include "i2c_devices.h"
+#include "i2c_pins.h"
 
 #include <cstdio>
 #include <cstdint>
@@ -40,6 +46,9 @@ static Vcov_i2c_wrap *dut;
 
 static uint8_t slave_sda = 1;  // slave SDA output (1 = released)
 
+// T14+: device bus in place of the canned slave below (nullptr = off)
+static I2cPins *bus_pins = nullptr;
+
 enum SlaveState {
     SL_IDLE,
     SL_ADDR,         // receiving 7-bit address + R/W
@@ -247,6 +256,14 @@ struct I2CSlave {
 
 // ---- helpers ----
 
+// Device bus: the devices may hold SCL low (clock stretching), which the
+// master sees through scl_i. Time is in clock cycles.
+static void bus_update() {
+    bus_pins->eval(sim_time / 2, dut->scl_o, dut->sda_o);
+    dut->scl_i = dut->scl_o & bus_pins->scl();
+    dut->sda_i = dut->sda_o & bus_pins->sda();
+}
+
 static void tick() {
     // Compute sda_i = open-drain wired-AND
     // scl_i = scl_o (no clock stretching) but use 1 initially
@@ -255,26 +272,35 @@ static void tick() {
 
     dut->scl_i = scl_bus;
     dut->sda_i = sda_bus;
+    if (bus_pins) bus_update();
 
     dut->clk = 0;
     dut->eval();
     sim_time++;
 
     // Update slave on falling edge with post-eval bus state
-    slave.update(dut->scl_o, dut->sda_o);
-
-    // Recompute after slave may have changed slave_sda
-    dut->sda_i = dut->sda_o & slave_sda;
-    dut->scl_i = dut->scl_o;
+    if (bus_pins) {
+        bus_update();
+    } else {
+        slave.update(dut->scl_o, dut->sda_o);
+
+        // Recompute after slave may have changed slave_sda
+        dut->sda_i = dut->sda_o & slave_sda;
+        dut->scl_i = dut->scl_o;
+    }
 
     dut->clk = 1;
     dut->eval();
     sim_time++;
 
     // Update slave on rising edge
-    slave.update(dut->scl_o, dut->sda_o);
-    dut->sda_i = dut->sda_o & slave_sda;
-    dut->scl_i = dut->scl_o;
+    if (bus_pins) {
+        bus_update();
+    } else {
+        slave.update(dut->scl_o, dut->sda_o);
+        dut->sda_i = dut->sda_o & slave_sda;
+        dut->scl_i = dut->scl_o;
+    }
 }
 
 static void ticks(int n) {
@@ -799,6 +825,135 @@ static void test_sda_cdc_sync() {
     printf("  [T13] done\n");
 }
 
+// ===================================================================
+// T14-T16: register-level devices on the bus (iss/i2c_devices.h)
+// Datasheet delays at 1 cycle/us so a 15 ms measurement is 15k clocks.
+// ===================================================================
+
+// START+WRITE_M addr, bytes..., last with STOP. A refused address leaves
+// the device unselected, so the last byte is NACKed too.
+static bool dev_write(uint8_t addr, const uint8_t *buf, int n) {
+    mmio_data_wr(cmd_bits(true, false, false, true, false, addr));
+    wait_tx_ready(30000);
+    for (int i = 0; i < n; i++) {
+        mmio_data_wr(cmd_bits(false, false, true, false, i == n - 1, buf[i]));
+        wait_tx_ready(30000);
+    }
+    wait_not_busy(50000);
+    return !missed_ack();
+}
+
+// START+READ addr, n bytes, last with STOP. Returns false when the address
+// was NACKed (sampled with the first byte; the next READ clears the latch).
+static bool dev_read(uint8_t addr, uint8_t *buf, int n, int timeout = 50000) {
+    bool nack = false;
+    for (int i = 0; i < n; i++) {
+        mmio_data_wr(cmd_bits(i == 0, true, false, false, i == n - 1, addr));
+        if (!wait_rx_valid(timeout)) return false;
+        buf[i] = rx_data();
+        if (i == 0) nack = missed_ack();
+        mmio_data_rd();
+        tick();
+    }
+    wait_not_busy(50000);
+    return !nack;
+}
+
+static void test_dev_sht3x_polling() {
+    printf("[T14] SHT3x single shot, NACK-on-busy polling\n");
+    do_reset();
+    mmio_config_wr(4);
+
+    Sht3xSlave sht(0x44, 1);
+    I2cBus bus;
+    bus.add(&sht);
+    I2cPins pins(bus);
+    bus_pins = &pins;
+
+    const uint8_t cmd[2] = {0x24, 0x00};
+    CHECK(dev_write(0x44, cmd, 2), "SHT3x ACKs measure command");
+    uint64_t t0 = sim_time / 2;
+    uint8_t d[6] = {0};
+    int polls = 0;
+    while (polls < 200 && !dev_read(0x44, d, 6)) polls++;
+    uint64_t dt = sim_time / 2 - t0;
+    printf("  %d NACKed polls, data after %llu cycles: %02X%02X %02X %02X%02X %02X\n", polls,
+           (unsigned long long)dt, d[0], d[1], d[2], d[3], d[4], d[5]);
+    CHECK(polls > 0 && polls < 200, "read header NACKed while measuring, then ACKed");
+    CHECK(dt >= 15000, "data not before the 15 ms measurement time");
+    CHECK(Sht3xSlave::crc8(d, 2) == d[2] && Sht3xSlave::crc8(d + 3, 2) == d[5], "CRC-8 of T and RH");
+    CHECK(sht.busy_nacks == (uint32_t)polls, "device counted the busy NACKs");
+
+    bus_pins = nullptr;
+    printf("  [T14] done\n");
+}
+
+static void test_dev_sht3x_stretch() {
+    printf("[T15] SHT3x clock stretching (0x2C06)\n");
+    do_reset();
+    mmio_config_wr(4);
+
+    Sht3xSlave sht(0x44, 1);
+    I2cBus bus;
+    bus.add(&sht);
+    I2cPins pins(bus);
+    bus_pins = &pins;
+
+    const uint8_t cmd[2] = {0x2C, 0x06};
+    CHECK(dev_write(0x44, cmd, 2), "SHT3x ACKs stretch command");
+    uint8_t d[6] = {0};
+    bool ack = dev_read(0x44, d, 6, 40000);
+    printf("  SCL held %llu cycles, %u stale reads\n",
+           (unsigned long long)pins.held, sht.stale_reads);
+    CHECK(ack, "read header ACKed without polling");
+    CHECK(pins.held > 10000, "SCL held low through the measurement");
+    CHECK(sht.stale_reads == 0, "master waited for SCL (no 0xFF bytes)");
+    CHECK(Sht3xSlave::crc8(d, 2) == d[2] && Sht3xSlave::crc8(d + 3, 2) == d[5], "CRC-8 of T and RH");
+
+    // An explicit policy (--i2c-devices sht3x:nack) wins over the command
+    sht.busy_policy = I2cDevice::BUSY_NACK;
+    sht.busy_policy_fixed = true;
+    CHECK(dev_write(0x44, cmd, 2), "SHT3x ACKs stretch command (policy nack)");
+    CHECK(!dev_read(0x44, d, 6), "read header NACKed while measuring");
+    CHECK(sht.busy_policy == I2cDevice::BUSY_NACK, "parsed policy kept");
+
+    bus_pins = nullptr;
+    printf("  [T15] done\n");
+}
+
+static void test_dev_eeprom_bme280() {
+    printf("[T16] EEPROM page write + ACK polling, BME280 chip id\n");
+    do_reset();
+    mmio_config_wr(4);
+
+    EepromSlave ee(0x50, 4096, 32, 2, 1);
+    Bme280Slave bme(0x76, 1);
+    I2cBus bus;
+    bus.add(&ee);
+    bus.add(&bme);
+    I2cPins pins(bus);
+    bus_pins = &pins;
+
+    // 8 bytes at 0x001C: 4 fit the page, the rest wrap to 0x0000
+    uint8_t w[10] = {0x00, 0x1C};
+    for (int i = 0; i < 8; i++) w[2 + i] = 0xA0 + i;
+    CHECK(dev_write(0x50, w, 10), "page write ACKed");
+    int polls = 0;
+    while (polls < 200 && !dev_write(0x50, w, 2)) polls++;
+    printf("  tWR: %d NACKed polls\n", polls);
+    CHECK(polls > 0 && polls < 200, "ACK polling through the write cycle");
+    uint8_t r[4];
+    CHECK(dev_read(0x50, r, 4), "sequential read ACKed");
+    CHECK(r[0] == 0xA0 && r[3] == 0xA3, "bytes before the page boundary");
+    CHECK(ee.mem[0] == 0xA4 && ee.mem[3] == 0xA7 && ee.mem[0x20] == 0xFF, "roll-over stays in the page");
+
+    const uint8_t reg = Bme280Slave::REG_ID;
+    CHECK(dev_write(0x76, &reg, 1) && dev_read(0x76, r, 1) && r[0] == 0x60, "BME280 chip id 0x60");
+
+    bus_pins = nullptr;
+    printf("  [T16] done\n");
+}
+
 // ===================================================================
 // main
 // ===================================================================
@@ -822,6 +977,9 @@ int main(int argc, char **argv) {
     test_data_out_fields();
     test_loopback_simple();
     test_sda_cdc_sync();
+    test_dev_sht3x_polling();
+    test_dev_sht3x_stretch();
+    test_dev_eeprom_bme280();
 
     printf("\n=== Results: %d / %d PASS ===\n", pass_count, test_count);
 
@@ -832,5 +990,6 @@ int main(int argc, char **argv) {
     printf("Coverage written to: %s\n", cov_path);
 
     delete dut;
+    printf("[PERF] %llu cycles\n", (unsigned long long)(sim_time / 2));
     return (pass_count == test_count) ? 0 : 1;
 }
@@ -279,5 +279,6 @@ int main(int argc, char **argv) {
     VerilatedCov::write("verify/obj_latch/coverage.dat");
     dut->final();
     delete dut;
+    printf("[PERF] %llu cycles\n", (unsigned long long)(sim_time / 3));
     return fail_cnt > 0 ? 1 : 0;
 }
@@ -1,11 +1,21 @@
 // cov_project_tb.cpp — Verilator coverage testbench for full LoRa Edge SoC
 // Boots the POST firmware via QSPI flash model and monitors UART output.
-// No waveform tracing — coverage data only.
+// No waveform tracing — coverage data only. Every MMIO read is checked
+// against project.v RULE A/B by BusRuleMonitor (bus_rules.h), and
+// MmioProfiler (mmio_profile.h) prints where the POST cycles went: bus
+// cycles and polling per peripheral slot, QSPI flash vs PSRAM.
+// --mmio-profile FILE also writes the profile as JSON.
+// UART output goes through UartSink (uart_sink.h): no per-byte printf,
+// --uart-file FILE writes the raw bytes.
 
 #include "Vcov_project_wrap.h"
 #include "verilated.h"
 #include "verilated_cov.h"
 
+#include "bus_rules.h"
+#include "mmio_profile.h"
+#include "uart_sink.h"
+
 #include <cstdio>
 #include <cstdint>
 #include <cstring>
@@ -13,50 +23,13 @@
 
 static Vcov_project_wrap *dut;
 static VerilatedContext *contextp;
+static BusRuleMonitor bus_rules;
+static MmioProfiler mmio_profile;
+static uint64_t cycle;
 
-// UART receiver state (115200 baud @ 25 MHz = 217 clocks/bit)
-static const int UART_BIT_CLKS = 217;
-static int uart_bit_cnt = -1;
-static int uart_clk_cnt = 0;
-static uint8_t uart_shift = 0;
-static uint8_t uart_prev_txd = 1;
-static uint8_t uart_buf[256];
-static int uart_idx = 0;
-
-static void uart_sample(uint8_t txd) {
-    uint8_t start_edge = uart_prev_txd && !txd;
-    uart_prev_txd = txd;
-
-    if (uart_bit_cnt == -1) {
-        if (start_edge) {
-            uart_bit_cnt = 0;
-            uart_clk_cnt = UART_BIT_CLKS + (UART_BIT_CLKS / 2);
-        }
-        return;
-    }
-
-    if (uart_clk_cnt > 0) {
-        uart_clk_cnt--;
-        return;
-    }
-
-    uart_clk_cnt = UART_BIT_CLKS;
-    if (uart_bit_cnt < 8) {
-        uart_shift = (uart_shift >> 1) | (txd << 7);
-        uart_bit_cnt++;
-    } else {
-        // Stop bit — byte complete
-        if (uart_idx < 256) {
-            uart_buf[uart_idx] = uart_shift;
-            if (uart_shift >= 0x20 && uart_shift < 0x7F)
-                printf("[UART] byte %d: 0x%02X '%c'\n", uart_idx, uart_shift, uart_shift);
-            else
-                printf("[UART] byte %d: 0x%02X\n", uart_idx, uart_shift);
-            uart_idx++;
-        }
-        uart_bit_cnt = -1;
-    }
-}
+// uo_out[0], 115200 baud @ 25 MHz. Bytes are only buffered (the POST
+// checks index into them); --uart-file FILE streams them to FILE too.
+static UartSink uart;
 
 // One full clock cycle: fall then rise
 // Advance simulation time to allow --timing edge detection on derived clocks
@@ -72,12 +45,30 @@ static void tick() {
     dut->eval();
 
     // Sample UART on uo_out[0] after rising edge
-    uart_sample(dut->uo_out & 0x01);
+    uart.sample(cycle, dut->uo_out & 0x01);
+
+    mmio_profile.sample(cycle, dut->mon_read_n, dut->mon_write_n, dut->mon_read_complete,
+                        dut->mon_connect_peripheral, dut->mon_data_from_read, dut->uio_out);
+    bus_rules.write(dut->mon_write_n, dut->mon_connect_peripheral, dut->mon_data_to_write);
+    bus_rules.sample(cycle++, dut->mon_read_n, dut->mon_read_complete,
+                     dut->mon_connect_peripheral, dut->mon_data_from_read);
 }
 
 int main(int argc, char **argv) {
     contextp = new VerilatedContext;
     contextp->commandArgs(argc, argv);
+    const char *profile_path = nullptr;
+    const char *uart_path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--mmio-profile") && i + 1 < argc) profile_path = argv[++i];
+        else if (!strcmp(argv[i], "--uart-file") && i + 1 < argc) uart_path = argv[++i];
+    }
+    FILE *uart_file = nullptr;
+    if (uart_path && !(uart_file = fopen(uart_path, "wb"))) {
+        printf("[FAIL] cannot write %s\n", uart_path);
+        return 1;
+    }
+    uart.set_file(uart_file);
 
     dut = new Vcov_project_wrap{contextp};
 
@@ -96,7 +87,7 @@ int main(int argc, char **argv) {
     // Run until we see 26 UART bytes (full POST output) or timeout
     // POST takes ~75M cycles at 25MHz. Verilator is fast enough.
     const uint64_t MAX_CYCLES = 80000000ULL;  // 80M cycles safety margin
-    const int EXPECTED_CHARS = 26;
+    const uint64_t EXPECTED_CHARS = 26;
 
     // Early diagnostic: check DUT is generating SPI clock activity
     int spi_clk_transitions = 0;
@@ -118,28 +109,29 @@ int main(int argc, char **argv) {
         }
 
         // Check for completion every 1M cycles to avoid overhead
-        if ((cyc & 0xFFFFF) == 0 && uart_idx >= EXPECTED_CHARS) {
+        if ((cyc & 0xFFFFF) == 0 && uart.total() >= EXPECTED_CHARS) {
             printf("\nPOST complete after ~%lluM cycles.\n", (unsigned long long)(cyc / 1000000));
             break;
         }
 
         // Print progress every 10M cycles
         if ((cyc % 10000000) == 0 && cyc > 0) {
-            printf("  ... %lluM cycles, %d UART bytes, uo_out=0x%02X\n",
-                   (unsigned long long)(cyc / 1000000), uart_idx, dut->uo_out);
+            printf("  ... %lluM cycles, %llu UART bytes, uo_out=0x%02X\n",
+                   (unsigned long long)(cyc / 1000000), (unsigned long long)uart.total(), dut->uo_out);
         }
     }
 
-    printf("\n--- Received %d UART bytes ---\n", uart_idx);
+    printf("\n--- Received %llu UART bytes, %llu framing errors ---\n",
+           (unsigned long long)uart.total(), (unsigned long long)uart.framing_errors);
+    if (uart_file) fclose(uart_file);
 
     // Verify POST results
     int pass = 0, fail = 0;
 
     // Check banner "POST\n"
-    if (uart_idx >= 5 &&
-        uart_buf[0] == 'P' && uart_buf[1] == 'O' &&
-        uart_buf[2] == 'S' && uart_buf[3] == 'T' &&
-        uart_buf[4] == '\n') {
+    if (uart.at(0) == 'P' && uart.at(1) == 'O' &&
+        uart.at(2) == 'S' && uart.at(3) == 'T' &&
+        uart.at(4) == '\n') {
         printf("[PASS] Banner: POST\\n\n");
         pass++;
     } else {
@@ -149,8 +141,7 @@ int main(int argc, char **argv) {
 
     // Check 2-char pairs
     auto check2 = [&](int idx, char tag, char val, const char *name) {
-        if (uart_idx > idx + 1 &&
-            uart_buf[idx] == (uint8_t)tag && uart_buf[idx+1] == (uint8_t)val) {
+        if (uart.at(idx) == tag && uart.at(idx + 1) == val) {
             printf("[PASS] %s: %c%c\n", name, tag, val);
             pass++;
         } else {
@@ -170,9 +161,8 @@ int main(int argc, char **argv) {
     check2(21, 'R', '1', "RTC");
 
     // Check "DN\n"
-    if (uart_idx >= 26 &&
-        uart_buf[23] == 'D' && uart_buf[24] == 'N' &&
-        uart_buf[25] == '\n') {
+    if (uart.at(23) == 'D' && uart.at(24) == 'N' &&
+        uart.at(25) == '\n') {
         printf("[PASS] Completion: DN\\n\n");
         pass++;
     } else {
@@ -180,6 +170,20 @@ int main(int argc, char **argv) {
         fail++;
     }
 
+    if (bus_rules.report()) {
+        printf("[PASS] RULE A/B: read data stable until read_complete\n");
+        pass++;
+    } else {
+        printf("[FAIL] RULE A/B: %llu violations\n", (unsigned long long)bus_rules.violations);
+        fail++;
+    }
+
+    mmio_profile.report();
+    if (profile_path && !mmio_profile.write_json(profile_path, "fw_post.hex")) {
+        printf("[FAIL] cannot write %s\n", profile_path);
+        fail++;
+    }
+
     printf("\n=== Results: %d PASS, %d FAIL ===\n", pass, fail);
 
     // Finalize and write coverage
@@ -189,5 +193,6 @@ int main(int argc, char **argv) {
 
     delete dut;
     delete contextp;
+    printf("[PERF] %llu cycles\n", (unsigned long long)(cycle));
     return (fail == 0) ? 0 : 1;
 }
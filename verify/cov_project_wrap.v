@@ -13,7 +13,16 @@ module cov_project_wrap (
     input  wire       rst_n,
     output wire [7:0] uo_out,
     output wire [7:0] uio_out,
-    output wire [7:0] uio_oe
+    output wire [7:0] uio_oe,
+
+    // project.v bus taps for the RULE A/B monitor (bus_rules.h) and the
+    // MMIO profiler (mmio_profile.h)
+    output wire [1:0]  mon_read_n,
+    output wire [1:0]  mon_write_n,
+    output wire        mon_read_complete,
+    output wire [4:0]  mon_connect_peripheral,
+    output wire [31:0] mon_data_to_write,
+    output wire [31:0] mon_data_from_read
 );
 
     // TT interface signals
@@ -150,4 +159,14 @@ module cov_project_wrap (
         ui_in[7] = 1'b1;       // UART RX - tie high (idle)
     end
 
+    // ================================================================
+    // Bus taps
+    // ================================================================
+    assign mon_read_n             = dut.read_n;
+    assign mon_write_n            = dut.write_n;
+    assign mon_read_complete      = dut.read_complete;
+    assign mon_connect_peripheral = dut.connect_peripheral;
+    assign mon_data_to_write      = dut.data_to_write;
+    assign mon_data_from_read     = dut.data_from_read;
+
 endmodule
@@ -149,5 +149,6 @@ int main(int argc, char **argv) {
     }
 
     delete dut;
+    printf("[PERF] %llu cycles\n", (unsigned long long)(sim_time / 2));
     return fail_count;
 }
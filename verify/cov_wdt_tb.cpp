@@ -204,5 +204,6 @@ int main(int argc, char **argv) {
     dut->final();
     delete dut;
 
+    printf("[PERF] %llu cycles\n", (unsigned long long)(sim_time / 2));
     return (fail > 0) ? 1 : 0;
 }
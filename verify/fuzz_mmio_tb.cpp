@@ -0,0 +1,246 @@
+// fuzz_mmio_tb.cpp — Coverage-guided fuzzing of the MMIO interface
+//
+// libFuzzer target on the Verilated SoC (rand_mmio_wrap.v, tinyQV data bus
+// forced to the harness). Each input is decoded into a sequence of MMIO
+// transactions and pin changes, run in-process on one model that is reset
+// through rst_n between inputs (no process or model construction per exec).
+//
+// Feedback: the model is built with Verilator --coverage-line and
+// --coverage-toggle and compiled with -fsanitize=fuzzer. Every Verilator
+// coverage point becomes a conditional counter increment in the generated
+// C++, so SanitizerCoverage sees each line/branch and toggle point as an
+// edge; libFuzzer keeps inputs that reach new ones. The Verilator counters
+// themselves are written to coverage.dat at exit (verilator_coverage).
+//
+// Invariants, checked every clock from the mon_* taps (abort = crash input):
+//   I1  mono_count never decreases and steps by at most +1 (seal P1)
+//   I2  every sealed record's CRC matches CRC16-MODBUS over
+//       {sensor_id, value, mono} (gen_seal_golden.py), whatever the CPU did
+//       to CRC16 while the seal owned the engine
+//   I3  WDT enabled stays set until the SoC resets (wdt P5)
+//   I4  an enabled WDT that reached 0 resets the SoC within 64 clocks
+//
+// Input encoding (one opcode byte, then operands):
+//   op[7:5] 0  write slot op[3:0], 1 data byte        4  read without read_complete
+//           1  write, 2 data bytes (I2C commands)     5  idle 1..256 clocks
+//           2  write, 4 data bytes                    6  ui_in = next byte
+//           3  read slot op[3:0]                      7  idle 16..4096 clocks
+//   op[4] selects latch_mem (0x4000000 + slot) instead of MMIO for 0-4.
+// SYSINFO 0xA5 and WDT expiry are allowed: the invariants restart with the
+// SoC reset.
+//
+// Build and run: see docs/verification.md §2.11. Without libFuzzer
+// (-DFUZZ_MMIO_MAIN) the binary replays the input files given on the
+// command line, e.g. a crash-* file.
+
+#include "Vrand_mmio_wrap.h"
+#include "verilated.h"
+#include "verilated_cov.h"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+static Vrand_mmio_wrap *dut;
+static VerilatedContext *contextp;
+static uint64_t cycle;
+
+static const uint32_t MMIO_BASE = 0x8000000;
+static const uint32_t LMEM_BASE = 0x4000000;
+static const uint64_t MAX_CYCLES = 60000;   // per input, keeps exec/s high
+static const int      WDT_RESET_CLKS = 64;
+
+// ================================================================
+// Invariants
+// ================================================================
+static uint16_t crc16_modbus(const uint8_t *p, int n) {
+    uint16_t c = 0xFFFF;
+    for (int i = 0; i < n; i++) {
+        c ^= p[i];
+        for (int b = 0; b < 8; b++) c = (c & 1) ? (uint16_t)((c >> 1) ^ 0xA001) : (uint16_t)(c >> 1);
+    }
+    return c;
+}
+
+static bool     inv_valid = false;          // previous sample is from the same reset epoch
+static uint32_t prev_mono = 0;
+static bool     prev_wdt_en = false;
+static int      wdt_zero_clks = 0;
+static uint64_t seals = 0, soc_resets = 0;
+
+static void fail(const char *what) {
+    printf("[FAIL] cycle %llu: %s\n", (unsigned long long)cycle, what);
+    printf("       mono_count %u, sealed {sid %02x value %08x mono %08x crc %04x}, "
+           "wdt en %d counter %u\n",
+           dut->mon_mono_count, dut->mon_seal_sensor_id, dut->mon_sealed_value,
+           dut->mon_sealed_mono, dut->mon_sealed_crc, dut->mon_wdt_enabled,
+           dut->mon_wdt_counter);
+    fflush(stdout);
+    abort();
+}
+
+static void check_invariants() {
+    if (!dut->rst_reg_n) {
+        if (inv_valid) soc_resets++;
+        inv_valid = false;
+        return;
+    }
+    uint32_t mono = dut->mon_mono_count;
+    bool wdt_en = dut->mon_wdt_enabled;
+    if (inv_valid) {
+        // I1
+        if (mono != prev_mono && mono != prev_mono + 1) fail("I1 mono_count moved by other than +1");
+        // I2: the record latches on the same edge as mono_count++
+        if (mono == prev_mono + 1) {
+            uint8_t b[9];
+            uint32_t v = dut->mon_sealed_value, m = dut->mon_sealed_mono;
+            b[0] = dut->mon_seal_sensor_id;
+            for (int i = 0; i < 4; i++) b[1 + i] = (uint8_t)(v >> (8 * i));
+            for (int i = 0; i < 4; i++) b[5 + i] = (uint8_t)(m >> (8 * i));
+            if (m != prev_mono) fail("I2 sealed mono is not the pre-commit mono_count");
+            if (crc16_modbus(b, 9) != dut->mon_sealed_crc) fail("I2 sealed CRC corrupted");
+            seals++;
+        }
+        // I3
+        if (prev_wdt_en && !wdt_en) fail("I3 WDT disabled while enabled");
+    }
+    // I4
+    if (wdt_en && dut->mon_wdt_counter == 0) {
+        if (++wdt_zero_clks > WDT_RESET_CLKS) fail("I4 WDT expired without resetting the SoC");
+    } else {
+        wdt_zero_clks = 0;
+    }
+    prev_mono = mono;
+    prev_wdt_en = wdt_en;
+    inv_valid = true;
+}
+
+// ================================================================
+// Bus master (tb_project.v timing, see rand_mmio_tb.cpp)
+// ================================================================
+static void tick() {
+    dut->clk = 0;
+    contextp->timeInc(1);
+    dut->eval();
+    dut->clk = 1;
+    contextp->timeInc(1);
+    dut->eval();
+    cycle++;
+    check_invariants();
+}
+
+static void bus_write(uint32_t addr, uint32_t data) {
+    dut->drv_addr = addr;
+    dut->drv_data = data;
+    dut->drv_write_n = 2;
+    tick();
+    dut->drv_write_n = 3;
+    tick();
+}
+
+static void bus_read(uint32_t addr, bool complete) {
+    dut->drv_addr = addr;
+    dut->drv_read_n = 2;
+    dut->drv_read_complete = complete;
+    tick();
+    dut->drv_read_complete = 0;
+    dut->drv_read_n = 3;
+    tick();
+}
+
+static void soc_reset() {
+    dut->drv_write_n = 3;
+    dut->drv_read_n = 3;
+    dut->drv_read_complete = 0;
+    dut->ui_in = 0x88;                      // UART RX idle, SDA released
+    dut->rst_n = 0;
+    for (int i = 0; i < 4; i++) tick();
+    dut->rst_n = 1;
+    for (int i = 0; i < 200 && !dut->rst_reg_n; i++) tick();
+}
+
+// ================================================================
+// libFuzzer entry points
+// ================================================================
+static void write_coverage() {
+    VerilatedCov::write("coverage.dat");
+}
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv) {
+    contextp = new VerilatedContext;
+    contextp->commandArgs(*argc, *argv);
+    dut = new Vrand_mmio_wrap{contextp};
+    dut->clk = 0;
+    atexit(write_coverage);
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    size_t pos = 0;
+    auto next = [&]() -> uint8_t { return pos < size ? data[pos++] : 0; };
+
+    soc_reset();
+    uint64_t end = cycle + MAX_CYCLES;
+    while (pos < size && cycle < end) {
+        uint8_t op = next();
+        uint32_t slot = op & 0xF;
+        uint32_t addr = (op & 0x10) ? LMEM_BASE + slot * 2 : MMIO_BASE + slot * 4;
+        uint32_t d;
+        switch (op >> 5) {
+        case 0:
+            bus_write(addr, next());
+            break;
+        case 1:
+            d = next();
+            bus_write(addr, d | (uint32_t)next() << 8);
+            break;
+        case 2:
+            d = next();
+            d |= (uint32_t)next() << 8;
+            d |= (uint32_t)next() << 16;
+            bus_write(addr, d | (uint32_t)next() << 24);
+            break;
+        case 3:
+            bus_read(addr, true);
+            break;
+        case 4:
+            bus_read(addr, false);
+            break;
+        case 5:
+            for (int n = next(); n >= 0; n--) tick();
+            break;
+        case 6:
+            dut->ui_in = next();
+            tick();
+            break;
+        case 7:
+            for (int n = (next() + 1) * 16; n > 0 && cycle < end; n--) tick();
+            break;
+        }
+    }
+    return 0;
+}
+
+#ifdef FUZZ_MMIO_MAIN
+// Replay: ./fuzz_mmio_tb crash-1234 ...
+int main(int argc, char **argv) {
+    LLVMFuzzerInitialize(&argc, &argv);
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '+' || argv[i][0] == '-') continue;
+        FILE *f = fopen(argv[i], "rb");
+        if (!f) {
+            printf("[FAIL] cannot read %s\n", argv[i]);
+            return 1;
+        }
+        static uint8_t buf[1 << 20];
+        size_t n = fread(buf, 1, sizeof(buf), f);
+        fclose(f);
+        LLVMFuzzerTestOneInput(buf, n);
+        printf("[PASS] %s: %zu bytes, %llu cycles\n", argv[i], n, (unsigned long long)cycle);
+    }
+    printf("%llu seals checked, %llu SoC resets\n", (unsigned long long)seals,
+           (unsigned long long)soc_resets);
+    return 0;
+}
+#endif
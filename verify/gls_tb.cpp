@@ -0,0 +1,215 @@
+// gls_tb.cpp — Gate-level (or RTL) firmware run on the Verilated board
+//
+// Boots the image baked into gls_wrap.v (-GHEX_FILE) and decodes UART TX
+// (uo_out[0], 217 clocks/bit). Every received byte is stamped with the
+// clock cycle at which its stop bit was sampled, so an RTL run and a
+// gate-level run of the same image can be compared byte for byte and
+// cycle for cycle: the netlist is the same synchronous design, so any
+// difference is a synthesis/PnR (or cell model) bug, not timing noise.
+//
+//   --expect S      UART signature, stop as soon as it is seen
+//                   (default: fw_post's full POST line)
+//   --max-cycles N  give up after N clocks
+//   --uart-log F    write "cycle byte" lines to F
+//   --ref F         compare against a --uart-log from another run (RTL)
+//
+// Build and run: see docs/verification.md §2.12 (scripts/gls_verilator.sh
+// builds both variants and does the comparison).
+
+#include "Vgls_wrap.h"
+#include "verilated.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static Vgls_wrap *dut;
+static VerilatedContext *contextp;
+static uint64_t cycle;
+
+// ================================================================
+// UART receiver (same as cov_project_tb.cpp, 217 clocks/bit)
+// ================================================================
+static const int UART_BIT_CLKS = 217;
+static int uart_bit_cnt = -1;
+static int uart_clk_cnt = 0;
+static uint8_t uart_shift = 0;
+static uint8_t uart_prev_txd = 1;
+static std::string uart_buf;
+
+struct UartByte {
+    uint64_t cycle;
+    uint8_t  value;
+};
+static std::vector<UartByte> uart_log;
+
+static void uart_sample(uint8_t txd) {
+    uint8_t start_edge = uart_prev_txd && !txd;
+    uart_prev_txd = txd;
+
+    if (uart_bit_cnt == -1) {
+        if (start_edge) {
+            uart_bit_cnt = 0;
+            uart_clk_cnt = UART_BIT_CLKS + (UART_BIT_CLKS / 2);
+        }
+        return;
+    }
+    if (uart_clk_cnt > 0) {
+        uart_clk_cnt--;
+        return;
+    }
+    uart_clk_cnt = UART_BIT_CLKS;
+    if (uart_bit_cnt < 8) {
+        uart_shift = (uart_shift >> 1) | (txd << 7);
+        uart_bit_cnt++;
+    } else {
+        uart_buf += (char)uart_shift;
+        uart_log.push_back({cycle, uart_shift});
+        uart_bit_cnt = -1;
+    }
+}
+
+static void tick() {
+    dut->clk = 0;
+    contextp->timeInc(1);
+    dut->eval();
+    dut->clk = 1;
+    contextp->timeInc(1);
+    dut->eval();
+    cycle++;
+    uart_sample(dut->uo_out & 1);
+}
+
+static std::string unescape(const char *s) {
+    std::string r;
+    for (; *s; s++) {
+        if (s[0] == '\\' && s[1] == 'n') { r += '\n'; s++; }
+        else r += *s;
+    }
+    return r;
+}
+
+static std::string printable(uint8_t c) {
+    char b[8];
+    if (c == '\n') return "\\n";
+    if (c >= 0x20 && c < 0x7F) { b[0] = (char)c; b[1] = 0; }
+    else snprintf(b, sizeof(b), "\\x%02x", c);
+    return b;
+}
+
+static bool load_log(const char *path, std::vector<UartByte> &out) {
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+    unsigned long long cyc;
+    unsigned val;
+    while (fscanf(f, "%llu %x", &cyc, &val) == 2) out.push_back({cyc, (uint8_t)val});
+    fclose(f);
+    return true;
+}
+
+// Returns the number of differences, printing the first few
+static int compare_logs(const std::vector<UartByte> &ref) {
+    int diffs = 0;
+    size_t n = ref.size() > uart_log.size() ? ref.size() : uart_log.size();
+    for (size_t i = 0; i < n; i++) {
+        bool have_r = i < ref.size(), have_u = i < uart_log.size();
+        if (have_r && have_u && ref[i].cycle == uart_log[i].cycle && ref[i].value == uart_log[i].value)
+            continue;
+        if (diffs++ < 8) {
+            printf("  byte %zu: ref ", i);
+            if (have_r) printf("'%s' @%llu", printable(ref[i].value).c_str(), (unsigned long long)ref[i].cycle);
+            else printf("(none)");
+            printf(", this ");
+            if (have_u) printf("'%s' @%llu", printable(uart_log[i].value).c_str(), (unsigned long long)uart_log[i].cycle);
+            else printf("(none)");
+            printf("\n");
+        }
+    }
+    return diffs;
+}
+
+int main(int argc, char **argv) {
+    std::string expect = "POST\nY1C1T1W1I1L1L2M1R1DN\n";
+    uint64_t max_cycles = 20000000ULL;
+    const char *log_path = nullptr, *ref_path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--expect") && i + 1 < argc) expect = unescape(argv[++i]);
+        else if (!strcmp(argv[i], "--max-cycles") && i + 1 < argc) max_cycles = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--uart-log") && i + 1 < argc) log_path = argv[++i];
+        else if (!strcmp(argv[i], "--ref") && i + 1 < argc) ref_path = argv[++i];
+    }
+
+    std::vector<UartByte> ref;
+    if (ref_path && !load_log(ref_path, ref)) {
+        printf("[FAIL] cannot read %s\n", ref_path);
+        return 1;
+    }
+
+    contextp = new VerilatedContext;
+    contextp->commandArgs(argc, argv);
+    dut = new Vgls_wrap{contextp};
+
+    printf("=== LoRa Edge SoC — firmware run (%s) ===\n",
+#ifdef GL_TEST
+           "gate level"
+#else
+           "RTL"
+#endif
+    );
+
+    auto t0 = std::chrono::steady_clock::now();
+    dut->rst_n = 0;
+    dut->clk = 0;
+    for (int i = 0; i < 20; i++) tick();
+    dut->rst_n = 1;
+
+    while (cycle < max_cycles && uart_buf.find(expect) == std::string::npos) tick();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    dut->final();
+
+    printf("%llu cycles in %.1f s (%.3f Mcycles/s), %zu UART bytes\n", (unsigned long long)cycle,
+           secs, secs > 0 ? cycle / secs / 1e6 : 0.0, uart_log.size());
+
+    if (log_path) {
+        FILE *f = fopen(log_path, "w");
+        if (!f) {
+            printf("[FAIL] cannot write %s\n", log_path);
+            return 1;
+        }
+        for (const UartByte &b : uart_log)
+            fprintf(f, "%llu %02x\n", (unsigned long long)b.cycle, b.value);
+        fclose(f);
+    }
+
+    int pass = 0, fail = 0;
+    if (uart_buf.find(expect) != std::string::npos) {
+        printf("[PASS] UART signature\n");
+        pass++;
+    } else {
+        std::string got;
+        for (char c : uart_buf) got += printable((uint8_t)c);
+        printf("[FAIL] UART signature after %llu cycles: \"%s\"\n", (unsigned long long)cycle, got.c_str());
+        fail++;
+    }
+    if (ref_path) {
+        int diffs = compare_logs(ref);
+        if (diffs == 0) {
+            printf("[PASS] UART bytes and cycles match %s (%zu bytes)\n", ref_path, ref.size());
+            pass++;
+        } else {
+            printf("[FAIL] %d UART byte(s) differ from %s\n", diffs, ref_path);
+            fail++;
+        }
+    }
+
+    printf("\n=== Results: %d PASS, %d FAIL ===\n", pass, fail);
+    if (fail == 0) printf("ALL TESTS PASSED\n");
+
+    delete dut;
+    delete contextp;
+    return fail == 0 ? 0 : 1;
+}
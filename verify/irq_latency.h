@@ -0,0 +1,150 @@
+// irq_latency.h — IRQ16/17/18 latency histograms for cosim_tb
+//
+// Latency through tinyQV is the sum of the interrupt_req synchroniser,
+// mip edge capture, waiting for the current instruction (a PSRAM load can
+// take tens of cycles), the flash fetch of the vector and the register
+// saves in _irq_handler. For every source edge the harness reports
+//   edge(line, cycle)       rising edge at the source: ui_in[0] (DIO1,
+//                           IRQ16), timer_irq (IRQ17), uart_rx_valid (IRQ18)
+//   entered(line, cycle)    the instruction at the interrupt vector (0x8)
+//                           retired (debug_instr_complete) for that cause
+//   mmio(cycle)             data-bus cycle of the first MMIO access after
+//                           entry (the handler reading/clearing its source)
+// and IrqLatency keeps two samples per serviced interrupt: edge -> entry
+// and edge -> first MMIO. The earliest pending edge of the line is used;
+// later edges that arrive before entry are folded into the same service
+// (edge-captured mip bits merge them too) and counted as coalesced.
+//
+// report() prints count/min/mean/p50/p99/max and a histogram per line and
+// kind; write_csv() dumps the raw samples.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+class IrqLatency {
+public:
+    static const int    LINES = 3;              // IRQ16..IRQ18
+    static const size_t MAX_PENDING = 4096;     // per line, oldest dropped
+
+    struct Sample {
+        int      line;
+        uint64_t edge, entry, mmio;             // mmio = 0: none seen
+    };
+    std::vector<Sample> samples;
+    uint64_t coalesced[LINES] = {};
+    uint64_t dropped[LINES] = {};
+    uint64_t no_edge[LINES] = {};               // entry without a recorded edge
+
+    void edge(int line, uint64_t cycle) {
+        std::deque<uint64_t> &q = pending[line];
+        if (q.size() >= MAX_PENDING) {
+            q.pop_front();
+            dropped[line]++;
+        }
+        q.push_back(cycle);
+    }
+
+    void entered(int line, uint64_t cycle) {
+        std::deque<uint64_t> &q = pending[line];
+        if (q.empty() || q.front() >= cycle) {
+            no_edge[line]++;
+            awaiting = -1;
+            return;
+        }
+        uint64_t first = q.front();
+        q.pop_front();
+        while (!q.empty() && q.front() < cycle) {
+            q.pop_front();
+            coalesced[line]++;
+        }
+        samples.push_back({line, first, cycle, 0});
+        awaiting = (int)samples.size() - 1;
+    }
+
+    void mmio(uint64_t cycle) {
+        if (awaiting < 0) return;
+        samples[awaiting].mmio = cycle;
+        awaiting = -1;
+    }
+
+    // Core reset: pending edges are lost with the core state
+    void reset() {
+        for (std::deque<uint64_t> &q : pending) q.clear();
+        awaiting = -1;
+    }
+
+    void report(uint64_t bin) const {
+        if (!bin) bin = 1;
+        for (int line = 0; line < LINES; line++) {
+            std::vector<uint64_t> entry, first_mmio;
+            for (const Sample &s : samples) {
+                if (s.line != line) continue;
+                entry.push_back(s.entry - s.edge);
+                if (s.mmio) first_mmio.push_back(s.mmio - s.edge);
+            }
+            size_t unserviced = pending[line].size();
+            if (entry.empty() && !unserviced && !no_edge[line]) continue;
+            printf("[IRQ] IRQ%d (%s): %zu serviced, %llu coalesced, %zu unserviced, %llu without edge\n",
+                   16 + line, source_name(line), entry.size(), (unsigned long long)coalesced[line],
+                   unserviced + dropped[line], (unsigned long long)no_edge[line]);
+            histogram("edge->entry", entry, bin);
+            histogram("edge->mmio", first_mmio, bin);
+        }
+    }
+
+    bool write_csv(const char *path) const {
+        FILE *f = fopen(path, "w");
+        if (!f) return false;
+        fprintf(f, "irq,edge_cycle,entry_cycle,mmio_cycle,entry_latency,mmio_latency\n");
+        for (const Sample &s : samples) {
+            fprintf(f, "%d,%llu,%llu,", 16 + s.line, (unsigned long long)s.edge, (unsigned long long)s.entry);
+            if (s.mmio)
+                fprintf(f, "%llu,%llu,%llu\n", (unsigned long long)s.mmio,
+                        (unsigned long long)(s.entry - s.edge), (unsigned long long)(s.mmio - s.edge));
+            else
+                fprintf(f, ",%llu,\n", (unsigned long long)(s.entry - s.edge));
+        }
+        fclose(f);
+        return true;
+    }
+
+    static const char *source_name(int line) {
+        static const char *const names[LINES] = {"DIO1 ui_in[0]", "timer_irq", "uart_rx_valid"};
+        return names[line];
+    }
+
+private:
+    std::deque<uint64_t> pending[LINES];
+    int awaiting = -1;
+
+    static void histogram(const char *what, std::vector<uint64_t> v, uint64_t bin) {
+        if (v.empty()) return;
+        std::sort(v.begin(), v.end());
+        uint64_t sum = 0;
+        for (uint64_t x : v) sum += x;
+        printf("[IRQ]   %-11s n=%zu min=%llu mean=%.1f p50=%llu p99=%llu max=%llu cycles\n", what, v.size(),
+               (unsigned long long)v.front(), (double)sum / v.size(), (unsigned long long)v[v.size() / 2],
+               (unsigned long long)v[(v.size() * 99) / 100], (unsigned long long)v.back());
+        size_t peak = 0;
+        for (size_t i = 0; i < v.size();) {
+            size_t j = i;
+            while (j < v.size() && v[j] / bin == v[i] / bin) j++;
+            peak = std::max(peak, j - i);
+            i = j;
+        }
+        for (size_t i = 0; i < v.size();) {
+            size_t j = i;
+            while (j < v.size() && v[j] / bin == v[i] / bin) j++;
+            uint64_t lo = v[i] / bin * bin;
+            int bar = (int)((j - i) * 40 / peak);
+            printf("[IRQ]     %6llu-%-6llu %6zu %.*s\n", (unsigned long long)lo, (unsigned long long)(lo + bin - 1),
+                   j - i, bar ? bar : 1, "########################################");
+            i = j;
+        }
+    }
+};
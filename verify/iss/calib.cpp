@@ -0,0 +1,221 @@
+// calib.cpp — Calibrate the QSPI timing model against RTL cycle traces
+//
+// Usage: calib [options] trace.tqt...
+//   --syms FILE        nm listing for function names (one per trace, in order)
+//   --fit              tune SocTiming to minimise the per-function error
+//   --tolerance PCT    fail if any function above 1% of the cycles is off by
+//                      more than PCT percent (default 5)
+//   --top N            functions listed per trace (default 12)
+//
+// Traces come from cosim_tb --timing-trace (RTL cycles per instruction) or
+// iss --timing-trace (model cycles, i.e. a self-check). Each trace is replayed
+// through QspiTiming; cycles are summed per function for both and compared.
+
+#include "qspi_timing.h"
+#include "func_profile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Trace {
+    std::string path;
+    std::vector<TimingTraceRec> recs;
+    FuncProfile rtl;            // measured, fixed
+    FuncProfile model;          // refreshed by replay()
+    uint64_t rtl_total;
+    uint64_t model_total;
+};
+
+static bool read_trace(const char *path, Trace &t) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    uint32_t magic = 0;
+    if (fread(&magic, 4, 1, f) != 1 || magic != TIMING_TRACE_MAGIC) {
+        fclose(f);
+        return false;
+    }
+    TimingTraceRec r;
+    while (fread(&r, sizeof(r), 1, f) == 1) t.recs.push_back(r);
+    fclose(f);
+
+    t.path = path;
+    t.rtl_total = 0;
+    for (const TimingTraceRec &r : t.recs) {
+        if (r.flags & TT_RESET) t.rtl.reset();
+        t.rtl.retire(timing_trace_unpack(r), r.cycles);
+        t.rtl_total += r.cycles;
+    }
+    return true;
+}
+
+static void replay(Trace &t, const SocTiming &timing) {
+    QspiTiming q;
+    q.t = timing;
+    t.model = FuncProfile();
+
+    uint64_t now = 0;
+    for (const TimingTraceRec &r : t.recs) {
+        if (r.flags & TT_RESET) {
+            q.reset(now);
+            t.model.reset();
+        }
+        Rv32Retire ret = timing_trace_unpack(r);
+        uint32_t c = q.retire(ret, now);
+        t.model.retire(ret, c);
+        now += c;
+    }
+    t.model_total = now;
+}
+
+// Sum of per-function absolute cycle errors, relative to the RTL total
+static double cost(const std::vector<Trace> &traces) {
+    double e = 0;
+    for (const Trace &t : traces) {
+        uint64_t sum = 0;
+        for (const auto &kv : t.rtl.funcs) {
+            auto m = t.model.funcs.find(kv.first);
+            uint64_t mc = m == t.model.funcs.end() ? 0 : m->second.cycles;
+            sum += mc > kv.second.cycles ? mc - kv.second.cycles : kv.second.cycles - mc;
+        }
+        e += t.rtl_total ? (double)sum / t.rtl_total : 0;
+    }
+    return e;
+}
+
+// Integer coordinate descent: single-parameter moves of 1..8, then paired
+// moves that trade one parameter against another (fetch vs execute cost are
+// strongly correlated, so single moves alone stall in local minima).
+static void fit(std::vector<Trace> &traces, SocTiming &timing) {
+    auto eval = [&](const SocTiming &s) {
+        for (Trace &t : traces) replay(t, s);
+        return cost(traces);
+    };
+    auto valid = [](SocTiming &s) {
+        for (int i = 0; i < SocTiming::N_PARAMS; i++)
+            if ((int32_t)s.param(i) < 0 || s.param(i) > 256) return false;
+        return s.clk_per_byte_fetch > 0;
+    };
+    static const int STEPS[] = {1, -1, 2, -2, 4, -4, 8, -8};
+
+    double best = eval(timing);
+    printf("Fitting %d parameters, start cost %.4f\n", SocTiming::N_PARAMS, best);
+    for (int pass = 0; pass < 100; pass++) {
+        SocTiming cand = timing;
+        double cand_cost = best;
+        for (int i = 0; i < SocTiming::N_PARAMS; i++)
+            for (int d : STEPS) {
+                SocTiming s = timing;
+                s.param(i) += d;
+                if (!valid(s)) continue;
+                double c = eval(s);
+                if (c < cand_cost - 1e-9) { cand = s; cand_cost = c; }
+            }
+        if (cand_cost >= best - 1e-9) {
+            for (int i = 0; i < SocTiming::N_PARAMS; i++)
+                for (int j = 0; j < SocTiming::N_PARAMS; j++) {
+                    if (i == j) continue;
+                    for (int d = 1; d <= 2; d++) {
+                        SocTiming s = timing;
+                        s.param(i) += d;
+                        s.param(j) -= d;
+                        if (!valid(s)) continue;
+                        double c = eval(s);
+                        if (c < cand_cost - 1e-9) { cand = s; cand_cost = c; }
+                    }
+                }
+        }
+        if (cand_cost >= best - 1e-9) break;
+        timing = cand;
+        best = cand_cost;
+    }
+    printf("Fitted cost %.4f:\n", best);
+    timing.print(stdout);
+    printf("\n");
+    for (Trace &t : traces) replay(t, timing);
+}
+
+static double pct(uint64_t model, uint64_t rtl) {
+    return rtl ? 100.0 * ((double)model - (double)rtl) / rtl : 0.0;
+}
+
+static bool report(const Trace &t, double tolerance, int top) {
+    printf("--- %s: %zu instructions, RTL %llu cycles, model %llu cycles (%+.2f%%) ---\n",
+           t.path.c_str(), t.recs.size(), (unsigned long long)t.rtl_total,
+           (unsigned long long)t.model_total, pct(t.model_total, t.rtl_total));
+
+    std::vector<std::pair<uint64_t, uint32_t>> order;
+    for (const auto &kv : t.rtl.funcs) order.push_back({kv.second.cycles, kv.first});
+    std::sort(order.rbegin(), order.rend());
+
+    printf("  %-24s %8s %10s %12s %12s %8s\n", "function", "calls", "insns", "rtl", "model", "error");
+    double worst = 0;
+    int shown = 0;
+    for (const auto &o : order) {
+        const FuncStats &r = t.rtl.funcs.at(o.second);
+        auto m = t.model.funcs.find(o.second);
+        uint64_t mc = m == t.model.funcs.end() ? 0 : m->second.cycles;
+        double e = pct(mc, r.cycles);
+        bool significant = r.cycles * 100 >= t.rtl_total;
+        if (significant && std::fabs(e) > std::fabs(worst)) worst = e;
+        if (shown++ < top)
+            printf("  %-24s %8llu %10llu %12llu %12llu %+7.2f%%%s\n",
+                   t.rtl.name(o.second).c_str(), (unsigned long long)r.calls,
+                   (unsigned long long)r.insns, (unsigned long long)r.cycles,
+                   (unsigned long long)mc, e, significant ? "" : " *");
+    }
+    bool ok = std::fabs(worst) <= tolerance;
+    printf("%s %s: total %+.2f%%, worst function %+.2f%% (tolerance %.1f%%)\n\n",
+           ok ? "[PASS]" : "[FAIL]", t.path.c_str(), pct(t.model_total, t.rtl_total),
+           worst, tolerance);
+    return ok;
+}
+
+static void usage() {
+    fprintf(stderr, "usage: calib [--syms FILE]... [--fit] [--tolerance PCT] [--top N] trace...\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    std::vector<const char *> paths, syms;
+    bool do_fit = false;
+    double tolerance = 5.0;
+    int top = 12;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--syms") && i + 1 < argc) syms.push_back(argv[++i]);
+        else if (!strcmp(argv[i], "--fit")) do_fit = true;
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc) tolerance = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--top") && i + 1 < argc) top = atoi(argv[++i]);
+        else if (argv[i][0] == '-') usage();
+        else paths.push_back(argv[i]);
+    }
+    if (paths.empty()) usage();
+
+    std::vector<Trace> traces(paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (!read_trace(paths[i], traces[i])) {
+            fprintf(stderr, "calib: cannot read trace %s\n", paths[i]);
+            return 2;
+        }
+        if (i < syms.size() && !traces[i].rtl.load_symbols(syms[i])) {
+            fprintf(stderr, "calib: cannot read symbols %s\n", syms[i]);
+            return 2;
+        }
+    }
+
+    printf("=== QSPI timing model calibration ===\n");
+    SocTiming timing;
+    if (do_fit) fit(traces, timing);
+    else for (Trace &t : traces) replay(t, timing);
+
+    int pass = 0, fail = 0;
+    for (const Trace &t : traces) (report(t, tolerance, top) ? pass : fail)++;
+
+    printf("=== Results: %d PASS, %d FAIL ===\n", pass, fail);
+    if (fail == 0) printf("ALL TESTS PASSED\n");
+    return fail == 0 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// func_profile.h — Per-function cycle accounting over a retired-instruction stream
+//
+// Functions are identified by call target: jal/jalr with rd = ra pushes the
+// target, ret (jalr x0, 0(ra) / c.jr ra) pops. Interrupt entry pushes the
+// 0x8 vector and mret pops it. Cycles are charged to the function on top
+// of the stack (self time); tail calls stay with the caller.
+//
+// Names come from an optional `nm` listing (riscv64-elf-nm fw.elf > fw.sym);
+// without one, functions are reported by address.
+
+#pragma once
+
+#include "rv32_core.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+struct FuncStats {
+    uint64_t calls  = 0;
+    uint64_t insns  = 0;
+    uint64_t cycles = 0;
+};
+
+class FuncProfile {
+public:
+    std::map<uint32_t, FuncStats> funcs;
+    std::map<uint32_t, std::string> names;
+
+    FuncProfile() { reset(); }
+
+    // Core reset: back in the reset vector, call stack empty
+    void reset() {
+        stack.assign(1, 0);
+        funcs[0].calls++;
+    }
+
+    void retire(const Rv32Retire &r, uint64_t cycles) {
+        if (r.cls == RV_IRQ) {
+            push(Rv32Core::VEC_IRQ);
+            charge(cycles);
+            return;
+        }
+        charge(cycles);
+        funcs[stack.back()].insns++;
+        if (r.trap) return;
+        if (r.cls == RV_JUMP && r.rd == 1) push(r.next_pc);
+        else if (is_return(r)) pop();
+    }
+
+    // Load `nm` output: "0000001c T main". Returns false if unreadable.
+    bool load_symbols(const char *path) {
+        FILE *f = fopen(path, "r");
+        if (!f) return false;
+        char line[256], type, name[200];
+        unsigned addr;
+        while (fgets(line, sizeof(line), f))
+            if (sscanf(line, "%x %c %199s", &addr, &type, name) == 3 &&
+                (type == 'T' || type == 't'))
+                names[addr] = name;
+        fclose(f);
+        return true;
+    }
+
+    std::string name(uint32_t addr) const {
+        auto it = names.find(addr);
+        if (it != names.end()) return it->second;
+        if (addr == 0) return "<reset>";
+        if (addr == Rv32Core::VEC_IRQ) return "<irq>";
+        char buf[16];
+        snprintf(buf, sizeof(buf), "fn_%05x", addr);
+        return buf;
+    }
+
+private:
+    std::vector<uint32_t> stack;
+
+    static bool is_return(const Rv32Retire &r) {
+        if (r.cls == RV_SYSTEM && r.insn == 0x30200073) return true;   // mret
+        if (r.cls != RV_JUMP) return false;
+        if (r.len == 2) return r.insn == 0x8082;                         // c.jr ra
+        return r.insn == 0x00008067;                                     // jalr x0, 0(ra)
+    }
+
+    void push(uint32_t target) {
+        if (stack.size() < 256) stack.push_back(target);
+        else stack.back() = target;
+        funcs[target].calls++;
+    }
+
+    void pop() {
+        if (stack.size() > 1) stack.pop_back();
+    }
+
+    void charge(uint64_t cycles) { funcs[stack.back()].cycles += cycles; }
+};
@@ -0,0 +1,393 @@
+// i2c_devices.cpp — Register-level I2C sensor/memory models and a shared bus
+
+#include "i2c_devices.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// ================================================================
+// Common device protocol
+// ================================================================
+void I2cDevice::start() {
+    selected = false;
+}
+
+bool I2cDevice::address(uint8_t a, bool rd) {
+    selected = reading = false;
+    pending_stretch = 0;
+    if (a != addr) return false;
+    transactions++;
+    if (busy()) {
+        if (busy_policy == BUSY_NACK) {
+            busy_nacks++;
+            nacks++;
+            return false;
+        }
+        if (busy_policy == BUSY_STRETCH) pending_stretch = busy_until - now;
+    }
+    if (!on_address(rd)) {
+        nacks++;
+        return false;
+    }
+    selected = true;
+    reading = rd;
+    return true;
+}
+
+bool I2cDevice::write(uint8_t b) {
+    if (!selected || reading) return false;
+    bytes_written++;
+    bool ack = on_write(b);
+    if (!ack) nacks++;
+    return ack;
+}
+
+uint8_t I2cDevice::read() {
+    if (!selected || !reading) return 0xFF;
+    // Still holding SCL, but the master clocked on: SDA is released
+    if (busy_policy == BUSY_STRETCH && busy()) {
+        stale_reads++;
+        return 0xFF;
+    }
+    bytes_read++;
+    return on_read();
+}
+
+void I2cDevice::stop() {
+    if (selected) on_stop();
+    selected = reading = false;
+}
+
+uint64_t I2cDevice::stretch() {
+    uint64_t s = pending_stretch;
+    pending_stretch = 0;
+    stretched += s;
+    return s;
+}
+
+// ================================================================
+// Bus
+// ================================================================
+void I2cBus::start() {
+    for (I2cDevice *d : devices) d->start();
+    cur = nullptr;
+}
+
+bool I2cBus::address(uint8_t a, bool rd) {
+    cur = nullptr;
+    for (I2cDevice *d : devices)
+        if (d->address(a, rd)) cur = d;
+    return cur != nullptr;
+}
+
+bool I2cBus::write(uint8_t b) { return cur ? cur->write(b) : false; }
+uint8_t I2cBus::read() { return cur ? cur->read() : 0xFF; }
+void I2cBus::read_ack(bool ack) { if (cur) cur->read_ack(ack); }
+
+void I2cBus::stop() {
+    for (I2cDevice *d : devices) d->stop();
+    cur = nullptr;
+}
+
+void I2cBus::advance(uint64_t now) {
+    for (I2cDevice *d : devices) d->advance(now);
+}
+
+uint64_t I2cBus::stretch() { return cur ? cur->stretch() : 0; }
+
+// ================================================================
+// SHT3x
+// ================================================================
+uint8_t Sht3xSlave::crc8(const uint8_t *p, int n) {
+    uint8_t crc = 0xFF;
+    for (int i = 0; i < n; i++) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; b++) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+void Sht3xSlave::command(uint16_t c) {
+    uint32_t meas_us = 0;
+    bool stretch_mode = false;
+    switch (c) {
+    case 0x2400: meas_us = 15000; break;            // repeatability high / medium / low
+    case 0x240B: meas_us = 6000;  break;
+    case 0x2416: meas_us = 4000;  break;
+    case 0x2C06: meas_us = 15000; stretch_mode = true; break;
+    case 0x2C0D: meas_us = 6000;  stretch_mode = true; break;
+    case 0x2C10: meas_us = 4000;  stretch_mode = true; break;
+    case 0xF32D: {                                  // read status
+        out[0] = (uint8_t)(status >> 8);
+        out[1] = (uint8_t)status;
+        out[2] = crc8(out, 2);
+        nout = 3;
+        return;
+    }
+    case 0x3041:                                    // clear status
+        status &= (uint16_t)~0x8C10;
+        return;
+    case 0x30A2:                                    // soft reset
+        status = 0x8010;
+        nout = 0;
+        if (!busy_policy_fixed) busy_policy = BUSY_NACK;
+        busy_until = now + us(1500);
+        return;
+    default:
+        status |= 0x0002;                           // command not processed
+        return;
+    }
+    double t = (temperature_c + 45.0) / 175.0 * 65535.0;
+    double h = humidity_pct / 100.0 * 65535.0;
+    uint16_t st = (uint16_t)std::lround(std::fmin(std::fmax(t, 0.0), 65535.0));
+    uint16_t srh = (uint16_t)std::lround(std::fmin(std::fmax(h, 0.0), 65535.0));
+    out[0] = (uint8_t)(st >> 8);
+    out[1] = (uint8_t)st;
+    out[2] = crc8(out, 2);
+    out[3] = (uint8_t)(srh >> 8);
+    out[4] = (uint8_t)srh;
+    out[5] = crc8(out + 3, 2);
+    nout = 6;
+    status &= (uint16_t)~0x0002;
+    if (!busy_policy_fixed) busy_policy = stretch_mode ? BUSY_STRETCH : BUSY_NACK;
+    busy_until = now + us(meas_us);
+}
+
+bool Sht3xSlave::on_address(bool rd) {
+    ncmd = 0;
+    idx = 0;
+    return !rd || nout > 0;     // read header NACKed while no data is available
+}
+
+bool Sht3xSlave::on_write(uint8_t b) {
+    cmd[ncmd++] = b;
+    if (ncmd == 2) {
+        command((uint16_t)((cmd[0] << 8) | cmd[1]));
+        ncmd = 0;
+    }
+    return true;
+}
+
+uint8_t Sht3xSlave::on_read() {
+    return idx < nout ? out[idx++] : 0xFF;
+}
+
+void Sht3xSlave::on_stop() {
+    if (reading && idx > 0) nout = 0;   // a result is read once
+}
+
+// ================================================================
+// BME280
+// ================================================================
+static const uint32_t BME_STANDBY_US[8] = { 500, 62500, 125000, 250000, 500000, 1000000, 10000, 20000 };
+
+static uint32_t oversampling(uint8_t code) {
+    static const uint8_t n[8] = { 0, 1, 2, 4, 8, 16, 16, 16 };
+    return n[code & 7];
+}
+
+Bme280Slave::Bme280Slave(uint8_t addr7, uint32_t cycles_per_us)
+    : I2cDevice("bme280", addr7, BUSY_IGNORE, cycles_per_us) {
+    power_on();
+}
+
+void Bme280Slave::power_on() {
+    memset(regs, 0, sizeof(regs));
+    regs[REG_ID] = 0x60;
+    // dig_T1..T3, dig_P1..P9 (0x88, little endian) and dig_H1..H6
+    static const int16_t cal[12] = { 27504, 26435, -1000, (int16_t)36477, -10685, 3024,
+                                     2855, 140, -7, 15500, -14600, 6000 };
+    for (int i = 0; i < 12; i++) {
+        regs[0x88 + 2 * i] = (uint8_t)cal[i];
+        regs[0x89 + 2 * i] = (uint8_t)(cal[i] >> 8);
+    }
+    regs[0xA1] = 75;                        // H1
+    regs[0xE1] = 362 & 0xFF;                // H2
+    regs[0xE2] = 362 >> 8;
+    regs[0xE3] = 0;                         // H3
+    regs[0xE4] = 313 >> 4;                  // H4 = E4 << 4 | E5[3:0]
+    regs[0xE5] = (313 & 0xF) | ((50 & 0xF) << 4);
+    regs[0xE6] = 50 >> 4;                   // H5 = E6 << 4 | E5[7:4]
+    regs[0xE7] = 30;                        // H6
+    // Data registers hold the "skipped" values until the first conversion
+    regs[0xF7] = 0x80;
+    regs[0xFA] = 0x80;
+    regs[0xFD] = 0x80;
+    ptr = 0;
+    have_ptr = false;
+    measuring = false;
+}
+
+uint64_t Bme280Slave::measure_us() const {
+    uint32_t t = oversampling(regs[REG_CTRL_MEAS] >> 5);
+    uint32_t p = oversampling(regs[REG_CTRL_MEAS] >> 2);
+    uint32_t h = oversampling(regs[REG_CTRL_HUM]);
+    uint64_t us10 = 12500 + 23000 * (uint64_t)t;        // 0.1 us units
+    if (p) us10 += 23000 * (uint64_t)p + 5750;
+    if (h) us10 += 23000 * (uint64_t)h + 5750;
+    return (us10 + 9) / 10;
+}
+
+void Bme280Slave::begin_measurement(uint64_t t) {
+    measuring = true;
+    meas_start = t;
+    busy_until = t + us(measure_us());
+}
+
+void Bme280Slave::latch() {
+    bool t = oversampling(regs[REG_CTRL_MEAS] >> 5) != 0;
+    bool p = oversampling(regs[REG_CTRL_MEAS] >> 2) != 0;
+    bool h = oversampling(regs[REG_CTRL_HUM]) != 0;
+    uint32_t ap = p ? adc_p : 0x80000, at = t ? adc_t : 0x80000;
+    uint32_t ah = h ? adc_h : 0x8000;
+    regs[0xF7] = (uint8_t)(ap >> 12);
+    regs[0xF8] = (uint8_t)(ap >> 4);
+    regs[0xF9] = (uint8_t)((ap & 0xF) << 4);
+    regs[0xFA] = (uint8_t)(at >> 12);
+    regs[0xFB] = (uint8_t)(at >> 4);
+    regs[0xFC] = (uint8_t)((at & 0xF) << 4);
+    regs[0xFD] = (uint8_t)(ah >> 8);
+    regs[0xFE] = (uint8_t)ah;
+}
+
+void Bme280Slave::advance(uint64_t t) {
+    I2cDevice::advance(t);
+    while (measuring && now >= busy_until) {
+        latch();
+        if ((regs[REG_CTRL_MEAS] & 3) == 3) {
+            begin_measurement(busy_until + us(BME_STANDBY_US[regs[REG_CONFIG] >> 5]));
+        } else {
+            regs[REG_CTRL_MEAS] &= (uint8_t)~3;     // forced mode falls back to sleep
+            measuring = false;
+        }
+    }
+}
+
+bool Bme280Slave::on_address(bool rd) {
+    if (!rd) have_ptr = false;
+    return true;
+}
+
+bool Bme280Slave::on_write(uint8_t b) {
+    if (!have_ptr) {
+        ptr = b;
+        have_ptr = true;
+        return true;
+    }
+    have_ptr = false;           // writes are {register, value} pairs
+    switch (ptr) {
+    case REG_RESET:
+        if (b == 0xB6) power_on();
+        break;
+    case REG_CTRL_HUM:
+        regs[ptr] = b & 7;
+        break;
+    case REG_CTRL_MEAS:
+        regs[ptr] = b;
+        if (b & 3) begin_measurement(now);
+        else measuring = false;
+        break;
+    case REG_CONFIG:
+        regs[ptr] = b & 0xFD;
+        break;
+    }
+    return true;
+}
+
+uint8_t Bme280Slave::on_read() {
+    uint8_t v = ptr == REG_STATUS ? (uint8_t)(busy() ? 0x08 : 0) : regs[ptr];
+    ptr++;
+    return v;
+}
+
+// ================================================================
+// 24Cxx EEPROM
+// ================================================================
+EepromSlave::EepromSlave(uint8_t addr7, uint32_t size, uint32_t page, int addr_bytes,
+                         uint32_t cycles_per_us)
+    : I2cDevice("eeprom", addr7, BUSY_NACK, cycles_per_us), mem(size, 0xFF),
+      page(page), addr_bytes(addr_bytes) {}
+
+bool EepromSlave::on_address(bool rd) {
+    if (!rd) {
+        nhdr = 0;
+        pending.clear();
+    }
+    return true;
+}
+
+bool EepromSlave::on_write(uint8_t b) {
+    if (nhdr < addr_bytes) {
+        ptr = nhdr == 0 ? b : ((ptr << 8) | b);
+        if (++nhdr == addr_bytes) ptr %= (uint32_t)mem.size();
+        return true;
+    }
+    pending.push_back(std::make_pair(ptr, b));
+    ptr = (ptr & ~(page - 1)) | ((ptr + 1) & (page - 1));  // roll over within the page
+    return true;
+}
+
+uint8_t EepromSlave::on_read() {
+    uint8_t v = mem[ptr];
+    ptr = (ptr + 1) % (uint32_t)mem.size();
+    return v;
+}
+
+void EepromSlave::on_stop() {
+    if (reading || pending.empty()) return;
+    for (const auto &w : pending) mem[w.first] = w.second;
+    pending.clear();
+    page_writes++;
+    busy_until = now + us(write_cycle_us);
+}
+
+// ================================================================
+// Bus description
+// ================================================================
+bool i2c_devices_parse(const std::string &spec, I2cBus &bus,
+                       std::vector<std::unique_ptr<I2cDevice>> &owned, uint32_t cycles_per_us) {
+    size_t pos = 0;
+    while (pos <= spec.size()) {
+        size_t end = spec.find(',', pos);
+        if (end == std::string::npos) end = spec.size();
+        std::string item = spec.substr(pos, end - pos);
+        pos = end + 1;
+        if (item.empty()) return false;
+
+        std::string policy;
+        size_t colon = item.find(':');
+        if (colon != std::string::npos) {
+            policy = item.substr(colon + 1);
+            item.resize(colon);
+        }
+        long a = -1;
+        size_t at = item.find('@');
+        if (at != std::string::npos) {
+            a = strtol(item.c_str() + at + 1, nullptr, 0);
+            item.resize(at);
+            if (a < 0x08 || a > 0x77) return false;
+        }
+
+        I2cDevice *d;
+        if (item == "sht3x" || item == "sht31")
+            d = new Sht3xSlave(a < 0 ? 0x44 : (uint8_t)a, cycles_per_us);
+        else if (item == "bme280")
+            d = new Bme280Slave(a < 0 ? 0x76 : (uint8_t)a, cycles_per_us);
+        else if (item == "eeprom" || item == "24c32")
+            d = new EepromSlave(a < 0 ? 0x50 : (uint8_t)a, 4096, 32, 2, cycles_per_us);
+        else if (item == "24c02")
+            d = new EepromSlave(a < 0 ? 0x50 : (uint8_t)a, 256, 8, 1, cycles_per_us);
+        else
+            return false;
+        owned.emplace_back(d);
+
+        if (policy == "nack") d->busy_policy = I2cDevice::BUSY_NACK;
+        else if (policy == "stretch") d->busy_policy = I2cDevice::BUSY_STRETCH;
+        else if (policy == "ignore") d->busy_policy = I2cDevice::BUSY_IGNORE;
+        else if (!policy.empty()) return false;
+        d->busy_policy_fixed = !policy.empty();
+        bus.add(d);
+    }
+    return true;
+}
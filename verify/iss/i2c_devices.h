@@ -0,0 +1,182 @@
+// i2c_devices.h — Register-level I2C sensor/memory models and a shared bus
+//
+// Each model is an I2cSlave with its own 7-bit address, so the same object
+// runs behind the transaction-level master in SocModel and behind the
+// pin-level I2cPins in the Verilator harnesses. Time comes from advance()
+// in master clock cycles; cycles_per_us converts the datasheet delays.
+//
+// While a device is busy (measurement, EEPROM write cycle) an address
+// byte for it is handled by its BusyPolicy:
+//   BUSY_NACK     NACK the address (datasheet "ACK polling")
+//   BUSY_STRETCH  ACK, then hold SCL low until ready; a master that ignores
+//                 SCL (the SoC) clocks out released SDA: 0xFF
+//   BUSY_IGNORE   ACK and answer from the current registers
+//
+//   Sht3xSlave    SHT30/31/35 @0x44: single-shot commands with and without
+//                 clock stretching (BUSY_STRETCH / BUSY_NACK per command
+//                 unless busy_policy_fixed), status register, soft reset, CRC-8
+//   Bme280Slave   BME280 @0x76: register pointer map, forced and normal
+//                 mode, measuring status bit, datasheet timing
+//   EepromSlave   24Cxx @0x50: 1/2 address bytes, page writes that wrap in
+//                 the page, sequential reads, tWR write cycle
+
+#pragma once
+
+#include "i2c_slave.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class I2cDevice : public I2cSlave {
+public:
+    enum BusyPolicy { BUSY_NACK, BUSY_STRETCH, BUSY_IGNORE };
+
+    I2cDevice(const char *name, uint8_t addr7, BusyPolicy policy, uint32_t cycles_per_us)
+        : name(name), addr(addr7), busy_policy(policy), cycles_per_us(cycles_per_us) {}
+
+    const char *name;
+    uint8_t     addr;
+    BusyPolicy  busy_policy;
+    bool        busy_policy_fixed = false;  // given as NAME:POLICY, devices keep it
+    uint32_t    cycles_per_us;
+
+    // Counters
+    uint32_t transactions = 0, nacks = 0, busy_nacks = 0;
+    uint32_t bytes_written = 0, bytes_read = 0, stale_reads = 0;
+    uint64_t stretched = 0;             // cycles SCL was held low
+
+    void     start() override;
+    bool     address(uint8_t addr7, bool read) override;
+    bool     write(uint8_t byte) override;
+    uint8_t  read() override;
+    void     stop() override;
+    void     advance(uint64_t t) override { if (t > now) now = t; }
+    uint64_t stretch() override;
+
+    virtual bool busy() const { return now < busy_until; }
+
+protected:
+    uint64_t now = 0;
+    uint64_t busy_until = 0;
+    bool     selected = false;
+    bool     reading = false;
+    uint64_t pending_stretch = 0;
+
+    uint64_t us(uint64_t t) const { return t * cycles_per_us; }
+
+    // Model hooks, called only while addressed and not refused
+    virtual bool    on_address(bool read) { (void)read; return true; }
+    virtual bool    on_write(uint8_t byte) = 0;
+    virtual uint8_t on_read() = 0;
+    virtual void    on_stop() {}
+};
+
+// Several devices on one SDA/SCL pair (wired-AND: the addressed device
+// answers, everyone else stays released)
+class I2cBus : public I2cSlave {
+public:
+    void add(I2cDevice *d) { devices.push_back(d); }
+    const std::vector<I2cDevice *> &list() const { return devices; }
+
+    void     start() override;
+    bool     address(uint8_t addr7, bool read) override;
+    bool     write(uint8_t byte) override;
+    uint8_t  read() override;
+    void     read_ack(bool ack) override;
+    void     stop() override;
+    void     advance(uint64_t now) override;
+    uint64_t stretch() override;
+
+private:
+    std::vector<I2cDevice *> devices;
+    I2cDevice *cur = nullptr;
+};
+
+class Sht3xSlave : public I2cDevice {
+public:
+    explicit Sht3xSlave(uint8_t addr7 = 0x44, uint32_t cycles_per_us = 25)
+        : I2cDevice("sht3x", addr7, BUSY_NACK, cycles_per_us) {}
+
+    double temperature_c = 23.5;
+    double humidity_pct = 45.0;
+
+    static uint8_t crc8(const uint8_t *p, int n);   // poly 0x31, init 0xFF
+
+protected:
+    bool    on_address(bool read) override;
+    bool    on_write(uint8_t byte) override;
+    uint8_t on_read() override;
+    void    on_stop() override;
+
+private:
+    uint8_t  cmd[2];
+    int      ncmd = 0;
+    uint8_t  out[6];
+    int      nout = 0, idx = 0;
+    uint16_t status = 0x8010;           // alert pending, reset detected
+    void     command(uint16_t c);
+};
+
+class Bme280Slave : public I2cDevice {
+public:
+    explicit Bme280Slave(uint8_t addr7 = 0x76, uint32_t cycles_per_us = 25);
+
+    // Raw ADC results latched into 0xF7..0xFE at the end of a measurement
+    // (BMP280 datasheet 8.2 example: 25.08 degC, 100653 Pa)
+    uint32_t adc_t = 519888, adc_p = 415148, adc_h = 30000;
+
+    static const uint8_t REG_ID = 0xD0, REG_RESET = 0xE0, REG_CTRL_HUM = 0xF2,
+                         REG_STATUS = 0xF3, REG_CTRL_MEAS = 0xF4, REG_CONFIG = 0xF5,
+                         REG_DATA = 0xF7;
+
+    // Maximum measurement time for the given ctrl_hum/ctrl_meas (datasheet 9.1)
+    uint64_t measure_us() const;
+
+    void advance(uint64_t t) override;
+    bool busy() const override { return measuring && now >= meas_start && now < busy_until; }
+
+protected:
+    bool    on_address(bool read) override;
+    bool    on_write(uint8_t byte) override;
+    uint8_t on_read() override;
+
+private:
+    uint8_t  regs[256];
+    uint8_t  ptr = 0;
+    bool     have_ptr = false;          // first byte of a write is the pointer
+    bool     measuring = false;         // a conversion is scheduled
+    uint64_t meas_start = 0;            // current conversion: [meas_start, busy_until)
+    void     power_on();
+    void     begin_measurement(uint64_t t);
+    void     latch();
+};
+
+class EepromSlave : public I2cDevice {
+public:
+    // Default: 24C32 (4 KB, 32-byte pages, 2 address bytes, 5 ms tWR)
+    explicit EepromSlave(uint8_t addr7 = 0x50, uint32_t size = 4096, uint32_t page = 32,
+                         int addr_bytes = 2, uint32_t cycles_per_us = 25);
+
+    uint32_t write_cycle_us = 5000;
+    std::vector<uint8_t> mem;
+
+    uint32_t page_writes = 0;
+
+protected:
+    bool    on_address(bool read) override;
+    bool    on_write(uint8_t byte) override;
+    uint8_t on_read() override;
+    void    on_stop() override;
+
+private:
+    uint32_t page, ptr = 0;
+    int      addr_bytes, nhdr = 0;
+    std::vector<std::pair<uint32_t, uint8_t>> pending;  // page buffer
+};
+
+// "sht3x,bme280@0x77:stretch,eeprom" -> devices on a bus (iss --i2c-devices).
+// Policy suffixes: nack, stretch, ignore. Returns false on a bad spec.
+bool i2c_devices_parse(const std::string &spec, I2cBus &bus,
+                       std::vector<std::unique_ptr<I2cDevice>> &owned, uint32_t cycles_per_us);
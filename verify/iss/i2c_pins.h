@@ -0,0 +1,152 @@
+// i2c_pins.h — Pin-level front end for the I2cSlave models
+//
+// Decodes START/STOP, address and data bytes from the open-drain SCL/SDA
+// lines and drives the slave side: ACK/NACK, read data, and SCL held low
+// for the cycles stretch() asks for after an ACK. For Verilator harnesses
+// whose master sees SCL (cov_i2c_tb.cpp: i2c_master scl_i); call eval()
+// whenever the master outputs may have changed and feed the wired-AND back:
+//
+//   pins.eval(t, scl_o, sda_o);
+//   scl_i = scl_o & pins.scl();  sda_i = sda_o & pins.sda();
+
+#pragma once
+
+#include "i2c_slave.h"
+
+#include <cstdint>
+
+class I2cPins {
+public:
+    explicit I2cPins(I2cSlave &s) : slave(s) {}
+
+    // Slave outputs, 1 = released
+    bool scl() const { return !holding; }
+    bool sda() const { return s_sda; }
+
+    uint32_t starts = 0, stops = 0;
+    uint64_t held = 0;                  // cycles SCL was stretched
+
+    void eval(uint64_t now, bool m_scl, bool m_sda) {
+        if (holding && now >= hold_until) {
+            holding = false;
+            held += hold_until - hold_from;
+            if (load_pending) load(now);
+        }
+        bool scl = m_scl && !holding, sda = m_sda && s_sda;
+        bool rise = scl && !p_scl, fall = !scl && p_scl;
+        bool start = scl && p_scl && p_sda && !sda;
+        bool stop = scl && p_scl && !p_sda && sda;
+        p_scl = scl;
+        p_sda = sda;
+
+        if (start) {
+            slave.advance(now);
+            slave.start();
+            starts++;
+            st = ADDR;
+            bits = 0;
+            s_sda = true;
+            return;
+        }
+        if (stop) {
+            slave.advance(now);
+            slave.stop();
+            stops++;
+            st = IDLE;
+            s_sda = true;
+            return;
+        }
+
+        if (rise) {
+            switch (st) {
+            case ADDR:
+            case WRITE:
+                shift = (uint8_t)((shift << 1) | (sda ? 1 : 0));
+                if (++bits == 8) {
+                    slave.advance(now);
+                    if (st == ADDR) {
+                        rd = shift & 1;
+                        acked = slave.address(shift >> 1, rd);
+                    } else {
+                        acked = slave.write(shift);
+                    }
+                    st = ACK;
+                }
+                break;
+            case READ:
+                if (++bits == 8) st = READ_ACK;
+                break;
+            case READ_ACK:
+                slave.advance(now);
+                acked = !sda;
+                slave.read_ack(acked);
+                st = acked ? READ_NEXT : IDLE;
+                break;
+            default:
+                break;
+            }
+        } else if (fall) {
+            switch (st) {
+            case ACK:                   // drive the 9th bit
+                s_sda = !acked;
+                st = acked ? ACK_END : ACK_NACK;
+                break;
+            case ACK_NACK:
+                st = IDLE;              // ignore the bus until START
+                break;
+            case ACK_END: {
+                s_sda = true;
+                uint64_t s = slave.stretch();
+                if (s) {
+                    holding = true;
+                    hold_from = now;
+                    hold_until = now + s;
+                }
+                bits = 0;
+                if (!rd) {
+                    st = WRITE;
+                } else if (holding) {
+                    load_pending = true;
+                    st = READ_WAIT;
+                } else {
+                    load(now);
+                }
+                break;
+            }
+            case READ:
+                s_sda = (out >> (7 - bits)) & 1;
+                break;
+            case READ_ACK:
+                s_sda = true;           // master drives ACK/NACK
+                break;
+            case READ_NEXT:
+                load(now);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+private:
+    enum State { IDLE, ADDR, ACK, ACK_END, ACK_NACK, WRITE, READ_WAIT, READ, READ_ACK, READ_NEXT };
+
+    I2cSlave &slave;
+    State    st = IDLE;
+    bool     p_scl = true, p_sda = true;
+    bool     s_sda = true;
+    bool     holding = false, load_pending = false;
+    uint64_t hold_from = 0, hold_until = 0;
+    bool     rd = false, acked = false;
+    uint8_t  shift = 0, out = 0xFF;
+    int      bits = 0;
+
+    void load(uint64_t now) {
+        slave.advance(now);
+        out = slave.read();
+        load_pending = false;
+        bits = 0;
+        s_sda = (out & 0x80) != 0;
+        st = READ;
+    }
+};
@@ -0,0 +1,61 @@
+// i2c_slave.h — Transaction-level I2C slave interface for the SoC model
+//
+// The functional I2C master in soc_model.cpp does not toggle SCL/SDA; it
+// calls these hooks once per protocol event instead. A slave returns the
+// ACK (true) / NACK (false) it would drive on the bus.
+//
+// advance() gives the bus time (master clock cycles) before each event, for
+// slaves that measure or program for a while. stretch() is asked after
+// every ACK bit: the number of cycles the slave now holds SCL low. Only a
+// master that watches SCL honours it (I2cPins, i2c_pins.h); project.v ties
+// the Forencich master's scl_i high, so on the SoC a stretch is ignored.
+// Device models are in i2c_devices.h.
+
+#pragma once
+
+#include <cstdint>
+
+class I2cSlave {
+public:
+    virtual ~I2cSlave() {}
+    virtual void    start() {}                              // START or repeated START
+    virtual bool    address(uint8_t addr7, bool read) = 0;  // address byte, ACK?
+    virtual bool    write(uint8_t byte) = 0;                // data byte, ACK?
+    virtual uint8_t read() = 0;                             // next byte to master
+    virtual void    read_ack(bool ack) { (void)ack; }       // master ACK/NACK
+    virtual void    stop() {}
+    virtual void    advance(uint64_t now) { (void)now; }   // bus time, cycles
+    virtual uint64_t stretch() { return 0; }               // SCL low after ACK
+};
+
+// Functional twin of test/i2c_slave_model.v: SHT31 at SLAVE_ADDR, ACKs all
+// writes, returns the canned measurement {63 32 A1 8C A4 DB} on reads.
+// Read index restarts on every address match and advances after each
+// master ACK; after a NACK the slave goes idle until the next START.
+class Sht31Slave : public I2cSlave {
+public:
+    explicit Sht31Slave(uint8_t addr7 = 0x44) : addr(addr7) {}
+
+    void start() override { selected = false; }
+    bool address(uint8_t a, bool rd) override {
+        selected = (a == addr);
+        if (selected) { is_read = rd; idx = 0; }
+        return selected;
+    }
+    bool write(uint8_t) override { return selected && !is_read; }
+    uint8_t read() override {
+        return (selected && is_read) ? data[idx] : 0xFF;
+    }
+    void read_ack(bool ack) override {
+        if (!ack) selected = false;
+        else if (idx < 5) idx++;
+    }
+    void stop() override { selected = false; }
+
+private:
+    const uint8_t data[6] = { 0x63, 0x32, 0xA1, 0x8C, 0xA4, 0xDB };
+    uint8_t addr;
+    bool    selected = false;
+    bool    is_read = false;
+    int     idx = 0;
+};
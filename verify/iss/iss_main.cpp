@@ -0,0 +1,236 @@
+// iss_main.cpp — Run a firmware image on the SoC functional model
+//
+// Usage: iss [options] image.hex
+//   --max-cycles N      stop after N clocks (default 80M, same as cov_project_tb)
+//   --expect STR        pass when the UART output contains STR (\n escapes ok)
+//   --dio1-follows-led  drive ui_in[0] from uo_out[7] (tb_irq_priority stimulus)
+//   --uart-loopback     feed every transmitted byte back to uart_rxd (fw_uart_irq)
+//   --sx1268            SX1268 model on SPI/BUSY/DIO1/NRESET, with a loopback
+//                       gateway ACKing fw_lora_node uplinks
+//   --sx1268-ack-ms N   loopback ACK delay after the uplink ends (default 10)
+//   --i2c-devices SPEC  replace the SHT31 stub with i2c_devices.h models,
+//                       e.g. "sht3x,bme280,eeprom" or "eeprom@0x51:stretch"
+//   --trace             print every retired instruction
+//   --quiet             do not echo UART bytes
+//   --profile           print predicted cycles per function
+//   --syms FILE         nm listing for --profile function names
+//   --timing-trace FILE write the model's per-instruction cycles (for calib)
+
+#include "soc_model.h"
+#include "func_profile.h"
+#include "sx1268.h"
+#include "i2c_devices.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+static std::string unescape(const char *s) {
+    std::string r;
+    for (; *s; s++) {
+        if (s[0] == '\\' && s[1] == 'n') { r += '\n'; s++; }
+        else r += *s;
+    }
+    return r;
+}
+
+static void usage() {
+    fprintf(stderr, "usage: iss [--max-cycles N] [--expect STR] [--dio1-follows-led] [--uart-loopback]\n"
+                    "           [--sx1268] [--sx1268-ack-ms N] [--i2c-devices SPEC] [--trace] [--quiet] [--profile] [--syms FILE]\n"
+                    "           [--timing-trace FILE] image.hex\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    uint64_t max_cycles = 80000000ULL;
+    const char *image = nullptr;
+    std::string expect;
+    bool have_expect = false, dio1_follows_led = false, uart_loopback = false, trace = false, quiet = false;
+    bool profile = false, sx1268 = false;
+    uint32_t ack_ms = 10;
+    const char *syms = nullptr, *ttrace = nullptr, *i2c_spec = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--max-cycles") && i + 1 < argc)
+            max_cycles = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--expect") && i + 1 < argc) {
+            expect = unescape(argv[++i]);
+            have_expect = true;
+        } else if (!strcmp(argv[i], "--dio1-follows-led"))
+            dio1_follows_led = true;
+        else if (!strcmp(argv[i], "--uart-loopback"))
+            uart_loopback = true;
+        else if (!strcmp(argv[i], "--sx1268"))
+            sx1268 = true;
+        else if (!strcmp(argv[i], "--sx1268-ack-ms") && i + 1 < argc)
+            ack_ms = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--i2c-devices") && i + 1 < argc)
+            i2c_spec = argv[++i];
+        else if (!strcmp(argv[i], "--trace"))
+            trace = true;
+        else if (!strcmp(argv[i], "--quiet"))
+            quiet = true;
+        else if (!strcmp(argv[i], "--profile"))
+            profile = true;
+        else if (!strcmp(argv[i], "--syms") && i + 1 < argc)
+            syms = argv[++i];
+        else if (!strcmp(argv[i], "--timing-trace") && i + 1 < argc)
+            ttrace = argv[++i];
+        else if (argv[i][0] == '-' || image)
+            usage();
+        else
+            image = argv[i];
+    }
+    if (!image) usage();
+
+    static SocModel soc;        // ~270 KB of memories: keep off the stack
+    Sht31Slave sht31;
+    I2cBus i2c_bus;
+    std::vector<std::unique_ptr<I2cDevice>> i2c_devs;
+    if (i2c_spec) {
+        if (!i2c_devices_parse(i2c_spec, i2c_bus, i2c_devs, SocModel::CLK_HZ / 1000000)) {
+            fprintf(stderr, "iss: bad --i2c-devices spec '%s'\n", i2c_spec);
+            return 2;
+        }
+        soc.attach_i2c(&i2c_bus);
+    } else {
+        soc.attach_i2c(&sht31);
+    }
+    if (!soc.load_hex(image)) {
+        fprintf(stderr, "iss: cannot read %s\n", image);
+        return 2;
+    }
+
+    std::string uart;
+    soc.on_uart_tx = [&](uint8_t b) {
+        uart += (char)b;
+        if (!quiet) { putchar(b); fflush(stdout); }
+        if (uart_loopback) soc.uart_rx_inject(b);
+        if (have_expect && uart.find(expect) != std::string::npos) soc.stop();
+    };
+    if (dio1_follows_led) {
+        soc.on_uo_out = [&](uint8_t uo) {
+            uint8_t ui = soc.ui_in();
+            soc.set_ui_in((uo & 0x80) ? (ui | 1) : (ui & ~1));
+        };
+    }
+    Sx1268 radio;
+    uint64_t rng = 1;
+    if (sx1268) {
+        sx1268_connect(soc, radio);
+        radio.random = [&rng] {
+            rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+            return (uint32_t)(rng >> 32);
+        };
+        sx1268_loopback_ack(radio, (uint64_t)ack_ms * (SocModel::CLK_HZ / 1000));
+    }
+    soc.on_reset = [&](bool wdt) {
+        if (!quiet) printf("\n[ISS] %s reset at cycle %llu\n", wdt ? "WDT" : "soft",
+                           (unsigned long long)soc.now);
+    };
+
+    FuncProfile prof;
+    if (syms && !prof.load_symbols(syms)) {
+        fprintf(stderr, "iss: cannot read %s\n", syms);
+        return 2;
+    }
+    FILE *tt = nullptr;
+    if (ttrace) {
+        tt = fopen(ttrace, "wb");
+        if (!tt) {
+            fprintf(stderr, "iss: cannot write %s\n", ttrace);
+            return 2;
+        }
+        fwrite(&TIMING_TRACE_MAGIC, 4, 1, tt);
+    }
+    if (profile || tt) {
+        soc.on_retire = [&](const Rv32Retire &r, uint32_t cycles, bool after_reset) {
+            if (after_reset) prof.reset();
+            prof.retire(r, cycles);
+            if (tt) {
+                TimingTraceRec rec = timing_trace_pack(r, cycles, after_reset);
+                fwrite(&rec, sizeof(rec), 1, tt);
+            }
+        };
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    if (trace) {
+        while (soc.now < max_cycles) {
+            soc.step();
+            const Rv32Retire &r = soc.last();
+            if (r.cls == RV_IRQ) {
+                printf("%10llu  IRQ  mcause=%08x\n", (unsigned long long)soc.now, soc.cpu.mcause);
+                continue;
+            }
+            printf("%10llu  %08x  %08x", (unsigned long long)soc.now, r.pc, r.insn);
+            if (r.rd >= 0) printf("  %-4s=%08x", Rv32Core::reg_name(r.rd), r.rd_value);
+            if (r.mem) printf("  %s[%08x]=%08x", r.mem_write ? "st" : "ld", r.mem_addr, r.mem_data);
+            if (r.trap) printf("  TRAP mcause=%u", soc.cpu.mcause);
+            printf("\n");
+            if (sx1268) radio.sync(soc.now);
+            if (have_expect && uart.find(expect) != std::string::npos) break;
+        }
+    } else if (sx1268) {
+        // Stop at every radio event so DIO1/BUSY edges land on time
+        while (soc.now < max_cycles) {
+            uint64_t t = radio.next_event();
+            soc.run_until(t < max_cycles ? t : max_cycles);
+            radio.sync(soc.now);
+            if (have_expect && uart.find(expect) != std::string::npos) break;
+        }
+    } else {
+        soc.run_until(max_cycles);
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (tt) fclose(tt);
+
+    printf("\n[ISS] %s: %llu cycles, %llu instructions, %u resets, %.3f s (%.1f MHz simulated)\n",
+           image, (unsigned long long)soc.now, (unsigned long long)soc.cpu.instret,
+           soc.resets, secs, secs > 0 ? soc.now / secs / 1e6 : 0.0);
+
+    if (sx1268) {
+        printf("[ISS] SX1268: %u TX, %u RX, %u RX timeouts, %u BUSY violations, "
+               "DIO1 service %.1f us mean\n",
+               radio.tx_count, radio.rx_count, radio.rx_timeouts, radio.busy_violations,
+               radio.irq_latency_n ? radio.irq_latency_sum / (SocModel::CLK_HZ / 1e6) / radio.irq_latency_n : 0.0);
+    }
+
+    for (const I2cDevice *d : i2c_bus.list()) {
+        printf("[ISS] I2C %-6s @0x%02x: %u transactions, %u NACKs (%u busy), %u B written, "
+               "%u B read, %u stale reads",
+               d->name, d->addr, d->transactions, d->nacks, d->busy_nacks, d->bytes_written,
+               d->bytes_read, d->stale_reads);
+        if (const EepromSlave *e = dynamic_cast<const EepromSlave *>(d))
+            printf(", %u page writes", e->page_writes);
+        printf("\n");
+    }
+
+    if (profile) {
+        std::vector<std::pair<uint64_t, uint32_t>> order;
+        for (const auto &kv : prof.funcs) order.push_back({kv.second.cycles, kv.first});
+        std::sort(order.rbegin(), order.rend());
+        printf("[ISS] predicted cycles per function (self):\n");
+        printf("  %-24s %8s %10s %12s %7s\n", "function", "calls", "insns", "cycles", "share");
+        for (const auto &o : order) {
+            const FuncStats &f = prof.funcs.at(o.second);
+            printf("  %-24s %8llu %10llu %12llu %6.2f%%\n", prof.name(o.second).c_str(),
+                   (unsigned long long)f.calls, (unsigned long long)f.insns,
+                   (unsigned long long)f.cycles, soc.now ? 100.0 * f.cycles / soc.now : 0.0);
+        }
+    }
+
+    if (!have_expect) return 0;
+    if (uart.find(expect) != std::string::npos) {
+        printf("[PASS] UART signature\n");
+        printf("ALL TESTS PASSED\n");
+        return 0;
+    }
+    printf("[FAIL] UART signature: got %zu bytes, expected \"%s\"\n", uart.size(), expect.c_str());
+    return 1;
+}
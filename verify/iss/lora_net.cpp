@@ -0,0 +1,627 @@
+// lora_net.cpp — Multi-node LoRa network simulation
+//
+// Usage: lora_net [options] node.hex
+//   --nodes N          SoC models (default 8)
+//   --records N        seal records per node (default 8)
+//   --period-ms N      sleep between records (default 1000)
+//   --seed S           channel and radio RNG seed (default 1)
+//   --threads N        worker threads (default: one per node)
+//   --loss P           random loss probability per frame and receiver
+//   --corrupt P        probability that an uplink arrives with one bit of a
+//                      CRC-covered seal field flipped (radio CRC missed it)
+//   --ack-delay-ms N   gateway ACK start after the uplink ends (default 10)
+//   --epoch-us N       barrier interval (default 1000)
+//   --max-ms N         simulated time limit (default 60000)
+//   --pin-level        drive each radio through Sx1268Pins (SPI waveform)
+//   --replay-check     run again on one thread, require identical results
+//   --pin-check        run again at pin level, require identical results
+//   --quiet            summary only
+//
+// Every node is a SocModel running the same image, provisioned with its own
+// node id (flash 0x3FFF0, see test/fw_lora_node.c), with an Sx1268 model on
+// its SPI/BUSY/DIO1 pins. Nodes run in parallel between barriers; at each
+// barrier the channel (single threaded) collects the uplinks started in the
+// epoch, resolves the ones that have ended (collision, random loss, gateway
+// busy transmitting), passes survivors to the gateway and schedules its
+// ACKs on every node's radio. Nothing crosses threads inside an epoch and
+// all randomness is derived from (seed, node, time), so a seed replays
+// bit-identically for any thread count or epoch length; the digest covers
+// every channel event in resolution order and --replay-check compares it.
+// --pin-check does the same for the pin-level radio front end, which must
+// decode exactly what the byte-level binding sees.
+//
+// The gateway verifies each seal record (CRC16 over sensor_id, value, mono)
+// and tracks mono per node/session to count duplicates, gaps and ordering
+// violations. Uplinks are SF7/BW125; downlinks use inverted IQ, so nodes
+// never demodulate each other. The gateway is half duplex: uplinks that
+// overlap one of its downlinks are lost.
+
+#include "seal_frame.h"
+#include "soc_model.h"
+#include "sx1268.h"
+#include "sx1268_pins.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const uint32_t PROV_ADDR = 0x3FFF0;     // fw_lora_node.c PROV
+static const uint32_t FRAME_LEN = SEAL_FRAME_LEN;
+static const uint64_t US = SocModel::CLK_HZ / 1000000;
+
+struct NetConfig {
+    const char *image = nullptr;
+    int      nodes = 8;
+    uint32_t records = 8;
+    uint32_t period_ms = 1000;
+    uint64_t seed = 1;
+    int      threads = 0;
+    double   loss = 0;
+    double   corrupt = 0;
+    uint32_t ack_delay_ms = 10;
+    uint32_t epoch_us = 1000;
+    uint32_t max_ms = 60000;
+    bool     pin_level = false;
+    bool     quiet = false;
+};
+
+// ================================================================
+// Deterministic randomness
+// ================================================================
+static uint64_t splitmix64(uint64_t &s) {
+    uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform [0, 1) keyed on the event, independent of evaluation order
+static double event_rand(uint64_t seed, char kind, int node, uint64_t t) {
+    uint64_t s = seed ^ ((uint64_t)(uint8_t)kind << 56) ^ ((uint64_t)node << 40) ^ t;
+    splitmix64(s);
+    return (splitmix64(s) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// FNV-1a over the event log
+struct Digest {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    void add(const void *p, size_t n) {
+        const uint8_t *b = (const uint8_t *)p;
+        for (size_t i = 0; i < n; i++) h = (h ^ b[i]) * 0x100000001B3ULL;
+    }
+    void add64(uint64_t v) { add(&v, sizeof(v)); }
+    void add(const std::vector<uint8_t> &v) { add64(v.size()); add(v.data(), v.size()); }
+};
+
+// ================================================================
+// Seal records
+// ================================================================
+// Uplink frame: SealFrame (seal_frame.h), FRAME_LEN bytes
+
+// Frame bytes covered by the seal CRC (sensor_id, value, mono, crc)
+static const int CRC_COVERED[] = { 0, 1, 2, 3, 4, 5, 6, 7, 10, 11, 12 };
+
+// ================================================================
+// Gateway
+// ================================================================
+struct GatewayStats {
+    uint64_t received = 0, malformed = 0, crc_fail = 0, payload_mismatch = 0;
+    uint64_t unique = 0, duplicates = 0, order_errors = 0, gaps = 0, sessions = 0;
+    uint64_t latency_sum = 0, latency_max = 0;     // cycles, first TX -> verified
+    double   verify_ns = 0;                        // host time, not in the digest
+};
+
+class Gateway {
+public:
+    GatewayStats st;
+    std::map<int, uint64_t> unique_per_node;
+
+    // Verify one demodulated uplink at cycle `at`. Returns true and fills
+    // `ack` if the record passed (new or duplicate).
+    bool receive(const std::vector<uint8_t> &d, uint64_t at, uint64_t first_tx,
+                 std::vector<uint8_t> &ack) {
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = verify(d, at, first_tx);
+        st.verify_ns += std::chrono::duration<double, std::nano>(
+                            std::chrono::steady_clock::now() - t0).count();
+        if (!ok) return false;
+        ack.assign({ 'A', d[0], d[5], d[6], d[7], d[12] });    // mono LE
+        return true;
+    }
+
+private:
+    struct NodeState { uint8_t sid; uint32_t mono; };
+    std::map<int, NodeState> nodes;
+
+    bool verify(const std::vector<uint8_t> &d, uint64_t at, uint64_t first_tx) {
+        st.received++;
+        SealFrame f;
+        if (!f.decode(d)) { st.malformed++; return false; }
+        if (f.crc != f.expected_crc()) { st.crc_fail++; return false; }
+        if ((f.value >> 16) != f.node) { st.payload_mismatch++; return false; }
+
+        auto it = nodes.find(f.node);
+        if (it == nodes.end() || it->second.sid != f.sid) {
+            st.sessions++;                          // first record or reboot
+        } else if (f.mono == it->second.mono) {
+            st.duplicates++;                        // our ACK was lost
+            return true;
+        } else if (f.mono < it->second.mono) {
+            st.order_errors++;
+            return false;
+        } else {
+            st.gaps += f.mono - it->second.mono - 1;
+        }
+        nodes[f.node] = NodeState{ f.sid, f.mono };
+        st.unique++;
+        unique_per_node[f.node]++;
+        uint64_t lat = at - first_tx;
+        st.latency_sum += lat;
+        if (lat > st.latency_max) st.latency_max = lat;
+        return true;
+    }
+};
+
+// ================================================================
+// Nodes and worker threads
+// ================================================================
+struct Node {
+    int      id;
+    SocModel soc;
+    Sx1268   radio;
+    std::unique_ptr<Sx1268Pins> pins;   // --pin-level
+    uint64_t rng;
+    std::string uart;
+    bool     done = false;
+    std::vector<LoraFrame> outbox;      // uplinks started this epoch
+
+    void run(uint64_t until) {
+        while (!done && soc.now < until) {
+            uint64_t t = radio.next_event();
+            soc.run_until(t < until ? t : until);
+            radio.sync(soc.now);
+        }
+    }
+};
+
+// Runs every node up to a barrier on a fixed node -> thread assignment
+class EpochPool {
+public:
+    EpochPool(std::vector<std::unique_ptr<Node>> &n, int threads) : nodes(n) {
+        for (int w = 0; w < threads; w++)
+            workers.emplace_back([this, w, threads] { loop(w, threads); });
+    }
+    ~EpochPool() {
+        {
+            std::lock_guard<std::mutex> l(m);
+            quit = true;
+            gen++;
+        }
+        cv_start.notify_all();
+        for (std::thread &t : workers) t.join();
+    }
+
+    void run(uint64_t until) {
+        {
+            std::lock_guard<std::mutex> l(m);
+            target = until;
+            pending = (int)workers.size();
+            gen++;
+        }
+        cv_start.notify_all();
+        std::unique_lock<std::mutex> l(m);
+        cv_done.wait(l, [this] { return pending == 0; });
+    }
+
+private:
+    std::vector<std::unique_ptr<Node>> &nodes;
+    std::vector<std::thread> workers;
+    std::mutex m;
+    std::condition_variable cv_start, cv_done;
+    uint64_t gen = 0, target = 0;
+    int      pending = 0;
+    bool     quit = false;
+
+    void loop(int w, int stride) {
+        uint64_t seen = 0;
+        for (;;) {
+            uint64_t until;
+            {
+                std::unique_lock<std::mutex> l(m);
+                cv_start.wait(l, [&] { return gen != seen; });
+                seen = gen;
+                if (quit) return;
+                until = target;
+            }
+            for (size_t i = w; i < nodes.size(); i += stride) nodes[i]->run(until);
+            {
+                std::lock_guard<std::mutex> l(m);
+                if (--pending == 0) cv_done.notify_one();
+            }
+        }
+    }
+};
+
+// ================================================================
+// Network
+// ================================================================
+struct NetResult {
+    uint64_t digest = 0;
+    uint64_t sim_cycles = 0;
+    uint64_t node_cycles = 0;
+    double   wall = 0;
+    bool     finished = false;
+    uint64_t uplinks = 0, collided = 0, lost_up = 0, gw_busy = 0, corrupted = 0;
+    uint64_t downlinks = 0, lost_down = 0;
+    uint64_t airtime = 0;                       // uplink cycles on air
+    uint64_t acked = 0, given_up = 0;
+    bool     accounting_ok = true;
+    uint64_t busy_violations = 0;
+    uint64_t irq_latency_sum = 0, irq_latency_max = 0, irq_latency_n = 0;
+    uint64_t turnaround_sum = 0, turnaround_max = 0, turnaround_n = 0;
+    GatewayStats gw;
+    std::vector<std::string> node_lines;
+};
+
+struct Uplink {
+    LoraFrame f;
+    int       node;
+    bool      resolved;
+};
+
+class LoraNet {
+public:
+    explicit LoraNet(const NetConfig &c) : cfg(c) {}
+
+    bool setup() {
+        for (int i = 0; i < cfg.nodes; i++) {
+            std::unique_ptr<Node> n(new Node);
+            n->id = i + 1;
+            if (!n->soc.load_hex(cfg.image)) return false;
+            uint32_t prov[4] = { (uint32_t)n->id, cfg.records, cfg.period_ms * 1000, 0xFFFFF };
+            memcpy(&n->soc.flash[PROV_ADDR], prov, sizeof(prov));
+
+            n->rng = cfg.seed ^ ((uint64_t)n->id << 32);
+            Node *np = n.get();
+            sx1268_connect(np->soc, np->radio);
+            if (cfg.pin_level) {
+                np->pins.reset(new Sx1268Pins(np->radio));
+                np->soc.on_spi_byte = [np](uint8_t b) { return np->pins->clock_byte(b, np->soc.now); };
+                np->soc.on_spi_end = [np]() {
+                    np->pins->release(np->soc.now);
+                    np->soc.stop();
+                };
+                np->soc.on_uo_out = [np](uint8_t uo) {
+                    np->pins->eval(np->soc.now, uo, 0);
+                    np->soc.stop();
+                };
+            }
+            np->radio.random = [np] { return (uint32_t)(splitmix64(np->rng) >> 32); };
+            np->radio.on_tx = [np](const LoraFrame &f) { np->outbox.push_back(f); };
+            np->soc.on_uart_tx = [np](uint8_t b) {
+                np->uart += (char)b;
+                if (np->uart.size() >= 2 && !np->uart.compare(np->uart.size() - 2, 2, "DN")) {
+                    np->done = true;
+                    np->soc.stop();
+                }
+            };
+            nodes.push_back(std::move(n));
+        }
+        return true;
+    }
+
+    NetResult run(int threads) {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t epoch = cfg.epoch_us * US;
+        uint64_t limit = (uint64_t)cfg.max_ms * 1000 * US;
+        {
+            EpochPool pool(nodes, threads);
+            uint64_t t = 0;
+            while (t < limit && !all_done()) {
+                t += epoch;
+                pool.run(t);
+                barrier(t);
+            }
+            res.sim_cycles = t;
+        }
+        res.wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        finish();
+        return res;
+    }
+
+private:
+    NetConfig cfg;
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::vector<Uplink> air;
+    std::vector<std::pair<uint64_t, uint64_t>> gw_tx;   // downlink [start, end)
+    uint64_t gw_free = 0;
+    std::map<uint64_t, uint64_t> first_tx;              // (node, mono) -> cycle
+    Gateway  gw;
+    Digest   dig;
+    NetResult res;
+
+    bool all_done() const {
+        for (const auto &n : nodes) if (!n->done) return false;
+        return true;
+    }
+
+    static bool overlap(uint64_t a0, uint64_t a1, uint64_t b0, uint64_t b1) {
+        return a0 < b1 && b0 < a1;
+    }
+
+    void barrier(uint64_t t) {
+        // Collect uplinks started in this epoch, in node order
+        for (auto &n : nodes) {
+            for (LoraFrame &f : n->outbox) {
+                air.push_back(Uplink{ f, n->id, false });
+                res.uplinks++;
+                res.airtime += f.end - f.start;
+                SealFrame s;
+                if (s.decode(f.data)) {
+                    uint64_t key = ((uint64_t)n->id << 32) | s.mono;
+                    if (!first_tx.count(key)) first_tx[key] = f.start;
+                }
+            }
+            n->outbox.clear();
+        }
+
+        // Resolve every uplink that has ended: all overlapping ones are known
+        std::vector<size_t> due;
+        for (size_t i = 0; i < air.size(); i++)
+            if (!air[i].resolved && air[i].f.end <= t) due.push_back(i);
+        std::sort(due.begin(), due.end(), [&](size_t a, size_t b) {
+            if (air[a].f.end != air[b].f.end) return air[a].f.end < air[b].f.end;
+            return air[a].node < air[b].node;
+        });
+        for (size_t i : due) resolve(i, t);
+
+        // Forget what can no longer overlap an unresolved or future uplink
+        uint64_t horizon = t;
+        for (const Uplink &u : air) if (!u.resolved && u.f.start < horizon) horizon = u.f.start;
+        air.erase(std::remove_if(air.begin(), air.end(), [&](const Uplink &u) {
+            return u.resolved && u.f.end <= horizon; }), air.end());
+        gw_tx.erase(std::remove_if(gw_tx.begin(), gw_tx.end(), [&](const std::pair<uint64_t, uint64_t> &g) {
+            return g.second <= horizon; }), gw_tx.end());
+    }
+
+    void resolve(size_t i, uint64_t t) {
+        Uplink &u = air[i];
+        u.resolved = true;
+        const LoraFrame &f = u.f;
+
+        char outcome = 'R';
+        for (size_t j = 0; j < air.size() && outcome == 'R'; j++)
+            if (j != i && air[j].f.p.sf == f.p.sf && air[j].f.p.bw == f.p.bw &&
+                overlap(f.start, f.end, air[j].f.start, air[j].f.end))
+                outcome = 'C';
+        for (size_t j = 0; j < gw_tx.size() && outcome == 'R'; j++)
+            if (overlap(f.start, f.end, gw_tx[j].first, gw_tx[j].second)) outcome = 'B';
+        if (outcome == 'R' && event_rand(cfg.seed, 'U', u.node, f.start) < cfg.loss) outcome = 'L';
+        dig.add64(outcome); dig.add64(u.node); dig.add64(f.start); dig.add64(f.end); dig.add(f.data);
+
+        switch (outcome) {
+        case 'C': res.collided++; return;
+        case 'B': res.gw_busy++;  return;
+        case 'L': res.lost_up++;  return;
+        }
+
+        std::vector<uint8_t> data = f.data;
+        if (event_rand(cfg.seed, 'X', u.node, f.start) < cfg.corrupt && data.size() == FRAME_LEN) {
+            uint64_t s = cfg.seed ^ f.start;
+            uint64_t r = splitmix64(s);
+            int byte = CRC_COVERED[r % (sizeof(CRC_COVERED) / sizeof(CRC_COVERED[0]))];
+            data[byte] ^= (uint8_t)(1u << ((r >> 8) & 7));
+            res.corrupted++;
+        }
+
+        SealFrame s;
+        uint64_t first = f.start;
+        if (s.decode(data)) {
+            auto it = first_tx.find(((uint64_t)u.node << 32) | s.mono);
+            if (it != first_tx.end()) first = it->second;
+        }
+        std::vector<uint8_t> ack;
+        bool ok = gw.receive(data, f.end, first, ack);
+        dig.add64(ok);
+        if (ok) send_downlink(ack, f.p, f.end, t);
+    }
+
+    void send_downlink(const std::vector<uint8_t> &data, const LoraParams &p,
+                       uint64_t uplink_end, uint64_t t) {
+        LoraFrame d;
+        d.data = data;
+        d.p = p;
+        d.p.invert_iq = true;
+        d.start = uplink_end + (uint64_t)cfg.ack_delay_ms * 1000 * US;
+        if (d.start < gw_free) d.start = gw_free;
+        if (d.start <= t) d.start = t + 1;
+        d.end = d.start + (uint64_t)(d.p.time_on_air_us((uint32_t)data.size()) * US + 0.5);
+        gw_free = d.end;
+        gw_tx.push_back(std::make_pair(d.start, d.end));
+        res.downlinks++;
+        dig.add64('D'); dig.add64(d.start); dig.add(d.data);
+
+        // Every node hears the gateway; each reception can be lost on its own
+        for (auto &n : nodes) {
+            if (event_rand(cfg.seed, 'D', n->id, d.start) < cfg.loss) {
+                if (n->id == data[1]) res.lost_down++;
+                continue;
+            }
+            n->radio.deliver(d);
+        }
+    }
+
+    void finish() {
+        res.finished = all_done();
+        res.gw = gw.st;
+        for (auto &n : nodes) {
+            uint64_t a = std::count(n->uart.begin(), n->uart.end(), 'A');
+            uint64_t x = std::count(n->uart.begin(), n->uart.end(), 'X');
+            res.acked += a;
+            res.given_up += x;
+            res.node_cycles += n->soc.now;
+            // An ACK implies a verified record; a record given up on may
+            // still have reached the gateway (only its ACKs were lost)
+            uint64_t u = gw.unique_per_node.count(n->id) ? gw.unique_per_node[n->id] : 0;
+            if (u < a || u > a + x) res.accounting_ok = false;
+            const Sx1268 &r = n->radio;
+            res.busy_violations += r.busy_violations;
+            res.irq_latency_sum += r.irq_latency_sum;
+            res.irq_latency_n += r.irq_latency_n;
+            res.irq_latency_max = std::max(res.irq_latency_max, r.irq_latency_max);
+            res.turnaround_sum += r.turnaround_sum;
+            res.turnaround_n += r.turnaround_n;
+            res.turnaround_max = std::max(res.turnaround_max, r.turnaround_max);
+            char line[160];
+            snprintf(line, sizeof(line), "node %3d  %-12s tx %3u rx %3u timeouts %3u verified %3llu",
+                     n->id, n->uart.c_str(), n->radio.tx_count, n->radio.rx_count,
+                     n->radio.rx_timeouts, (unsigned long long)u);
+            res.node_lines.push_back(line);
+            dig.add64(n->id); dig.add(std::vector<uint8_t>(n->uart.begin(), n->uart.end()));
+            dig.add64(n->radio.rx_count); dig.add64(n->radio.rx_timeouts);
+        }
+        res.digest = dig.h;
+    }
+};
+
+// ================================================================
+// Report
+// ================================================================
+static double ms(uint64_t cycles) { return cycles / (double)(1000 * US); }
+
+static void report(const NetConfig &c, const NetResult &r, int threads) {
+    const GatewayStats &g = r.gw;
+    uint64_t records = (uint64_t)c.nodes * c.records;
+    double secs = ms(r.sim_cycles) / 1000;
+    printf("=== LoRa network: %d nodes, %u records/node, seed %llu ===\n",
+           c.nodes, c.records, (unsigned long long)c.seed);
+    printf("  simulated     %.3f s (%s), wall %.3f s on %d threads, %.1f M node-cycles/s\n",
+           secs, r.finished ? "all nodes done" : "time limit", r.wall, threads,
+           r.wall > 0 ? r.node_cycles / r.wall / 1e6 : 0.0);
+    printf("  uplinks       %llu sent, %llu collided, %llu lost, %llu gateway busy, %llu corrupted\n",
+           (unsigned long long)r.uplinks, (unsigned long long)r.collided,
+           (unsigned long long)r.lost_up, (unsigned long long)r.gw_busy,
+           (unsigned long long)r.corrupted);
+    printf("  downlinks     %llu sent, %llu lost to the addressed node\n",
+           (unsigned long long)r.downlinks, (unsigned long long)r.lost_down);
+    printf("  records       %llu sealed, %llu verified (%.1f%%), %llu acked, %llu given up, %llu duplicates\n",
+           (unsigned long long)records, (unsigned long long)g.unique,
+           records ? 100.0 * g.unique / records : 0.0, (unsigned long long)r.acked,
+           (unsigned long long)r.given_up, (unsigned long long)g.duplicates);
+    printf("  gateway       %llu received, %llu CRC fail, %llu order errors, %llu gaps, "
+           "%llu malformed, %llu sessions\n",
+           (unsigned long long)g.received, (unsigned long long)g.crc_fail,
+           (unsigned long long)g.order_errors, (unsigned long long)g.gaps,
+           (unsigned long long)g.malformed, (unsigned long long)g.sessions);
+    printf("  throughput    %.2f records/s, %.1f payload B/s, channel busy %.1f%%\n",
+           secs > 0 ? g.unique / secs : 0.0, secs > 0 ? g.unique * FRAME_LEN / secs : 0.0,
+           r.sim_cycles ? 100.0 * r.airtime / r.sim_cycles : 0.0);
+    printf("  loss          %.1f%% of records, %.1f%% of uplinks\n",
+           records ? 100.0 * (records - std::min<uint64_t>(g.unique, records)) / records : 0.0,
+           r.uplinks ? 100.0 * (r.uplinks - (g.received - g.crc_fail)) / r.uplinks : 0.0);
+    printf("  latency       mean %.1f ms, max %.1f ms (first transmission -> verified)\n",
+           g.unique ? ms(g.latency_sum) / g.unique : 0.0, ms(g.latency_max));
+    printf("  radio         TxDone->RX %.1f us mean, %.1f us max; DIO1 service %.1f us mean, "
+           "%.1f us max; %llu BUSY violations\n",
+           r.turnaround_n ? r.turnaround_sum / (double)US / r.turnaround_n : 0.0,
+           r.turnaround_max / (double)US,
+           r.irq_latency_n ? r.irq_latency_sum / (double)US / r.irq_latency_n : 0.0,
+           r.irq_latency_max / (double)US, (unsigned long long)r.busy_violations);
+    printf("  verification  %.0f ns/frame host, 9 CRC bytes/frame\n",
+           g.received ? g.verify_ns / g.received : 0.0);
+    printf("  digest        %016llx\n", (unsigned long long)r.digest);
+    if (!c.quiet)
+        for (const std::string &l : r.node_lines) printf("  %s\n", l.c_str());
+}
+
+static void usage() {
+    fprintf(stderr, "usage: lora_net [--nodes N] [--records N] [--period-ms N] [--seed S]\n"
+                    "                [--threads N] [--loss P] [--corrupt P] [--ack-delay-ms N]\n"
+                    "                [--epoch-us N] [--max-ms N] [--pin-level] [--replay-check]\n"
+                    "                [--pin-check] [--quiet] node.hex\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    NetConfig c;
+    bool replay = false, pin_check = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--nodes") && i + 1 < argc) c.nodes = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--records") && i + 1 < argc) c.records = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--period-ms") && i + 1 < argc) c.period_ms = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) c.seed = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) c.threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--loss") && i + 1 < argc) c.loss = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--corrupt") && i + 1 < argc) c.corrupt = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--ack-delay-ms") && i + 1 < argc) c.ack_delay_ms = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--epoch-us") && i + 1 < argc) c.epoch_us = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--max-ms") && i + 1 < argc) c.max_ms = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--pin-level")) c.pin_level = true;
+        else if (!strcmp(argv[i], "--replay-check")) replay = true;
+        else if (!strcmp(argv[i], "--pin-check")) pin_check = true;
+        else if (!strcmp(argv[i], "--quiet")) c.quiet = true;
+        else if (argv[i][0] == '-' || c.image) usage();
+        else c.image = argv[i];
+    }
+    if (!c.image || c.nodes < 1 || c.nodes > 255 || c.epoch_us == 0) usage();
+    // ACKs are scheduled at a barrier and must still lie in every node's future
+    if ((uint64_t)c.epoch_us * 2 > (uint64_t)c.ack_delay_ms * 1000) {
+        fprintf(stderr, "lora_net: --epoch-us must be at most half of --ack-delay-ms\n");
+        return 2;
+    }
+    int threads = c.threads > 0 ? std::min(c.threads, c.nodes) : c.nodes;
+
+    std::unique_ptr<LoraNet> net(new LoraNet(c));
+    if (!net->setup()) {
+        fprintf(stderr, "lora_net: cannot read %s\n", c.image);
+        return 2;
+    }
+    NetResult r = net->run(threads);
+    net.reset();
+    report(c, r, threads);
+
+    int fail = 0;
+    auto check = [&](bool ok, const char *what) {
+        printf("[%s] %s\n", ok ? "PASS" : "FAIL", what);
+        if (!ok) fail++;
+    };
+    check(r.finished, "every node finished its records");
+    check(r.gw.crc_fail == r.corrupted, "gateway CRC rejects exactly the corrupted uplinks");
+    check(r.gw.order_errors == 0 && r.gw.payload_mismatch == 0 && r.gw.malformed == 0,
+          "no ordering violations or malformed records");
+    check(r.accounting_ok, "node ACK/give-up counts agree with the gateway");
+    check(r.busy_violations == 0, "firmware never starts a command with BUSY high");
+
+    if (replay) {
+        std::unique_ptr<LoraNet> again(new LoraNet(c));
+        again->setup();
+        NetResult r1 = again->run(1);
+        printf("  replay        1 thread: digest %016llx, wall %.3f s\n",
+               (unsigned long long)r1.digest, r1.wall);
+        check(r1.digest == r.digest && r1.sim_cycles == r.sim_cycles,
+              "replay on one thread is identical");
+    }
+    if (pin_check) {
+        NetConfig cp = c;
+        cp.pin_level = !c.pin_level;
+        std::unique_ptr<LoraNet> again(new LoraNet(cp));
+        again->setup();
+        NetResult r1 = again->run(threads);
+        printf("  pin check     %s level: digest %016llx, wall %.3f s\n",
+               cp.pin_level ? "pin" : "byte", (unsigned long long)r1.digest, r1.wall);
+        check(r1.digest == r.digest && r1.sim_cycles == r.sim_cycles,
+              "pin-level and byte-level radio front ends agree");
+    }
+
+    if (fail == 0) printf("ALL TESTS PASSED\n");
+    return fail == 0 ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+// qspi_timing.cpp — Cycle-approximate timing of tinyQV's QSPI memory path
+
+#include "qspi_timing.h"
+
+#include <cstring>
+
+// ================================================================
+// Parameters
+// ================================================================
+static const char *const PARAM_NAMES[SocTiming::N_PARAMS] = {
+    "clk_per_byte_fetch", "exec_min", "fetch_restart", "mul_extra",
+    "mmio_extra", "lmem_extra", "psram_read_hdr", "psram_write_hdr",
+    "flash_read_hdr", "irq_entry", "prefetch_bytes",
+};
+
+const char *SocTiming::param_name(int i) { return PARAM_NAMES[i]; }
+
+uint32_t &SocTiming::param(int i) {
+    uint32_t *p[N_PARAMS] = {
+        &clk_per_byte_fetch, &exec_min, &fetch_restart, &mul_extra,
+        &mmio_extra, &lmem_extra, &psram_read_hdr, &psram_write_hdr,
+        &flash_read_hdr, &irq_entry, &prefetch_bytes,
+    };
+    return *p[i];
+}
+
+void SocTiming::print(FILE *f) const {
+    SocTiming c = *this;
+    for (int i = 0; i < N_PARAMS; i++)
+        fprintf(f, "    %-18s = %u\n", param_name(i), c.param(i));
+}
+
+// ================================================================
+// Model
+// ================================================================
+void QspiTiming::reset(uint64_t now) {
+    open = false;
+    stalled = false;
+    next_pc = 0;
+    fetch_addr = 0;
+    fetch_time = now;
+}
+
+uint32_t QspiTiming::retire(const Rv32Retire &r, uint64_t now) {
+    if (r.cls == RV_IRQ) {
+        // mepc <- pc, jump to 0x8: the buffered bytes are thrown away
+        uint64_t done = now + t.irq_entry;
+        open = false;
+        if (fetch_time < done) fetch_time = done;
+        return t.irq_entry;
+    }
+
+    uint32_t pc = r.pc & 0x0FFFFFFF;
+    uint32_t end = pc + r.len;
+
+    // Restart the stream unless this is the next sequential instruction
+    if (!open || pc != next_pc) {
+        uint64_t start = fetch_time > now ? fetch_time : now;
+        uint32_t hdr = pc >= 0x1000000 ? t.psram_read_hdr : t.fetch_restart;
+        fetch_time = start + hdr;
+        fetch_addr = pc;
+        open = true;
+    } else if (stalled && fetch_time < now) {
+        fetch_time = now;       // buffer had been full: resumes as we consume
+    }
+    stalled = false;
+    if (fetch_addr < end) {
+        fetch_time += (uint64_t)(end - fetch_addr) * t.clk_per_byte_fetch;
+        fetch_addr = end;
+    }
+
+    uint64_t issue = fetch_time > now ? fetch_time : now;
+    uint64_t done = issue + t.exec_min;
+    if (r.cls == RV_MUL) done += t.mul_extra;
+
+    if (r.mem) {
+        uint32_t a = r.mem_addr & 0x0FFFFFFF;
+        if (a < 0x2000000) {
+            uint32_t hdr = a < 0x1000000 ? t.flash_read_hdr :
+                           r.mem_write ? t.psram_write_hdr : t.psram_read_hdr;
+            done += hdr + (uint64_t)t.clk_per_byte_fetch * r.mem_size;
+            open = false;
+        } else if (a & 0x4000000) {
+            done += t.lmem_extra;
+        } else {
+            done += t.mmio_extra;
+        }
+    }
+    if (r.taken || r.trap) open = false;
+
+    if (open) {
+        // Keep streaming while the instruction executes, up to the buffer depth
+        uint32_t room = end + t.prefetch_bytes - fetch_addr;
+        uint64_t n = done > fetch_time && t.clk_per_byte_fetch ?
+                     (done - fetch_time) / t.clk_per_byte_fetch : 0;
+        if (n >= room) {
+            n = room;
+            stalled = true;
+        }
+        fetch_addr += (uint32_t)n;
+        fetch_time += n * t.clk_per_byte_fetch;
+        next_pc = end;
+    } else {
+        fetch_time = done;      // controller free once the instruction is done
+    }
+    return (uint32_t)(done - now);
+}
+
+// ================================================================
+// Trace records
+// ================================================================
+TimingTraceRec timing_trace_pack(const Rv32Retire &r, uint32_t cycles, bool reset) {
+    TimingTraceRec t;
+    memset(&t, 0, sizeof(t));
+    t.pc = r.pc;
+    t.insn = r.insn;
+    t.mem_addr = r.mem_addr;
+    t.cycles = cycles;
+    t.len = r.len;
+    t.cls = r.cls;
+    t.rd = r.rd;
+    t.flags = (r.taken || r.trap ? TT_TAKEN : 0) | (r.mem ? TT_MEM : 0) |
+              (r.mem_write ? TT_MEM_WRITE : 0) | (reset ? TT_RESET : 0);
+    if (r.mem) t.flags |= (r.mem_size == 4 ? 2 : r.mem_size == 2 ? 1 : 0) << TT_SIZE_SHIFT;
+    return t;
+}
+
+Rv32Retire timing_trace_unpack(const TimingTraceRec &t) {
+    Rv32Retire r;
+    memset(&r, 0, sizeof(r));
+    r.pc = t.pc;
+    r.insn = t.insn;
+    r.len = t.len;
+    r.cls = (Rv32Class)t.cls;
+    r.rd = t.rd;
+    r.rd_discard = -1;
+    r.taken = t.flags & TT_TAKEN;
+    r.mem = t.flags & TT_MEM;
+    r.mem_write = t.flags & TT_MEM_WRITE;
+    r.mem_size = (uint8_t)(1u << ((t.flags >> TT_SIZE_SHIFT) & 3));
+    r.mem_addr = t.mem_addr;
+    r.next_pc = t.pc + t.len;
+    return r;
+}
@@ -0,0 +1,95 @@
+// qspi_timing.h — Cycle-approximate timing of tinyQV's QSPI memory path
+//
+// tinyQV executes from XIP flash through qspi_ctrl. Sequential code is
+// streamed: once CS is low the controller keeps clocking bytes into the
+// instruction buffer while the core executes, so straight-line code costs
+// max(fetch, execute). Anything that breaks the stream pays the full
+// transaction header again:
+//
+//   taken branch / jump / IRQ entry   CS high, restart at the target
+//   load from flash                   CS high, flash read txn, restart
+//   load/store to PSRAM               CS high, PSRAM txn, restart
+//
+// MMIO and latch_mem accesses do not touch QSPI and leave the stream open.
+//
+// QspiTiming replays retired instructions (Rv32Retire) against that model
+// and returns the clock cycles each one takes. The parameters live in
+// SocTiming; the defaults follow the qspi_ctrl protocol and are not yet
+// fitted. verify/iss/calib compares and fits them against traces recorded
+// from the Verilated RTL (cosim_tb --timing-trace).
+
+#pragma once
+
+#include "rv32_core.h"
+
+#include <cstdint>
+#include <cstdio>
+
+// Cycle costs (25 MHz clocks). QSPI transfers one nibble every 2 clocks;
+// tinyQV executes 4 bits per clock.
+struct SocTiming {
+    uint32_t clk_per_byte_fetch = 4;    // 2 nibbles x 2 clk
+    uint32_t exec_min           = 8;    // 32-bit op through a 4-bit ALU
+    uint32_t fetch_restart      = 24;   // CS + 6 addr + 2 mode + 4 dummy nibbles
+    uint32_t mul_extra          = 8;
+    uint32_t mmio_extra         = 8;
+    uint32_t lmem_extra         = 4;
+    uint32_t psram_read_hdr     = 24;   // cmd 0x0B + 6 addr + 4 dummy nibbles
+    uint32_t psram_write_hdr    = 16;   // cmd 0x02 + 6 addr nibbles
+    uint32_t flash_read_hdr     = 24;   // 6 addr + 2 mode + 4 dummy nibbles
+    uint32_t irq_entry          = 8;
+    uint32_t prefetch_bytes     = 8;    // instruction buffer depth ahead of the PC
+
+    // Parameter table, for calibration and printing
+    static const int N_PARAMS = 11;
+    static const char *param_name(int i);
+    uint32_t &param(int i);
+    void print(FILE *f) const;
+};
+
+class QspiTiming {
+public:
+    SocTiming t;
+
+    QspiTiming() { reset(0); }
+
+    // Core reset released at cycle `now`: stream closed, buffer empty.
+    void reset(uint64_t now);
+
+    // Charge one retired instruction (or interrupt entry) that was ready to
+    // issue at `now`. Returns the cycles until the next one may issue.
+    uint32_t retire(const Rv32Retire &r, uint64_t now);
+
+private:
+    bool     open;          // CS low, bytes streaming into the buffer
+    bool     stalled;       // buffer filled up, stream paused
+    uint32_t next_pc;       // address the stream continues at
+    uint32_t fetch_addr;    // bytes before this address are buffered
+    uint64_t fetch_time;    // cycle the last buffered byte arrived
+};
+
+// One record of a timing trace: a retired instruction and the cycles the
+// RTL took for it (debug_instr_complete to debug_instr_complete).
+struct TimingTraceRec {
+    uint32_t pc;
+    uint32_t insn;
+    uint32_t mem_addr;
+    uint32_t cycles;
+    uint8_t  len;
+    uint8_t  cls;
+    uint8_t  flags;         // TT_* below
+    int8_t   rd;
+};
+
+enum {
+    TT_TAKEN     = 1,
+    TT_MEM       = 2,
+    TT_MEM_WRITE = 4,
+    TT_RESET     = 8,       // core reset released before this instruction
+    TT_SIZE_SHIFT = 4,      // bits 5:4 = log2(mem_size)
+};
+
+static const uint32_t TIMING_TRACE_MAGIC = 0x31545154;     // "TQT1"
+
+TimingTraceRec timing_trace_pack(const Rv32Retire &r, uint32_t cycles, bool reset);
+Rv32Retire     timing_trace_unpack(const TimingTraceRec &t);
@@ -0,0 +1,595 @@
+// rv32_core.cpp — TinyQV-compatible RV32EC + Zcb + Zicond instruction-set model
+
+#include "rv32_core.h"
+
+#include <cstring>
+
+enum Op : uint16_t {
+    OP_ILLEGAL = 0,
+    OP_LUI, OP_AUIPC, OP_JAL, OP_JALR,
+    OP_BEQ, OP_BNE, OP_BLT, OP_BGE, OP_BLTU, OP_BGEU,
+    OP_LB, OP_LH, OP_LW, OP_LBU, OP_LHU,
+    OP_SB, OP_SH, OP_SW,
+    OP_ADDI, OP_SLTI, OP_SLTIU, OP_XORI, OP_ORI, OP_ANDI,
+    OP_SLLI, OP_SRLI, OP_SRAI,
+    OP_ADD, OP_SUB, OP_SLL, OP_SLT, OP_SLTU, OP_XOR, OP_SRL, OP_SRA, OP_OR, OP_AND,
+    OP_MUL, OP_CZERO_EQZ, OP_CZERO_NEZ,
+    OP_SEXT_B, OP_SEXT_H, OP_ZEXT_B, OP_ZEXT_H, OP_NOT,
+    OP_FENCE, OP_ECALL, OP_EBREAK, OP_MRET, OP_WFI,
+    OP_CSRRW, OP_CSRRS, OP_CSRRC, OP_CSRRWI, OP_CSRRSI, OP_CSRRCI,
+};
+
+static inline int32_t sext(uint32_t v, int bits) {
+    return (int32_t)(v << (32 - bits)) >> (32 - bits);
+}
+
+static inline uint32_t bit(uint32_t v, int b) { return (v >> b) & 1u; }
+static inline uint32_t bits(uint32_t v, int hi, int lo) {
+    return (v >> lo) & ((1u << (hi - lo + 1)) - 1u);
+}
+
+// ================================================================
+// 32-bit decode
+// ================================================================
+static void decode32(uint32_t w, Rv32Decoded &d) {
+    uint32_t opc = w & 0x7F;
+    uint32_t f3  = bits(w, 14, 12);
+    uint32_t f7  = bits(w, 31, 25);
+    d.rd  = bits(w, 11, 7);
+    d.rs1 = bits(w, 19, 15);
+    d.rs2 = bits(w, 24, 20);
+    d.len = 4;
+    d.op  = OP_ILLEGAL;
+
+    int32_t imm_i = sext(w >> 20, 12);
+    int32_t imm_s = sext((bits(w, 31, 25) << 5) | bits(w, 11, 7), 12);
+    int32_t imm_b = sext((bit(w, 31) << 12) | (bit(w, 7) << 11) |
+                         (bits(w, 30, 25) << 5) | (bits(w, 11, 8) << 1), 13);
+    int32_t imm_u = (int32_t)(w & 0xFFFFF000u);
+    int32_t imm_j = sext((bit(w, 31) << 20) | (bits(w, 19, 12) << 12) |
+                         (bit(w, 20) << 11) | (bits(w, 30, 21) << 1), 21);
+
+    switch (opc) {
+    case 0x37: d.op = OP_LUI;   d.imm = imm_u; break;
+    case 0x17: d.op = OP_AUIPC; d.imm = imm_u; break;
+    case 0x6F: d.op = OP_JAL;   d.imm = imm_j; break;
+    case 0x67: if (f3 == 0) { d.op = OP_JALR; d.imm = imm_i; } break;
+    case 0x63:
+        d.imm = imm_b;
+        switch (f3) {
+        case 0: d.op = OP_BEQ;  break;
+        case 1: d.op = OP_BNE;  break;
+        case 4: d.op = OP_BLT;  break;
+        case 5: d.op = OP_BGE;  break;
+        case 6: d.op = OP_BLTU; break;
+        case 7: d.op = OP_BGEU; break;
+        }
+        break;
+    case 0x03:
+        d.imm = imm_i;
+        switch (f3) {
+        case 0: d.op = OP_LB;  break;
+        case 1: d.op = OP_LH;  break;
+        case 2: d.op = OP_LW;  break;
+        case 4: d.op = OP_LBU; break;
+        case 5: d.op = OP_LHU; break;
+        }
+        break;
+    case 0x23:
+        d.imm = imm_s;
+        switch (f3) {
+        case 0: d.op = OP_SB; break;
+        case 1: d.op = OP_SH; break;
+        case 2: d.op = OP_SW; break;
+        }
+        break;
+    case 0x13:
+        d.imm = imm_i;
+        switch (f3) {
+        case 0: d.op = OP_ADDI;  break;
+        case 2: d.op = OP_SLTI;  break;
+        case 3: d.op = OP_SLTIU; break;
+        case 4: d.op = OP_XORI;  break;
+        case 6: d.op = OP_ORI;   break;
+        case 7: d.op = OP_ANDI;  break;
+        case 1: if (f7 == 0x00) { d.op = OP_SLLI; d.imm = d.rs2; } break;
+        case 5:
+            if (f7 == 0x00)      { d.op = OP_SRLI; d.imm = d.rs2; }
+            else if (f7 == 0x20) { d.op = OP_SRAI; d.imm = d.rs2; }
+            break;
+        }
+        break;
+    case 0x33:
+        if (f7 == 0x00) {
+            static const uint16_t ops[8] = { OP_ADD, OP_SLL, OP_SLT, OP_SLTU,
+                                             OP_XOR, OP_SRL, OP_OR, OP_AND };
+            d.op = ops[f3];
+        } else if (f7 == 0x20) {
+            if (f3 == 0) d.op = OP_SUB;
+            else if (f3 == 5) d.op = OP_SRA;
+        } else if (f7 == 0x01) {
+            if (f3 == 0) d.op = OP_MUL;
+        } else if (f7 == 0x07) {
+            if (f3 == 5) d.op = OP_CZERO_EQZ;
+            else if (f3 == 7) d.op = OP_CZERO_NEZ;
+        }
+        break;
+    case 0x0F:
+        d.op = OP_FENCE;
+        break;
+    case 0x73:
+        d.imm = (int32_t)bits(w, 31, 20);   // CSR number / funct12
+        switch (f3) {
+        case 0:
+            if (w == 0x00000073) d.op = OP_ECALL;
+            else if (w == 0x00100073) d.op = OP_EBREAK;
+            else if (w == 0x30200073) d.op = OP_MRET;
+            else if (w == 0x10500073) d.op = OP_WFI;
+            break;
+        case 1: d.op = OP_CSRRW;  break;
+        case 2: d.op = OP_CSRRS;  break;
+        case 3: d.op = OP_CSRRC;  break;
+        case 5: d.op = OP_CSRRWI; break;
+        case 6: d.op = OP_CSRRSI; break;
+        case 7: d.op = OP_CSRRCI; break;
+        }
+        break;
+    }
+
+    // RV32E: only x0-x15 exist
+    if (d.op != OP_ILLEGAL && (d.rd > 15 || d.rs1 > 15 || d.rs2 > 15)) {
+        bool uses_rs2 = (opc == 0x63 || opc == 0x23 || opc == 0x33);
+        bool uses_rs1 = !(opc == 0x37 || opc == 0x17 || opc == 0x6F ||
+                          (opc == 0x73 && f3 >= 5));
+        bool uses_rd  = !(opc == 0x63 || opc == 0x23);
+        if ((uses_rd && d.rd > 15) || (uses_rs1 && d.rs1 > 15) ||
+            (uses_rs2 && d.rs2 > 15))
+            d.op = OP_ILLEGAL;
+    }
+}
+
+// ================================================================
+// 16-bit (C + Zcb) decode
+// ================================================================
+static void decode16(uint32_t h, Rv32Decoded &d) {
+    uint32_t q  = h & 3;
+    uint32_t f3 = bits(h, 15, 13);
+    uint32_t rdp  = 8 + bits(h, 4, 2);   // rd' / rs2'
+    uint32_t rs1p = 8 + bits(h, 9, 7);   // rs1' / rd'
+    uint32_t rd   = bits(h, 11, 7);
+    uint32_t rs2  = bits(h, 6, 2);
+    d.len = 2;
+    d.op  = OP_ILLEGAL;
+    d.rd = d.rs1 = d.rs2 = 0;
+    d.imm = 0;
+
+    if (q == 0) {
+        switch (f3) {
+        case 0: {   // c.addi4spn
+            uint32_t nz = (bits(h, 10, 7) << 6) | (bits(h, 12, 11) << 4) |
+                          (bit(h, 5) << 3) | (bit(h, 6) << 2);
+            if (nz) { d.op = OP_ADDI; d.rd = rdp; d.rs1 = 2; d.imm = nz; }
+            break;
+        }
+        case 2:     // c.lw
+            d.op = OP_LW; d.rd = rdp; d.rs1 = rs1p;
+            d.imm = (bit(h, 5) << 6) | (bits(h, 12, 10) << 3) | (bit(h, 6) << 2);
+            break;
+        case 6:     // c.sw
+            d.op = OP_SW; d.rs2 = rdp; d.rs1 = rs1p;
+            d.imm = (bit(h, 5) << 6) | (bits(h, 12, 10) << 3) | (bit(h, 6) << 2);
+            break;
+        case 4: {   // Zcb loads/stores
+            uint32_t f6 = bits(h, 15, 10);
+            d.rs1 = rs1p;
+            if (f6 == 0x20) {           // c.lbu
+                d.op = OP_LBU; d.rd = rdp;
+                d.imm = (bit(h, 5) << 1) | bit(h, 6);
+            } else if (f6 == 0x21) {    // c.lhu / c.lh
+                d.op = bit(h, 6) ? OP_LH : OP_LHU; d.rd = rdp;
+                d.imm = bit(h, 5) << 1;
+            } else if (f6 == 0x22) {    // c.sb
+                d.op = OP_SB; d.rs2 = rdp;
+                d.imm = (bit(h, 5) << 1) | bit(h, 6);
+            } else if (f6 == 0x23 && !bit(h, 6)) {  // c.sh
+                d.op = OP_SH; d.rs2 = rdp;
+                d.imm = bit(h, 5) << 1;
+            }
+            break;
+        }
+        }
+    } else if (q == 1) {
+        int32_t imm6 = sext((bit(h, 12) << 5) | bits(h, 6, 2), 6);
+        int32_t immj = sext((bit(h, 12) << 11) | (bit(h, 8) << 10) |
+                            (bits(h, 10, 9) << 8) | (bit(h, 6) << 7) |
+                            (bit(h, 7) << 6) | (bit(h, 2) << 5) |
+                            (bit(h, 11) << 4) | (bits(h, 5, 3) << 1), 12);
+        int32_t immb = sext((bit(h, 12) << 8) | (bits(h, 6, 5) << 6) |
+                            (bit(h, 2) << 5) | (bits(h, 11, 10) << 3) |
+                            (bits(h, 4, 3) << 1), 9);
+        switch (f3) {
+        case 0:     // c.addi / c.nop
+            d.op = OP_ADDI; d.rd = rd; d.rs1 = rd; d.imm = imm6;
+            break;
+        case 1:     // c.jal
+            d.op = OP_JAL; d.rd = 1; d.imm = immj;
+            break;
+        case 2:     // c.li
+            d.op = OP_ADDI; d.rd = rd; d.rs1 = 0; d.imm = imm6;
+            break;
+        case 3:
+            if (rd == 2) {  // c.addi16sp
+                int32_t nz = sext((bit(h, 12) << 9) | (bits(h, 4, 3) << 7) |
+                                  (bit(h, 5) << 6) | (bit(h, 2) << 5) |
+                                  (bit(h, 6) << 4), 10);
+                if (nz) { d.op = OP_ADDI; d.rd = 2; d.rs1 = 2; d.imm = nz; }
+            } else if (imm6 != 0) {     // c.lui
+                d.op = OP_LUI; d.rd = rd; d.imm = imm6 << 12;
+            }
+            break;
+        case 4: {
+            uint32_t f2 = bits(h, 11, 10);
+            d.rd = rs1p; d.rs1 = rs1p;
+            if (f2 == 0 && !bit(h, 12)) {
+                d.op = OP_SRLI; d.imm = bits(h, 6, 2);
+            } else if (f2 == 1 && !bit(h, 12)) {
+                d.op = OP_SRAI; d.imm = bits(h, 6, 2);
+            } else if (f2 == 2) {
+                d.op = OP_ANDI; d.imm = imm6;
+            } else if (f2 == 3) {
+                uint32_t f = bits(h, 6, 5);
+                d.rs2 = rdp;
+                if (!bit(h, 12)) {
+                    static const uint16_t ops[4] = { OP_SUB, OP_XOR, OP_OR, OP_AND };
+                    d.op = ops[f];
+                } else if (f == 2) {            // c.mul (Zcb)
+                    d.op = OP_MUL;
+                } else if (f == 3) {            // Zcb unary ops
+                    switch (bits(h, 4, 2)) {
+                    case 0: d.op = OP_ZEXT_B; break;
+                    case 1: d.op = OP_SEXT_B; break;
+                    case 2: d.op = OP_ZEXT_H; break;
+                    case 3: d.op = OP_SEXT_H; break;
+                    case 5: d.op = OP_NOT;    break;
+                    }
+                }
+            }
+            break;
+        }
+        case 5:     // c.j
+            d.op = OP_JAL; d.rd = 0; d.imm = immj;
+            break;
+        case 6:     // c.beqz
+            d.op = OP_BEQ; d.rs1 = rs1p; d.rs2 = 0; d.imm = immb;
+            break;
+        case 7:     // c.bnez
+            d.op = OP_BNE; d.rs1 = rs1p; d.rs2 = 0; d.imm = immb;
+            break;
+        }
+    } else if (q == 2) {
+        switch (f3) {
+        case 0:     // c.slli
+            if (!bit(h, 12)) { d.op = OP_SLLI; d.rd = rd; d.rs1 = rd; d.imm = rs2; }
+            break;
+        case 2:     // c.lwsp
+            if (rd != 0) {
+                d.op = OP_LW; d.rd = rd; d.rs1 = 2;
+                d.imm = (bits(h, 3, 2) << 6) | (bit(h, 12) << 5) | (bits(h, 6, 4) << 2);
+            }
+            break;
+        case 4:
+            if (!bit(h, 12)) {
+                if (rs2 == 0) {     // c.jr
+                    if (rd != 0) { d.op = OP_JALR; d.rd = 0; d.rs1 = rd; d.imm = 0; }
+                } else {            // c.mv
+                    d.op = OP_ADD; d.rd = rd; d.rs1 = 0; d.rs2 = rs2;
+                }
+            } else {
+                if (rd == 0 && rs2 == 0) {      // c.ebreak
+                    d.op = OP_EBREAK;
+                } else if (rs2 == 0) {          // c.jalr
+                    d.op = OP_JALR; d.rd = 1; d.rs1 = rd; d.imm = 0;
+                } else {                        // c.add
+                    d.op = OP_ADD; d.rd = rd; d.rs1 = rd; d.rs2 = rs2;
+                }
+            }
+            break;
+        case 6:     // c.swsp
+            d.op = OP_SW; d.rs1 = 2; d.rs2 = rs2;
+            d.imm = (bits(h, 8, 7) << 6) | (bits(h, 12, 9) << 2);
+            break;
+        }
+    }
+
+    if (d.op != OP_ILLEGAL && (d.rd > 15 || d.rs1 > 15 || d.rs2 > 15))
+        d.op = OP_ILLEGAL;
+}
+
+void Rv32Core::decode(uint32_t raw, Rv32Decoded &d) {
+    if ((raw & 3) == 3) decode32(raw, d);
+    else decode16(raw &= 0xFFFF, d);
+    d.raw = raw;
+    d.valid = 1;
+}
+
+const char *Rv32Core::reg_name(int r) {
+    static const char *names[16] = {
+        "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2",
+        "s0", "s1", "a0", "a1", "a2", "a3", "a4", "a5",
+    };
+    return (r >= 0 && r < 16) ? names[r] : "?";
+}
+
+// ================================================================
+// Core state
+// ================================================================
+Rv32Core::Rv32Core() : irq_lines_prev(0) {
+    reset();
+}
+
+void Rv32Core::reset() {
+    memset(x, 0, sizeof(x));
+    x[3] = GP_VALUE;
+    x[4] = TP_VALUE;
+    pc = VEC_RESET;
+    mstatus = 0;
+    mie = 0;
+    mip = 0;
+    mepc = 0;
+    mcause = 0;
+    instret = 0;
+    irq_lines_prev = 0;
+}
+
+void Rv32Core::set_icache_range(uint32_t bytes) {
+    icache.assign(bytes / 2, Rv32Decoded());
+}
+
+void Rv32Core::set_irq_lines(uint8_t lines) {
+    uint8_t rising = lines & ~irq_lines_prev;
+    irq_lines_prev = lines;
+    mip |= (uint32_t)(rising & 0x3) << 16;
+    mip = (mip & ~MIP_LEVEL_MASK) | ((uint32_t)(lines & 0xC) << 16);
+}
+
+void Rv32Core::take_irq(Rv32Retire &r) {
+    uint32_t pending = (mip & mie) >> 16;
+    uint32_t cause = 16;
+    while (!(pending & 1)) { pending >>= 1; cause++; }
+
+    memset(&r, 0, sizeof(r));
+    r.pc = pc;
+    r.cls = RV_IRQ;
+    r.rd = -1;
+    r.rd_discard = -1;
+    r.taken = true;
+
+    mepc = pc;
+    mcause = 0x80000000u | cause;
+    mstatus = (mstatus & ~MSTATUS_MPIE) | ((mstatus & MSTATUS_MIE) ? MSTATUS_MPIE : 0);
+    mstatus &= ~MSTATUS_MIE;
+    pc = VEC_IRQ;
+    r.next_pc = pc;
+}
+
+void Rv32Core::trap(Rv32Retire &r, uint32_t cause) {
+    r.trap = true;
+    r.taken = true;
+    r.rd = -1;
+    mepc = r.pc;
+    mcause = cause;
+    mstatus = (mstatus & ~MSTATUS_MPIE) | ((mstatus & MSTATUS_MIE) ? MSTATUS_MPIE : 0);
+    mstatus &= ~MSTATUS_MIE;
+    pc = VEC_TRAP;
+}
+
+uint32_t Rv32Core::read_csr(uint32_t csr, const Rv32Bus &bus, bool &ok) const {
+    ok = true;
+    switch (csr) {
+    case 0x300: return mstatus & (MSTATUS_MIE | MSTATUS_MPIE);
+    case 0x301: return 0x40000014u;     // misa: RV32, E + C
+    case 0x304: return mie;
+    case 0x341: return mepc;
+    case 0x342: return mcause;
+    case 0x344: return mip;
+    case 0xF11: return 0;               // mvendorid
+    case 0xC00: case 0xB00:
+    case 0xC01: return (uint32_t)bus.cycle_count();
+    case 0xC80: case 0xB80:
+    case 0xC81: return (uint32_t)(bus.cycle_count() >> 32);
+    case 0xC02: case 0xB02: return (uint32_t)instret;
+    case 0xC82: case 0xB82: return (uint32_t)(instret >> 32);
+    }
+    ok = false;
+    return 0;
+}
+
+bool Rv32Core::write_csr(uint32_t csr, uint32_t v) {
+    switch (csr) {
+    case 0x300: mstatus = v & (MSTATUS_MIE | MSTATUS_MPIE); return true;
+    case 0x304: mie = v & (0xFu << 16); return true;
+    case 0x341: mepc = v & ~1u; return true;
+    case 0x342: mcause = v; return true;
+    case 0x344:
+        // Only the edge-captured bits are writable; level bits follow the pins
+        mip = (mip & ~MIP_EDGE_MASK) | (v & MIP_EDGE_MASK);
+        return true;
+    case 0x301: case 0xF11:
+    case 0xC00: case 0xC01: case 0xC02: case 0xC80: case 0xC81: case 0xC82:
+    case 0xB00: case 0xB02: case 0xB80: case 0xB82:
+        return true;    // read-only / WARL: ignore
+    }
+    return false;
+}
+
+// ================================================================
+// Execute
+// ================================================================
+void Rv32Core::step(Rv32Bus &bus, Rv32Retire &r) {
+    r.pc = pc;
+    r.rd = -1;
+    r.rd_discard = -1;
+    r.taken = false;
+    r.trap = false;
+    r.mem = false;
+    r.mem_write = false;
+
+    Rv32Decoded dtmp;
+    const Rv32Decoded *d;
+    uint32_t idx = pc >> 1;
+    if (idx < icache.size()) {
+        Rv32Decoded &c = icache[idx];
+        if (!c.valid) {
+            uint32_t raw = bus.fetch16(pc);
+            if ((raw & 3) == 3) raw |= (uint32_t)bus.fetch16(pc + 2) << 16;
+            decode(raw, c);
+        }
+        d = &c;
+    } else {
+        uint32_t raw = bus.fetch16(pc);
+        if ((raw & 3) == 3) raw |= (uint32_t)bus.fetch16(pc + 2) << 16;
+        decode(raw, dtmp);
+        d = &dtmp;
+    }
+
+    r.len = d->len;
+    r.insn = d->raw;
+    uint32_t next = pc + d->len;
+    uint32_t a = x[d->rs1];
+    uint32_t b = x[d->rs2];
+    r.cls = RV_ALU;
+
+    switch (d->op) {
+    case OP_LUI:   write_rd(r, d->rd, (uint32_t)d->imm); break;
+    case OP_AUIPC: write_rd(r, d->rd, pc + (uint32_t)d->imm); break;
+    case OP_JAL:
+        write_rd(r, d->rd, next);
+        next = pc + (uint32_t)d->imm;
+        r.cls = RV_JUMP; r.taken = true;
+        break;
+    case OP_JALR: {
+        uint32_t t = (a + (uint32_t)d->imm) & ~1u;
+        write_rd(r, d->rd, next);
+        next = t;
+        r.cls = RV_JUMP; r.taken = true;
+        break;
+    }
+    case OP_BEQ:  r.taken = (a == b); goto branch;
+    case OP_BNE:  r.taken = (a != b); goto branch;
+    case OP_BLT:  r.taken = ((int32_t)a <  (int32_t)b); goto branch;
+    case OP_BGE:  r.taken = ((int32_t)a >= (int32_t)b); goto branch;
+    case OP_BLTU: r.taken = (a <  b); goto branch;
+    case OP_BGEU: r.taken = (a >= b);
+    branch:
+        r.cls = RV_BRANCH;
+        if (r.taken) next = pc + (uint32_t)d->imm;
+        break;
+
+    case OP_LB: case OP_LH: case OP_LW: case OP_LBU: case OP_LHU: {
+        int size = (d->op == OP_LB || d->op == OP_LBU) ? 1 :
+                   (d->op == OP_LW) ? 4 : 2;
+        uint32_t addr = a + (uint32_t)d->imm;
+        r.cls = RV_LOAD;
+        r.mem = true; r.mem_size = (uint8_t)size; r.mem_addr = addr;
+        uint32_t v = bus.load(addr, size);
+        r.mem_data = v;
+        if (d->op == OP_LB) v = (uint32_t)sext(v, 8);
+        else if (d->op == OP_LH) v = (uint32_t)sext(v, 16);
+        write_rd(r, d->rd, v);
+        break;
+    }
+    case OP_SB: case OP_SH: case OP_SW: {
+        int size = (d->op == OP_SB) ? 1 : (d->op == OP_SH) ? 2 : 4;
+        uint32_t addr = a + (uint32_t)d->imm;
+        uint32_t v = (size == 4) ? b : (b & ((1u << (size * 8)) - 1u));
+        r.cls = RV_STORE;
+        r.mem = true; r.mem_write = true; r.mem_size = (uint8_t)size;
+        r.mem_addr = addr; r.mem_data = v;
+        bus.store(addr, v, size);
+        break;
+    }
+
+    case OP_ADDI:  write_rd(r, d->rd, a + (uint32_t)d->imm); break;
+    case OP_SLTI:  write_rd(r, d->rd, (int32_t)a < d->imm); break;
+    case OP_SLTIU: write_rd(r, d->rd, a < (uint32_t)d->imm); break;
+    case OP_XORI:  write_rd(r, d->rd, a ^ (uint32_t)d->imm); break;
+    case OP_ORI:   write_rd(r, d->rd, a | (uint32_t)d->imm); break;
+    case OP_ANDI:  write_rd(r, d->rd, a & (uint32_t)d->imm); break;
+    case OP_SLLI:  write_rd(r, d->rd, a << (d->imm & 31)); break;
+    case OP_SRLI:  write_rd(r, d->rd, a >> (d->imm & 31)); break;
+    case OP_SRAI:  write_rd(r, d->rd, (uint32_t)((int32_t)a >> (d->imm & 31))); break;
+
+    case OP_ADD:  write_rd(r, d->rd, a + b); break;
+    case OP_SUB:  write_rd(r, d->rd, a - b); break;
+    case OP_SLL:  write_rd(r, d->rd, a << (b & 31)); break;
+    case OP_SLT:  write_rd(r, d->rd, (int32_t)a < (int32_t)b); break;
+    case OP_SLTU: write_rd(r, d->rd, a < b); break;
+    case OP_XOR:  write_rd(r, d->rd, a ^ b); break;
+    case OP_SRL:  write_rd(r, d->rd, a >> (b & 31)); break;
+    case OP_SRA:  write_rd(r, d->rd, (uint32_t)((int32_t)a >> (b & 31))); break;
+    case OP_OR:   write_rd(r, d->rd, a | b); break;
+    case OP_AND:  write_rd(r, d->rd, a & b); break;
+    case OP_MUL:  write_rd(r, d->rd, a * b); r.cls = RV_MUL; break;
+    case OP_CZERO_EQZ: write_rd(r, d->rd, b == 0 ? 0 : a); break;
+    case OP_CZERO_NEZ: write_rd(r, d->rd, b != 0 ? 0 : a); break;
+    case OP_SEXT_B: write_rd(r, d->rd, (uint32_t)sext(a, 8)); break;
+    case OP_SEXT_H: write_rd(r, d->rd, (uint32_t)sext(a, 16)); break;
+    case OP_ZEXT_B: write_rd(r, d->rd, a & 0xFF); break;
+    case OP_ZEXT_H: write_rd(r, d->rd, a & 0xFFFF); break;
+    case OP_NOT:    write_rd(r, d->rd, ~a); break;
+
+    case OP_FENCE:
+    case OP_WFI:
+        r.cls = RV_SYSTEM;
+        break;
+    case OP_ECALL:
+        r.cls = RV_SYSTEM;
+        trap(r, 11);
+        break;
+    case OP_EBREAK:
+        r.cls = RV_SYSTEM;
+        trap(r, 3);
+        break;
+    case OP_MRET:
+        r.cls = RV_SYSTEM;
+        r.taken = true;
+        next = mepc;
+        mstatus = (mstatus & ~MSTATUS_MIE) | ((mstatus & MSTATUS_MPIE) ? MSTATUS_MIE : 0);
+        mstatus |= MSTATUS_MPIE;
+        break;
+
+    case OP_CSRRW: case OP_CSRRS: case OP_CSRRC:
+    case OP_CSRRWI: case OP_CSRRSI: case OP_CSRRCI: {
+        uint32_t csr = (uint32_t)d->imm;
+        bool ok;
+        uint32_t old = read_csr(csr, bus, ok);
+        if (!ok) { r.cls = RV_CSR; trap(r, 2); break; }
+        uint32_t src = (d->op >= OP_CSRRWI) ? d->rs1 : a;
+        bool do_write = true;
+        uint32_t nv = old;
+        switch (d->op) {
+        case OP_CSRRW: case OP_CSRRWI: nv = src; break;
+        case OP_CSRRS: case OP_CSRRSI: nv = old | src;  do_write = d->rs1 != 0; break;
+        case OP_CSRRC: case OP_CSRRCI: nv = old & ~src; do_write = d->rs1 != 0; break;
+        }
+        if (do_write) write_csr(csr, nv);
+        write_rd(r, d->rd, old);
+        r.cls = RV_CSR;
+        break;
+    }
+
+    default:
+        r.cls = RV_SYSTEM;
+        trap(r, 2);
+        break;
+    }
+
+    if (r.trap) {
+        r.next_pc = pc;
+        instret++;
+        return;
+    }
+    pc = next;
+    r.next_pc = next;
+    instret++;
+}
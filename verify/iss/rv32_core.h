@@ -0,0 +1,141 @@
+// rv32_core.h — TinyQV-compatible RV32EC + Zcb + Zicond instruction-set model
+//
+// Architectural model of the tinyQV core as used by the LoRa Edge SoC:
+//   - 16 registers (RV32E), gp (x3) = 0x1000400 and tp (x4) = 0x8000000
+//     are hardwired, writes to them are ignored
+//   - C + Zcb compressed encodings, Zicond czero.eqz/czero.nez, mul
+//   - Vectors: 0x0 reset, 0x4 trap (ecall/ebreak/illegal), 0x8 interrupt
+//   - mip[17:16] edge-captured (cleared by csrc mip), mip[19:18] level
+//   - Priority: lowest IRQ number first (IRQ16 > IRQ17 > IRQ18 > IRQ19)
+//
+// The core is not cycle accurate. Each retired instruction is reported in
+// an Rv32Retire record; the SoC model (soc_model.h) turns that into clock
+// cycles and the co-simulation harness compares it against the RTL.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Memory/MMIO interface implemented by the SoC model.
+class Rv32Bus {
+public:
+    virtual ~Rv32Bus() {}
+    // size = 1, 2 or 4 bytes; returns the zero-extended raw value
+    virtual uint32_t load(uint32_t addr, int size) = 0;
+    virtual void     store(uint32_t addr, uint32_t data, int size) = 0;
+    virtual uint16_t fetch16(uint32_t addr) = 0;
+    // Free-running clock count for the cycle/time CSRs
+    virtual uint64_t cycle_count() const = 0;
+};
+
+// Coarse instruction class, used by the timing model.
+enum Rv32Class : uint8_t {
+    RV_ALU,
+    RV_MUL,
+    RV_CSR,
+    RV_LOAD,
+    RV_STORE,
+    RV_BRANCH,      // conditional branch (taken flag in Rv32Retire)
+    RV_JUMP,        // jal/jalr/c.j/c.jr/...
+    RV_SYSTEM,      // mret/ecall/ebreak/fence/wfi
+    RV_IRQ,         // pseudo-record: interrupt entry
+};
+
+struct Rv32Retire {
+    uint32_t  pc;
+    uint32_t  insn;         // raw encoding (16-bit parcels zero-extended)
+    uint32_t  next_pc;
+    uint8_t   len;          // 2 or 4 (0 for interrupt entry)
+    Rv32Class cls;
+    bool      taken;        // branch taken / control transfer
+    bool      trap;         // synchronous exception taken
+    int8_t    rd;           // destination register, -1 if none
+    uint32_t  rd_value;
+    int8_t    rd_discard;   // x0/gp/tp target the write was dropped for, -1 if none
+    bool      mem;          // load/store performed
+    bool      mem_write;
+    uint8_t   mem_size;
+    uint32_t  mem_addr;
+    uint32_t  mem_data;     // store data or raw loaded value
+};
+
+// Pre-decoded instruction (cached for code in flash).
+struct Rv32Decoded {
+    uint32_t raw;
+    uint16_t op;
+    uint8_t  rd, rs1, rs2;
+    uint8_t  len;
+    uint8_t  valid;
+    int32_t  imm;
+};
+
+class Rv32Core {
+public:
+    static const uint32_t GP_VALUE = 0x01000400u;
+    static const uint32_t TP_VALUE = 0x08000000u;
+
+    static const uint32_t VEC_RESET = 0x0;
+    static const uint32_t VEC_TRAP  = 0x4;
+    static const uint32_t VEC_IRQ   = 0x8;
+
+    // CSR bits
+    static const uint32_t MSTATUS_MIE  = 1u << 3;
+    static const uint32_t MSTATUS_MPIE = 1u << 7;
+    static const uint32_t MIP_EDGE_MASK  = 0x3u << 16;   // IRQ16, IRQ17
+    static const uint32_t MIP_LEVEL_MASK = 0x3u << 18;   // IRQ18, IRQ19
+
+    uint32_t x[16];
+    uint32_t pc;
+    uint32_t mstatus;
+    uint32_t mie;
+    uint32_t mip;
+    uint32_t mepc;
+    uint32_t mcause;
+    uint64_t instret;
+
+    Rv32Core();
+
+    void reset();
+
+    // Limit the decode cache to [0, bytes) — code there must be immutable.
+    void set_icache_range(uint32_t bytes);
+
+    // Present the 4 interrupt_req lines (bit 0 = IRQ16). Rising edges of
+    // bits 0/1 set mip, bits 2/3 are level.
+    void set_irq_lines(uint8_t lines);
+
+    bool irq_ready() const {
+        return (mstatus & MSTATUS_MIE) && (mip & mie & (0xFu << 16));
+    }
+
+    // Enter the highest-priority pending interrupt. Caller checks irq_ready().
+    void take_irq(Rv32Retire &r);
+
+    // Execute one instruction.
+    void step(Rv32Bus &bus, Rv32Retire &r);
+
+    // Read a CSR as the firmware would see it (cycle CSRs need the bus).
+    uint32_t read_csr(uint32_t csr, const Rv32Bus &bus, bool &ok) const;
+
+    static void decode(uint32_t raw, Rv32Decoded &d);
+    static const char *reg_name(int r);
+
+private:
+    uint8_t irq_lines_prev;
+    std::vector<Rv32Decoded> icache;
+
+    // x0, gp and tp are not writable; such writes are only noted in rd_discard
+    void write_rd(Rv32Retire &r, int rd, uint32_t v) {
+        if (rd == 0 || rd == 3 || rd == 4) {
+            r.rd_discard = (int8_t)rd;
+            r.rd_value = v;
+            return;
+        }
+        r.rd = (int8_t)rd;
+        r.rd_value = v;
+        x[rd] = v;
+    }
+    bool write_csr(uint32_t csr, uint32_t v);
+    void trap(Rv32Retire &r, uint32_t cause);
+};
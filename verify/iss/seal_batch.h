@@ -0,0 +1,111 @@
+// seal_batch.h — Host side of test/fw_seal_batch.h: N seal records of one
+// sensor and session in one payload
+//
+//   0  sensor_id   1  session_id   2  count (1..255)   3..6  mono of record 0, LE
+//   count x { varint mono delta (not for record 0), varint value, crc16 LE }
+//
+// varint is unsigned LEB128 (at most 5 bytes, 32 bits). decode() rebuilds
+// full SealFrames; the CRCs are carried through untouched, so a receiver
+// checks each one with SealFrame::expected_crc() as for a single record.
+// encode() is the reference the firmware encoder is tested against.
+
+#pragma once
+
+#include "seal_frame.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+static const uint32_t SEAL_BATCH_HDR = 7;
+static const uint32_t SEAL_BATCH_MAX = 255;
+
+struct SealBatch {
+    std::vector<SealFrame> frames;
+
+    static void put_varint(std::vector<uint8_t> &out, uint32_t v) {
+        while (v >= 0x80) {
+            out.push_back((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back((uint8_t)v);
+    }
+
+    static bool get_varint(const uint8_t *&p, const uint8_t *end, uint32_t &v) {
+        uint32_t x = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (p == end) return false;
+            uint8_t b = *p++;
+            if (shift == 28 && b > 0x0F) return false;     // > 32 bits
+            x |= (uint32_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) {
+                v = x;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Empty on an empty or oversized batch or mixed sensor/session
+    std::vector<uint8_t> encode() const {
+        std::vector<uint8_t> out;
+        if (frames.empty() || frames.size() > SEAL_BATCH_MAX) return out;
+        const SealFrame &f0 = frames[0];
+        for (const SealFrame &f : frames)
+            if (f.node != f0.node || f.sid != f0.sid) return out;
+        out.push_back(f0.node);
+        out.push_back(f0.sid);
+        out.push_back((uint8_t)frames.size());
+        for (int k = 0; k < 32; k += 8) out.push_back((uint8_t)(f0.mono >> k));
+        for (size_t i = 0; i < frames.size(); i++) {
+            if (i) put_varint(out, frames[i].mono - frames[i - 1].mono);
+            put_varint(out, frames[i].value);
+            out.push_back((uint8_t)frames[i].crc);
+            out.push_back((uint8_t)(frames[i].crc >> 8));
+        }
+        return out;
+    }
+
+    // False (with a reason) on a malformed payload; CRCs are not checked here
+    bool decode(const uint8_t *p, size_t len, std::string *err = nullptr) {
+        auto fail = [&](const char *why) {
+            if (err) *err = why;
+            frames.clear();
+            return false;
+        };
+        frames.clear();
+        const uint8_t *end = p + len;
+        if (len < SEAL_BATCH_HDR) return fail("short header");
+        uint32_t n = p[2];
+        if (n == 0) return fail("empty batch");
+        uint32_t mono = le32(&p[3]);
+        const uint8_t *q = p + SEAL_BATCH_HDR;
+        for (uint32_t i = 0; i < n; i++) {
+            SealFrame f;
+            uint32_t d = 0;
+            if (i && !get_varint(q, end, d)) return fail("bad mono delta");
+            mono += d;
+            if (!get_varint(q, end, f.value)) return fail("bad value");
+            if (end - q < 2) return fail("truncated crc");
+            f.node = p[0];
+            f.sid  = p[1];
+            f.mono = mono;
+            f.crc  = (uint16_t)(q[0] | (q[1] << 8));
+            q += 2;
+            frames.push_back(f);
+        }
+        if (q != end) return fail("trailing bytes");
+        return true;
+    }
+
+    bool decode(const std::vector<uint8_t> &d, std::string *err = nullptr) {
+        return decode(d.data(), d.size(), err);
+    }
+
+    size_t crc_errors() const {
+        size_t bad = 0;
+        for (const SealFrame &f : frames) bad += f.crc != f.expected_crc();
+        return bad;
+    }
+};
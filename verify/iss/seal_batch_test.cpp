@@ -0,0 +1,191 @@
+// seal_batch_test.cpp — Host decoder (seal_batch.h) against the firmware
+// encoder (test/fw_seal_batch.h)
+//
+// Usage: seal_batch_test [--seed S] [--batches N] fw_seal_batch.hex
+//
+//   1. fixed vector: a hand-assembled 3-record batch decodes field by field
+//   2. random batches (values of every varint length, mono steps 1..2^32-1)
+//      survive encode -> decode, and real-looking ones take <= half of 11 B
+//      per record
+//   3. every truncation, a trailing byte, count 0 and a 6-byte varint are
+//      rejected; a flipped value bit decodes but fails exactly one CRC
+//   4. fw_seal_batch.hex runs on the SoC model: the batch it sends on the
+//      UART ("SB", length, payload) decodes here, every record's seal CRC
+//      holds and re-encoding gives the same bytes
+
+#include "seal_batch.h"
+#include "soc_model.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const uint32_t RECORD_BYTES = 11;           // value, session, mono, crc
+
+static uint64_t rng_state;
+static uint32_t rnd() {
+    rng_state = rng_state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(rng_state >> 32);
+}
+
+static SealFrame sealed(uint8_t node, uint8_t sid, uint32_t value, uint32_t mono) {
+    SealFrame f;
+    f.node = node;
+    f.sid = sid;
+    f.value = value;
+    f.mono = mono;
+    f.crc = f.expected_crc();
+    return f;
+}
+
+static bool same(const SealFrame &a, const SealFrame &b) {
+    return a.node == b.node && a.sid == b.sid && a.value == b.value && a.mono == b.mono && a.crc == b.crc;
+}
+
+// A value of a random varint length (1..5 bytes)
+static uint32_t rnd_value() {
+    static const uint32_t lim[5] = { 0x80, 0x4000, 0x200000, 0x10000000, 0 };
+    uint32_t l = lim[rnd() % 5];
+    return l ? rnd() % l : rnd();
+}
+
+int main(int argc, char **argv) {
+    const char *image = nullptr;
+    uint64_t seed = 1;
+    int batches = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--batches") && i + 1 < argc) batches = atoi(argv[++i]);
+        else if (argv[i][0] != '-') image = argv[i];
+        else {
+            fprintf(stderr, "usage: seal_batch_test [--seed S] [--batches N] fw_seal_batch.hex\n");
+            return 2;
+        }
+    }
+    rng_state = seed;
+
+    int fail = 0;
+    auto check = [&](bool ok, const char *what) {
+        printf("[%s] %s\n", ok ? "PASS" : "FAIL", what);
+        if (!ok) fail++;
+    };
+
+    // ---- 1. fixed vector ----
+    {
+        const uint8_t v[] = {
+            0x42, 0x07, 0x03, 0x10, 0x00, 0x00, 0x01,   // sensor, session, 3, mono 0x01000010
+            0x05, 0x34, 0x12,                           // value 5, crc 0x1234
+            0x01, 0xAC, 0x02, 0x78, 0x56,               // +1, value 300, crc 0x5678
+            0x80, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0xCD, 0xAB,  // +128, 0xFFFFFFFF
+        };
+        SealBatch b;
+        bool ok = b.decode(v, sizeof(v)) && b.frames.size() == 3;
+        ok = ok && b.frames[0].node == 0x42 && b.frames[2].sid == 0x07 &&
+             b.frames[0].mono == 0x01000010 && b.frames[0].value == 5 && b.frames[0].crc == 0x1234 &&
+             b.frames[1].mono == 0x01000011 && b.frames[1].value == 300 && b.frames[1].crc == 0x5678 &&
+             b.frames[2].mono == 0x01000091 && b.frames[2].value == 0xFFFFFFFF && b.frames[2].crc == 0xABCD;
+        ok = ok && b.encode() == std::vector<uint8_t>(v, v + sizeof(v));
+        check(ok, "fixed vector decodes field by field and re-encodes identically");
+    }
+
+    // ---- 2. random round trips ----
+    {
+        bool ok = true;
+        uint64_t bytes = 0, records = 0;
+        for (int k = 0; k < batches && ok; k++) {
+            SealBatch b;
+            uint32_t n = 1 + rnd() % SEAL_BATCH_MAX;
+            uint8_t node = (uint8_t)rnd(), sid = (uint8_t)rnd();
+            uint32_t mono = rnd();
+            for (uint32_t i = 0; i < n; i++) {
+                b.frames.push_back(sealed(node, sid, rnd_value(), mono));
+                uint32_t r = rnd();
+                mono += (r & 3) == 0 ? rnd() | 1 : 1 + (r >> 30);     // mostly 1..4, sometimes huge
+            }
+            std::vector<uint8_t> enc = b.encode();
+            SealBatch d;
+            ok = !enc.empty() && enc.size() <= SEAL_BATCH_HDR + 12 * n && d.decode(enc) &&
+                 d.frames.size() == n && d.crc_errors() == 0;
+            for (uint32_t i = 0; ok && i < n; i++) ok = same(d.frames[i], b.frames[i]);
+
+            // Sensor-like batch: 12-bit readings, back-to-back commits
+            SealBatch s;
+            uint32_t value = rnd() & 0xFFF;
+            for (uint32_t i = 0; i < n; i++) {
+                value = (value + (rnd() & 7) - 3) & 0xFFF;
+                s.frames.push_back(sealed(node, sid, value, mono + i));
+            }
+            bytes += s.encode().size();
+            records += n;
+        }
+        check(ok, "random batches round-trip (every varint length, any mono step)");
+        printf("  sensor-like batches: %.2f B/record vs %u (%.0f%%)\n",
+               (double)bytes / records, RECORD_BYTES, 100.0 * bytes / (records * RECORD_BYTES));
+        check(bytes * 2 <= records * RECORD_BYTES, "12-bit readings take at most half the air time");
+    }
+
+    // ---- 3. malformed payloads ----
+    {
+        SealBatch b;
+        for (uint32_t i = 0; i < 8; i++)
+            b.frames.push_back(sealed(0x42, 1, rnd_value(), 100 + 2 * i));
+        std::vector<uint8_t> enc = b.encode();
+        SealBatch d;
+        bool ok = true;
+        for (size_t len = 0; len < enc.size() && ok; len++) ok = !d.decode(enc.data(), len);
+        std::vector<uint8_t> t = enc;
+        t.push_back(0);
+        ok = ok && !d.decode(t);
+        t = enc;
+        t[2] = 0;
+        ok = ok && !d.decode(t);
+        const uint8_t over[] = { 0x42, 1, 1, 0, 0, 0, 0, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01, 0, 0 };
+        const uint8_t wide[] = { 0x42, 1, 1, 0, 0, 0, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F, 0, 0 };
+        ok = ok && !d.decode(over, sizeof(over)) && !d.decode(wide, sizeof(wide));
+        check(ok, "truncated, padded, empty and over-long payloads are rejected");
+
+        t = enc;
+        t[SEAL_BATCH_HDR] ^= 0x01;                  // value of record 0 (its low varint bits)
+        ok = d.decode(t) && d.crc_errors() == 1 && d.frames[0].crc != d.frames[0].expected_crc();
+        check(ok, "a flipped value bit fails exactly that record's CRC");
+    }
+
+    // ---- 4. firmware encoder ----
+    if (image) {
+        SocModel soc;
+        if (!soc.load_hex(image)) {
+            fprintf(stderr, "seal_batch_test: cannot read %s\n", image);
+            return 2;
+        }
+        std::string uart;
+        soc.on_uart_tx = [&](uint8_t b) {
+            uart += (char)b;
+            if (uart.find("DN") != std::string::npos && uart.find("K3") != std::string::npos) soc.stop();
+        };
+        soc.run_until(20000000);
+
+        size_t at = uart.find("SB");
+        bool ok = at != std::string::npos && at + 3 <= uart.size();
+        std::vector<uint8_t> payload;
+        if (ok) {
+            size_t len = (uint8_t)uart[at + 2];
+            ok = at + 3 + len <= uart.size();
+            if (ok) payload.assign(uart.begin() + at + 3, uart.begin() + at + 3 + len);
+        }
+        std::string err;
+        SealBatch d;
+        ok = ok && d.decode(payload, &err);
+        printf("  firmware batch: %zu records, %zu bytes (%u as single records, %u as %u-byte uplinks)%s%s\n",
+               d.frames.size(), payload.size(), (unsigned)(d.frames.size() * RECORD_BYTES),
+               (unsigned)(d.frames.size() * SEAL_FRAME_LEN), SEAL_FRAME_LEN,
+               err.empty() ? "" : ", ", err.c_str());
+        check(ok && uart.find("K1K2K3DN") != std::string::npos, "firmware self-check K1K2K3 and its batch decodes");
+        check(ok && d.frames.size() == 16 && d.crc_errors() == 0, "every firmware record's seal CRC holds");
+        check(ok && d.encode() == payload, "host and firmware encoders agree byte for byte");
+    }
+
+    if (fail == 0) printf("ALL TESTS PASSED\n");
+    return fail == 0 ? 0 : 1;
+}
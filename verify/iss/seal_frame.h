@@ -0,0 +1,61 @@
+// seal_frame.h — Seal record as firmware ships it: {sensor_id, SEAL_DATA
+// read 0, read 1, read 2}, 13 bytes, 32-bit words little endian
+//
+// seal_register.v serialises a sealed record over three SEAL_DATA reads:
+//   read 0  value[31:0]
+//   read 1  {session_id[7:0], mono_count[23:0]}
+//   read 2  {mono_count[31:24], crc16[15:0], 8'h00}
+// The CRC is CRC-16/MODBUS over sensor_id, value (LE) and mono_count (LE),
+// computed by the shared crc16_engine. Used by lora_net (LoRa uplinks) and
+// verify/uart_sink.h (records framed on the UART).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+static const uint32_t SEAL_FRAME_LEN = 13;
+
+inline uint16_t crc16_modbus(uint16_t c, uint8_t b) {
+    c ^= b;
+    for (int i = 0; i < 8; i++)
+        c = (c & 1) ? (uint16_t)((c >> 1) ^ 0xA001) : (uint16_t)(c >> 1);
+    return c;
+}
+
+inline uint32_t le32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+struct SealFrame {
+    uint8_t  node;          // sensor_id
+    uint32_t value;
+    uint8_t  sid;
+    uint32_t mono;
+    uint16_t crc;
+
+    void decode(const uint8_t *d) {
+        uint32_t w1 = le32(&d[5]), w2 = le32(&d[9]);
+        node  = d[0];
+        value = le32(&d[1]);
+        sid   = (uint8_t)(w1 >> 24);
+        mono  = (w1 & 0xFFFFFF) | (w2 & 0xFF000000);
+        crc   = (uint16_t)(w2 >> 8);
+    }
+
+    bool decode(const std::vector<uint8_t> &d) {
+        if (d.size() != SEAL_FRAME_LEN) return false;
+        decode(d.data());
+        return true;
+    }
+
+    // seal_register.v: sensor_id, value LE, mono LE
+    uint16_t expected_crc() const {
+        uint16_t c = 0xFFFF;
+        c = crc16_modbus(c, node);
+        for (int i = 0; i < 4; i++) c = crc16_modbus(c, (uint8_t)(value >> (8 * i)));
+        for (int i = 0; i < 4; i++) c = crc16_modbus(c, (uint8_t)(mono >> (8 * i)));
+        return c;
+    }
+};
@@ -0,0 +1,658 @@
+// soc_model.cpp — Functional model of the LoRa Edge SoC
+
+#include "soc_model.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const uint64_t NEVER = ~(uint64_t)0;
+
+// seal_register.v: commit write at cycle w -> S_IDLE again at w + 92
+// (init + 9 bytes x 10 clk + S_LATCH wait for the last byte).
+static const uint32_t SEAL_COMMIT_CLKS = 92;
+
+// i2c_master.v PHY: one bit = 4 prescale periods; START 2, repeated
+// START 4, STOP 3. A few clocks of FSM handshake per bit on top.
+static const uint32_t I2C_BIT_OVERHEAD = 2;
+
+// uo_out when no GPIO override is selected: TXD idle, SX1268 RESET high,
+// SCL/SDA released, MOSI/SCK low, CS high, LED off.
+static const uint8_t UO_DEFAULT = 0x57;
+
+SocModel::SocModel()
+    : resets(0), wdt_resets(0), soft_resets(0),
+      stop_req(false), ui(0x8C),    // MISO, SDA and UART RX idle high
+      i2c_slave(nullptr) {
+    memset(flash, 0xFF, sizeof(flash));
+    cpu.set_icache_range(FLASH_BYTES);
+    power_on_reset();
+}
+
+// ================================================================
+// Image loading
+// ================================================================
+bool load_verilog_hex(const char *path, uint8_t *mem, uint32_t size) {
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+    uint32_t addr = 0;
+    char tok[64];
+    while (fscanf(f, "%63s", tok) == 1) {
+        if (tok[0] == '@') {
+            addr = (uint32_t)strtoul(tok + 1, nullptr, 16);
+        } else {
+            if (addr < size)
+                mem[addr] = (uint8_t)strtoul(tok, nullptr, 16);
+            addr++;
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+bool SocModel::load_hex(const char *path) {
+    if (!load_verilog_hex(path, flash, FLASH_BYTES)) return false;
+    cpu.set_icache_range(FLASH_BYTES);     // drop stale decodes
+    return true;
+}
+
+// ================================================================
+// Reset
+// ================================================================
+void SocModel::power_on_reset() {
+    now = 0;
+    epoch = 0;
+    resets = wdt_resets = soft_resets = 0;
+    memset(psram, 0xFF, sizeof(psram));
+    memset(lmem, 0, sizeof(lmem));
+    uart_rx_q.clear();
+    cpu.reset();
+    timing.reset(0);
+    reset_since_retire = false;
+    reset_peripherals();
+}
+
+// Everything below rst_reg_n. PSRAM and latch_mem keep their contents.
+void SocModel::reset_peripherals() {
+    soft_reset_pending = false;
+    gpio_out = gpio_out_sel = 0;
+    pps_count = 0;
+
+    timer_load = 0;
+    timer_t0 = 0;
+
+    wdt_enabled = false;
+    wdt_load = 0;
+    wdt_t0 = 0;
+    wdt_expire = NEVER;
+
+    rtc_base = 0;
+    rtc_t0 = 0;
+
+    uart_tx_done = 0;
+    uart_tx_byte = -1;
+    uart_rx_data = 0;
+    uart_rx_valid = false;
+
+    spi_divider = 0;
+    spi_rx = 0;
+    spi_done = 0;
+
+    crc = 0xFFFF;
+    crc_done = 0;
+
+    seal_value_reg = 0;
+    seal_mono = 0;
+    seal_session_id = 0;
+    seal_session_locked = false;
+    sealed_value = sealed_mono = 0;
+    sealed_crc = 0;
+    sealed_sid = 0;
+    seal_read_seq = 0;
+    seal_commit_dropped = false;
+    seal_busy_flag = false;
+    seal_done = 0;
+    seal_sid_pending = 0;
+
+    i2c_prescale = 63;
+    i2c_addr_latch = 0;
+    i2c_cmd_pending = false;
+    i2c_cmd_addr = 0;
+    i2c_cmd_start = i2c_cmd_read = i2c_cmd_write_m = i2c_cmd_stop = false;
+    i2c_cmd_time = 0;
+    i2c_tx_pending = false;
+    i2c_tx_data = 0;
+    i2c_tx_last = false;
+    i2c_tx_time = 0;
+    i2c_rx_has = false;
+    i2c_rx_latch = 0;
+    i2c_missed_ack = false;
+    i2c_state = I2C_IDLE;
+    i2c_op_end = now;
+    i2c_cur_addr = 0;
+    i2c_mode_read = i2c_mode_write_m = i2c_mode_stop = false;
+    i2c_m_valid = false;
+    i2c_m_data = 0;
+    i2c_pend_nack = false;
+    i2c_pend_rx = false;
+    i2c_pend_rx_data = 0;
+}
+
+// WDT expiry or SYSINFO 0xA5 write at cycle `at`: 32-clock hold, then the
+// CPU fetches from 0x0 again.
+void SocModel::system_reset(uint64_t at, bool wdt) {
+    // A byte still on the wire when rst_reg_n drops is lost
+    if (uart_tx_byte >= 0 && uart_tx_done <= at && on_uart_tx)
+        on_uart_tx((uint8_t)uart_tx_byte);
+
+    resets++;
+    if (wdt) wdt_resets++;
+    else soft_resets++;
+    if (on_reset) on_reset(wdt);
+
+    uint64_t release = at + RESET_HOLD_CLKS;
+    if (release > now) now = release;
+    epoch = now;
+    cpu.reset();
+    timing.reset(now);
+    reset_since_retire = true;
+    reset_peripherals();
+}
+
+// ================================================================
+// Pins
+// ================================================================
+void SocModel::set_ui_in(uint8_t v) {
+    if ((v & 0x10) && !(ui & 0x10)) pps_count++;
+    ui = v;
+}
+
+uint8_t SocModel::uo_out() const {
+    return (gpio_out_sel & gpio_out) | (~gpio_out_sel & UO_DEFAULT);
+}
+
+void SocModel::uart_rx_inject(uint8_t byte) {
+    uint64_t t = now;
+    if (!uart_rx_q.empty() && uart_rx_q.back().first > t) t = uart_rx_q.back().first;
+    uart_rx_q.push_back(std::make_pair(t + 10 * UART_BIT_CLKS, byte));
+}
+
+// ================================================================
+// Timer / WDT
+// ================================================================
+uint32_t SocModel::timer_value() const {
+    uint64_t el = ticks(now) - timer_t0;
+    return el >= timer_load ? 0 : timer_load - (uint32_t)el;
+}
+
+bool SocModel::timer_irq() const {
+    return timer_load != 0 && ticks(now) - timer_t0 >= timer_load;
+}
+
+uint32_t SocModel::irq_lines() const {
+    return (ui & 1) | (timer_irq() ? 2 : 0) | (uart_rx_valid ? 4 : 0);
+}
+
+// ================================================================
+// CRC16 / seal
+// ================================================================
+uint16_t SocModel::crc16_byte(uint16_t c, uint8_t b) {
+    c ^= b;
+    for (int i = 0; i < 8; i++)
+        c = (c & 1) ? (uint16_t)((c >> 1) ^ 0xA001) : (uint16_t)(c >> 1);
+    return c;
+}
+
+void SocModel::seal_sync() {
+    if (!seal_busy_flag || now < seal_done) return;
+
+    // The seal drives the shared engine: init, then sid, value, mono (LE)
+    uint16_t c = 0xFFFF;
+    c = crc16_byte(c, seal_sid_pending);
+    for (int i = 0; i < 4; i++) c = crc16_byte(c, (uint8_t)(seal_value_reg >> (8 * i)));
+    for (int i = 0; i < 4; i++) c = crc16_byte(c, (uint8_t)(seal_mono >> (8 * i)));
+    crc = c;
+    crc_done = 0;
+
+    sealed_value = seal_value_reg;
+    sealed_mono  = seal_mono;
+    sealed_crc   = c;
+    if (!seal_session_locked) {
+        seal_session_id = (uint8_t)(ticks(seal_done - 1) / 1000);
+        seal_session_locked = true;
+    }
+    sealed_sid = seal_session_id;
+    seal_mono++;
+    seal_busy_flag = false;
+}
+
+// ================================================================
+// I2C: i2c_peripheral bridge + Forencich i2c_master at byte level
+// ================================================================
+bool SocModel::i2c_busy(uint64_t t) const {
+    return t < i2c_op_end || i2c_state == I2C_WRITE_1;
+}
+
+void SocModel::i2c_bus_address(uint64_t &t, bool repeated) {
+    uint64_t bit = 4 * (uint64_t)i2c_prescale + I2C_BIT_OVERHEAD;
+    t += (repeated ? 4 : 2) * (uint64_t)i2c_prescale;
+    if (i2c_slave) {
+        i2c_slave->advance(t);
+        i2c_slave->start();
+    }
+    t += 9 * bit;
+    if (i2c_slave) i2c_slave->advance(t);
+    bool ack = i2c_slave && i2c_slave->address(i2c_cur_addr, i2c_mode_read);
+    if (!ack) i2c_pend_nack = true;
+
+    if (i2c_mode_read) {
+        i2c_bus_read_byte(t);
+    } else {
+        i2c_state = I2C_WRITE_1;
+    }
+}
+
+void SocModel::i2c_bus_read_byte(uint64_t &t) {
+    uint64_t bit = 4 * (uint64_t)i2c_prescale + I2C_BIT_OVERHEAD;
+    if (i2c_slave) i2c_slave->advance(t);
+    i2c_pend_rx_data = i2c_slave ? i2c_slave->read() : 0xFF;
+    t += 8 * bit;
+    i2c_pend_rx = true;
+    if (i2c_mode_stop) {
+        // NACK the last byte, then STOP
+        t += bit + 3 * (uint64_t)i2c_prescale;
+        if (i2c_slave) {
+            i2c_slave->advance(t);
+            i2c_slave->read_ack(false);
+            i2c_slave->stop();
+        }
+        i2c_state = I2C_IDLE;
+    } else {
+        i2c_state = I2C_ACTIVE_READ;
+    }
+}
+
+// Advance the master to time t. Each accepted command/data beat runs its
+// whole bus sequence at once; results (RX byte, missed_ack) land at
+// i2c_op_end, which is also when the master can take the next beat.
+void SocModel::i2c_sync(uint64_t t) {
+    for (;;) {
+        if (i2c_op_end > t) return;
+
+        if (i2c_pend_nack) { i2c_missed_ack = true; i2c_pend_nack = false; }
+        if (i2c_pend_rx) {
+            i2c_m_valid = true;
+            i2c_m_data = i2c_pend_rx_data;
+            i2c_pend_rx = false;
+        }
+        if (i2c_m_valid && !i2c_rx_has) {
+            i2c_rx_latch = i2c_m_data;
+            i2c_rx_has = true;
+            i2c_m_valid = false;
+        }
+
+        uint64_t bit = 4 * (uint64_t)i2c_prescale + I2C_BIT_OVERHEAD;
+        uint64_t begin;
+
+        if (i2c_state == I2C_WRITE_1) {
+            if (!i2c_tx_pending || i2c_cmd_pending) return;
+            begin = i2c_tx_time > i2c_op_end ? i2c_tx_time : i2c_op_end;
+            if (begin > t) return;
+            i2c_tx_pending = false;
+            uint64_t e = begin + 9 * bit;
+            if (i2c_slave) i2c_slave->advance(e);
+            bool ack = i2c_slave && i2c_slave->write(i2c_tx_data);
+            if (!ack) i2c_pend_nack = true;
+            if (i2c_mode_write_m && !i2c_tx_last) {
+                i2c_state = I2C_WRITE_1;
+            } else if (i2c_mode_stop) {
+                e += 3 * (uint64_t)i2c_prescale;
+                if (i2c_slave) {
+                    i2c_slave->advance(e);
+                    i2c_slave->stop();
+                }
+                i2c_state = I2C_IDLE;
+            } else {
+                i2c_state = I2C_ACTIVE_WRITE;
+            }
+            i2c_op_end = e;
+            continue;
+        }
+
+        if (!i2c_cmd_pending) return;
+        if (i2c_state == I2C_ACTIVE_READ && i2c_m_valid) return;   // cmd_ready = !m_valid
+        begin = i2c_cmd_time > i2c_op_end ? i2c_cmd_time : i2c_op_end;
+        if (begin > t) return;
+        i2c_cmd_pending = false;
+
+        bool rw = i2c_cmd_read ^ i2c_cmd_write_m;
+        bool stop_only = i2c_cmd_stop && !i2c_cmd_read && !i2c_cmd_write_m;
+        uint64_t e = begin;
+        int from = i2c_state;
+
+        if (rw) {
+            bool new_addr = i2c_cmd_addr != i2c_cur_addr;
+            i2c_cur_addr = i2c_cmd_addr;
+            i2c_mode_read = i2c_cmd_read;
+            i2c_mode_write_m = i2c_cmd_write_m;
+            i2c_mode_stop = i2c_cmd_stop;
+            if (from == I2C_IDLE) {
+                i2c_bus_address(e, false);
+            } else if (from == I2C_ACTIVE_WRITE) {
+                if (i2c_cmd_start || new_addr || i2c_cmd_read)
+                    i2c_bus_address(e, true);
+                else
+                    i2c_state = I2C_WRITE_1;
+            } else {    // ACTIVE_READ: ACK/NACK the previous byte first
+                bool restart = i2c_cmd_start || new_addr || !i2c_cmd_read;
+                if (i2c_slave) i2c_slave->read_ack(!restart);
+                e += bit;
+                if (restart) i2c_bus_address(e, true);
+                else i2c_bus_read_byte(e);
+            }
+        } else if (stop_only && from != I2C_IDLE) {
+            if (from == I2C_ACTIVE_READ) {
+                if (i2c_slave) i2c_slave->read_ack(false);
+                e += bit;
+            }
+            e += 3 * (uint64_t)i2c_prescale;
+            if (i2c_slave) {
+                i2c_slave->advance(e);
+                i2c_slave->stop();
+            }
+            i2c_state = I2C_IDLE;
+        }
+        // else: handshake completes with no bus activity
+        i2c_op_end = e > begin ? e : begin + 1;
+    }
+}
+
+// ================================================================
+// MMIO
+// ================================================================
+uint32_t SocModel::mmio_read(uint32_t slot, bool consume) {
+    switch (slot) {
+    case PERI_GPIO_OUT:     return uo_out();
+    case PERI_GPIO_IN:      return ui;
+    case PERI_CRC16:
+        if (seal_busy()) return 0x10000u | crc;
+        return (now < crc_done ? 0x10000u : 0) | crc;
+    case PERI_GPIO_OUT_SEL: return gpio_out_sel;
+    case PERI_UART: {
+        uint32_t v = uart_rx_data;
+        if (consume) uart_rx_valid = false;
+        return v;
+    }
+    case PERI_UART_STATUS:
+        return (uart_rx_valid ? 2u : 0) | (now < uart_tx_done ? 1u : 0);
+    case PERI_I2C_DATA: {
+        i2c_sync(now);
+        uint32_t v = (i2c_tx_pending ? 1u << 11 : 0) | (i2c_rx_has ? 1u << 10 : 0) |
+                     (i2c_busy(now) ? 1u << 9 : 0) | (i2c_missed_ack ? 1u << 8 : 0) |
+                     i2c_rx_latch;
+        // read_complete: consume the latch, refill from the master if waiting
+        if (!consume) return v;
+        if (i2c_m_valid) {
+            i2c_rx_latch = i2c_m_data;
+            i2c_m_valid = false;
+        } else {
+            i2c_rx_has = false;
+        }
+        return v;
+    }
+    case PERI_I2C_CONFIG:   return i2c_prescale;
+    case PERI_SPI:          return spi_rx;
+    case PERI_SPI_STATUS:   return now < spi_done ? 1u : 0;
+    case PERI_RTC:
+        return rtc_base + (uint32_t)((ticks(now) - rtc_t0) / 1000000);
+    case PERI_SEAL_DATA: {
+        seal_sync();
+        uint32_t v = seal_read_seq == 0 ? sealed_value :
+                     seal_read_seq == 1 ? ((uint32_t)sealed_sid << 24) | (sealed_mono & 0xFFFFFF) :
+                     ((sealed_mono >> 24) << 24) | ((uint32_t)sealed_crc << 8);
+        if (consume) seal_read_seq = seal_read_seq == 2 ? 0 : seal_read_seq + 1;
+        return v;
+    }
+    case PERI_TIMER:        return timer_value();
+    case PERI_WDT: {
+        if (!wdt_enabled) return 0;
+        uint64_t el = ticks(now) - wdt_t0;
+        return el >= wdt_load ? 0 : wdt_load - (uint32_t)el;
+    }
+    case PERI_SEAL_CTRL: {
+        bool busy = seal_busy();
+        return (seal_commit_dropped ? 4u : 0) | (busy ? 1u : 2u);
+    }
+    case PERI_SYSINFO:      return ((uint32_t)pps_count << 16) | 0x0110;
+    }
+    return 0xFFFFFFFFu;
+}
+
+void SocModel::mmio_write(uint32_t slot, uint32_t d) {
+    switch (slot) {
+    case PERI_GPIO_OUT:
+    case PERI_GPIO_OUT_SEL: {
+        uint8_t before = uo_out();
+        if (slot == PERI_GPIO_OUT) gpio_out = (uint8_t)d;
+        else gpio_out_sel = (uint8_t)d;
+        if (on_uo_out && uo_out() != before) on_uo_out(uo_out());
+        break;
+    }
+    case PERI_CRC16:
+        if (seal_busy()) break;                 // seal owns the engine
+        if (d & 0x100) {
+            crc = 0xFFFF;
+            crc_done = 0;
+        } else if (now >= crc_done) {
+            crc = crc16_byte(crc, (uint8_t)d);
+            crc_done = now + 9;
+        }
+        break;
+    case PERI_UART:
+        if (now < uart_tx_done) break;
+        if (uart_tx_byte >= 0 && on_uart_tx) on_uart_tx((uint8_t)uart_tx_byte);
+        uart_tx_byte = d & 0xFF;
+        uart_tx_done = now + 1 + 10 * UART_BIT_CLKS;
+        break;
+    case PERI_I2C_DATA: {
+        i2c_sync(now);
+        bool start = d & (1u << 8), rd = d & (1u << 9), wr = d & (1u << 10);
+        bool wm = d & (1u << 11), stop = d & (1u << 12);
+        bool is_start_write = start && (wr || wm);
+        bool is_data_write  = !start && (wr || wm);
+        bool is_stop_only   = stop && !start && !wr && !wm && !rd;
+        if ((is_start_write || rd || is_stop_only) && !i2c_cmd_pending) {
+            i2c_cmd_pending = true;
+            i2c_cmd_time = now + 1;
+            if (is_start_write) {
+                // write_multiple so the master loops in WRITE_1, STOP on tlast
+                i2c_cmd_addr = d & 0x7F;
+                i2c_cmd_start = true;
+                i2c_cmd_read = false;
+                i2c_cmd_write_m = true;
+                i2c_cmd_stop = true;
+            } else if (rd) {
+                i2c_cmd_addr = start ? (d & 0x7F) : i2c_addr_latch;
+                i2c_cmd_start = start;
+                i2c_cmd_read = true;
+                i2c_cmd_write_m = false;
+                i2c_cmd_stop = stop;
+            } else {
+                i2c_cmd_addr = i2c_addr_latch;
+                i2c_cmd_start = false;
+                i2c_cmd_read = false;
+                i2c_cmd_write_m = false;
+                i2c_cmd_stop = true;
+            }
+        }
+        if (start) i2c_addr_latch = d & 0x7F;
+        if (is_data_write && !i2c_tx_pending) {
+            i2c_tx_pending = true;
+            i2c_tx_data = (uint8_t)d;
+            i2c_tx_last = stop;
+            i2c_tx_time = now + 1;
+        }
+        if (start || rd || wr || wm || stop) i2c_missed_ack = false;
+        break;
+    }
+    case PERI_I2C_CONFIG:
+        i2c_sync(now);
+        i2c_prescale = (uint16_t)d;
+        break;
+    case PERI_SPI:
+        if (now < spi_done) break;
+        spi_rx = on_spi_byte ? on_spi_byte((uint8_t)d) : ((ui & 4) ? 0xFF : 0x00);
+        spi_done = now + 2 + 16 * (uint64_t)(spi_divider + 1);
+        if ((d & 0x100) && on_spi_end) on_spi_end();
+        break;
+    case PERI_SPI_STATUS:
+        spi_divider = d & 0xF;
+        break;
+    case PERI_RTC:
+        rtc_base = d;
+        rtc_t0 = ticks(now);
+        break;
+    case PERI_SEAL_DATA:
+        if (!seal_busy()) seal_value_reg = d;
+        break;
+    case PERI_TIMER:
+        timer_load = d;
+        timer_t0 = ticks(now);
+        break;
+    case PERI_WDT:
+        if (d == 0) break;                      // cannot be disabled
+        wdt_enabled = true;
+        wdt_load = d;
+        wdt_t0 = ticks(now);
+        wdt_expire = tick_cycle(wdt_t0 + d);
+        break;
+    case PERI_SEAL_CTRL:
+        if (!(d & 2)) break;                    // standalone crc_reset: see below
+        if (seal_busy()) {
+            seal_commit_dropped = true;
+        } else {
+            seal_sid_pending = (uint8_t)(d >> 2);
+            seal_read_seq = 0;
+            seal_commit_dropped = false;
+            seal_busy_flag = true;
+            seal_done = now + SEAL_COMMIT_CLKS;
+        }
+        // seal_register's standalone crc_init pulse is issued while the seal
+        // is idle, when project.v routes the CPU bridge to the engine, so it
+        // never reaches crc16_engine. The model keeps that behaviour.
+        break;
+    case PERI_SYSINFO:
+        if ((d & 0xFF) == 0xA5) soft_reset_pending = true;
+        break;
+    }
+}
+
+// ================================================================
+// Rv32Bus
+// ================================================================
+// project.v peripheral decode: {addr[27:7], addr[1:0]} == 23'h400000
+// selects slot addr[6:2], anything else is PERI_NONE (read mux default
+// 0xFFFFFFFF, writes dropped). A byte/halfword access with a non-zero
+// offset therefore never reaches a peripheral.
+static const int PERI_NONE = -1;
+
+static inline int connect_peripheral(uint32_t a) {
+    uint32_t sel = ((a >> 7) & 0x1FFFFFu) << 2 | (a & 3u);
+    return sel == 0x400000u ? (int)((a >> 2) & 0x1F) : PERI_NONE;
+}
+
+uint32_t SocModel::load(uint32_t addr, int size) {
+    addr &= 0x0FFFFFFF;
+    uint32_t v = 0;
+    if (addr < 0x2000000) {
+        bool ram = addr >= 0x1000000;
+        for (int i = size - 1; i >= 0; i--) {
+            uint32_t a = addr + i;
+            uint8_t b = !ram ? flash[a % FLASH_BYTES] :
+                        a < 0x1800000 ? psram[a % PSRAM_BYTES] : 0xFF;
+            v = (v << 8) | b;
+        }
+        return v;
+    }
+    if (addr & 0x4000000) {
+        for (int i = size - 1; i >= 0; i--)
+            v = (v << 8) | lmem[(addr + i) % LMEM_BYTES];
+        return v;
+    }
+    int slot = connect_peripheral(addr);
+    v = slot != PERI_NONE ? mmio_read((uint32_t)slot) : 0xFFFFFFFFu;
+    return size == 4 ? v : v & ((1u << (8 * size)) - 1);
+}
+
+void SocModel::store(uint32_t addr, uint32_t data, int size) {
+    addr &= 0x0FFFFFFF;
+    if (addr < 0x2000000) {
+        if (addr >= 0x1000000 && addr < 0x1800000)
+            for (int i = 0; i < size; i++)
+                psram[(addr + i) % PSRAM_BYTES] = (uint8_t)(data >> (8 * i));
+        return;
+    }
+    if (addr & 0x4000000) {
+        for (int i = 0; i < size; i++)
+            lmem[(addr + i) % LMEM_BYTES] = (uint8_t)(data >> (8 * i));
+        return;
+    }
+    int slot = connect_peripheral(addr);
+    if (slot != PERI_NONE) mmio_write((uint32_t)slot, data);
+}
+
+uint16_t SocModel::fetch16(uint32_t addr) {
+    addr &= 0x0FFFFFFF;
+    if (addr < 0x1000000)
+        return (uint16_t)(flash[addr % FLASH_BYTES] | (flash[(addr + 1) % FLASH_BYTES] << 8));
+    if (addr < 0x1800000)
+        return (uint16_t)(psram[addr % PSRAM_BYTES] | (psram[(addr + 1) % PSRAM_BYTES] << 8));
+    return 0xFFFF;
+}
+
+// ================================================================
+// Execution
+// ================================================================
+void SocModel::service_events() {
+    if (now >= wdt_expire) {
+        system_reset(wdt_expire, true);
+        return;
+    }
+    if (uart_tx_byte >= 0 && now >= uart_tx_done) {
+        uint8_t b = (uint8_t)uart_tx_byte;
+        uart_tx_byte = -1;
+        if (on_uart_tx) on_uart_tx(b);
+    }
+    while (!uart_rx_q.empty() && uart_rx_q.front().first <= now) {
+        uart_rx_data = uart_rx_q.front().second;
+        uart_rx_valid = true;
+        uart_rx_q.pop_front();
+    }
+}
+
+void SocModel::step() {
+    service_events();
+
+    cpu.set_irq_lines((uint8_t)irq_lines());
+    if (cpu.irq_ready())
+        cpu.take_irq(ret);
+    else
+        cpu.step(*this, ret);
+    uint64_t issued = now;
+    uint32_t cost = timing.retire(ret, now);
+    now += cost;
+    if (on_retire) on_retire(ret, cost, reset_since_retire);
+    reset_since_retire = false;
+
+    if (soft_reset_pending) system_reset(issued, false);
+}
+
+void SocModel::advance_to(uint64_t t) {
+    if (t > now) now = t;
+    service_events();
+}
+
+void SocModel::run_until(uint64_t cycles) {
+    stop_req = false;
+    while (now < cycles && !stop_req) step();
+}
@@ -0,0 +1,226 @@
+// soc_model.h — Functional model of the LoRa Edge SoC (tt_um_techhu_rv32_trial)
+//
+// Couples the Rv32Core ISS to C++ models of everything project.v hangs off
+// the tinyQV data bus:
+//
+//   0x0000000  Flash 256 KB (XIP, read-only)     qspi_flash_model.v
+//   0x1000000  PSRAM RAM_A 8 KB (wraps)          qspi_psram_model.v
+//   0x4000000  latch_mem 32 B                    latch_mem.v
+//   0x8000000  16 MMIO slots (slot = addr[6:2])  project.v
+//
+// Peripherals are evaluated lazily against a global clock counter (`now`):
+// tick_1us, the countdown timer, WDT, RTC and session_ctr are computed from
+// the cycle of the last write instead of being clocked, so polling loops
+// cost one host call per instruction regardless of the tick rate. The
+// CRC16 engine, seal FSM and I2C master complete in one step and expose
+// their RTL busy windows as "busy until cycle N".
+//
+// Read side effects (UART RX, I2C RX, SEAL_DATA sequence) fire once per
+// load, which is the ISS equivalent of RULE A (read_complete).
+//
+// Timing is approximate: each retired instruction is charged by QspiTiming,
+// which models the XIP fetch stream and QSPI data transactions
+// (qspi_timing.h). UART signatures and peripheral behaviour match the RTL;
+// cycle counts are estimates from the qspi_ctrl protocol and have not been
+// fitted to RTL traces yet (verify/iss/calib does that once they exist).
+
+#pragma once
+
+#include "rv32_core.h"
+#include "i2c_slave.h"
+#include "qspi_timing.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+// Read an objcopy "-O verilog" image (@addr + hex bytes) into mem[0, size).
+bool load_verilog_hex(const char *path, uint8_t *mem, uint32_t size);
+
+class SocModel : public Rv32Bus {
+public:
+    static const uint32_t CLK_HZ      = 25000000;
+    static const uint32_t FLASH_BYTES = 256 * 1024;
+    static const uint32_t PSRAM_BYTES = 8 * 1024;
+    static const uint32_t LMEM_BYTES  = 32;
+
+    static const uint32_t UART_BIT_CLKS   = CLK_HZ / 115200;   // 217
+    static const uint32_t RESET_HOLD_CLKS = 34;                // hold counter + rst_reg_n
+
+    // MMIO slots (project.v PERI_*)
+    enum {
+        PERI_GPIO_OUT = 0x0, PERI_GPIO_IN, PERI_CRC16, PERI_GPIO_OUT_SEL,
+        PERI_UART, PERI_UART_STATUS, PERI_I2C_DATA, PERI_I2C_CONFIG,
+        PERI_SPI, PERI_SPI_STATUS, PERI_RTC, PERI_SEAL_DATA,
+        PERI_TIMER, PERI_WDT, PERI_SEAL_CTRL, PERI_SYSINFO,
+    };
+
+    Rv32Core   cpu;
+    QspiTiming timing;      // cycle cost of each retired instruction
+
+    uint8_t flash[FLASH_BYTES];
+    uint8_t psram[PSRAM_BYTES];
+    uint8_t lmem[LMEM_BYTES];
+
+    uint64_t now;           // clock cycles since power-on
+    uint32_t resets;        // WDT + soft resets since power-on
+    uint32_t wdt_resets;
+    uint32_t soft_resets;
+
+    // Host hooks (all optional)
+    std::function<void(uint8_t)> on_uart_tx;            // byte fully shifted out
+    std::function<void(uint8_t)> on_uo_out;             // uo_out changed by GPIO write
+    std::function<uint8_t(uint8_t)> on_spi_byte;        // MOSI byte -> MISO byte
+    std::function<void()> on_spi_end;                   // CS released (end_txn)
+    std::function<void(bool wdt)> on_reset;             // WDT / soft reset entered
+    // Every retired instruction with its cycle cost; after_reset marks the
+    // first one fetched from 0x0 after a WDT/soft reset
+    std::function<void(const Rv32Retire &, uint32_t cycles, bool after_reset)> on_retire;
+
+    SocModel();
+
+    // Objcopy "-O verilog" image into flash. Returns false on I/O error.
+    bool load_hex(const char *path);
+
+    void power_on_reset();
+
+    // Execute one instruction (or interrupt entry) and advance `now`.
+    void step();
+
+    // Run until `now` reaches `cycles` or stop() is called from a hook.
+    void run_until(uint64_t cycles);
+    void stop() { stop_req = true; }
+
+    // Pins
+    void    set_ui_in(uint8_t v);
+    uint8_t ui_in() const { return ui; }
+    uint8_t uo_out() const;
+
+    // Queue a byte on uart_rxd; it becomes valid one frame time from now.
+    void uart_rx_inject(uint8_t byte);
+
+    void attach_i2c(I2cSlave *s) { i2c_slave = s; }
+
+    // Bus-master access without the core, for transaction-level harnesses
+    // (verify/rand_mmio_tb.cpp): move `now` forward to t and deliver due
+    // events, then use load()/store() as the CPU would. mmio_peek() returns
+    // a slot's value without its read side effects (RULE A: no
+    // read_complete).
+    void     advance_to(uint64_t t);
+    uint32_t mmio_peek(uint32_t slot) { return mmio_read(slot, false); }
+
+    // Rv32Bus
+    uint32_t load(uint32_t addr, int size) override;
+    void     store(uint32_t addr, uint32_t data, int size) override;
+    uint16_t fetch16(uint32_t addr) override;
+    uint64_t cycle_count() const override { return now; }
+
+    // Last retired instruction, for tracing/co-simulation
+    const Rv32Retire &last() const { return ret; }
+
+private:
+    Rv32Retire ret;
+    bool       stop_req;
+    uint8_t    ui;
+
+    // ---- tick_1us ----
+    uint64_t epoch;             // cycle rst_reg_n went high
+    uint64_t ticks(uint64_t c) const { return c > epoch ? (c - epoch) / 25 : 0; }
+    uint64_t tick_cycle(uint64_t n) const { return epoch + 25 * n; }
+
+    // ---- GPIO / PPS ----
+    uint8_t  gpio_out, gpio_out_sel;
+    uint16_t pps_count;
+
+    // ---- Timer ----
+    uint32_t timer_load;
+    uint64_t timer_t0;          // tick count when loaded
+    uint32_t timer_value() const;
+    bool     timer_irq() const;
+
+    // ---- WDT ----
+    bool     wdt_enabled;
+    uint32_t wdt_load;
+    uint64_t wdt_t0;
+    uint64_t wdt_expire;        // cycle of wdt_reset pulse (UINT64_MAX = never)
+
+    // ---- RTC ----
+    uint32_t rtc_base;
+    uint64_t rtc_t0;
+
+    // ---- UART ----
+    uint64_t uart_tx_done;      // busy while now < uart_tx_done
+    int      uart_tx_byte;      // -1 = nothing in flight
+    uint8_t  uart_rx_data;
+    bool     uart_rx_valid;
+    std::deque<std::pair<uint64_t, uint8_t>> uart_rx_q;
+
+    // ---- SPI ----
+    uint8_t  spi_divider;
+    uint8_t  spi_rx;
+    uint64_t spi_done;
+
+    // ---- CRC16 engine (shared with seal) ----
+    uint16_t crc;
+    uint64_t crc_done;
+    static uint16_t crc16_byte(uint16_t c, uint8_t b);
+
+    // ---- Seal ----
+    uint32_t seal_value_reg;
+    uint32_t seal_mono;
+    uint8_t  seal_session_id;
+    bool     seal_session_locked;
+    uint32_t sealed_value, sealed_mono;
+    uint16_t sealed_crc;
+    uint8_t  sealed_sid;
+    uint8_t  seal_read_seq;
+    bool     seal_commit_dropped;
+    bool     seal_busy_flag;
+    uint64_t seal_done;
+    uint8_t  seal_sid_pending;
+    void     seal_sync();
+    bool     seal_busy() { seal_sync(); return seal_busy_flag; }
+
+    // ---- I2C (i2c_peripheral bridge + functional Forencich master) ----
+    I2cSlave *i2c_slave;
+    uint16_t i2c_prescale;
+    uint8_t  i2c_addr_latch;
+    bool     i2c_cmd_pending;
+    uint8_t  i2c_cmd_addr;
+    bool     i2c_cmd_start, i2c_cmd_read, i2c_cmd_write_m, i2c_cmd_stop;
+    uint64_t i2c_cmd_time;
+    bool     i2c_tx_pending;
+    uint8_t  i2c_tx_data;
+    bool     i2c_tx_last;
+    uint64_t i2c_tx_time;
+    bool     i2c_rx_has;
+    uint8_t  i2c_rx_latch;
+    bool     i2c_missed_ack;
+    // master
+    enum { I2C_IDLE, I2C_ACTIVE_WRITE, I2C_ACTIVE_READ, I2C_WRITE_1 };
+    int      i2c_state;         // state the master settles in after i2c_op_end
+    uint64_t i2c_op_end;        // master busy (in a bus sequence) until this cycle
+    uint8_t  i2c_cur_addr;
+    bool     i2c_mode_read, i2c_mode_write_m, i2c_mode_stop;
+    bool     i2c_m_valid;       // byte waiting on m_axis_data
+    uint8_t  i2c_m_data;
+    bool     i2c_pend_nack;     // missed_ack pulse due at i2c_op_end
+    bool     i2c_pend_rx;       // m_axis byte due at i2c_op_end
+    uint8_t  i2c_pend_rx_data;
+    void     i2c_sync(uint64_t t);
+    void     i2c_bus_address(uint64_t &t, bool repeated);
+    void     i2c_bus_read_byte(uint64_t &t);
+    bool     i2c_busy(uint64_t t) const;
+
+    // ---- Reset ----
+    bool soft_reset_pending;    // SYSINFO 0xA5 seen during this step
+    bool reset_since_retire;
+    void reset_peripherals();
+    void system_reset(uint64_t at, bool wdt);
+
+    // ---- Bus helpers ----
+    uint32_t mmio_read(uint32_t slot, bool consume = true);
+    void     mmio_write(uint32_t slot, uint32_t data);
+    uint32_t irq_lines() const;
+    void     service_events();
+};
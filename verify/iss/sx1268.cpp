@@ -0,0 +1,411 @@
+// sx1268.cpp — Behavioral model of the Semtech SX1268 LoRa transceiver
+
+#include "sx1268.h"
+#include "soc_model.h"
+
+#include <cmath>
+#include <cstring>
+
+static const uint64_t NEVER = ~(uint64_t)0;
+
+// Opcodes (SX126x datasheet 13)
+enum {
+    OP_SET_SLEEP          = 0x84,
+    OP_SET_STANDBY        = 0x80,
+    OP_SET_FS             = 0xC1,
+    OP_SET_TX             = 0x83,
+    OP_SET_RX             = 0x82,
+    OP_SET_PACKET_TYPE    = 0x8A,
+    OP_SET_RF_FREQUENCY   = 0x86,
+    OP_SET_TX_PARAMS      = 0x8E,
+    OP_SET_MOD_PARAMS     = 0x8B,
+    OP_SET_PKT_PARAMS     = 0x8C,
+    OP_SET_BUFFER_BASE    = 0x8F,
+    OP_SET_DIO_IRQ_PARAMS = 0x08,
+    OP_WRITE_BUFFER       = 0x0E,
+    OP_READ_BUFFER        = 0x1E,
+    OP_WRITE_REGISTER     = 0x0D,
+    OP_READ_REGISTER      = 0x1D,
+    OP_GET_IRQ_STATUS     = 0x12,
+    OP_CLEAR_IRQ_STATUS   = 0x02,
+    OP_GET_RX_BUF_STATUS  = 0x13,
+    OP_GET_PKT_STATUS     = 0x14,
+    OP_GET_STATUS         = 0xC0,
+};
+
+// Status byte command status field
+enum { CMD_DATA_AVAILABLE = 2, CMD_TIMEOUT = 3, CMD_TX_DONE = 6 };
+
+static const uint16_t REG_RANDOM_NUMBER = 0x0819;   // 4 bytes, MSB first
+
+// 15.625 us timeout units -> 25 MHz cycles (x 390.625)
+static uint64_t timeout_cycles(uint32_t t) { return ((uint64_t)t * 3125) / 8; }
+static uint64_t us_cycles(uint32_t us) { return (uint64_t)us * (Sx1268::CLK_HZ / 1000000); }
+
+// ================================================================
+// LoRa time on air
+// ================================================================
+uint32_t LoraParams::bw_hz() const {
+    switch (bw) {
+    case 0x00: return 7810;
+    case 0x08: return 10420;
+    case 0x01: return 15630;
+    case 0x09: return 20830;
+    case 0x02: return 31250;
+    case 0x0A: return 41670;
+    case 0x03: return 62500;
+    case 0x04: return 125000;
+    case 0x05: return 250000;
+    case 0x06: return 500000;
+    }
+    return 125000;
+}
+
+double LoraParams::time_on_air_us(uint32_t len) const {
+    double tsym = (double)(1u << sf) * 1e6 / bw_hz();
+    int n_crc = crc_on ? 16 : 0;
+    int n_hdr = implicit ? 0 : 20;
+    int bits, div;
+    double fixed;
+    if (sf <= 6) {
+        bits = 8 * (int)len + n_crc - 4 * sf + n_hdr;
+        div = 4 * sf;
+        fixed = 6.25 + 8;
+    } else {
+        bits = 8 * (int)len + n_crc - 4 * sf + 8 + n_hdr;
+        div = 4 * (ldro ? sf - 2 : sf);
+        fixed = 4.25 + 8;
+    }
+    int n_payload = bits > 0 ? (bits + div - 1) / div * (cr + 4) : 0;
+    return (preamble + fixed + n_payload) * tsym;
+}
+
+// ================================================================
+// Radio
+// ================================================================
+void Sx1268::reset() {
+    power_on_state();
+    in_reset = false;
+    busy_until = 0;
+    air.clear();
+    pin_dio1 = pin_busy = false;
+    tx_count = rx_count = rx_timeouts = rx_missed = 0;
+    busy_violations = 0;
+    irq_latency_sum = irq_latency_max = 0;
+    irq_latency_n = 0;
+    turnaround_sum = turnaround_max = 0;
+    turnaround_n = 0;
+}
+
+// Everything a cold start loses (frames on the air are not the chip's)
+void Sx1268::power_on_state() {
+    m = MODE_STBY_RC;
+    p = LoraParams();
+    payload_len = 0;
+    tx_base = rx_base = 0;
+    memset(buf, 0, sizeof(buf));
+    irq = irq_mask = dio1_mask = 0;
+    cmd_status = 0;
+    rx_len = rx_start = 0;
+    rng_word = 0;
+    cmd.clear();
+    selected = dropped = false;
+    tx_end = 0;
+    rx_listen = 0;
+    rx_deadline = NEVER;
+    rx_continuous = false;
+    receiving = false;
+    cold_sleep = false;
+    dio1_rise = NEVER;
+    tx_done_at = NEVER;
+}
+
+void Sx1268::set_busy(uint64_t until, uint64_t now) {
+    busy_until = until;
+    update_pins(now);
+}
+
+void Sx1268::set_irq(uint16_t bits, uint64_t now) {
+    irq |= bits & irq_mask;     // only enabled sources latch
+    update_pins(now);
+}
+
+void Sx1268::update_pins(uint64_t now) {
+    bool d = dio1(), b = busy_until > now;
+    if (d == pin_dio1 && b == pin_busy) return;
+    if (d && !pin_dio1) dio1_rise = now;
+    pin_dio1 = d;
+    pin_busy = b;
+    if (on_pins) on_pins(pin_dio1, pin_busy);
+}
+
+uint8_t Sx1268::read_register(uint16_t addr) {
+    if (addr >= REG_RANDOM_NUMBER && addr < REG_RANDOM_NUMBER + 4) {
+        if (addr == REG_RANDOM_NUMBER) rng_word = random ? random() : 0;
+        return (uint8_t)(rng_word >> (8 * (3 - (addr - REG_RANDOM_NUMBER))));
+    }
+    return 0;
+}
+
+void Sx1268::set_nreset(bool level, uint64_t now) {
+    sync(now);
+    if (!level && !in_reset) {
+        in_reset = true;
+        power_on_state();
+        set_busy(NEVER, now);
+    } else if (level && in_reset) {
+        in_reset = false;
+        set_busy(now + us_cycles(timing.cold_start_us), now);
+    }
+}
+
+void Sx1268::spi_select(uint64_t now) {
+    if (selected) return;
+    sync(now);
+    selected = true;
+    cmd.clear();
+    dropped = true;
+    if (in_reset) return;
+    if (m == MODE_SLEEP) {
+        // CS low wakes the chip; the transaction itself is not decoded
+        m = MODE_STBY_RC;
+        set_busy(now + us_cycles(cold_sleep ? timing.cold_start_us : timing.warm_start_us), now);
+        return;
+    }
+    if (pin_busy) {
+        busy_violations++;
+        return;
+    }
+    dropped = false;
+    if (dio1_rise != NEVER) {
+        uint64_t lat = now - dio1_rise;
+        irq_latency_sum += lat;
+        if (lat > irq_latency_max) irq_latency_max = lat;
+        irq_latency_n++;
+        dio1_rise = NEVER;
+    }
+}
+
+uint8_t Sx1268::spi_out(uint64_t now) {
+    spi_select(now);
+    if (dropped) return 0xFF;
+    size_t i = cmd.size();
+    if (i == 0) return status();
+
+    switch (cmd[0]) {
+    case OP_GET_IRQ_STATUS:
+        return i == 1 ? status() : i == 2 ? (uint8_t)(irq >> 8) : i == 3 ? (uint8_t)irq : 0;
+    case OP_GET_RX_BUF_STATUS:
+        return i == 1 ? status() : i == 2 ? rx_len : i == 3 ? rx_start : 0;
+    case OP_GET_PKT_STATUS:
+        // RssiPkt -40 dBm, SnrPkt +10 dB, SignalRssiPkt -40 dBm
+        return i == 1 ? status() : i == 2 ? 80 : i == 3 ? 40 : i == 4 ? 80 : 0;
+    case OP_READ_BUFFER:
+        return i < 3 ? status() : buf[(uint8_t)(cmd[1] + i - 3)];
+    case OP_READ_REGISTER:
+        return i < 4 ? status() : read_register((uint16_t)(((cmd[1] << 8) | cmd[2]) + i - 4));
+    }
+    return status();
+}
+
+void Sx1268::spi_in(uint8_t mosi, uint64_t now) {
+    spi_select(now);
+    if (dropped) return;
+    size_t i = cmd.size();
+    cmd.push_back(mosi);
+    if (cmd[0] == OP_WRITE_BUFFER && i >= 2) buf[(uint8_t)(cmd[1] + i - 2)] = mosi;
+}
+
+void Sx1268::spi_end(uint64_t now) {
+    if (!selected) return;
+    sync(now);
+    selected = false;
+    if (!dropped && !cmd.empty()) {
+        set_busy(now + us_cycles(timing.cmd_us), now);
+        execute(now);
+    }
+    cmd.clear();
+}
+
+void Sx1268::execute(uint64_t now) {
+    const std::vector<uint8_t> &c = cmd;
+    switch (c[0]) {
+    case OP_SET_SLEEP: {
+        bool warm = c.size() > 1 && (c[1] & 0x04);
+        uint8_t keep_status = cmd_status;
+        if (!warm) power_on_state();
+        cmd_status = keep_status;
+        memset(buf, 0, sizeof(buf));        // the data buffer is never retained
+        m = MODE_SLEEP;
+        receiving = false;
+        rx_deadline = NEVER;
+        set_busy(NEVER, now);
+        cold_sleep = !warm;
+        break;
+    }
+    case OP_SET_STANDBY:
+        m = (c.size() > 1 && c[1]) ? MODE_STBY_XOSC : MODE_STBY_RC;
+        receiving = false;
+        break;
+    case OP_SET_FS:
+        m = MODE_FS;
+        receiving = false;
+        set_busy(now + us_cycles(timing.fs_us), now);
+        break;
+    case OP_SET_MOD_PARAMS:
+        if (c.size() < 5) break;
+        p.sf = c[1];
+        p.bw = c[2];
+        p.cr = c[3];
+        p.ldro = c[4] != 0;
+        break;
+    case OP_SET_PKT_PARAMS:
+        if (c.size() < 7) break;
+        p.preamble = (uint16_t)((c[1] << 8) | c[2]);
+        p.implicit = c[3] != 0;
+        payload_len = c[4];
+        p.crc_on = c[5] != 0;
+        p.invert_iq = c[6] != 0;
+        break;
+    case OP_SET_BUFFER_BASE:
+        if (c.size() < 3) break;
+        tx_base = c[1];
+        rx_base = c[2];
+        break;
+    case OP_SET_DIO_IRQ_PARAMS:
+        if (c.size() < 5) break;
+        irq_mask = (uint16_t)((c[1] << 8) | c[2]);
+        dio1_mask = (uint16_t)((c[3] << 8) | c[4]);
+        update_pins(now);
+        break;
+    case OP_CLEAR_IRQ_STATUS:
+        if (c.size() < 3) break;
+        irq &= (uint16_t)~((c[1] << 8) | c[2]);
+        update_pins(now);
+        break;
+    case OP_SET_TX: {
+        LoraFrame f;
+        f.p = p;
+        for (uint32_t k = 0; k < payload_len; k++) f.data.push_back(buf[(uint8_t)(tx_base + k)]);
+        f.start = now + us_cycles(timing.tx_setup_us);
+        f.end = f.start + (uint64_t)llround(p.time_on_air_us(payload_len) * (CLK_HZ / 1000000));
+        m = MODE_TX;
+        receiving = false;
+        tx_end = f.end;
+        tx_count++;
+        set_busy(f.start, now);
+        if (on_tx) on_tx(f);
+        break;
+    }
+    case OP_SET_RX: {
+        if (c.size() < 4) break;
+        uint32_t t = ((uint32_t)c[1] << 16) | ((uint32_t)c[2] << 8) | c[3];
+        m = MODE_RX;
+        receiving = false;
+        rx_listen = now + us_cycles(timing.rx_setup_us);
+        rx_continuous = t == 0xFFFFFF;
+        rx_deadline = (t == 0 || rx_continuous) ? NEVER : rx_listen + timeout_cycles(t);
+        set_busy(rx_listen, now);
+        if (tx_done_at != NEVER) {
+            uint64_t ta = rx_listen - tx_done_at;
+            turnaround_sum += ta;
+            if (ta > turnaround_max) turnaround_max = ta;
+            turnaround_n++;
+            tx_done_at = NEVER;
+        }
+        break;
+    }
+    }
+}
+
+uint64_t Sx1268::next_event() const {
+    uint64_t t = NEVER;
+    if (m == MODE_TX) t = tx_end;
+    if (m == MODE_RX) t = receiving ? rx_frame.end : rx_deadline;
+    if (!air.empty() && air.front().start < t) t = air.front().start;
+    if (pin_busy && busy_until < t) t = busy_until;
+    return t;
+}
+
+void Sx1268::sync(uint64_t now) {
+    for (;;) {
+        uint64_t t = next_event();
+        if (t == NEVER || t > now) return;
+
+        if (pin_busy && t == busy_until) {
+            update_pins(t);
+        } else if (m == MODE_TX && t == tx_end) {
+            m = MODE_STBY_RC;
+            cmd_status = CMD_TX_DONE;
+            tx_done_at = t;
+            set_irq(IRQ_TX_DONE, t);
+        } else if (m == MODE_RX && receiving && t == rx_frame.end) {
+            receiving = false;
+            rx_start = rx_base;
+            rx_len = (uint8_t)rx_frame.data.size();
+            for (size_t k = 0; k < rx_frame.data.size(); k++)
+                buf[(uint8_t)(rx_base + k)] = rx_frame.data[k];
+            rx_count++;
+            if (!rx_continuous) m = MODE_STBY_RC;
+            cmd_status = CMD_DATA_AVAILABLE;
+            set_irq(IRQ_RX_DONE, t);
+        } else if (!air.empty() && t == air.front().start) {
+            LoraFrame f = air.front();
+            air.pop_front();
+            // Demodulated only if listening with the same SF/BW/IQ setting
+            if (m == MODE_RX && !receiving && t >= rx_listen && f.p.sf == p.sf &&
+                f.p.bw == p.bw && f.p.invert_iq == p.invert_iq) {
+                receiving = true;
+                rx_frame = f;
+                set_irq(IRQ_PREAMBLE | IRQ_HEADER_VALID, t);
+            } else {
+                rx_missed++;
+            }
+        } else {
+            // RX timeout with nothing detected
+            m = MODE_STBY_RC;
+            rx_timeouts++;
+            cmd_status = CMD_TIMEOUT;
+            set_irq(IRQ_TIMEOUT, t);
+        }
+    }
+}
+
+void Sx1268::deliver(const LoraFrame &f) {
+    auto it = air.end();
+    while (it != air.begin() && (it - 1)->start > f.start) --it;
+    air.insert(it, f);
+}
+
+// ================================================================
+// SoC model binding
+// ================================================================
+void sx1268_connect(SocModel &soc, Sx1268 &radio) {
+    soc.on_spi_byte = [&soc, &radio](uint8_t b) { return radio.spi_byte(b, soc.now); };
+    soc.on_spi_end = [&soc, &radio]() {
+        radio.spi_end(soc.now);
+        soc.stop();             // a command may have scheduled an event
+    };
+    soc.on_uo_out = [&soc, &radio](uint8_t uo) {
+        radio.set_nreset((uo & 2) != 0, soc.now);
+        soc.stop();
+    };
+    radio.on_pins = [&soc](bool dio1, bool busy) {
+        uint8_t ui = soc.ui_in() & ~3;
+        soc.set_ui_in((uint8_t)(ui | (dio1 ? 1 : 0) | (busy ? 2 : 0)));
+    };
+    radio.on_pins(radio.dio1(), radio.busy());
+}
+
+void sx1268_loopback_ack(Sx1268 &radio, uint64_t delay_cycles) {
+    radio.on_tx = [&radio, delay_cycles](const LoraFrame &f) {
+        if (f.data.size() != 13) return;
+        LoraFrame a;
+        a.data = { 'A', f.data[0], f.data[5], f.data[6], f.data[7], f.data[12] };
+        a.p = f.p;
+        a.p.invert_iq = true;
+        a.start = f.end + delay_cycles;
+        a.end = a.start + (uint64_t)llround(a.p.time_on_air_us(6) * (Sx1268::CLK_HZ / 1000000));
+        radio.deliver(a);
+    };
+}
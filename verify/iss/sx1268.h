@@ -0,0 +1,188 @@
+// sx1268.h — Behavioral model of the Semtech SX1268 LoRa transceiver
+//
+// The radio sits on spi_ctrl (uo_out[5:3], ui_in[2]) with BUSY on ui_in[1],
+// DIO1 on ui_in[0] and NRESET on uo_out[1]. The model decodes SPI commands
+// a byte at a time: spi_out() is the MISO byte for the next position,
+// spi_in() the MOSI byte that was clocked in, spi_end() is CS going high.
+// spi_byte() does both for hosts that work at byte level (SocModel);
+// Sx1268Pins (sx1268_pins.h) drives the same calls from pin levels.
+//
+// Supported (LoRa packet type only):
+//   SetSleep, SetStandby, SetFs, SetPacketType, SetRfFrequency,
+//   SetTxParams, SetModulationParams, SetPacketParams,
+//   SetBufferBaseAddress, SetDioIrqParams, WriteBuffer, ReadBuffer,
+//   WriteRegister, ReadRegister (0x0819 RandomNumberGen), SetTx, SetRx,
+//   GetIrqStatus, ClearIrqStatus, GetRxBufferStatus, GetPacketStatus,
+//   GetStatus
+// Anything else is accepted and ignored.
+//
+// Time is counted in SoC clock cycles. SetTx puts the buffer on air after
+// the TX ramp-up, for the LoRa time-on-air of the current modulation and
+// packet parameters, and raises TxDone at the end. Received packets come
+// from the host (deliver()); one is demodulated when the receiver is
+// listening (SetRx plus RX setup) at its start with matching SF/BW/IQ,
+// and RxDone is raised at its end.
+//
+// BUSY goes high when CS releases a command and stays high for the
+// command's processing time (Sx1268Timing), in sleep and while NRESET is
+// low, and for the wake-up / cold start that follows. A transaction that
+// starts while BUSY is high is dropped and counted in busy_violations;
+// one that starts in sleep only wakes the radio (as on the chip).
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+class SocModel;
+
+struct LoraParams {
+    uint8_t  sf        = 7;
+    uint8_t  bw        = 0x04;  // SetModulationParams code (0x04 = 125 kHz)
+    uint8_t  cr        = 1;     // 1..4 = 4/5..4/8
+    bool     ldro      = false;
+    uint16_t preamble  = 8;
+    bool     implicit  = false;
+    bool     crc_on    = true;
+    bool     invert_iq = false;
+
+    uint32_t bw_hz() const;
+    // Semtech SX126x datasheet 6.1.4
+    double   time_on_air_us(uint32_t payload_len) const;
+};
+
+// Mode switching and command processing times (SX126x datasheet 13.x
+// typical values), in microseconds
+struct Sx1268Timing {
+    uint32_t cmd_us        = 3;     // BUSY after any other command
+    uint32_t fs_us         = 50;    // STBY_RC -> FS
+    uint32_t tx_setup_us   = 126;   // SetTx -> first preamble symbol
+    uint32_t rx_setup_us   = 83;    // SetRx -> receiver listening
+    uint32_t warm_start_us = 340;   // sleep (config retained) -> STBY_RC
+    uint32_t cold_start_us = 3500;  // cold sleep or NRESET -> STBY_RC
+};
+
+struct LoraFrame {
+    std::vector<uint8_t> data;
+    LoraParams p;
+    uint64_t   start;           // SoC clock cycles
+    uint64_t   end;
+};
+
+class Sx1268 {
+public:
+    enum Mode { MODE_SLEEP = 0, MODE_STBY_RC = 2, MODE_STBY_XOSC = 3, MODE_FS = 4, MODE_RX = 5, MODE_TX = 6 };
+
+    enum {
+        IRQ_TX_DONE      = 1 << 0,
+        IRQ_RX_DONE      = 1 << 1,
+        IRQ_PREAMBLE     = 1 << 2,
+        IRQ_HEADER_VALID = 1 << 4,
+        IRQ_CRC_ERR      = 1 << 6,
+        IRQ_TIMEOUT      = 1 << 9,
+    };
+
+    static const uint32_t CLK_HZ = 25000000;    // SoC clock, the model's time base
+
+    // Host hooks
+    std::function<void(const LoraFrame &)> on_tx;          // SetTx: frame on air
+    std::function<void(bool dio1, bool busy)> on_pins;      // pin level changed
+    std::function<uint32_t()> random;                       // RandomNumberGen source
+
+    Sx1268Timing timing;
+
+    Sx1268() { reset(); }
+
+    // Power-on: ready in STBY_RC, BUSY low, counters cleared
+    void reset();
+
+    // SPI. spi_select() is CS going low; spi_out() calls it implicitly
+    // for the first byte of a transaction.
+    void    spi_select(uint64_t now);
+    uint8_t spi_out(uint64_t now);
+    void    spi_in(uint8_t mosi, uint64_t now);
+    uint8_t spi_byte(uint8_t mosi, uint64_t now) {
+        uint8_t miso = spi_out(now);
+        spi_in(mosi, now);
+        return miso;
+    }
+    void    spi_end(uint64_t now);
+
+    // NRESET pin level (uo_out[1])
+    void set_nreset(bool level, uint64_t now);
+
+    // Apply everything due up to `now` (TX/RX completion, timeouts)
+    void     sync(uint64_t now);
+    // Cycle of the next internal event (including BUSY falling),
+    // UINT64_MAX if none
+    uint64_t next_event() const;
+
+    // Host-side reception: frame on the air at the radio's antenna.
+    // Must be delivered before the radio's clock reaches frame.start.
+    void deliver(const LoraFrame &f);
+
+    bool dio1() const { return (irq & dio1_mask) != 0; }
+    bool busy() const { return pin_busy; }
+    Mode mode() const { return m; }
+    const LoraParams &params() const { return p; }
+
+    // Counters
+    uint32_t tx_count, rx_count, rx_timeouts, rx_missed;
+    uint32_t busy_violations;           // transactions started with BUSY high
+    // DIO1 rising -> next CS low (host IRQ service), in cycles
+    uint64_t irq_latency_sum, irq_latency_max;
+    uint32_t irq_latency_n;
+    // TxDone -> receiver listening again (TX/RX turnaround), in cycles
+    uint64_t turnaround_sum, turnaround_max;
+    uint32_t turnaround_n;
+
+private:
+    Mode       m;
+    LoraParams p;
+    uint8_t    payload_len;         // SetPacketParams
+    uint8_t    tx_base, rx_base;
+    uint8_t    buf[256];
+    uint16_t   irq, irq_mask, dio1_mask;
+    uint8_t    cmd_status;          // status byte bits 3:1
+    uint8_t    rx_len, rx_start;
+    uint32_t   rng_word;
+
+    std::vector<uint8_t> cmd;       // bytes of the current SPI transaction
+    bool     selected;              // CS low
+    bool     dropped;               // current transaction is ignored
+
+    bool     in_reset;              // NRESET low
+    bool     cold_sleep;            // MODE_SLEEP without config retention
+    uint64_t busy_until;            // BUSY falls here, UINT64_MAX = held high
+    uint64_t tx_end;                // valid in MODE_TX
+    uint64_t rx_listen;             // MODE_RX: receiver ready from here
+    uint64_t rx_deadline;           // MODE_RX timeout, UINT64_MAX = none
+    bool     rx_continuous;         // SetRx(0xFFFFFF): stay in RX after RxDone
+    bool     receiving;
+    LoraFrame rx_frame;
+    std::deque<LoraFrame> air;      // delivered frames, by start time
+    bool     pin_dio1, pin_busy;    // last levels reported through on_pins
+    uint64_t dio1_rise;             // unserviced DIO1 edge, UINT64_MAX = none
+    uint64_t tx_done_at;            // last TxDone not yet followed by SetRx
+
+    uint8_t status() const { return (uint8_t)((m << 4) | (cmd_status << 1)); }
+    void    power_on_state();
+    uint8_t read_register(uint16_t addr);
+    void    execute(uint64_t now);
+    void    set_busy(uint64_t until, uint64_t now);
+    void    set_irq(uint16_t bits, uint64_t now);
+    void    update_pins(uint64_t now);
+};
+
+// Wire a radio to the SoC model's SPI hooks, ui_in[1:0] and NRESET.
+// run_until() returns at every CS release and NRESET change; the caller
+// then calls radio.sync(soc.now) and runs on to radio.next_event(), which
+// keeps DIO1/BUSY edges exact to the instruction.
+void sx1268_connect(SocModel &soc, Sx1268 &radio);
+
+// Stand-in gateway for a single radio: answers every 13-byte seal frame
+// (test/fw_lora_node.c) with its ACK {'A', node, mono LE}, delay_cycles
+// after the uplink ends. Replaces radio.on_tx.
+void sx1268_loopback_ack(Sx1268 &radio, uint64_t delay_cycles);
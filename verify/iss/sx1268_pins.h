@@ -0,0 +1,80 @@
+// sx1268_pins.h — Pin-level front end for the Sx1268 model
+//
+// Samples the SoC's radio outputs (uo_out[1] NRESET, [3] MOSI, [4] CS,
+// [5] SCK) and drives its inputs (ui_in[0] DIO1, [1] BUSY, [2] MISO), for
+// harnesses that see pins rather than spi_ctrl bytes: the Verilator
+// co-simulation calls eval() once per clock. SPI mode 0, MSB first: MISO
+// is valid from CS low and changes on SCK falling edges, MOSI is sampled
+// on SCK rising edges.
+//
+// clock_byte()/release() synthesize the same waveform from SocModel's
+// byte hooks (zero width in time), so the pin decoder can be checked
+// against the byte-level binding on the ISS.
+
+#pragma once
+
+#include "sx1268.h"
+
+#include <cstdint>
+
+class Sx1268Pins {
+public:
+    static const uint8_t UO_NRESET = 1 << 1, UO_MOSI = 1 << 3, UO_CS = 1 << 4, UO_SCK = 1 << 5;
+
+    explicit Sx1268Pins(Sx1268 &r) : radio(r) {}
+
+    // One sample of uo_out at cycle `now`; returns ui_in with bits 2:0
+    // replaced by the radio's pins
+    uint8_t eval(uint64_t now, uint8_t uo_out, uint8_t ui_in) {
+        bool n_rst = uo_out & UO_NRESET, n_cs = uo_out & UO_CS, n_sck = uo_out & UO_SCK;
+        if (n_rst != nreset) radio.set_nreset(n_rst, now);
+        radio.sync(now);
+        if (cs && !n_cs) {
+            radio.spi_select(now);
+            out = radio.spi_out(now);
+            bits = 0;
+        } else if (!cs && n_cs) {
+            radio.spi_end(now);
+        } else if (!n_cs && !sck && n_sck) {
+            shift = (uint8_t)((shift << 1) | ((uo_out & UO_MOSI) ? 1 : 0));
+            if (++bits == 8) radio.spi_in(shift, now);
+        } else if (!n_cs && sck && !n_sck) {
+            if (bits == 8) {
+                out = radio.spi_out(now);
+                bits = 0;
+            } else {
+                out = (uint8_t)(out << 1);
+            }
+        }
+        nreset = n_rst;
+        cs = n_cs;
+        sck = n_sck;
+        this->uo_out = uo_out;
+        return (uint8_t)((ui_in & ~7) | ((out & 0x80) ? 4 : 0) |
+                         (radio.busy() ? 2 : 0) | (radio.dio1() ? 1 : 0));
+    }
+
+    // One spi_ctrl byte as a waveform: CS low if needed, 8 SCK pulses.
+    // Returns the MISO bits sampled on the rising edges.
+    uint8_t clock_byte(uint8_t mosi, uint64_t now) {
+        uint8_t uo = (uint8_t)(uo_out & ~(UO_CS | UO_SCK));
+        uint8_t miso = 0;
+        eval(now, uo, 0);
+        for (int b = 7; b >= 0; b--) {
+            uo = (uint8_t)((uo & ~UO_MOSI) | (((mosi >> b) & 1) ? UO_MOSI : 0));
+            eval(now, uo, 0);
+            miso = (uint8_t)((miso << 1) | ((eval(now, uo | UO_SCK, 0) >> 2) & 1));
+            eval(now, uo, 0);
+        }
+        return miso;
+    }
+
+    void release(uint64_t now) { eval(now, (uint8_t)(uo_out | UO_CS), 0); }
+
+private:
+    Sx1268 &radio;
+    uint8_t uo_out = UO_NRESET | UO_CS;
+    bool    nreset = true, cs = true, sck = false;
+    uint8_t shift = 0, out = 0xFF;
+    int     bits = 0;
+};
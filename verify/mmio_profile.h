@@ -0,0 +1,197 @@
+// mmio_profile.h — Per-peripheral MMIO activity and QSPI stall accounting
+//
+// Where do the cycles of a firmware run go? Fed the project.v bus taps and
+// uio_out (QSPI chip selects) once per clock, after the rising edge, the
+// profiler counts per connect_peripheral slot:
+//   reads / writes   transactions (read_n / write_n becoming active)
+//   bus              cycles the slot holds the bus: read_n or write_n
+//                    active, plus the read_complete cycle
+//   repeat           reads that returned the same value as the previous
+//                    read of the same slot with no other data-bus access in
+//                    between: a polling loop that has not seen its change
+//   poll             cycles from the start of the first read of such a run
+//                    to the end of the read that saw the value change (or
+//                    the last repeat), including the instruction fetches
+//                    of the loop body: the time spent spinning on the slot
+// and the cycles each QSPI chip select is low: flash (instruction fetch
+// and .rodata) and PSRAM A/B (data). Flash and PSRAM share the SPI bus, so
+// the two never overlap; MMIO cycles may overlap a flash prefetch.
+//
+// The value compared for repeats is data_from_read at the first read_n
+// cycle, masked to the access width (as BusRuleMonitor does).
+//
+// Used by cosim_tb.cpp (any image, --mmio-profile) and cov_project_tb.cpp
+// (POST).
+
+#pragma once
+
+#include "bus_rules.h"
+
+#include <cstdint>
+#include <cstdio>
+
+class MmioProfiler {
+public:
+    struct SlotStats {
+        uint64_t reads = 0;
+        uint64_t writes = 0;
+        uint64_t bus_cycles = 0;
+        uint64_t repeat_reads = 0;
+        uint64_t poll_runs = 0;
+        uint64_t poll_cycles = 0;
+    };
+    SlotStats slots[32];
+    uint64_t  cycles = 0;
+    uint64_t  flash_cycles = 0, flash_txns = 0;
+    uint64_t  psram_cycles = 0, psram_txns = 0;
+
+    void sample(uint64_t cycle, uint8_t read_n, uint8_t write_n, bool read_complete, uint8_t slot,
+                uint32_t data, uint8_t uio_out) {
+        cycles++;
+        bool flash = !(uio_out & 0x01);
+        bool psram = (uio_out & 0xC0) != 0xC0;
+        flash_cycles += flash;
+        psram_cycles += psram;
+        flash_txns += flash && !prev_flash;
+        psram_txns += psram && !prev_psram;
+        prev_flash = flash;
+        prev_psram = psram;
+
+        if (write_n != 3) {
+            slots[slot & 31].bus_cycles++;
+            if (prev_write_n == 3 || slot != write_slot) {
+                slots[slot & 31].writes++;
+                write_slot = slot;
+                end_run();
+            }
+        }
+        prev_write_n = write_n;
+
+        if (read_n != 3) {
+            if (!reading || dropped || slot != read_slot) {
+                uint32_t width = read_n == 0 ? 0xFF : read_n == 1 ? 0xFFFF : 0xFFFFFFFF;
+                reading = true;
+                dropped = false;
+                read_slot = slot;
+                read_start = cycle;
+                read_value = data & width;
+                slots[slot & 31].reads++;
+            }
+            slots[read_slot & 31].bus_cycles++;
+        } else if (reading) {
+            dropped = true;
+            if (read_complete) slots[read_slot & 31].bus_cycles++;
+        }
+        if (read_complete && reading) {
+            reading = false;
+            finish_read(cycle);
+        }
+    }
+
+    // Core reset: drop the open read and any polling run
+    void reset() {
+        reading = false;
+        end_run();
+    }
+
+    uint64_t total(uint64_t SlotStats::*field) const {
+        uint64_t t = 0;
+        for (const SlotStats &st : slots) t += st.*field;
+        return t;
+    }
+
+    void report() const {
+        printf("[PROF] MMIO profile over %llu cycles\n", (unsigned long long)cycles);
+        printf("[PROF] %-12s %9s %9s %11s %6s %9s %11s %6s\n", "slot", "reads", "writes", "bus cyc",
+               "bus%", "repeat", "poll cyc", "poll%");
+        for (int s = 0; s < 32; s++) {
+            const SlotStats &st = slots[s];
+            if (!st.reads && !st.writes) continue;
+            printf("[PROF] %-12s %9llu %9llu %11llu %5.1f%% %9llu %11llu %5.1f%%\n",
+                   BusRuleMonitor::slot_name((uint8_t)s), (unsigned long long)st.reads,
+                   (unsigned long long)st.writes, (unsigned long long)st.bus_cycles, pct(st.bus_cycles),
+                   (unsigned long long)st.repeat_reads, (unsigned long long)st.poll_cycles,
+                   pct(st.poll_cycles));
+        }
+        uint64_t poll = total(&SlotStats::poll_cycles);
+        printf("[PROF] QSPI flash  %11llu cycles %5.1f%% in %llu transactions\n",
+               (unsigned long long)flash_cycles, pct(flash_cycles), (unsigned long long)flash_txns);
+        printf("[PROF] QSPI PSRAM  %11llu cycles %5.1f%% in %llu transactions\n",
+               (unsigned long long)psram_cycles, pct(psram_cycles), (unsigned long long)psram_txns);
+        printf("[PROF] polling     %11llu cycles %5.1f%%, other work %llu cycles %5.1f%%\n",
+               (unsigned long long)poll, pct(poll), (unsigned long long)(cycles - poll), pct(cycles - poll));
+    }
+
+    // Same numbers as JSON, keyed by slot name; `image` names the firmware
+    bool write_json(const char *path, const char *image) const {
+        FILE *f = fopen(path, "w");
+        if (!f) return false;
+        fprintf(f, "{\n  \"image\": \"%s\",\n  \"cycles\": %llu,\n", image, (unsigned long long)cycles);
+        fprintf(f, "  \"qspi\": {\"flash_cycles\": %llu, \"flash_txns\": %llu, "
+                   "\"psram_cycles\": %llu, \"psram_txns\": %llu},\n",
+                (unsigned long long)flash_cycles, (unsigned long long)flash_txns,
+                (unsigned long long)psram_cycles, (unsigned long long)psram_txns);
+        fprintf(f, "  \"poll_cycles\": %llu,\n  \"slots\": {", (unsigned long long)total(&SlotStats::poll_cycles));
+        const char *sep = "\n";
+        for (int s = 0; s < 32; s++) {
+            const SlotStats &st = slots[s];
+            if (!st.reads && !st.writes) continue;
+            fprintf(f, "%s    \"%s\": {\"reads\": %llu, \"writes\": %llu, \"bus_cycles\": %llu, "
+                       "\"repeat_reads\": %llu, \"poll_runs\": %llu, \"poll_cycles\": %llu}",
+                    sep, BusRuleMonitor::slot_name((uint8_t)s), (unsigned long long)st.reads,
+                    (unsigned long long)st.writes, (unsigned long long)st.bus_cycles,
+                    (unsigned long long)st.repeat_reads, (unsigned long long)st.poll_runs,
+                    (unsigned long long)st.poll_cycles);
+            sep = ",\n";
+        }
+        fprintf(f, "\n  }\n}\n");
+        fclose(f);
+        return true;
+    }
+
+private:
+    bool     prev_flash = false, prev_psram = false;
+    uint8_t  prev_write_n = 3, write_slot = 0;
+    bool     reading = false, dropped = false;
+    uint8_t  read_slot = 0;
+    uint32_t read_value = 0;
+    uint64_t read_start = 0;
+
+    // Previous completed read, while no other access has happened since
+    bool     last_valid = false, in_run = false;
+    uint8_t  last_slot = 0;
+    uint32_t last_value = 0;
+    uint64_t last_start = 0, last_end = 0;
+
+    double pct(uint64_t n) const { return cycles ? 100.0 * n / cycles : 0.0; }
+
+    void end_run() {
+        last_valid = false;
+        in_run = false;
+    }
+
+    void finish_read(uint64_t cycle) {
+        SlotStats &st = slots[read_slot & 31];
+        if (last_valid && last_slot == read_slot) {
+            if (last_value == read_value) {
+                st.repeat_reads++;
+                if (!in_run) {
+                    in_run = true;
+                    st.poll_runs++;
+                    st.poll_cycles += last_end - last_start + 1;
+                }
+                st.poll_cycles += cycle - last_end;
+            } else if (in_run) {
+                st.poll_cycles += cycle - last_end;     // the read that saw the change
+                in_run = false;
+            }
+        } else {
+            in_run = false;
+        }
+        last_valid = true;
+        last_slot = read_slot;
+        last_value = read_value;
+        last_start = read_start;
+        last_end = cycle;
+    }
+};
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+"""Make sg13g2_stdcell_nodelay.v buildable by Verilator.
+
+The nodelay library models its flops, latches and muxes with UDPs
+(ihp_dff_r, ihp_latch, ihp_mux2, ...), which Verilator cannot compile.
+This script writes a copy in which
+  - primitive ... endprimitive blocks and specify blocks are removed,
+  - every unnamed UDP instance gets an instance name,
+  - the UDPs the cells use are replaced by two-state behavioral modules
+    with the same port order (notifier / X-check inputs are ignored).
+Combinational cells (gate primitives) are kept as they are.
+
+Usage: sg13g2_verilator.py [IN] OUT   (IN defaults to the file next to this
+script). Used by scripts/gls_verilator.sh.
+"""
+
+import os
+import re
+import sys
+
+UDP_MODULES = """
+// ---- Behavioral replacements for the ihp_* UDPs (sg13g2_verilator.py) ----
+
+module ihp_dff_r_err (output q, input clk, input d, input r);
+    assign q = 1'b0;
+endmodule
+
+module ihp_dff_sr_err (output q, input clk, input d, input s, input r);
+    assign q = 1'b0;
+endmodule
+
+// Rising-edge flop, async active-high reset
+module ihp_dff_r (output reg q, input v, input clk, input d, input r, input xcr);
+    always @(posedge clk or posedge r)
+        if (r) q <= 1'b0;
+        else   q <= d;
+endmodule
+
+// Rising-edge flop, async set and reset, set wins
+module ihp_dff_sr_1 (output reg q, input v, input clk, input d, input s, input r, input xcr);
+    always @(posedge clk or posedge s or posedge r)
+        if (s)      q <= 1'b1;
+        else if (r) q <= 1'b0;
+        else        q <= d;
+endmodule
+
+// Transparent-high latch
+module ihp_latch (output reg q, input v, input clk, input d);
+    always @(*)
+        if (clk) q = d;
+endmodule
+
+// Transparent-high latch, async active-high reset
+module ihp_latch_r (output reg q, input v, input clk, input d, input r);
+    always @(*)
+        if (r)        q = 1'b0;
+        else if (clk) q = d;
+endmodule
+
+module ihp_mux2 (output z, input a, input b, input s);
+    assign z = s ? b : a;
+endmodule
+
+module ihp_mux4 (output z, input a, input b, input c, input d, input s0, input s1);
+    assign z = s1 ? (s0 ? d : c) : (s0 ? b : a);
+endmodule
+"""
+
+SUPPORTED = {"ihp_dff_r_err", "ihp_dff_sr_err", "ihp_dff_r", "ihp_dff_sr_1",
+             "ihp_latch", "ihp_latch_r", "ihp_mux2", "ihp_mux4"}
+
+
+def convert(text):
+    text = re.sub(r"^primitive\b.*?^endprimitive\b", "", text, flags=re.S | re.M)
+    text = re.sub(r"^\s*specify\b.*?^\s*endspecify\b", "", text, flags=re.S | re.M)
+
+    used = set()
+    count = {}
+
+    def name(m):
+        udp = m.group(2)
+        used.add(udp)
+        count[udp] = count.get(udp, 0) + 1
+        return "%s%s u_%s_%d (" % (m.group(1), udp, udp, count[udp])
+
+    text = re.sub(r"^(\s*)(ihp_\w+)\s*\(", name, text, flags=re.M)
+    missing = used - SUPPORTED
+    if missing:
+        sys.exit("no behavioral model for: " + " ".join(sorted(missing)))
+    return text + UDP_MODULES
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    args = sys.argv[1:]
+    if len(args) == 1:
+        args = [os.path.join(here, "sg13g2_stdcell_nodelay.v")] + args
+    if len(args) != 2:
+        sys.exit(__doc__)
+    with open(args[0]) as f:
+        out = convert(f.read())
+    with open(args[1], "w") as f:
+        f.write(out)
+
+
+if __name__ == "__main__":
+    main()
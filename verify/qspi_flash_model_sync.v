@@ -23,11 +23,17 @@ module qspi_flash_model #(
     // 256KB memory
     reg [7:0] mem [0:262143];
 
+    // +flash_hex=PATH overrides HEX_FILE, so one Verilated model can boot
+    // any image (verify/soclib passes it per VerilatedContext)
+    reg [8*1024-1:0] hex_path;
     integer init_i;
     initial begin
         for (init_i = 0; init_i < 262144; init_i = init_i + 1)
             mem[init_i] = 8'hFF;
-        $readmemh(HEX_FILE, mem);
+        if ($value$plusargs("flash_hex=%s", hex_path))
+            $readmemh(hex_path, mem);
+        else
+            $readmemh(HEX_FILE, mem);
     end
 
     // Protocol states
@@ -0,0 +1,571 @@
+// rand_mmio_tb.cpp — Constrained-random MMIO traffic with a SocModel scoreboard
+//
+// Drives the Verilated SoC (rand_mmio_wrap.v) as the only data-bus master:
+// random reads and writes to all 16 MMIO slots, interleaved with pin
+// stimuli on ui_in (PPS pulses, DIO1/BUSY toggles, MISO, a bit-banged UART
+// RX byte stream) and I2C transactions against a 24C02 EEPROM modelled in
+// C++ (i2c_pins.h on uo_out[2]/uo_out[6], SDA readback on ui_in[3]).
+//
+// The scoreboard is verify/iss SocModel used without its core: every bus
+// transaction and pin change is replayed on it at the same clock
+// (advance_to + load/store/set_ui_in), and every RTL read is compared with
+// the model's value under a per-slot mask:
+//   exact     GPIO_OUT_SEL, I2C_CONFIG, UART rx data, SPI rx, SEAL_DATA,
+//             SEAL_CTRL, SYSINFO (pps_count settled), GPIO_IN (bit 3 is the
+//             live SDA line), GPIO_OUT (GPIO-selected bits)
+//   busy bits CRC16[16], UART_STATUS, SPI_STATUS: away from the start/end
+//             of the busy window, whose exact cycle the model only estimates
+//   +-1       TIMER, WDT, RTC (tick_1us phase)
+//   I2C_DATA  rx data/RX_VALID/NACK at the harness's sync points (both sides
+//             have a byte, or both are idle); BUSY/TX_PENDING are only used
+//             to pace the sequence
+//
+// Constraints keep both sides in the same state: no 0xA5 to SYSINFO, the
+// WDT is loaded with >= 1 s and kicked at half its load, GPIO_OUT_SEL never
+// takes the I2C pins, MISO only moves between SPI transfers, and writes to
+// CRC16/UART/SPI/SEAL are issued either clearly inside or clearly outside
+// the busy window (both sides drop or both accept). Interrupt lines are not
+// compared.
+//
+// Build and run: see docs/verification.md §2.10, e.g.
+//   ./obj_dir/rand_mmio_tb --seed 7 --txns 5000000
+
+#include "Vrand_mmio_wrap.h"
+#include "verilated.h"
+
+#include "soc_model.h"
+#include "i2c_devices.h"
+#include "i2c_pins.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+static Vrand_mmio_wrap *dut;
+static VerilatedContext *contextp;
+static uint64_t cycle;              // clocks since rst_reg_n went high (= soc.now)
+
+static SocModel soc;
+
+static const uint32_t MMIO_BASE = 0x8000000;
+static const uint64_t GUARD = 24;   // clocks kept clear of a model-estimated edge
+
+enum {
+    S_GPIO_OUT, S_GPIO_IN, S_CRC16, S_GPIO_OUT_SEL, S_UART, S_UART_STATUS,
+    S_I2C_DATA, S_I2C_CONFIG, S_SPI, S_SPI_STATUS, S_RTC, S_SEAL_DATA,
+    S_TIMER, S_WDT, S_SEAL_CTRL, S_SYSINFO
+};
+
+static const char *const slot_names[16] = {
+    "GPIO_OUT", "GPIO_IN", "CRC16", "GPIO_OUT_SEL", "UART", "UART_STATUS",
+    "I2C_DATA", "I2C_CONFIG", "SPI", "SPI_STATUS", "RTC", "SEAL_DATA",
+    "TIMER", "WDT", "SEAL_CTRL", "SYSINFO"};
+
+static const uint32_t I2C_CMD_START = 1u << 8, I2C_CMD_READ = 1u << 9,
+                      I2C_CMD_WRITE = 1u << 10, I2C_CMD_STOP = 1u << 12;
+static const uint32_t I2C_NACK = 1u << 8, I2C_BUSY = 1u << 9,
+                      I2C_RX_VALID = 1u << 10, I2C_TX_PENDING = 1u << 11;
+
+// ================================================================
+// Random source (xorshift64*, reproducible from --seed)
+// ================================================================
+static uint64_t rng_state = 1;
+
+static uint32_t rnd() {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (uint32_t)((rng_state * 2685821657736338717ULL) >> 32);
+}
+
+static uint32_t rnd(uint32_t n) { return rnd() % n; }
+
+// ================================================================
+// Scoreboard
+// ================================================================
+struct SlotStats {
+    uint64_t reads = 0, writes = 0, compared = 0, skipped = 0, mismatches = 0;
+};
+static SlotStats stats[16];
+static uint64_t mismatches = 0;
+static int max_report = 10;
+
+static void check(uint8_t slot, uint32_t rtl, uint32_t model, uint32_t mask, const char *what) {
+    stats[slot].compared++;
+    if (!((rtl ^ model) & mask)) return;
+    stats[slot].mismatches++;
+    if (mismatches++ < (uint64_t)max_report)
+        printf("[MISMATCH] cycle %llu %s%s%s: rtl %08x model %08x (mask %08x)\n",
+               (unsigned long long)cycle, slot_names[slot], what[0] ? " " : "", what,
+               rtl, model, mask);
+}
+
+static void check_near(uint8_t slot, uint32_t rtl, uint32_t model, uint32_t tol) {
+    stats[slot].compared++;
+    uint32_t d = rtl > model ? rtl - model : model - rtl;
+    if (d <= tol) return;
+    stats[slot].mismatches++;
+    if (mismatches++ < (uint64_t)max_report)
+        printf("[MISMATCH] cycle %llu %s: rtl %u model %u (tolerance %u)\n",
+               (unsigned long long)cycle, slot_names[slot], rtl, model, tol);
+}
+
+// ================================================================
+// Pins
+// ================================================================
+static EepromSlave rtl_eeprom(0x50, 256, 8, 1, SocModel::CLK_HZ / 1000000);
+static EepromSlave model_eeprom(0x50, 256, 8, 1, SocModel::CLK_HZ / 1000000);
+static I2cPins i2c_pins(rtl_eeprom);
+
+// ui_in except bit 3 (SDA readback, computed from the I2C bus every clock)
+static uint8_t ui_drive = 0x88;         // UART RX idle, SDA released
+static int rx_bit = -1;                 // UART RX frame bit being sent, -1 idle
+static uint32_t rx_clk = 0;
+static uint16_t rx_frame = 0;
+static uint64_t pps_fall = 0;
+
+static void set_pins(uint8_t v) {
+    if (v == ui_drive) return;
+    ui_drive = v;
+    soc.advance_to(cycle);
+    soc.set_ui_in(v | 0x08);
+}
+
+static void tick() {
+    dut->clk = 0;
+    contextp->timeInc(1);
+    dut->eval();
+    dut->clk = 1;
+    contextp->timeInc(1);
+    dut->eval();
+    if (dut->rst_reg_n) cycle++;
+
+    // I2C: slave sees the master's open-drain outputs, SDA is read back
+    // through ui_in[3] (project.v ties the master's scl_i high)
+    bool scl = (dut->uo_out >> 2) & 1, sda = (dut->uo_out >> 6) & 1;
+    i2c_pins.eval(cycle, scl, sda);
+    bool sda_bus = sda && i2c_pins.sda();
+
+    // UART RX bit-bang, LSB first, 217 clocks/bit
+    if (rx_bit >= 0 && ++rx_clk == SocModel::UART_BIT_CLKS) {
+        rx_clk = 0;
+        if (++rx_bit == 10) rx_bit = -1;
+        uint8_t rxd = rx_bit < 0 ? 1 : (rx_frame >> rx_bit) & 1;
+        set_pins((uint8_t)((ui_drive & 0x7F) | (rxd << 7)));
+    }
+    if (pps_fall && cycle >= pps_fall) {
+        pps_fall = 0;
+        set_pins(ui_drive & ~0x10);
+    }
+
+    dut->ui_in = (uint8_t)((ui_drive & ~0x08) | (sda_bus ? 0x08 : 0));
+}
+
+// ================================================================
+// Bus master (tb_project.v bus_write / bus_read timing)
+// ================================================================
+static void bus_write(uint8_t slot, uint32_t data) {
+    soc.advance_to(cycle);
+    soc.store(MMIO_BASE + slot * 4, data, 4);
+    stats[slot].writes++;
+    dut->drv_addr = MMIO_BASE | (slot << 2);
+    dut->drv_data = data;
+    dut->drv_write_n = 2;
+    tick();
+    dut->drv_write_n = 3;
+    tick();
+}
+
+// Returns the RTL value; *model gets the scoreboard's value for the same cycle
+static uint32_t bus_read(uint8_t slot, uint32_t *model) {
+    soc.advance_to(cycle);
+    *model = soc.load(MMIO_BASE + slot * 4, 4);
+    stats[slot].reads++;
+    dut->drv_addr = MMIO_BASE | (slot << 2);
+    dut->drv_read_n = 2;
+    dut->eval();
+    uint32_t v = dut->bus_data_from_read;
+    dut->drv_read_complete = 1;
+    tick();
+    dut->drv_read_complete = 0;
+    dut->drv_read_n = 3;
+    tick();
+    return v;
+}
+
+// Value of a slot without read_complete (no side effects on either side)
+static uint32_t rtl_peek(uint8_t slot) {
+    dut->drv_addr = MMIO_BASE | (slot << 2);
+    dut->drv_read_n = 2;
+    dut->eval();
+    uint32_t v = dut->bus_data_from_read;
+    dut->drv_read_n = 3;
+    dut->eval();
+    return v;
+}
+
+static uint32_t model_peek(uint8_t slot) {
+    soc.advance_to(cycle);
+    return soc.mmio_peek(slot);
+}
+
+// ================================================================
+// Busy windows, as estimated by the model: [a, b)
+// ================================================================
+struct Window {
+    uint64_t a = 0, b = 0;
+    bool busy(uint64_t t) const { return t >= a && t < b; }
+    // t is not within GUARD of either edge: both sides agree on busy()
+    bool clear(uint64_t t) const {
+        return !(t + GUARD >= a && t <= a + GUARD) && !(t + GUARD >= b && t <= b + GUARD);
+    }
+    bool done(uint64_t t) const { return t > b + GUARD; }
+};
+
+static Window crc_w, seal_w, uart_tx_w, spi_w, uart_rx_w;
+static uint32_t spi_div = 0;
+static uint64_t pps_edge = 0;
+static bool wdt_on = false;
+static uint64_t wdt_kick = 0, wdt_half = 0;
+
+// ================================================================
+// I2C sequences: START+W(addr) + n data bytes, or START+R(addr) + n bytes
+// ================================================================
+struct I2cSeq {
+    enum { IDLE, WRITE, READ, END } st = IDLE;
+    bool     rd = false;
+    uint8_t  addr = 0x50;
+    int      n = 0, i = 0;
+    uint64_t since = 0;
+    uint64_t writes = 0, reads = 0, nacks = 0, timeouts = 0;
+};
+static I2cSeq i2c;
+
+static bool i2c_both(uint32_t bits, bool set) {
+    uint32_t r = rtl_peek(S_I2C_DATA) & bits, m = model_peek(S_I2C_DATA) & bits;
+    return set ? (r == bits && m == bits) : (!r && !m);
+}
+
+static bool i2c_idle() {
+    return i2c.st == I2cSeq::IDLE && i2c_both(I2C_BUSY | I2C_TX_PENDING | I2C_RX_VALID, false);
+}
+
+// One step of the current sequence; returns false when it has to wait
+static bool i2c_step() {
+    uint32_t m, r;
+    if (i2c.st != I2cSeq::IDLE && cycle - i2c.since > 400000) {
+        stats[S_I2C_DATA].mismatches++;
+        if (mismatches++ < (uint64_t)max_report)
+            printf("[MISMATCH] cycle %llu I2C_DATA: sequence stalled (rtl %08x model %08x)\n",
+                   (unsigned long long)cycle, rtl_peek(S_I2C_DATA), model_peek(S_I2C_DATA));
+        i2c.timeouts++;
+        i2c.st = I2cSeq::IDLE;
+        return true;
+    }
+    switch (i2c.st) {
+    case I2cSeq::IDLE:
+        if (!i2c_idle()) return false;
+        i2c.rd = rnd(2);
+        i2c.addr = rnd(4) ? 0x50 : (uint8_t)(0x08 + rnd(0x70));
+        i2c.n = 1 + rnd(i2c.rd ? 6 : 9);
+        i2c.i = 0;
+        i2c.since = cycle;
+        if (i2c.rd) {
+            bus_write(S_I2C_DATA, I2C_CMD_START | I2C_CMD_READ |
+                                  (i2c.n == 1 ? I2C_CMD_STOP : 0) | i2c.addr);
+            i2c.st = I2cSeq::READ;
+            i2c.reads++;
+        } else {
+            bus_write(S_I2C_DATA, I2C_CMD_START | I2C_CMD_WRITE | i2c.addr);
+            i2c.st = I2cSeq::WRITE;
+            i2c.writes++;
+        }
+        return true;
+    case I2cSeq::WRITE:
+        if (!i2c_both(I2C_TX_PENDING, false)) return false;
+        bus_write(S_I2C_DATA, I2C_CMD_WRITE | (i2c.i == i2c.n - 1 ? I2C_CMD_STOP : 0) | rnd(256));
+        if (++i2c.i == i2c.n) i2c.st = I2cSeq::END;
+        return true;
+    case I2cSeq::READ:
+        if (!i2c_both(I2C_RX_VALID, true)) return false;
+        r = bus_read(S_I2C_DATA, &m);
+        check(S_I2C_DATA, r, m, I2C_RX_VALID | I2C_NACK | 0xFF, "rx");
+        if (i2c.i == 0 && (r & I2C_NACK)) i2c.nacks++;
+        if (++i2c.i == i2c.n) {
+            i2c.st = I2cSeq::END;
+        } else {
+            bus_write(S_I2C_DATA, I2C_CMD_READ | (i2c.i == i2c.n - 1 ? I2C_CMD_STOP : 0));
+        }
+        return true;
+    case I2cSeq::END:
+        if (!i2c_both(I2C_BUSY | I2C_TX_PENDING, false)) return false;
+        r = bus_read(S_I2C_DATA, &m);
+        check(S_I2C_DATA, r, m, 0xFFF, "end");
+        if (!i2c.rd && (r & I2C_NACK)) i2c.nacks++;
+        i2c.st = I2cSeq::IDLE;
+        return true;
+    }
+    return false;
+}
+
+// ================================================================
+// Random writes
+// ================================================================
+static void random_write(uint8_t slot) {
+    uint64_t t = cycle;
+    uint32_t d = rnd();
+    switch (slot) {
+    case S_GPIO_OUT:
+        break;
+    case S_GPIO_OUT_SEL:
+        d &= ~0x44u;                    // SCL/SDA stay with the I2C master
+        break;
+    case S_CRC16:
+        if (!crc_w.clear(t) || !seal_w.clear(t)) {
+            stats[slot].skipped++;
+            return;
+        }
+        d = rnd(8) ? (d & 0xFF) : 0x100;
+        if (!(d & 0x100) && !crc_w.busy(t) && !seal_w.busy(t)) crc_w = {t, t + 9};
+        break;
+    case S_UART:
+        if (!uart_tx_w.clear(t)) { stats[slot].skipped++; return; }
+        d &= 0xFF;
+        if (!uart_tx_w.busy(t)) uart_tx_w = {t, t + 1 + 10 * SocModel::UART_BIT_CLKS};
+        break;
+    case S_SPI:
+        if (!spi_w.clear(t)) { stats[slot].skipped++; return; }
+        d &= 0x1FF;
+        if (!spi_w.busy(t)) spi_w = {t, t + 2 + 16 * (uint64_t)(spi_div + 1)};
+        break;
+    case S_SPI_STATUS:
+        if (!spi_w.done(t)) { stats[slot].skipped++; return; }
+        spi_div = rnd(4);               // keep transfers short
+        d = spi_div;
+        break;
+    case S_SEAL_DATA:
+        if (!seal_w.clear(t)) { stats[slot].skipped++; return; }
+        break;
+    case S_SEAL_CTRL:
+        if (!seal_w.clear(t) || !crc_w.done(t)) { stats[slot].skipped++; return; }
+        d = (d & ~3u) | (rnd(8) ? 2 : 0);
+        if ((d & 2) && !seal_w.busy(t)) seal_w = {t, t + 92};
+        break;
+    case S_TIMER:
+        d = rnd(2) ? rnd(5000) : d;
+        break;
+    case S_WDT:
+        d = rnd(16) ? (1u << 20) + rnd(1u << 22) : 0;   // 0 must be ignored
+        if (d) {
+            wdt_on = true;
+            wdt_kick = t;
+            wdt_half = (uint64_t)d * 25 / 2;
+        }
+        break;
+    case S_SYSINFO:
+        if ((d & 0xFF) == 0xA5) d ^= 1;                 // no soft reset
+        break;
+    case S_I2C_DATA:                    // only from i2c_step()
+    case S_I2C_CONFIG:
+        if (!i2c_idle()) { stats[slot].skipped++; return; }
+        if (slot == S_I2C_DATA) return;
+        d = 1 + rnd(15);
+        break;
+    default:                            // read-only slots: writes are ignored
+        break;
+    }
+    bus_write(slot, d);
+}
+
+// ================================================================
+// Random reads
+// ================================================================
+static void random_read(uint8_t slot) {
+    uint64_t t = cycle;
+    uint32_t m, r;
+    switch (slot) {
+    case S_UART:                        // consumes rx_valid: not while a byte lands
+    case S_UART_STATUS:
+        if (uart_rx_w.busy(t) || !uart_rx_w.clear(t) || (slot == S_UART_STATUS && !uart_tx_w.clear(t))) {
+            stats[slot].skipped++;
+            return;
+        }
+        break;
+    case S_I2C_DATA:
+        if (!i2c_idle()) { stats[slot].skipped++; return; }
+        break;
+    case S_SEAL_DATA:
+        if (!seal_w.done(t)) { stats[slot].skipped++; return; }
+        break;
+    case S_CRC16:
+    case S_SEAL_CTRL:
+        if (!crc_w.clear(t) || !seal_w.clear(t)) { stats[slot].skipped++; return; }
+        break;
+    case S_SPI:
+    case S_SPI_STATUS:
+        if (!spi_w.clear(t)) { stats[slot].skipped++; return; }
+        break;
+    case S_SYSINFO:
+        if (t < pps_edge + 8) { stats[slot].skipped++; return; }
+        break;
+    default:
+        break;
+    }
+
+    r = bus_read(slot, &m);
+    switch (slot) {
+    case S_GPIO_OUT:     check(slot, r, m, soc.mmio_peek(S_GPIO_OUT_SEL) & 0xFF, ""); break;
+    case S_GPIO_IN:      check(slot, r, m, 0xF7, ""); break;
+    case S_CRC16:
+        // the engine is shared with the seal FSM: value only when both idle
+        check(slot, r, m, crc_w.busy(t) || seal_w.busy(t) ? 0x10000 : 0x1FFFF, "");
+        break;
+    case S_UART:         check(slot, r, m, 0xFF, ""); break;
+    case S_UART_STATUS:  check(slot, r, m, 0x3, ""); break;
+    case S_SPI:          check(slot, r, m, spi_w.busy(t) ? 0 : 0xFF, ""); break;
+    case S_SPI_STATUS:   check(slot, r, m, 0x1, ""); break;
+    case S_RTC:
+    case S_TIMER:
+    case S_WDT:          check_near(slot, r, m, 1); break;
+    default:             check(slot, r, m, 0xFFFFFFFF, ""); break;
+    }
+}
+
+// ================================================================
+// Pin stimuli
+// ================================================================
+static uint64_t uart_rx_sent = 0, pps_pulses = 0;
+
+static void random_pins() {
+    uint64_t t = cycle;
+    uint32_t k = rnd(1024);
+    uint8_t v = ui_drive;
+    if (k < 16) {
+        v ^= 0x01;                                      // DIO1
+    } else if (k < 24) {
+        v ^= 0x02;                                      // BUSY
+    } else if (k < 32) {
+        v ^= (uint8_t)(rnd(4) << 5);                    // spare inputs
+    } else if (k < 40 && spi_w.done(t)) {
+        v ^= 0x04;                                      // MISO between transfers
+    } else if (k < 42 && !pps_fall && t > pps_edge + 64) {
+        v |= 0x10;                                      // PPS pulse, 2 us high
+        pps_fall = t + 50;
+        pps_edge = t;
+        pps_pulses++;
+    } else if (k < 46 && rx_bit < 0 && uart_rx_w.done(t)) {
+        uint8_t b = (uint8_t)rnd(256);
+        rx_frame = (uint16_t)(0x200 | (b << 1));        // start 0, 8 data, stop 1
+        rx_bit = 0;
+        rx_clk = 0;
+        v &= 0x7F;
+        soc.advance_to(t);
+        soc.uart_rx_inject(b);
+        // RTL flags the byte during the stop bit, the model at its end
+        uart_rx_w = {t + 9 * SocModel::UART_BIT_CLKS, t + 10 * SocModel::UART_BIT_CLKS};
+        uart_rx_sent++;
+    }
+    set_pins(v);
+}
+
+// ================================================================
+// Main
+// ================================================================
+int main(int argc, char **argv) {
+    uint64_t txns = 1000000, seed = 1;
+    bool use_i2c = true;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--txns") && i + 1 < argc) txns = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--max-report") && i + 1 < argc) max_report = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--no-i2c")) use_i2c = false;
+    }
+    rng_state = seed ? seed : 1;
+
+    contextp = new VerilatedContext;
+    contextp->commandArgs(argc, argv);
+    dut = new Vrand_mmio_wrap{contextp};
+
+    printf("=== LoRa Edge SoC — constrained-random MMIO vs SocModel ===\n");
+    printf("Seed %llu, %llu transactions%s\n", (unsigned long long)seed,
+           (unsigned long long)txns, use_i2c ? "" : ", no I2C");
+
+    rtl_eeprom.write_cycle_us = 0;
+    model_eeprom.write_cycle_us = 0;
+    soc.attach_i2c(&model_eeprom);
+    soc.power_on_reset();
+    soc.set_ui_in(ui_drive | 0x08);
+
+    dut->rst_n = 0;
+    dut->ui_in = ui_drive | 0x08;
+    dut->drv_write_n = 3;
+    dut->drv_read_n = 3;
+    dut->drv_read_complete = 0;
+    dut->clk = 0;
+    for (int i = 0; i < 20; i++) tick();
+    dut->rst_n = 1;
+    for (int i = 0; i < 200 && !dut->rst_reg_n; i++) tick();
+    if (!dut->rst_reg_n) {
+        printf("[FAIL] rst_reg_n never released\n");
+        return 1;
+    }
+
+    bus_write(S_I2C_CONFIG, 2 + rnd(8));
+
+    auto t_start = std::chrono::steady_clock::now();
+    uint64_t done = 0;
+    while (done < txns) {
+        uint32_t gap = rnd(256) ? rnd(4) : rnd(3000);   // occasionally let things finish
+        for (uint32_t g = 0; g < gap; g++) tick();
+        random_pins();
+
+        if (wdt_on && cycle - wdt_kick > wdt_half) {
+            bus_write(S_WDT, 1u << 22);
+            wdt_kick = cycle;
+            wdt_half = (uint64_t)(1u << 22) * 25 / 2;
+            done++;
+            continue;
+        }
+        if (use_i2c && (i2c.st != I2cSeq::IDLE ? rnd(2) : !rnd(32))) {
+            if (i2c_step()) {
+                done++;
+                continue;
+            }
+        }
+        uint8_t slot = (uint8_t)rnd(16);
+        if (rnd(2)) random_read(slot);
+        else random_write(slot);
+        done++;
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+
+    printf("\n[SCOREBOARD] %-12s %10s %10s %10s %10s %6s\n", "slot", "reads", "writes", "compared",
+           "skipped", "miss");
+    for (int s = 0; s < 16; s++) {
+        const SlotStats &st = stats[s];
+        printf("[SCOREBOARD] %-12s %10llu %10llu %10llu %10llu %6llu\n", slot_names[s],
+               (unsigned long long)st.reads, (unsigned long long)st.writes,
+               (unsigned long long)st.compared, (unsigned long long)st.skipped,
+               (unsigned long long)st.mismatches);
+    }
+    printf("[STIM] %llu PPS pulses, %llu UART RX bytes, I2C %llu writes / %llu reads "
+           "(%llu NACKed, %llu stalled), SCL held %llu\n",
+           (unsigned long long)pps_pulses, (unsigned long long)uart_rx_sent,
+           (unsigned long long)i2c.writes, (unsigned long long)i2c.reads,
+           (unsigned long long)i2c.nacks, (unsigned long long)i2c.timeouts,
+           (unsigned long long)i2c_pins.held);
+    printf("[PERF] %llu transactions, %llu cycles in %.1f s (%.0f txn/s, %.2f Mcycles/s)\n",
+           (unsigned long long)done, (unsigned long long)cycle, secs, done / secs,
+           cycle / secs / 1e6);
+
+    bool ok = mismatches == 0;
+    printf("%s scoreboard: %llu mismatches\n", ok ? "[PASS]" : "[FAIL]",
+           (unsigned long long)mismatches);
+
+    dut->final();
+    delete dut;
+    delete contextp;
+    return ok ? 0 : 1;
+}
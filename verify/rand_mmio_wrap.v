@@ -0,0 +1,81 @@
+// ============================================================================
+// rand_mmio_wrap.v — Verilator wrapper for constrained-random MMIO traffic
+// ============================================================================
+// DUT with the tinyQV data bus taken over by the testbench: the bus outputs
+// of i_tinyqv are forced to the drv_* inputs for the whole run (same
+// hierarchical force as tb_project.v bus_write/bus_read, but permanent), so
+// rand_mmio_tb.cpp is the only bus master. The core still runs, fetching
+// from an absent flash; only its data bus is disconnected.
+//
+// ui_in is driven directly (DIO1, MISO, I2C SDA readback, PPS, UART RX);
+// the I2C slave lives in C++ (verify/iss/i2c_pins.h).
+//
+// The mon_* taps expose seal/WDT state for the invariant checks in
+// fuzz_mmio_tb.cpp.
+//
+// Needs Verilator 5 (force/release).
+// ============================================================================
+
+`timescale 1ns / 1ps
+`default_nettype none
+
+module rand_mmio_wrap (
+    input  wire        clk,
+    input  wire        rst_n,
+    input  wire [7:0]  ui_in,
+    output wire [7:0]  uo_out,
+
+    // Bus master (testbench)
+    input  wire [27:0] drv_addr,
+    input  wire [1:0]  drv_write_n,
+    input  wire [1:0]  drv_read_n,
+    input  wire [31:0] drv_data,
+    input  wire        drv_read_complete,
+
+    // project.v side
+    output wire [31:0] bus_data_from_read,
+    output wire        rst_reg_n,
+
+    // Invariant taps
+    output wire [31:0] mon_mono_count,
+    output wire [31:0] mon_sealed_value,
+    output wire [31:0] mon_sealed_mono,
+    output wire [15:0] mon_sealed_crc,
+    output wire [7:0]  mon_seal_sensor_id,
+    output wire        mon_wdt_enabled,
+    output wire [31:0] mon_wdt_counter
+);
+
+    wire [7:0] uio_out, uio_oe;
+
+    tt_um_techhu_rv32_trial dut (
+        .ui_in  (ui_in),
+        .uo_out (uo_out),
+        .uio_in (8'hFF),
+        .uio_out(uio_out),
+        .uio_oe (uio_oe),
+        .ena    (1'b1),
+        .clk    (clk),
+        .rst_n  (rst_n)
+    );
+
+    initial begin
+        force dut.i_tinyqv.data_addr          = drv_addr;
+        force dut.i_tinyqv.data_write_n       = drv_write_n;
+        force dut.i_tinyqv.data_read_n        = drv_read_n;
+        force dut.i_tinyqv.data_out           = drv_data;
+        force dut.i_tinyqv.data_read_complete = drv_read_complete;
+    end
+
+    assign bus_data_from_read = dut.data_from_read;
+    assign rst_reg_n          = dut.rst_reg_n;
+
+    assign mon_mono_count     = dut.i_seal.mono_count;
+    assign mon_sealed_value   = dut.i_seal.sealed_value;
+    assign mon_sealed_mono    = dut.i_seal.sealed_mono;
+    assign mon_sealed_crc     = dut.i_seal.sealed_crc;
+    assign mon_seal_sensor_id = dut.i_seal.sensor_id_reg;
+    assign mon_wdt_enabled    = dut.i_wdt.enabled;
+    assign mon_wdt_counter    = dut.i_wdt.counter;
+
+endmodule
@@ -0,0 +1,282 @@
+// ring_trace.h — Failure-triggered waveform capture for Verilator harnesses
+//
+// Full tracing (VerilatedVcdC/FstC) of an 80M-cycle firmware run is not
+// affordable, and most of it is never looked at. RingTrace keeps only the
+// last `depth` clock cycles of a few selected model fields in memory (one
+// copy per field per cycle) and writes them to a waveform file only when
+// asked to: on a CHECK failure, a lockstep divergence, or when a trigger
+// expression over the same fields becomes true.
+//
+//   RingTrace ring(16384);
+//   ring.add("uo_out", &dut->uo_out);            // any model port / tap
+//   ring.add("bus_addr", &dut->bus_addr, 28);     // width defaults to the type
+//   ring.set_trigger("bus_addr==0x8000028&&bus_write_n!=3", "trig" + ring.ext());
+//   ... every clock, after the rising-edge eval:  ring.sample(cycle);
+//   ... on failure:                               ring.dump("fail.fst", "why");
+//
+// A trigger captures depth/2 cycles after it fires, so the event sits in
+// the middle of the window, then writes the file (once; finish() flushes a
+// trigger that fired less than depth/2 cycles before the end).
+//
+// Output is FST when the harness is Verilated with --trace-fst (uses
+// Verilator's bundled fstapi), VCD text otherwise. The clock is synthesised
+// from the cycle numbers (high at cycle*period, low half a period later).
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(VM_TRACE_FST) && VM_TRACE_FST
+#include "gtkwave/fstapi.h"
+#define RING_TRACE_FST 1
+#else
+#define RING_TRACE_FST 0
+#endif
+
+class RingTrace {
+public:
+    explicit RingTrace(size_t depth, uint32_t clk_period_ns = 40)
+        : depth_(depth ? depth : 1), period_(clk_period_ns), cycles_(depth_) {}
+
+    static const char *ext() { return RING_TRACE_FST ? ".fst" : ".vcd"; }
+
+    template <class T>
+    void add(const char *name, const T *field, int width = 8 * sizeof(T)) {
+        static_assert(sizeof(T) <= 8, "fields up to 64 bits");
+        sigs_.push_back({name, field, (int)sizeof(T), width});
+        buf_.assign(depth_ * sigs_.size(), 0);
+        count_ = head_ = 0;
+    }
+
+    // EXPR: terms joined by "&&", each "name OP value" with OP one of
+    // == != >= <= > < or "name&mask" (true when any masked bit is set).
+    // "cycle" is also accepted as a name. Returns false and sets *err on a
+    // parse error.
+    bool set_trigger(const std::string &expr, const std::string &path, std::string *err) {
+        terms_.clear();
+        size_t pos = 0;
+        while (pos <= expr.size()) {
+            size_t end = expr.find("&&", pos);
+            if (end == std::string::npos) end = expr.size();
+            Term t;
+            if (!parse_term(expr.substr(pos, end - pos), &t)) {
+                if (err) *err = "bad trigger term '" + expr.substr(pos, end - pos) + "'";
+                terms_.clear();
+                return false;
+            }
+            terms_.push_back(t);
+            pos = end + 2;
+        }
+        trigger_expr_ = expr;
+        trigger_path_ = path;
+        return true;
+    }
+
+    void sample(uint64_t cycle) {
+        size_t n = sigs_.size();
+        uint64_t *row = &buf_[head_ * n];
+        for (size_t i = 0; i < n; i++) row[i] = read(sigs_[i]);
+        cycles_[head_] = cycle;
+        head_ = (head_ + 1) % depth_;
+        if (count_ < depth_) count_++;
+
+        if (terms_.empty() || dumped_trigger_) return;
+        if (!fired_ && eval_trigger(row, cycle)) {
+            fired_ = true;
+            fire_cycle_ = cycle;
+            post_ = depth_ / 2;
+            printf("[RING] trigger '%s' at cycle %llu\n", trigger_expr_.c_str(), (unsigned long long)cycle);
+            if (post_ == 0) flush_trigger();
+        } else if (fired_ && post_ > 0 && --post_ == 0) {
+            flush_trigger();
+        }
+    }
+
+    // Flush a trigger window that is still collecting post-trigger cycles
+    void finish() {
+        if (fired_ && !dumped_trigger_) flush_trigger();
+    }
+
+    bool triggered() const { return fired_; }
+
+    bool dump(const std::string &path, const std::string &reason) {
+        bool ok = RING_TRACE_FST ? write_fst(path, reason) : write_vcd(path, reason);
+        if (ok)
+            printf("[RING] %s: last %zu cycles (%llu..%llu) -> %s\n", reason.c_str(), count_,
+                   (unsigned long long)first_cycle(), (unsigned long long)last_cycle(), path.c_str());
+        else
+            printf("[RING] cannot write %s\n", path.c_str());
+        return ok;
+    }
+
+private:
+    struct Sig {
+        std::string name;
+        const void *field;
+        int bytes, width;
+    };
+    enum Op { EQ, NE, GE, LE, GT, LT, AND };
+    struct Term {
+        int sig;                            // -1 = cycle
+        Op op;
+        uint64_t value;
+    };
+
+    static uint64_t read(const Sig &s) {
+        switch (s.bytes) {
+        case 1: return *(const uint8_t *)s.field;
+        case 2: return *(const uint16_t *)s.field;
+        case 4: return *(const uint32_t *)s.field;
+        default: return *(const uint64_t *)s.field;
+        }
+    }
+
+    bool parse_term(std::string s, Term *t) {
+        std::string clean;
+        for (char c : s)
+            if (c != ' ' && c != '\t') clean += c;
+        static const struct { const char *tok; Op op; } ops[] = {
+            {"==", EQ}, {"!=", NE}, {">=", GE}, {"<=", LE}, {">", GT}, {"<", LT}, {"&", AND}};
+        for (const auto &o : ops) {
+            size_t p = clean.find(o.tok);
+            if (p == std::string::npos || p == 0) continue;
+            std::string name = clean.substr(0, p), val = clean.substr(p + strlen(o.tok));
+            char *end = nullptr;
+            t->value = strtoull(val.c_str(), &end, 0);
+            if (val.empty() || *end) return false;
+            t->op = o.op;
+            t->sig = -2;
+            if (name == "cycle") t->sig = -1;
+            for (size_t i = 0; i < sigs_.size(); i++)
+                if (sigs_[i].name == name) t->sig = (int)i;
+            return t->sig != -2;
+        }
+        return false;
+    }
+
+    bool eval_trigger(const uint64_t *row, uint64_t cycle) const {
+        for (const Term &t : terms_) {
+            uint64_t v = t.sig < 0 ? cycle : row[t.sig];
+            bool hit;
+            switch (t.op) {
+            case EQ: hit = v == t.value; break;
+            case NE: hit = v != t.value; break;
+            case GE: hit = v >= t.value; break;
+            case LE: hit = v <= t.value; break;
+            case GT: hit = v > t.value; break;
+            case LT: hit = v < t.value; break;
+            default: hit = (v & t.value) != 0; break;
+            }
+            if (!hit) return false;
+        }
+        return true;
+    }
+
+    void flush_trigger() {
+        dumped_trigger_ = true;
+        char reason[96];
+        snprintf(reason, sizeof(reason), "trigger at cycle %llu", (unsigned long long)fire_cycle_);
+        dump(trigger_path_, reason);
+    }
+
+    size_t oldest() const { return count_ < depth_ ? 0 : head_; }
+    uint64_t first_cycle() const { return count_ ? cycles_[oldest()] : 0; }
+    uint64_t last_cycle() const { return count_ ? cycles_[(head_ + depth_ - 1) % depth_] : 0; }
+
+    static std::string bits(uint64_t v, int width) {
+        std::string s(width, '0');
+        for (int b = 0; b < width; b++)
+            if ((v >> b) & 1) s[width - 1 - b] = '1';
+        return s;
+    }
+
+    static std::string vcd_id(size_t i) {
+        std::string id;
+        do {
+            id += (char)('!' + i % 94);
+            i /= 94;
+        } while (i);
+        return id;
+    }
+
+    // Calls emit(time, sig index or -1 for clk, value) for every change in
+    // the window, oldest first
+    template <class F>
+    void walk(F emit) const {
+        size_t n = sigs_.size();
+        std::vector<uint64_t> prev(n);
+        for (size_t k = 0; k < count_; k++) {
+            size_t slot = (oldest() + k) % depth_;
+            const uint64_t *row = &buf_[slot * n];
+            uint64_t t = cycles_[slot] * period_;
+            emit(t, -1, 1);
+            for (size_t i = 0; i < n; i++)
+                if (k == 0 || row[i] != prev[i]) emit(t, (int)i, row[i]);
+            emit(t + period_ / 2, -1, 0);
+            std::memcpy(prev.data(), row, n * sizeof(uint64_t));
+        }
+    }
+
+    bool write_vcd(const std::string &path, const std::string &reason) const {
+        FILE *f = fopen(path.c_str(), "w");
+        if (!f) return false;
+        fprintf(f, "$comment %s $end\n$timescale 1ns $end\n$scope module ring $end\n", reason.c_str());
+        fprintf(f, "$var wire 1 %s clk $end\n", vcd_id(0).c_str());
+        for (size_t i = 0; i < sigs_.size(); i++)
+            fprintf(f, "$var wire %d %s %s $end\n", sigs_[i].width, vcd_id(i + 1).c_str(), sigs_[i].name.c_str());
+        fprintf(f, "$upscope $end\n$enddefinitions $end\n");
+        uint64_t last_t = ~0ULL;
+        walk([&](uint64_t t, int i, uint64_t v) {
+            if (t != last_t) fprintf(f, "#%llu\n", (unsigned long long)(last_t = t));
+            if (i < 0) fprintf(f, "%d%s\n", (int)v, vcd_id(0).c_str());
+            else if (sigs_[i].width == 1) fprintf(f, "%d%s\n", (int)(v & 1), vcd_id(i + 1).c_str());
+            else fprintf(f, "b%s %s\n", bits(v, sigs_[i].width).c_str(), vcd_id(i + 1).c_str());
+        });
+        fclose(f);
+        return true;
+    }
+
+#if RING_TRACE_FST
+    bool write_fst(const std::string &path, const std::string &reason) const {
+        void *ctx = fstWriterCreate(path.c_str(), 1);
+        if (!ctx) return false;
+        fstWriterSetTimescale(ctx, -9);
+        fstWriterSetComment(ctx, reason.c_str());
+        fstWriterSetScope(ctx, FST_ST_VCD_MODULE, "ring", nullptr);
+        std::vector<fstHandle> h(sigs_.size() + 1);
+        h[0] = fstWriterCreateVar(ctx, FST_VT_VCD_WIRE, FST_VD_IMPLICIT, 1, "clk", 0);
+        for (size_t i = 0; i < sigs_.size(); i++)
+            h[i + 1] = fstWriterCreateVar(ctx, FST_VT_VCD_WIRE, FST_VD_IMPLICIT, sigs_[i].width,
+                                          sigs_[i].name.c_str(), 0);
+        fstWriterSetUpscope(ctx);
+        uint64_t last_t = ~0ULL;
+        walk([&](uint64_t t, int i, uint64_t v) {
+            if (t != last_t) fstWriterEmitTimeChange(ctx, last_t = t);
+            int w = i < 0 ? 1 : sigs_[i].width;
+            fstWriterEmitValueChange(ctx, h[i + 1], bits(v, w).c_str());
+        });
+        fstWriterClose(ctx);
+        return true;
+    }
+#else
+    bool write_fst(const std::string &, const std::string &) const { return false; }
+#endif
+
+    size_t depth_;
+    uint32_t period_;
+    std::vector<Sig> sigs_;
+    std::vector<uint64_t> buf_;             // depth_ rows of sigs_.size() values
+    std::vector<uint64_t> cycles_;
+    size_t head_ = 0, count_ = 0;
+
+    std::vector<Term> terms_;
+    std::string trigger_expr_, trigger_path_;
+    bool fired_ = false, dumped_trigger_ = false;
+    uint64_t fire_cycle_ = 0;
+    size_t post_ = 0;
+};
@@ -1,20 +1,30 @@
 // seal_cov_tb.cpp — Verilator coverage testbench for seal_register
 // Exercises all FSM arcs, backpressure, commit_dropped, read serialization,
 // session_id locking, and standalone crc_reset.
+//
+// Tracing: full VCD (seal_cov.vcd) by default; --ring N keeps only the last
+// N cycles of the ports in memory and writes seal_cov_fail.vcd/.fst on the
+// first failed CHECK (ring_trace.h); --no-trace disables both.
 
 #include "Vseal_register.h"
 #include "verilated.h"
 #include "verilated_cov.h"
 #include "verilated_vcd_c.h"
 
+#include "ring_trace.h"
+
 #include <cstdio>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <cassert>
 
 static vluint64_t sim_time = 0;
 
 static Vseal_register *dut;
 static VerilatedVcdC   *tfp;
+static RingTrace       *ring;
+static uint64_t         cycle = 0;
 
 // ─── helpers ───────────────────────────────────────────────────────────
 
@@ -25,6 +35,8 @@ static void tick() {
     dut->clk = 1;
     dut->eval();
     if (tfp) tfp->dump(sim_time++);
+    if (ring) ring->sample(cycle);
+    cycle++;
 }
 
 static void reset() {
@@ -107,10 +119,21 @@ static void do_commit(uint32_t value, uint8_t sensor_id,
 static int test_count = 0;
 static int pass_count = 0;
 
+static void check_failed(const char *msg, int line) {
+    printf("  FAIL: %s (line %d)\n", msg, line);
+    static bool dumped = false;
+    if (ring && !dumped) {
+        char reason[160];
+        snprintf(reason, sizeof(reason), "CHECK failed: %s (line %d)", msg, line);
+        ring->dump(std::string("seal_cov_fail") + RingTrace::ext(), reason);
+        dumped = true;
+    }
+}
+
 #define CHECK(cond, msg) do { \
     test_count++; \
     if (!(cond)) { \
-        printf("  FAIL: %s (line %d)\n", msg, __LINE__); \
+        check_failed(msg, __LINE__); \
     } else { \
         pass_count++; \
     } \
@@ -401,10 +424,36 @@ int main(int argc, char **argv) {
     Verilated::commandArgs(argc, argv);
     Verilated::traceEverOn(true);
 
+    size_t ring_depth = 0;
+    bool full_trace = true;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--ring") && i + 1 < argc) { ring_depth = strtoul(argv[++i], nullptr, 0); full_trace = false; }
+        else if (!strcmp(argv[i], "--no-trace")) full_trace = false;
+    }
+
     dut = new Vseal_register;
-    tfp = new VerilatedVcdC;
-    dut->trace(tfp, 99);
-    tfp->open("seal_cov.vcd");
+    if (full_trace) {
+        tfp = new VerilatedVcdC;
+        dut->trace(tfp, 99);
+        tfp->open("seal_cov.vcd");
+    }
+    if (ring_depth) {
+        ring = new RingTrace(ring_depth);
+        ring->add("rst_n", &dut->rst_n, 1);
+        ring->add("crc_byte", &dut->crc_byte);
+        ring->add("crc_feed", &dut->crc_feed, 1);
+        ring->add("crc_busy", &dut->crc_busy, 1);
+        ring->add("crc_value", &dut->crc_value);
+        ring->add("crc_init", &dut->crc_init, 1);
+        ring->add("data_wr", &dut->data_wr, 1);
+        ring->add("data_in", &dut->data_in);
+        ring->add("data_out", &dut->data_out);
+        ring->add("data_rd", &dut->data_rd, 1);
+        ring->add("ctrl_wr", &dut->ctrl_wr, 1);
+        ring->add("ctrl_in", &dut->ctrl_in, 10);
+        ring->add("ctrl_out", &dut->ctrl_out);
+        ring->add("session_ctr_in", &dut->session_ctr_in);
+    }
 
     printf("=== seal_register coverage testbench ===\n\n");
 
@@ -422,7 +471,7 @@ int main(int argc, char **argv) {
 
     printf("\n=== Results: %d / %d PASS ===\n", pass_count, test_count);
 
-    tfp->close();
+    if (tfp) tfp->close();
     dut->final();
     // Write coverage data — try multiple paths for robustness
     const char *cov_path = "coverage.dat";
@@ -430,5 +479,6 @@ int main(int argc, char **argv) {
     printf("Coverage written to: %s\n", cov_path);
     delete dut;
 
+    printf("[PERF] %llu cycles\n", (unsigned long long)(cycle));
     return (pass_count == test_count) ? 0 : 1;
 }
@@ -0,0 +1,162 @@
+// soc_run.cpp — Run many firmware images against the Verilated SoC library
+//
+// Usage: soc_run [options] [MANIFEST...]
+//   --jobs N        tests run in parallel, one SocSim each (default 1)
+//   --filter S      only tests whose name contains S
+//   --test-dir D    where manifest images and t.image() live (default test/)
+//   --max-cycles N  default cycle limit of manifest images (80000000)
+//   --list          print the test names and exit
+//
+// Two kinds of tests run in one process:
+//   - manifest lines (default images.txt):  IMAGE EXPECT [OPTIONS]
+//     boot IMAGE, run until the UART signature EXPECT (\n escapes) has been
+//     seen, then check RULE A/B and UART framing. OPTIONS: --dio1-follows-led,
+//     --sx1268, --uart-loopback (uart_rxd = uart_txd), --max-cycles N
+//   - SOC_TEST cases linked in from tests/*.cpp (soc_test.h)
+// Each test gets a fresh SocSim (own VerilatedContext), so order and
+// --jobs do not change results.
+
+#include "soc_sim.h"
+#include "soc_test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef SOCLIB_DIR
+#define SOCLIB_DIR "."
+#endif
+
+static std::string unescape(const std::string &s) {
+    std::string r;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '\\' && i + 1 < s.size() && s[i + 1] == 'n') { r += '\n'; i++; }
+        else r += s[i];
+    }
+    return r;
+}
+
+// One manifest line as a test case
+static bool parse_manifest(const char *path, uint64_t max_cycles, std::vector<SocTestCase> &out) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        printf("[FAIL] cannot read %s\n", path);
+        return false;
+    }
+    char line[1024];
+    int lineno = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), f)) {
+        lineno++;
+        std::istringstream in(line);
+        std::string image, expect, opt;
+        if (!(in >> image) || image[0] == '#') continue;
+        if (!(in >> expect)) {
+            printf("[FAIL] %s:%d: missing signature\n", path, lineno);
+            ok = false;
+            continue;
+        }
+        bool led = false, sx = false, loop = false;
+        uint64_t limit = max_cycles;
+        while (in >> opt) {
+            if (opt == "--dio1-follows-led") led = true;
+            else if (opt == "--sx1268") sx = true;
+            else if (opt == "--uart-loopback") loop = true;
+            else if (opt == "--max-cycles" && (in >> limit)) {}
+            else {
+                printf("[FAIL] %s:%d: unknown option %s\n", path, lineno, opt.c_str());
+                ok = false;
+            }
+        }
+        std::string sig = unescape(expect), name = image.substr(0, image.rfind('.'));
+        out.push_back({name, [=](SocCheck &t) {
+            SocSim soc(t.image(image.c_str()));
+            soc.dio1_follows_led(led);
+            if (sx) soc.attach_sx1268();
+            if (loop) soc.on_cycle([](SocSim &s) { s.set_uart_rx(s.uo_out() & 1); });
+            int id = soc.uart.watch(sig);
+            soc.reset();
+            bool seen = soc.run_until([&] { return soc.uart.seen(id); }, limit);
+            t.check(seen, "UART %s after %llu cycles (%llu bytes)", expect.c_str(),
+                    (unsigned long long)soc.cycle(), (unsigned long long)soc.uart.total());
+            t.check_board(soc);
+        }});
+    }
+    fclose(f);
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    int jobs = 1;
+    const char *filter = nullptr;
+    std::string test_dir = SOCLIB_DIR "/../../test";
+    uint64_t max_cycles = 80000000ULL;
+    bool list = false;
+    std::vector<const char *> manifests;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--jobs") && i + 1 < argc) jobs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--filter") && i + 1 < argc) filter = argv[++i];
+        else if (!strcmp(argv[i], "--test-dir") && i + 1 < argc) test_dir = argv[++i];
+        else if (!strcmp(argv[i], "--max-cycles") && i + 1 < argc) max_cycles = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(argv[i], "--list")) list = true;
+        else manifests.push_back(argv[i]);
+    }
+    if (manifests.empty()) manifests.push_back(SOCLIB_DIR "/images.txt");
+
+    std::vector<SocTestCase> tests;
+    bool manifest_ok = true;
+    for (const char *m : manifests) manifest_ok &= parse_manifest(m, max_cycles, tests);
+    tests.insert(tests.end(), soc_tests().begin(), soc_tests().end());
+    if (filter)
+        tests.erase(std::remove_if(tests.begin(), tests.end(),
+                                   [&](const SocTestCase &c) { return c.name.find(filter) == std::string::npos; }),
+                    tests.end());
+
+    if (list) {
+        for (const SocTestCase &c : tests) printf("%s\n", c.name.c_str());
+        return 0;
+    }
+
+    printf("=== LoRa Edge SoC — %zu tests, %d jobs ===\n", tests.size(), jobs);
+    std::atomic<size_t> next{0};
+    std::mutex out;
+    int passed = 0, failed = manifest_ok ? 0 : 1;
+    auto worker = [&] {
+        for (size_t i; (i = next++) < tests.size();) {
+            SocCheck t;
+            t.test_dir = test_dir;
+            auto t0 = std::chrono::steady_clock::now();
+            try {
+                tests[i].fn(t);
+            } catch (const std::exception &e) {
+                t.check(false, "exception: %s", e.what());
+            }
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            bool ok = t.fail == 0 && t.pass > 0;
+            std::lock_guard<std::mutex> lock(out);
+            printf("\n--- %s: %s (%d checks, %.1f s) ---\n%s", tests[i].name.c_str(), ok ? "PASS" : "FAIL",
+                   t.pass + t.fail, secs, t.log.c_str());
+            fflush(stdout);
+            if (ok) passed++;
+            else failed++;
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int j = 1; j < jobs; j++) pool.emplace_back(worker);
+    worker();
+    for (std::thread &th : pool) th.join();
+
+    printf("\n=== Results: %d PASS, %d FAIL ===\n", passed, failed);
+    if (failed) return 1;
+    printf("ALL TESTS PASSED\n");
+    return 0;
+}
@@ -0,0 +1,144 @@
+// soc_sim.cpp — SocSim on top of the Verilated cosim_wrap (see soc_sim.h)
+
+#include "soc_sim.h"
+
+#include "Vcosim_wrap.h"
+#include "verilated.h"
+
+#include "soc_model.h"
+#include "sx1268.h"
+#include "sx1268_pins.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+struct SocSim::Impl {
+    std::unique_ptr<VerilatedContext> ctx;
+    std::unique_ptr<Vcosim_wrap> dut;
+    std::string hex;
+    uint64_t cycle = 0;
+    bool in_rst = true;
+    std::vector<std::function<void(SocSim &)>> hooks;
+    bool dio1_led = false;
+    std::unique_ptr<Sx1268> radio;
+    std::unique_ptr<Sx1268Pins> pins;
+    uint64_t rng = 1;
+};
+
+SocSim::SocSim(const std::string &hex, const std::vector<std::string> &plusargs) : p(new Impl) {
+    // $readmemh only warns on a missing file; fail loudly instead
+    FILE *f = fopen(hex.c_str(), "r");
+    if (!f) throw std::runtime_error("cannot read " + hex);
+    fclose(f);
+
+    p->hex = hex;
+    p->ctx.reset(new VerilatedContext);
+    std::string flash = "+flash_hex=" + hex;
+    std::vector<const char *> argv{"socsim", flash.c_str()};
+    for (const std::string &a : plusargs) argv.push_back(a.c_str());
+    p->ctx->commandArgs((int)argv.size(), argv.data());
+    p->dut.reset(new Vcosim_wrap{p->ctx.get()});
+
+    Vcosim_wrap *d = p->dut.get();
+    d->clk = 0;
+    d->rst_n = 0;
+    d->dio1 = 0;
+    d->sx_busy = 0;
+    d->sx_miso = 1;
+    d->uart_rx = 1;
+    d->pps = 0;
+    d->eval();
+}
+
+SocSim::~SocSim() {
+    p->dut->final();
+}
+
+void SocSim::tick() {
+    Vcosim_wrap *d = p->dut.get();
+    d->clk = 0;
+    p->ctx->timeInc(1);
+    d->eval();
+    d->clk = 1;
+    p->ctx->timeInc(1);
+    d->eval();
+
+    uint64_t c = p->cycle++;
+    uart.sample(c, d->uo_out & 1);
+    // WDT / soft reset: a read in flight is abandoned with the core state
+    bool in_rst = !d->uio_oe;
+    if (in_rst && !p->in_rst) bus_rules.reset();
+    p->in_rst = in_rst;
+    bus_rules.write(d->bus_write_n, d->bus_connect_peripheral, d->bus_data_to_write);
+    bus_rules.sample(c, d->bus_read_n, d->bus_read_complete, d->bus_connect_peripheral, d->bus_data_from_read);
+
+    if (p->dio1_led) d->dio1 = (d->uo_out >> 7) & 1;
+    if (p->pins) {
+        uint8_t ui = p->pins->eval(p->cycle, d->uo_out, 0);
+        d->dio1 = ui & 1;
+        d->sx_busy = (ui >> 1) & 1;
+        d->sx_miso = (ui >> 2) & 1;
+    }
+    for (std::function<void(SocSim &)> &fn : p->hooks) fn(*this);
+}
+
+void SocSim::run(uint64_t cycles) {
+    for (uint64_t i = 0; i < cycles; i++) tick();
+}
+
+bool SocSim::run_until(const std::function<bool()> &done, uint64_t max_cycles) {
+    for (uint64_t i = 0; i < max_cycles; i++) {
+        tick();
+        if (done()) return true;
+    }
+    return false;
+}
+
+void SocSim::reset(int cycles) {
+    p->dut->rst_n = 0;
+    for (int i = 0; i < cycles; i++) tick();
+    p->dut->rst_n = 1;
+}
+
+uint64_t SocSim::cycle() const { return p->cycle; }
+const std::string &SocSim::hex() const { return p->hex; }
+
+uint8_t SocSim::uo_out() const { return p->dut->uo_out; }
+uint8_t SocSim::uio_out() const { return p->dut->uio_out; }
+uint8_t SocSim::uio_oe() const { return p->dut->uio_oe; }
+
+void SocSim::set_rst_n(bool v) { p->dut->rst_n = v; }
+void SocSim::set_dio1(bool v) { p->dut->dio1 = v; }
+void SocSim::set_sx_busy(bool v) { p->dut->sx_busy = v; }
+void SocSim::set_sx_miso(bool v) { p->dut->sx_miso = v; }
+void SocSim::set_uart_rx(bool v) { p->dut->uart_rx = v; }
+void SocSim::set_pps(bool v) { p->dut->pps = v; }
+
+SocSim::Bus SocSim::bus() const {
+    const Vcosim_wrap *d = p->dut.get();
+    return {d->bus_addr, d->bus_write_n, d->bus_read_n, (bool)d->bus_read_complete, (bool)d->bus_data_ready,
+            d->bus_data_to_write, d->bus_data_from_read, d->bus_connect_peripheral, d->bus_interrupt_req};
+}
+
+SocSim::Debug SocSim::debug() const {
+    const Vcosim_wrap *d = p->dut.get();
+    return {(bool)d->dbg_instr_complete, (bool)d->dbg_reg_wen, (bool)d->dbg_counter_0, d->dbg_rd};
+}
+
+void SocSim::on_cycle(std::function<void(SocSim &)> fn) { p->hooks.push_back(std::move(fn)); }
+
+void SocSim::dio1_follows_led(bool on) { p->dio1_led = on; }
+
+Sx1268 &SocSim::attach_sx1268(uint32_t ack_ms) {
+    if (!p->radio) {
+        p->radio.reset(new Sx1268);
+        p->pins.reset(new Sx1268Pins(*p->radio));
+        Impl *impl = p.get();
+        p->radio->random = [impl] {
+            impl->rng = impl->rng * 6364136223846793005ULL + 1442695040888963407ULL;
+            return (uint32_t)(impl->rng >> 32);
+        };
+        sx1268_loopback_ack(*p->radio, (uint64_t)ack_ms * (SocModel::CLK_HZ / 1000));
+    }
+    return *p->radio;
+}
@@ -0,0 +1,99 @@
+// soc_sim.h — Verilated LoRa Edge SoC as a linkable library
+//
+// The board of verify/cosim_wrap.v (tt_um_techhu_rv32_trial + synchronous
+// QSPI flash/PSRAM and SHT31 models) is Verilated once into
+// build/libsocsim.a by verify/soclib/Makefile. Test programs include only
+// this header and link the library, so a testbench-only change recompiles
+// one .cpp and relinks; the RTL is not rebuilt.
+//
+// Every SocSim has its own VerilatedContext and boots the image given to
+// the constructor (+flash_hex= plusarg of qspi_flash_model_sync.v), so any
+// number of images can run one after another, or on separate threads, in
+// one process.
+//
+//   SocSim soc("../../test/fw_post.hex");
+//   soc.reset();
+//   int dn = soc.uart.watch("DN\n");
+//   soc.run_until([&] { return soc.uart.seen(dn); }, 80000000);
+//
+// Pins are the cosim_wrap ports; bus() and debug() return the project.v
+// data bus and the tinyQV debug port as of the last rising edge. uart
+// (uart_sink.h) and bus_rules (bus_rules.h) are fed every cycle.
+// on_cycle() adds per-cycle stimulus/monitors; attach_sx1268() puts the
+// verify/iss SX1268 model on the radio pins like cosim_tb --sx1268.
+
+#pragma once
+
+#include "bus_rules.h"
+#include "uart_sink.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Sx1268;
+
+class SocSim {
+public:
+    static const uint32_t CLK_HZ = 25000000;
+
+    // project.v data bus (cosim_wrap bus_* taps)
+    struct Bus {
+        uint32_t addr;
+        uint8_t  write_n, read_n;
+        bool     read_complete, data_ready;
+        uint32_t data_to_write, data_from_read;
+        uint8_t  connect_peripheral;
+        uint8_t  interrupt_req;
+    };
+
+    // tinyQV debug port
+    struct Debug {
+        bool    instr_complete, reg_wen, counter_0;
+        uint8_t rd;
+    };
+
+    UartSink       uart;
+    BusRuleMonitor bus_rules;
+
+    // plusargs are passed to the context after +flash_hex=HEX
+    explicit SocSim(const std::string &hex, const std::vector<std::string> &plusargs = {});
+    ~SocSim();
+    SocSim(const SocSim &) = delete;
+    SocSim &operator=(const SocSim &) = delete;
+
+    // ---- clock ----
+    void tick();                                // one clk period, then monitors and hooks
+    void run(uint64_t cycles);
+    bool run_until(const std::function<bool()> &done, uint64_t max_cycles);
+    void reset(int cycles = 20);                // rst_n low for N cycles, then high
+    uint64_t cycle() const;
+    const std::string &hex() const;
+
+    // ---- pins ----
+    uint8_t uo_out() const;
+    uint8_t uio_out() const;
+    uint8_t uio_oe() const;
+    bool core_in_reset() const { return !uio_oe(); }   // rst_n, WDT or soft reset hold
+    void set_rst_n(bool v);
+    void set_dio1(bool v);
+    void set_sx_busy(bool v);
+    void set_sx_miso(bool v);
+    void set_uart_rx(bool v);
+    void set_pps(bool v);
+
+    // ---- probes ----
+    Bus bus() const;
+    Debug debug() const;
+
+    // ---- board options ----
+    void on_cycle(std::function<void(SocSim &)> fn);    // after the rising edge, in order
+    void dio1_follows_led(bool on = true);              // ui_in[0] = uo_out[7]
+    Sx1268 &attach_sx1268(uint32_t ack_ms = 10);        // model + loopback gateway
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> p;
+};
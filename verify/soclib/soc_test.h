@@ -0,0 +1,83 @@
+// soc_test.h — C++ test cases for soc_run
+//
+//   SOC_TEST(wdt_reboot) {
+//       SocSim soc(t.image("fw_wdt_reboot.hex"));
+//       ...
+//       t.check(resets == 1, "one WDT reset, got %d", resets);
+//   }
+//
+// Any .cpp under verify/soclib/tests/ is linked into soc_run, which runs
+// every registered test (and every image of images.txt) in one process.
+// Output goes through the SocCheck so parallel tests do not interleave.
+
+#pragma once
+
+#include "soc_sim.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class SocCheck {
+public:
+    int pass = 0, fail = 0;
+    std::string log;
+
+    // Test image by file name, from soc_run --test-dir (default test/)
+    std::string image(const char *name) const { return test_dir + "/" + name; }
+
+    void check(bool ok, const char *fmt, ...) __attribute__((format(printf, 3, 4))) {
+        va_list ap;
+        va_start(ap, fmt);
+        append(ok ? "[PASS] " : "[FAIL] ", fmt, ap);
+        va_end(ap);
+        if (ok) pass++;
+        else fail++;
+    }
+
+    void note(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+        va_list ap;
+        va_start(ap, fmt);
+        append("  ", fmt, ap);
+        va_end(ap);
+    }
+
+    // RULE A/B and UART framing, common to every SoC run
+    void check_board(const SocSim &soc) {
+        check(soc.bus_rules.violations == 0, "RULE A/B: %llu violations",
+              (unsigned long long)soc.bus_rules.violations);
+        check(soc.uart.framing_errors == 0, "UART: %llu framing errors",
+              (unsigned long long)soc.uart.framing_errors);
+    }
+
+    std::string test_dir;
+
+private:
+    void append(const char *prefix, const char *fmt, va_list ap) {
+        char buf[512];
+        vsnprintf(buf, sizeof(buf), fmt, ap);
+        log += prefix;
+        log += buf;
+        log += '\n';
+    }
+};
+
+struct SocTestCase {
+    std::string name;
+    std::function<void(SocCheck &)> fn;
+};
+
+inline std::vector<SocTestCase> &soc_tests() {
+    static std::vector<SocTestCase> tests;
+    return tests;
+}
+
+struct SocTestReg {
+    SocTestReg(const char *name, void (*fn)(SocCheck &)) { soc_tests().push_back({name, fn}); }
+};
+
+#define SOC_TEST(name)                                               \
+    static void soc_test_##name(SocCheck &t);                        \
+    static SocTestReg soc_test_reg_##name(#name, soc_test_##name);   \
+    static void soc_test_##name(SocCheck &t)
@@ -0,0 +1,27 @@
+// post.cpp — fw_post result pairs, one check each (as cov_project_tb)
+
+#include "soc_test.h"
+
+SOC_TEST(post_pairs) {
+    SocSim soc(t.image("fw_post.hex"));
+    int dn = soc.uart.watch("DN\n");
+    soc.reset();
+    soc.run_until([&] { return soc.uart.seen(dn); }, 80000000);
+
+    const UartSink &u = soc.uart;
+    t.check(u.at(0) == 'P' && u.at(1) == 'O' && u.at(2) == 'S' && u.at(3) == 'T' && u.at(4) == '\n',
+            "Banner: POST\\n");
+    static const struct { char tag, val; const char *name; } pairs[] = {
+        {'Y', '1', "SYSINFO"}, {'C', '1', "CRC16"}, {'T', '1', "Timer"},  {'W', '1', "WDT"},
+        {'I', '1', "I2C"},     {'L', '1', "Seal_1"}, {'L', '2', "Seal_2"}, {'M', '1', "PSRAM"},
+        {'R', '1', "RTC"},
+    };
+    int idx = 5;
+    for (const auto &p : pairs) {
+        t.check(u.at(idx) == p.tag && u.at(idx + 1) == p.val, "%s: %c%c", p.name, p.tag, p.val);
+        idx += 2;
+    }
+    t.check(u.at(idx) == 'D' && u.at(idx + 1) == 'N', "Completion: DN at cycle %llu",
+            (unsigned long long)u.seen_cycle(dn));
+    t.check_board(soc);
+}
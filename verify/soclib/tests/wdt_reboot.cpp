@@ -0,0 +1,33 @@
+// wdt_reboot.cpp — fw_wdt_reboot: exactly one watchdog reset, between the
+// B1 of the first boot and the B2 of the second
+
+#include "soc_test.h"
+
+SOC_TEST(wdt_reboot_once) {
+    SocSim soc(t.image("fw_wdt_reboot.hex"));
+    int b1 = soc.uart.watch("B1"), dn = soc.uart.watch("B2DN");
+    soc.reset();
+
+    // uio_oe is 0 while the core is held in reset (rst_n or WDT hold)
+    int resets = 0;
+    bool prev = true, booted = false;
+    uint64_t reset_at = 0, hold = 0;
+    soc.on_cycle([&](SocSim &s) {
+        bool in_rst = s.core_in_reset();
+        if (!in_rst) booted = true;
+        if (booted && in_rst && !prev) {
+            resets++;
+            reset_at = s.cycle();
+        }
+        if (booted && !in_rst && prev) hold = s.cycle() - reset_at;
+        prev = in_rst;
+    });
+    bool done = soc.run_until([&] { return soc.uart.seen(dn); }, 80000000);
+
+    t.check(done, "UART B1B2DN after %llu cycles", (unsigned long long)soc.cycle());
+    t.check(resets == 1, "WDT resets: %d", resets);
+    t.check(soc.uart.seen(b1) && soc.uart.seen_cycle(b1) < reset_at && reset_at < soc.uart.seen_cycle(dn),
+            "B1 before the reset (cycle %llu), B2 after", (unsigned long long)reset_at);
+    t.note("reset hold %llu cycles", (unsigned long long)hold);
+    t.check_board(soc);
+}
@@ -0,0 +1,195 @@
+// uart_sink.h — Streaming 8N1 UART receiver for the Verilator harnesses
+//
+// sample(cycle, txd) is called once per clock with uo_out[0]. The bit
+// period is clk_hz / baud in 1/256 clock steps, so any baud works without
+// accumulated drift (115200 @ 25 MHz = 217.01 clocks/bit). A start edge is
+// confirmed at mid start bit, data bits are sampled mid-bit and a low stop
+// bit counts as a framing error (the byte is still delivered).
+//
+// Received bytes go into a buffer that is unbounded by default; set_limit(N)
+// keeps only the last N bytes (older ones are dropped and counted), so
+// multi-megabyte telemetry can run without growing memory. set_file()
+// streams every byte to a FILE as well. Nothing is printed per byte.
+//
+// Non-blocking API for the test loop:
+//   available() / getc() / read()   consume bytes in arrival order
+//   watch(pattern) -> id            seen(id), seen_cycle(id): the pattern
+//                                   ended at that cycle (checked per byte
+//                                   against the buffer tail, no rescans)
+//   at(i), str(), total()           inspect what is still buffered
+//
+// Seal records on the UART (enable_seal()): SEAL_MARKER followed by the
+// 13-byte record of seal_frame.h. The record is decoded and its CRC16
+// checked inline as it arrives; next_record() pops records in order,
+// seal_ok / seal_bad count good and corrupted ones. Text bytes never start
+// a record (0xA5 is not ASCII), and the raw bytes stay in the buffer.
+
+#pragma once
+
+#include "iss/seal_frame.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+class UartSink {
+public:
+    static const uint8_t SEAL_MARKER = 0xA5;
+    static const size_t  MAX_RECORDS = 4096;    // unread records, oldest dropped
+
+    struct Record {
+        uint64_t  cycle;                        // stop bit of the last byte
+        SealFrame frame;
+        bool      crc_ok;
+    };
+
+    uint64_t framing_errors = 0;
+    uint64_t dropped = 0;                       // bytes lost to set_limit()
+    uint64_t seal_ok = 0, seal_bad = 0, seal_dropped = 0;
+
+    explicit UartSink(uint32_t clk_hz = 25000000, uint32_t baud = 115200)
+        : period_q8((uint64_t)clk_hz * 256 / baud) {}
+
+    void set_limit(size_t bytes) { limit = bytes; }
+    void set_file(FILE *f) { file = f; }
+    void enable_seal(bool on = true) { seal = on; }
+
+    // ---- receiver ----
+    void sample(uint64_t cycle, uint8_t txd) {
+        now_q8 += 256;
+        if (bit == -1) {
+            if (prev_txd && !txd) {
+                bit = -2;                       // start bit, not yet confirmed
+                next_q8 = now_q8 + period_q8 / 2;
+            }
+            prev_txd = txd;
+            return;
+        }
+        prev_txd = txd;
+        if (now_q8 < next_q8) return;
+        next_q8 += period_q8;
+        if (bit == -2) {
+            if (txd) bit = -1;                  // glitch: back to idle
+            else { bit = 0; shift = 0; }
+        } else if (bit < 8) {
+            shift = (uint8_t)((shift >> 1) | ((txd & 1) << 7));
+            bit++;
+        } else {
+            if (!txd) framing_errors++;
+            bit = -1;
+            push(cycle, shift);
+        }
+    }
+
+    // ---- consumer ----
+    uint64_t total() const { return base + buf.size(); }
+    size_t available() const { return (size_t)(total() - rd); }
+
+    int getc() {
+        if (rd < base) rd = base;
+        if (rd == total()) return -1;
+        return (uint8_t)buf[(size_t)(rd++ - base)];
+    }
+
+    size_t read(void *dst, size_t n) {
+        uint8_t *p = (uint8_t *)dst;
+        size_t got = 0;
+        int c;
+        while (got < n && (c = getc()) >= 0) p[got++] = (uint8_t)c;
+        return got;
+    }
+
+    // Byte i of the stream (0 = first received), -1 if not buffered
+    int at(uint64_t i) const {
+        return i >= base && i < total() ? (uint8_t)buf[(size_t)(i - base)] : -1;
+    }
+    const std::string &str() const { return buf; }     // starts at byte first()
+    uint64_t first() const { return base; }
+
+    int watch(const std::string &pattern) {
+        watches.push_back({pattern, ~0ULL});
+        if (pattern.size() > longest) longest = pattern.size();
+        if (!pattern.empty() && buf.find(pattern) != std::string::npos)
+            watches.back().cycle = 0;           // already buffered: cycle unknown
+        return (int)watches.size() - 1;
+    }
+    bool seen(int id) const { return watches[id].cycle != ~0ULL; }
+    uint64_t seen_cycle(int id) const { return watches[id].cycle; }
+
+    bool next_record(Record &r) {
+        if (records.empty()) return false;
+        r = records.front();
+        records.pop_front();
+        return true;
+    }
+
+private:
+    struct Watch {
+        std::string pattern;
+        uint64_t    cycle;                      // ~0: not seen yet
+    };
+
+    uint64_t period_q8;
+    uint64_t now_q8 = 0, next_q8 = 0;
+    int      bit = -1;                          // -1 idle, -2 start bit, 0..8
+    uint8_t  shift = 0, prev_txd = 1;
+
+    std::string buf;
+    uint64_t base = 0, rd = 0;
+    size_t   limit = 0, longest = 0;
+    FILE    *file = nullptr;
+    std::vector<Watch> watches;
+
+    bool     seal = false;
+    int      seal_pos = -1;                     // -1: hunting for the marker
+    uint8_t  seal_buf[SEAL_FRAME_LEN];
+    std::deque<Record> records;
+
+    void push(uint64_t cycle, uint8_t c) {
+        buf += (char)c;
+        if (file) fputc(c, file);
+
+        for (Watch &w : watches) {
+            if (w.cycle != ~0ULL || w.pattern.empty() || (uint8_t)w.pattern.back() != c) continue;
+            size_t n = w.pattern.size();
+            if (buf.size() >= n && !buf.compare(buf.size() - n, n, w.pattern)) w.cycle = cycle;
+        }
+
+        if (seal) seal_byte(cycle, c);
+
+        // Trim in chunks so the erase is amortised over many bytes
+        size_t keep = limit > longest ? limit : longest;
+        if (limit && buf.size() >= 2 * keep) {
+            size_t drop = buf.size() - keep;
+            buf.erase(0, drop);
+            base += drop;
+            if (rd < base) {
+                dropped += base - rd;
+                rd = base;
+            }
+        }
+    }
+
+    void seal_byte(uint64_t cycle, uint8_t c) {
+        if (seal_pos < 0) {
+            if (c == SEAL_MARKER) seal_pos = 0;
+            return;
+        }
+        seal_buf[seal_pos++] = c;
+        if (seal_pos < (int)SEAL_FRAME_LEN) return;
+        seal_pos = -1;
+        Record r;
+        r.cycle = cycle;
+        r.frame.decode(seal_buf);
+        r.crc_ok = r.frame.crc == r.frame.expected_crc();
+        if (r.crc_ok) seal_ok++;
+        else seal_bad++;
+        if (records.size() >= MAX_RECORDS) {
+            records.pop_front();
+            seal_dropped++;
+        }
+        records.push_back(r);
+    }
+};